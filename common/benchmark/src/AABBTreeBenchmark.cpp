@@ -20,21 +20,30 @@
 #include <gtest/gtest.h>
 
 #include "BenchmarkUtils.h"
+#include "MapGenerator.h"
 
 #include "AABBTree.h"
-#include "IO/DiskIO.h"
-#include "IO/File.h"
-#include "IO/Path.h"
-#include "IO/Reader.h"
-#include "IO/TestParserStatus.h"
-#include "IO/WorldReader.h"
 #include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/Entity.h"
+#include "Model/Layer.h"
 #include "Model/NodeVisitor.h"
+#include "Model/PickResult.h"
 #include "Model/World.h"
+#include "RayBoxBatch.h"
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <bitset>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, Model::Node*>;
@@ -62,23 +71,307 @@ namespace TrenchBroom {
     };
 
     TEST(AABBTreeBenchmark, benchBuildTree) {
+        MapGeneratorConfig config;
+        config.worldBrushCount = 5'000;
+        config.pointEntityCount = 500;
+        config.minSides = 3;
+        config.maxSides = 8;
+        auto world = generateWorld(config);
 
-        const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
-        const auto file = IO::Disk::openFile(mapPath);
-        auto fileReader = file->reader().buffer();
-
-        IO::TestParserStatus status;
-        IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
-
-        const vm::bbox3 worldBounds(8192.0);
-        auto world = worldReader.read(Model::MapFormat::Standard, worldBounds, status);
-
-        std::vector<AABB> trees(100);
-        timeLambda([&world, &trees]() {
+        std::vector<AABB> trees;
+        measureLambda("AABBTree/AddObjects", 5, [&]() {
+            trees = std::vector<AABB>(100);
+        }, [&]() {
             for (auto& tree : trees) {
                 TreeBuilder builder(tree);
                 world->acceptAndRecurse(builder);
             }
-        }, "Add objects to AABB tree");
+        });
+    }
+
+    using IndexAABB = AABBTree<double, 3, size_t>;
+
+    static double averageIntersectorVisits(const IndexAABB& tree, const std::vector<vm::ray3>& rays) {
+        size_t visits = 0u;
+        for (const auto& ray : rays) {
+            visits += tree.countIntersectorVisits(ray);
+        }
+        return static_cast<double>(visits) / static_cast<double>(rays.size());
+    }
+
+    static constexpr double BenchmarkWorldSize = 8192.0;
+
+    /**
+     * Returns the given number of boxes of varying sizes, scattered randomly in the world.
+     */
+    static std::vector<BOX> makeRandomBoxes(const size_t count) {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> position(-BenchmarkWorldSize / 2.0, BenchmarkWorldSize / 2.0);
+        std::uniform_real_distribution<double> extent(8.0, 256.0);
+
+        std::vector<BOX> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto min = vm::vec3(position(rng), position(rng), position(rng));
+            const auto max = min + vm::vec3(extent(rng), extent(rng), extent(rng));
+            result.emplace_back(min, max);
+        }
+        return result;
+    }
+
+    /**
+     * Returns the given number of rays with random origins in the world and random directions.
+     */
+    static std::vector<vm::ray3> makeRandomRays(const size_t count) {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> position(-BenchmarkWorldSize / 2.0, BenchmarkWorldSize / 2.0);
+        std::uniform_real_distribution<double> direction(-1.0, 1.0);
+
+        std::vector<vm::ray3> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto origin = vm::vec3(position(rng), position(rng), position(rng));
+            result.emplace_back(origin, vm::normalize(vm::vec3(direction(rng), direction(rng), direction(rng))));
+        }
+        return result;
+    }
+
+    static std::vector<size_t> makeIndices(const size_t count) {
+        std::vector<size_t> result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            result.push_back(i);
+        }
+        return result;
+    }
+
+    TEST(AABBTreeBenchmark, benchBulkBuildTree) {
+        static constexpr size_t NumBoxes = 100'000;
+        static constexpr size_t NumRays = 10'000;
+
+        const auto bounds = makeRandomBoxes(NumBoxes);
+        const auto data = makeIndices(NumBoxes);
+        const auto rays = makeRandomRays(NumRays);
+
+        IndexAABB incrementalTree;
+        timeLambda([&]() {
+            for (const auto i : data) {
+                incrementalTree.insert(bounds[i], i);
+            }
+        }, "Insert " + std::to_string(NumBoxes) + " boxes into AABB tree");
+
+        IndexAABB bulkTree;
+        timeLambda([&]() {
+            bulkTree.build(data, [&](const auto i) { return bounds[i]; });
+        }, "Bulk build AABB tree from " + std::to_string(NumBoxes) + " boxes");
+
+        printf("Incremental tree: height %zu, %f average node visits per ray query\n",
+               incrementalTree.height(), averageIntersectorVisits(incrementalTree, rays));
+        printf("Bulk tree: height %zu, %f average node visits per ray query\n",
+               bulkTree.height(), averageIntersectorVisits(bulkTree, rays));
+
+        timeLambda([&]() {
+            for (const auto& ray : rays) {
+                incrementalTree.findIntersectors(ray);
+            }
+        }, "Find intersectors of " + std::to_string(NumRays) + " rays in incremental tree");
+        timeLambda([&]() {
+            for (const auto& ray : rays) {
+                bulkTree.findIntersectors(ray);
+            }
+        }, "Find intersectors of " + std::to_string(NumRays) + " rays in bulk tree");
+    }
+
+    static void printRaysPerSecond(const std::chrono::high_resolution_clock::duration& duration, const size_t numRays, const std::string& message) {
+        const auto seconds = std::chrono::duration<double>(duration).count();
+        printf("%s: %f rays/s\n", message.c_str(), static_cast<double>(numRays) / seconds);
+    }
+
+    TEST(AABBTreeBenchmark, benchFindIntersectors) {
+        static constexpr size_t NumBoxes = 100'000;
+        static constexpr size_t NumRays = 1'000'000;
+
+        const auto bounds = makeRandomBoxes(NumBoxes);
+        const auto rays = makeRandomRays(NumRays);
+
+        IndexAABB tree;
+        tree.build(makeIndices(NumBoxes), [&](const auto i) { return bounds[i]; });
+
+        size_t hits = 0u;
+        std::vector<size_t> intersectors;
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& ray : rays) {
+            intersectors.clear();
+            tree.findIntersectors(ray, std::back_inserter(intersectors));
+            hits += intersectors.size();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        printRaysPerSecond(end - start, NumRays, "Find intersectors of " + std::to_string(NumRays) + " rays in AABB tree with " + std::to_string(NumBoxes) + " boxes (" + std::to_string(hits) + " hits)");
+    }
+
+    TEST(AABBTreeBenchmark, benchAlternateUpdateAndFindIntersectors) {
+        static constexpr size_t NumBoxes = 100'000;
+        static constexpr size_t NumRays = 10'000;
+
+        const auto bounds = makeRandomBoxes(NumBoxes);
+        const auto rays = makeRandomRays(NumRays);
+
+        IndexAABB tree;
+        tree.build(makeIndices(NumBoxes), [&](const auto i) { return bounds[i]; });
+
+        // each update invalidates the query snapshot of the tree, so this must not flatten the tree for every ray
+        size_t hits = 0u;
+        std::vector<size_t> intersectors;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < NumRays; ++i) {
+            const auto index = i % NumBoxes;
+            tree.update(bounds[index].translate(vm::vec3(16.0, 0.0, 0.0)), index);
+
+            intersectors.clear();
+            tree.findIntersectors(rays[i], std::back_inserter(intersectors));
+            hits += intersectors.size();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        printRaysPerSecond(end - start, NumRays, "Update one box and find intersectors of one ray " + std::to_string(NumRays) + " times in AABB tree with " + std::to_string(NumBoxes) + " boxes (" + std::to_string(hits) + " hits)");
+    }
+
+    TEST(AABBTreeBenchmark, benchRayBoxBatch) {
+        static constexpr size_t NumBatches = 100'000;
+        static constexpr size_t NumRays = 100;
+
+        using Batch = BoxBatch<3>;
+        std::vector<Batch> batches(NumBatches);
+        const auto bounds = makeRandomBoxes(NumBatches * Batch::Width);
+        for (size_t k = 0; k < bounds.size(); ++k) {
+            for (size_t i = 0; i < 3; ++i) {
+                batches[k / Batch::Width].min[i][k % Batch::Width] = static_cast<float>(bounds[k].min[i]);
+                batches[k / Batch::Width].max[i][k % Batch::Width] = static_cast<float>(bounds[k].max[i]);
+            }
+        }
+
+        std::vector<RayBoxBatchTest<double, 3>> tests;
+        for (const auto& ray : makeRandomRays(NumRays)) {
+            tests.emplace_back(ray);
+        }
+
+        const auto numTests = std::to_string(NumRays * NumBatches * Batch::Width);
+
+        size_t scalarHits = 0u;
+        timeLambda([&]() {
+            for (const auto& test : tests) {
+                for (const auto& batch : batches) {
+                    scalarHits += std::bitset<Batch::Width>(test.testScalar(batch)).count();
+                }
+            }
+        }, "Test " + numTests + " ray / box pairs one by one");
+
+        size_t batchHits = 0u;
+        timeLambda([&]() {
+            for (const auto& test : tests) {
+                for (const auto& batch : batches) {
+                    batchHits += std::bitset<Batch::Width>(test.test(batch)).count();
+                }
+            }
+        }, "Test " + numTests + " ray / box pairs in batches");
+
+        ASSERT_EQ(scalarHits, batchHits);
+    }
+
+    TEST(AABBTreeBenchmark, benchFindIntersectorsForRayPacket) {
+        static constexpr size_t NumBoxes = 100'000;
+        static constexpr size_t NumRaysPerAxis = 512;
+
+        const auto bounds = makeRandomBoxes(NumBoxes);
+
+        IndexAABB tree;
+        tree.build(makeIndices(NumBoxes), [&](const auto i) { return bounds[i]; });
+
+        // coherent rays as they would be cast through the pixels of a viewport, ordered in 8x8 tiles
+        std::vector<vm::ray3> rays;
+        const auto origin = vm::vec3(0.0, 0.0, -BenchmarkWorldSize);
+        for (size_t tx = 0; tx < NumRaysPerAxis; tx += 8) {
+            for (size_t ty = 0; ty < NumRaysPerAxis; ty += 8) {
+                for (size_t x = tx; x < tx + 8; ++x) {
+                    for (size_t y = ty; y < ty + 8; ++y) {
+                        const auto u = static_cast<double>(x) / static_cast<double>(NumRaysPerAxis) - 0.5;
+                        const auto v = static_cast<double>(y) / static_cast<double>(NumRaysPerAxis) - 0.5;
+                        rays.emplace_back(origin, vm::normalize(vm::vec3(u, v, 1.0)));
+                    }
+                }
+            }
+        }
+
+        size_t singleHits = 0u;
+        std::vector<size_t> intersectors;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& ray : rays) {
+            intersectors.clear();
+            tree.findIntersectors(ray, std::back_inserter(intersectors));
+            singleHits += intersectors.size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        printRaysPerSecond(end - start, rays.size(), "Find intersectors of " + std::to_string(rays.size()) + " coherent rays one by one (" + std::to_string(singleHits) + " hits)");
+
+        size_t packetHits = 0u;
+        start = std::chrono::high_resolution_clock::now();
+        for (const auto& list : tree.findIntersectors(rays)) {
+            packetHits += list.size();
+        }
+        end = std::chrono::high_resolution_clock::now();
+        printRaysPerSecond(end - start, rays.size(), "Find intersectors of " + std::to_string(rays.size()) + " coherent rays in packets (" + std::to_string(packetHits) + " hits)");
+
+        ASSERT_EQ(singleHits, packetHits);
+    }
+
+    TEST(AABBTreeBenchmark, benchPickWorld) {
+        static constexpr size_t NumBrushesPerAxis = 32;
+        static constexpr size_t NumRays = 1'000'000;
+
+        const vm::bbox3 worldBounds(BenchmarkWorldSize);
+        Model::World world(Model::MapFormat::Standard);
+        Model::BrushBuilder builder(&world, worldBounds);
+
+        // a grid of cuboids with gaps between them, centered at the origin
+        std::vector<Model::Node*> brushes;
+        const auto offset = -static_cast<double>(NumBrushesPerAxis) * 64.0 / 2.0;
+        for (size_t x = 0; x < NumBrushesPerAxis; ++x) {
+            for (size_t y = 0; y < NumBrushesPerAxis; ++y) {
+                for (size_t z = 0; z < NumBrushesPerAxis; ++z) {
+                    const auto min = vm::vec3(static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)) * 64.0 + vm::vec3::fill(offset);
+                    brushes.push_back(builder.createCuboid(vm::bbox3(min, min + vm::vec3::fill(48.0)), "texture"));
+                }
+            }
+        }
+        world.defaultLayer()->addChildren(brushes);
+
+        // the brushes are inserted one by one, so the first few picks traverse the node tree until its query snapshot
+        // is built
+        const auto rays = makeRandomRays(NumRays);
+
+        size_t hits = 0u;
+        const auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& ray : rays) {
+            Model::PickResult pickResult;
+            world.pick(ray, pickResult);
+            hits += pickResult.size();
+        }
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        printRaysPerSecond(end - start, NumRays, "Pick " + std::to_string(NumRays) + " rays in world with " + std::to_string(brushes.size()) + " brushes (" + std::to_string(hits) + " hits)");
+
+        size_t batchHits = 0u;
+        const auto batchStart = std::chrono::high_resolution_clock::now();
+        std::vector<Model::PickResult> pickResults(NumRays);
+        world.pick(rays, pickResults);
+        for (const auto& pickResult : pickResults) {
+            batchHits += pickResult.size();
+        }
+        const auto batchEnd = std::chrono::high_resolution_clock::now();
+
+        printRaysPerSecond(batchEnd - batchStart, NumRays, "Pick " + std::to_string(NumRays) + " rays at once in world with " + std::to_string(brushes.size()) + " brushes (" + std::to_string(batchHits) + " hits)");
+        ASSERT_EQ(hits, batchHits);
     }
 }
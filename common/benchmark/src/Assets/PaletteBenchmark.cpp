@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Color.h"
+#include "Assets/Palette.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static Palette makePalette() {
+            std::vector<unsigned char> data(768);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<unsigned char>((i * 37u) % 256u);
+            }
+            return Palette(std::move(data));
+        }
+
+        TEST(PaletteBenchmark, benchIndexedToRgba) {
+            const auto palette = makePalette();
+
+            // the sizes of typical mip levels and skins, converted often enough to add up to a similar number of pixels
+            const size_t sizes[] = { 16, 64, 128, 256, 512 };
+            for (const auto size : sizes) {
+                const auto pixelCount = size * size;
+                const auto repetitions = (1024u * 1024u * 16u) / pixelCount;
+
+                std::vector<unsigned char> indices(pixelCount);
+                for (size_t i = 0; i < pixelCount; ++i) {
+                    indices[i] = static_cast<unsigned char>((i * 7u) % 256u);
+                }
+                std::vector<unsigned char> rgbaImage(pixelCount * 4);
+
+                for (const auto transparency : { PaletteTransparency::Opaque, PaletteTransparency::Index255Transparent }) {
+                    const auto name = "Palette/IndexedToRgba/" + std::to_string(size) + "x" + std::to_string(size) +
+                        (transparency == PaletteTransparency::Opaque ? "/Opaque" : "/Index255Transparent");
+
+                    measureLambda(name, 5, [&]() {
+                        Color averageColor;
+                        for (size_t i = 0; i < repetitions; ++i) {
+                            palette.indexedToRgba(indices, pixelCount, rgbaImage, transparency, averageColor);
+                        }
+                    });
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkReport.h"
+
+#include "Ensure.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    BenchmarkReport& BenchmarkReport::instance() {
+        static BenchmarkReport report;
+        return report;
+    }
+
+    const BenchmarkResult& BenchmarkReport::add(const std::string& name, std::vector<double> durationsMs) {
+        ensure(!durationsMs.empty(), "at least one duration is required");
+
+        std::sort(std::begin(durationsMs), std::end(durationsMs));
+
+        const auto count = durationsMs.size();
+        const auto median = count % 2u == 1u
+            ? durationsMs[count / 2u]
+            : (durationsMs[count / 2u - 1u] + durationsMs[count / 2u]) / 2.0;
+
+        // nearest rank method
+        const auto p95Rank = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(count)));
+        const auto p95 = durationsMs[std::max(p95Rank, size_t(1)) - 1u];
+
+        m_results.push_back(BenchmarkResult{name, count, durationsMs.front(), median, p95});
+        return m_results.back();
+    }
+
+    static void writeJsonString(std::ostream& stream, const std::string& str) {
+        stream << '"';
+        for (const auto c : str) {
+            switch (c) {
+                case '"':
+                    stream << "\\\"";
+                    break;
+                case '\\':
+                    stream << "\\\\";
+                    break;
+                case '\n':
+                    stream << "\\n";
+                    break;
+                case '\t':
+                    stream << "\\t";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+                        stream << escaped;
+                    } else {
+                        stream << c;
+                    }
+                    break;
+            }
+        }
+        stream << '"';
+    }
+
+    static void writeJsonNumber(std::ostream& stream, const double d) {
+        char chars[32];
+        std::snprintf(chars, sizeof(chars), "%.6f", d);
+        stream << chars;
+    }
+
+    void BenchmarkReport::writeJson(std::ostream& stream) const {
+        stream << "{\n  \"benchmarks\": [";
+        for (size_t i = 0; i < m_results.size(); ++i) {
+            const auto& result = m_results[i];
+            stream << (i > 0u ? ",\n" : "\n") << "    {\"name\": ";
+            writeJsonString(stream, result.name);
+            stream << ", \"iterations\": " << result.iterations;
+            stream << ", \"min_ms\": ";
+            writeJsonNumber(stream, result.minMs);
+            stream << ", \"median_ms\": ";
+            writeJsonNumber(stream, result.medianMs);
+            stream << ", \"p95_ms\": ";
+            writeJsonNumber(stream, result.p95Ms);
+            stream << "}";
+        }
+        stream << "\n  ]\n}\n";
+    }
+
+    /**
+     * Writes the benchmark report to the file named by the TB_BENCHMARK_JSON environment variable after all benchmarks
+     * have run.
+     */
+    class BenchmarkReportEnvironment : public ::testing::Environment {
+    public:
+        void TearDown() override {
+            const char* path = std::getenv("TB_BENCHMARK_JSON");
+            if (path != nullptr && *path != '\0') {
+                std::ofstream stream(path);
+                BenchmarkReport::instance().writeJson(stream);
+                if (!stream) {
+                    std::fprintf(stderr, "Could not write benchmark report to '%s'\n", path);
+                }
+            }
+        }
+    };
+
+    // gtest takes ownership of the environment
+    static ::testing::Environment* const benchmarkReportEnvironment = ::testing::AddGlobalTestEnvironment(new BenchmarkReportEnvironment());
+}
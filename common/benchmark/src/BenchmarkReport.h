@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_BENCHMARKREPORT_H
+#define TRENCHBROOM_BENCHMARKREPORT_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    struct BenchmarkResult {
+        std::string name;
+        size_t iterations;
+        double minMs;
+        double medianMs;
+        double p95Ms;
+    };
+
+    /**
+     * Collects the results of all benchmarks that were run.
+     *
+     * If the environment variable TB_BENCHMARK_JSON is set, the results are written as JSON to the file it names once
+     * all benchmarks have run, so that they can be compared across commits. The file contains an object with a single
+     * member "benchmarks", which is an array of objects with the members "name", "iterations", "min_ms", "median_ms"
+     * and "p95_ms".
+     */
+    class BenchmarkReport {
+    private:
+        std::vector<BenchmarkResult> m_results;
+    public:
+        static BenchmarkReport& instance();
+
+        /**
+         * Computes the statistics of the given durations and adds them to this report under the given name.
+         *
+         * @param name the name of the benchmark, should be unique
+         * @param durationsMs the measured durations in milliseconds, must not be empty
+         * @return the added result
+         */
+        const BenchmarkResult& add(const std::string& name, std::vector<double> durationsMs);
+
+        void writeJson(std::ostream& stream) const;
+    };
+}
+
+#endif //TRENCHBROOM_BENCHMARKREPORT_H
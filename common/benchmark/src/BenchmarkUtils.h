@@ -20,8 +20,13 @@
 #ifndef TRENCHBROOM_BENCHMARKUTILS_H
 #define TRENCHBROOM_BENCHMARKUTILS_H
 
+#include "BenchmarkReport.h"
+
 #include <chrono>
+#include <cstdio>
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef __GNUC__
 #define TB_NOINLINE __attribute__((noinline))
@@ -40,5 +45,38 @@ TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message) {
            std::chrono::duration<double>(end - start).count() * 1000.0);
 }
 
+/**
+ * Calls the given setup lambda and then the given lambda the given number of times, and adds the min, median and 95th
+ * percentile of the durations of the lambda calls to the benchmark report. Only the lambda calls are timed. Use the
+ * setup lambda to restore any state that the lambda modifies.
+ *
+ * The first call of the lambda is a warm-up call and is not timed.
+ */
+template<class S, class L>
+TB_NOINLINE static void measureLambda(const std::string& name, const size_t iterations, S&& setup, L&& lambda) {
+    setup();
+    lambda();
+
+    std::vector<double> durationsMs;
+    durationsMs.reserve(iterations);
+    for (size_t i = 0; i < iterations; ++i) {
+        setup();
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        lambda();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        durationsMs.push_back(std::chrono::duration<double>(end - start).count() * 1000.0);
+    }
+
+    const auto& result = TrenchBroom::BenchmarkReport::instance().add(name, std::move(durationsMs));
+    printf("%s: min %fms, median %fms, p95 %fms (%zu iterations)\n", result.name.c_str(),
+           result.minMs, result.medianMs, result.p95Ms, result.iterations);
+}
+
+template<class L>
+TB_NOINLINE static void measureLambda(const std::string& name, const size_t iterations, L&& lambda) {
+    measureLambda(name, iterations, []() {}, std::forward<L>(lambda));
+}
 
 #endif //TRENCHBROOM_BENCHMARKUTILS_H
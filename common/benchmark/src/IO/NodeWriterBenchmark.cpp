@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "IO/NodeWriter.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushesPerAxis = 32;
+
+        /**
+         * Creates a Valve 220 map containing a grid of NumBrushesPerAxis^3 slightly rotated worldspawn brushes, so that
+         * most of the written coordinates are not integers.
+         */
+        static std::string makeMap() {
+            std::stringstream str;
+            str << "{\n\"classname\" \"worldspawn\"\n\"mapversion\" \"220\"\n";
+            for (size_t x = 0; x < NumBrushesPerAxis; ++x) {
+                for (size_t y = 0; y < NumBrushesPerAxis; ++y) {
+                    for (size_t z = 0; z < NumBrushesPerAxis; ++z) {
+                        const auto x0 = static_cast<double>(x * 64), x1 = x0 + 48.0;
+                        const auto y0 = static_cast<double>(y * 64), y1 = y0 + 48.0;
+                        const auto z0 = static_cast<double>(z * 64), z1 = z0 + 48.0;
+                        const auto d = 0.1 + static_cast<double>(z) / 7.0;
+
+                        str << "{\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) ( " << x1 << " " << y0 + d << " " << z0 << " ) tex [ 1 0 0 0.5 ] [ 0 0 -1 0 ] 0 0.25 0.25\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) tex [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 0.25 0.25\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) tex [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 0.25 0.25\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) tex [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 0.25 0.25\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) tex [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 0.25 0.25\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) tex [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 0.25 0.25\n";
+                        str << "}\n";
+                    }
+                }
+            }
+            str << "}\n";
+            return str.str();
+        }
+
+        TEST(NodeWriterBenchmark, benchWriteMap) {
+            const std::string data = makeMap();
+            const vm::bbox3 worldBounds(8192.0);
+
+            TestParserStatus status;
+            WorldReader reader(data);
+            auto world = reader.read(Model::MapFormat::Valve, worldBounds, status);
+            ASSERT_EQ(NumBrushesPerAxis * NumBrushesPerAxis * NumBrushesPerAxis, world->defaultLayer()->childCount());
+
+            for (size_t i = 0; i < 3; ++i) {
+                std::stringstream str;
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                NodeWriter writer(*world, str);
+                writer.writeMap();
+                const auto end = std::chrono::high_resolution_clock::now();
+
+                const auto megabytes = static_cast<double>(str.str().size()) / (1024.0 * 1024.0);
+                const auto seconds = std::chrono::duration<double>(end - start).count();
+                std::printf("Wrote %.1f MB map with %zu brushes: %fms (%.1f MB/s)\n",
+                    megabytes, world->defaultLayer()->childCount(), seconds * 1000.0, megabytes / seconds);
+            }
+        }
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IdPakFileSystem.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumEntries = 2048;
+        static constexpr size_t EntrySize = 64 * 1024;
+
+        struct PakEntry {
+            std::string name;
+            size_t offset;
+            size_t size;
+        };
+
+        static void writeInt(std::ofstream& stream, const int32_t value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        /**
+         * Writes a Quake PAK file with NumEntries entries of EntrySize bytes each and returns its directory.
+         */
+        static std::vector<PakEntry> writePak(const Path& path) {
+            std::vector<PakEntry> entries;
+            for (size_t i = 0; i < NumEntries; ++i) {
+                entries.push_back({ "maps/entry" + std::to_string(i) + ".bsp", 12 + i * EntrySize, EntrySize });
+            }
+
+            std::ofstream stream(path.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+            stream.write("PACK", 4);
+            writeInt(stream, static_cast<int32_t>(12 + NumEntries * EntrySize));
+            writeInt(stream, static_cast<int32_t>(NumEntries * 64));
+
+            const auto data = std::vector<char>(EntrySize, 'x');
+            for (size_t i = 0; i < NumEntries; ++i) {
+                stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+            }
+
+            for (const auto& entry : entries) {
+                auto name = entry.name;
+                name.resize(56, '\0');
+                stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+                writeInt(stream, static_cast<int32_t>(entry.offset));
+                writeInt(stream, static_cast<int32_t>(entry.size));
+            }
+            return entries;
+        }
+
+        /**
+         * Buffers every entry of the given PAK file and returns the number of bytes that were copied into buffers
+         * instead of being read in place from the given mapped file, if any.
+         */
+        static size_t readEntries(const std::shared_ptr<File>& file, const std::vector<PakEntry>& entries, const MappedFile* mappedFile) {
+            size_t copied = 0;
+            for (const auto& entry : entries) {
+                const FileView view(Path(entry.name), file, entry.offset, entry.size);
+                const auto buffer = view.reader().buffer();
+                if (mappedFile == nullptr || buffer.begin() < mappedFile->begin() || buffer.end() > mappedFile->end()) {
+                    copied += static_cast<size_t>(buffer.end() - buffer.begin());
+                }
+            }
+            return copied;
+        }
+
+        TEST(PakReadingBenchmark, benchReadEntries) {
+            const auto path = Disk::getCurrentWorkingDir() + Path("benchmark.pak");
+            const auto entries = writePak(path);
+
+            {
+                const auto cFile = std::make_shared<CFile>(path);
+                size_t copied = 0;
+                measureLambda("Pak/ReadEntries/CFile", 5, [&]() {
+                    copied = readEntries(cFile, entries, nullptr);
+                });
+                std::printf("CFile: copied %zu MB\n", copied / (1024 * 1024));
+            }
+
+            {
+                const auto mappedFile = std::make_shared<MappedFile>(path);
+                size_t copied = 0;
+                measureLambda("Pak/ReadEntries/MappedFile", 5, [&]() {
+                    copied = readEntries(mappedFile, entries, mappedFile.get());
+                });
+                std::printf("MappedFile: copied %zu MB\n", copied / (1024 * 1024));
+            }
+
+            {
+                const IdPakFileSystem fs(path);
+                measureLambda("Pak/ReadEntries/IdPakFileSystem", 5, [&]() {
+                    for (const auto& entry : entries) {
+                        const auto buffer = fs.openFile(Path(entry.name))->reader().buffer();
+                        ASSERT_EQ(entry.size, static_cast<size_t>(buffer.end() - buffer.begin()));
+                    }
+                });
+            }
+
+            std::remove(path.asString().c_str());
+        }
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "IO/StandardMapParser.h"
+#include "IO/TestParserStatus.h"
+#include "Model/MapFormat.h"
+
+#include <kdl/parallel.h>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushesPerAxis = 40;
+
+        /**
+         * Creates a Valve 220 map containing a grid of NumBrushesPerAxis^3 cuboid worldspawn brushes and NumBrushesPerAxis^2
+         * point entities.
+         */
+        static std::string makeValveMap() {
+            std::stringstream str;
+            str << "// Game: Half-Life\n// Format: Valve\n";
+            str << "{\n\"classname\" \"worldspawn\"\n\"mapversion\" \"220\"\n\"wad\" \"halflife.wad\"\n";
+
+            const auto face = [&](const int x0, const int y0, const int z0, const int x1, const int y1, const int z1, const int x2, const int y2, const int z2, const char* axes) {
+                str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x1 << " " << y1 << " " << z1 << " ) ( " << x2 << " " << y2 << " " << z2 << " ) "
+                    << "some_texture_name " << axes << " 0 0.25 0.25\n";
+            };
+
+            for (size_t x = 0; x < NumBrushesPerAxis; ++x) {
+                for (size_t y = 0; y < NumBrushesPerAxis; ++y) {
+                    for (size_t z = 0; z < NumBrushesPerAxis; ++z) {
+                        const auto x0 = static_cast<int>(x * 64), x1 = x0 + 48;
+                        const auto y0 = static_cast<int>(y * 64), y1 = y0 + 48;
+                        const auto z0 = static_cast<int>(z * 64), z1 = z0 + 48;
+
+                        str << "{\n";
+                        face(x0, y0, z0, x0, y0, z1, x1, y0, z0, "[ 1 0 0 -16.5 ] [ 0 0 -1 8.125 ]");
+                        face(x0, y0, z0, x0, y1, z0, x0, y0, z1, "[ 0 1 0 -16.5 ] [ 0 0 -1 8.125 ]");
+                        face(x0, y0, z0, x1, y0, z0, x0, y1, z0, "[ 1 0 0 -16.5 ] [ 0 -1 0 8.125 ]");
+                        face(x1, y1, z1, x0, y1, z1, x1, y1, z0, "[ 1 0 0 -16.5 ] [ 0 -1 0 8.125 ]");
+                        face(x1, y1, z1, x1, y1, z0, x1, y0, z1, "[ 0 1 0 -16.5 ] [ 0 0 -1 8.125 ]");
+                        face(x1, y1, z1, x1, y0, z1, x0, y1, z1, "[ 1 0 0 -16.5 ] [ 0 0 -1 8.125 ]");
+                        str << "}\n";
+                    }
+                }
+            }
+            str << "}\n";
+
+            for (size_t i = 0; i < NumBrushesPerAxis * NumBrushesPerAxis; ++i) {
+                str << "{\n\"classname\" \"light\"\n\"origin\" \"" << i * 8 << " -32.5 128\"\n\"light\" \"300\"\n\"_color\" \"1 0.75 0.5\"\n}\n";
+            }
+            return str.str();
+        }
+
+        /**
+         * Only parses the map and counts the parsed elements, so that the benchmark measures the cost of tokenizing
+         * and parsing without building any nodes.
+         */
+        class CountingMapParser : public StandardMapParser {
+        public:
+            size_t entityCount = 0;
+            size_t brushCount = 0;
+            size_t faceCount = 0;
+        public:
+            explicit CountingMapParser(const std::string& str) :
+            StandardMapParser(str) {}
+
+            void parse(const Model::MapFormat format, ParserStatus& status, const size_t threadCount) {
+                parseEntities(format, status, threadCount);
+            }
+        private:
+            void onFormatSet(Model::MapFormat /* format */) override {}
+
+            void onBeginEntity(size_t /* line */, const std::vector<Model::EntityAttribute>& /* attributes */, const ExtraAttributes& /* extraAttributes */, ParserStatus& /* status */) override {
+                ++entityCount;
+            }
+
+            void onEndEntity(size_t /* startLine */, size_t /* lineCount */, ParserStatus& /* status */) override {}
+
+            void onBeginBrush(size_t /* line */, ParserStatus& /* status */) override {
+                ++brushCount;
+            }
+
+            void onEndBrush(size_t /* startLine */, size_t /* lineCount */, const ExtraAttributes& /* extraAttributes */, ParserStatus& /* status */) override {}
+
+            void onBrushFace(size_t /* line */, const vm::vec3& /* point1 */, const vm::vec3& /* point2 */, const vm::vec3& /* point3 */, const Model::BrushFaceAttributes& /* attribs */, const vm::vec3& /* texAxisX */, const vm::vec3& /* texAxisY */, ParserStatus& /* status */) override {
+                ++faceCount;
+            }
+        };
+
+        TEST(StandardMapParserBenchmark, benchParseValveMap) {
+            const std::string data = makeValveMap();
+            const auto megabytes = static_cast<double>(data.size()) / (1024.0 * 1024.0);
+
+            const auto maxThreadCount = kdl::parallel_default_thread_count();
+            for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+                TestParserStatus status;
+                CountingMapParser parser(data);
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                parser.parse(Model::MapFormat::Valve, status, threadCount);
+                const auto end = std::chrono::high_resolution_clock::now();
+
+                ASSERT_EQ(1u + NumBrushesPerAxis * NumBrushesPerAxis, parser.entityCount);
+                ASSERT_EQ(NumBrushesPerAxis * NumBrushesPerAxis * NumBrushesPerAxis, parser.brushCount);
+                ASSERT_EQ(6u * parser.brushCount, parser.faceCount);
+
+                const auto seconds = std::chrono::duration<double>(end - start).count();
+                std::printf("Parsed %.1f MB Valve map with %zu brushes using %zu thread(s): %fms (%.1f MB/s)\n",
+                    megabytes, parser.brushCount, threadCount, seconds * 1000.0, megabytes / seconds);
+            }
+        }
+    }
+}
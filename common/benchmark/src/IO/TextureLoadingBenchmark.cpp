@@ -0,0 +1,127 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "IO/File.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TextureReader.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumTextures = 4096;
+        static constexpr size_t TextureSize = 64;
+        // the share of textures that a typical first frame uses
+        static constexpr size_t NumVisibleTextures = NumTextures / 20;
+
+        static void appendInt(std::vector<char>& data, const uint32_t value) {
+            for (size_t i = 0; i < 4; ++i) {
+                data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+            }
+        }
+
+        /**
+         * Creates the contents of a mip texture of TextureSize x TextureSize pixels with four mip levels.
+         */
+        static std::vector<char> makeMipTexture() {
+            std::vector<char> data(16, '\0');
+            appendInt(data, TextureSize);
+            appendInt(data, TextureSize);
+
+            auto offset = static_cast<uint32_t>(data.size() + 4 * 4);
+            for (size_t i = 0; i < 4; ++i) {
+                appendInt(data, offset);
+                offset += static_cast<uint32_t>((TextureSize >> i) * (TextureSize >> i));
+            }
+
+            for (size_t i = 0; i < 4; ++i) {
+                const auto size = (TextureSize >> i) * (TextureSize >> i);
+                for (size_t j = 0; j < size; ++j) {
+                    data.push_back(static_cast<char>(j % 255));
+                }
+            }
+            return data;
+        }
+
+        static Assets::Palette makePalette() {
+            std::vector<unsigned char> data(768);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<unsigned char>(i % 256);
+            }
+            return Assets::Palette(std::move(data));
+        }
+
+        static size_t decodedSize(const std::vector<std::unique_ptr<Assets::Texture>>& textures) {
+            size_t result = 0;
+            for (const auto& texture : textures) {
+                for (const auto& buffer : texture->buffersIfUnprepared()) {
+                    result += buffer.size();
+                }
+            }
+            return result;
+        }
+
+        TEST(TextureLoadingBenchmark, benchLoadLazily) {
+            const auto data = makeMipTexture();
+
+            std::vector<std::shared_ptr<File>> files;
+            for (size_t i = 0; i < NumTextures; ++i) {
+                const auto path = Path("wad" + std::to_string(i / 256)) + Path("texture" + std::to_string(i) + ".D");
+                files.push_back(std::make_shared<NonOwningBufferFile>(path, data.data(), data.data() + data.size()));
+            }
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            const auto reader = std::make_shared<IdMipTextureReader>(nameStrategy, makePalette());
+
+            std::vector<std::unique_ptr<Assets::Texture>> eager;
+            timeLambda([&]() {
+                for (const auto& file : files) {
+                    eager.emplace_back(reader->readTexture(file));
+                }
+            }, "load textures eagerly");
+
+            std::vector<std::unique_ptr<Assets::Texture>> lazy;
+            timeLambda([&]() {
+                for (const auto& file : files) {
+                    lazy.emplace_back(TextureReader::readTextureLazily(reader, file));
+                }
+            }, "load textures lazily");
+
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumVisibleTextures; ++i) {
+                    lazy[i]->ensureDecoded();
+                }
+            }, "decode the textures of the first frame");
+
+            std::printf("Decoded %zu KB eagerly and %zu KB lazily for %zu of %zu textures\n",
+                decodedSize(eager) / 1024, decodedSize(lazy) / 1024, NumVisibleTextures, NumTextures);
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <kdl/parallel.h>
+
+#include <vecmath/bbox.h>
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushesPerAxis = 32;
+
+        /**
+         * Creates a map containing a grid of NumBrushesPerAxis^3 cuboid worldspawn brushes.
+         */
+        static std::string makeMap() {
+            std::stringstream str;
+            str << "{\n\"classname\" \"worldspawn\"\n";
+            for (size_t x = 0; x < NumBrushesPerAxis; ++x) {
+                for (size_t y = 0; y < NumBrushesPerAxis; ++y) {
+                    for (size_t z = 0; z < NumBrushesPerAxis; ++z) {
+                        const auto x0 = static_cast<int>(x * 64), x1 = x0 + 48;
+                        const auto y0 = static_cast<int>(y * 64), y1 = y0 + 48;
+                        const auto z0 = static_cast<int>(z * 64), z1 = z0 + 48;
+
+                        str << "{\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) ( " << x0 << " " << y0 << " " << z1 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x0 << " " << y0 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z0 << " ) ( " << x0 << " " << y1 << " " << z0 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y1 << " " << z0 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) tex 0 0 0 1 1\n";
+                        str << "( " << x1 << " " << y1 << " " << z1 << " ) ( " << x1 << " " << y0 << " " << z1 << " ) ( " << x0 << " " << y1 << " " << z1 << " ) tex 0 0 0 1 1\n";
+                        str << "}\n";
+                    }
+                }
+            }
+            str << "}\n";
+            return str.str();
+        }
+
+        TEST(WorldReaderBenchmark, benchParallelBrushGeometry) {
+            const std::string data = makeMap();
+            const vm::bbox3 worldBounds(8192.0);
+
+            const auto maxThreadCount = kdl::parallel_default_thread_count();
+            double serialTime = 0.0;
+
+            for (size_t threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+                TestParserStatus status;
+                WorldReader reader(data);
+                reader.setThreadCount(threadCount);
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+                const auto end = std::chrono::high_resolution_clock::now();
+
+                ASSERT_EQ(NumBrushesPerAxis * NumBrushesPerAxis * NumBrushesPerAxis, world->defaultLayer()->childCount());
+
+                const auto time = std::chrono::duration<double>(end - start).count() * 1000.0;
+                if (threadCount == 1) {
+                    serialTime = time;
+                }
+
+                std::printf("Read map with %zu brushes using %zu thread(s): %fms (speedup %.2fx)\n",
+                    world->defaultLayer()->childCount(), threadCount, time, serialTime / time);
+            }
+        }
+    }
+}
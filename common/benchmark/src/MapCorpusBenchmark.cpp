@@ -0,0 +1,256 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "MapGenerator.h"
+
+#include "IO/NodeWriter.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/AssortNodesVisitor.h"
+#include "Model/AttributeNameWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/AttributeValueWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectNodesVisitor.h"
+#include "Model/EmptyAttributeNameIssueGenerator.h"
+#include "Model/EmptyAttributeValueIssueGenerator.h"
+#include "Model/EmptyBrushEntityIssueGenerator.h"
+#include "Model/EmptyGroupIssueGenerator.h"
+#include "Model/InvalidTextureScaleIssueGenerator.h"
+#include "Model/LinkSourceIssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/LongAttributeNameIssueGenerator.h"
+#include "Model/LongAttributeValueIssueGenerator.h"
+#include "Model/MapFormat.h"
+#include "Model/MissingClassnameIssueGenerator.h"
+#include "Model/MissingDefinitionIssueGenerator.h"
+#include "Model/MixedBrushContentsIssueGenerator.h"
+#include "Model/NonIntegerPlanePointsIssueGenerator.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/PickResult.h"
+#include "Model/PointEntityWithBrushesIssueGenerator.h"
+#include "Model/World.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+#include "Renderer/BrushRenderer.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    /*
+     * These benchmarks all run on maps created by generateMap. The names of the measurements must stay stable so that
+     * their results can be compared across commits, see BenchmarkReport.
+     */
+
+    static const vm::bbox3 CorpusWorldBounds(8192.0);
+    static constexpr size_t CorpusBrushCount = 20'000;
+    static constexpr size_t CorpusEditCount = 1'000;
+
+    static MapGeneratorConfig corpusConfig(const Model::MapFormat format) {
+        MapGeneratorConfig config;
+        config.format = format;
+        config.worldBrushCount = CorpusBrushCount;
+        config.pointEntityCount = 2'000;
+        config.brushEntityCount = 200;
+        config.brushesPerBrushEntity = 4;
+        config.minSides = 3;
+        config.maxSides = 8;
+        return config;
+    }
+
+    static std::vector<Model::Brush*> collectBrushes(Model::World& world) {
+        Model::CollectBrushesVisitor visitor;
+        world.acceptAndRecurse(visitor);
+        return visitor.brushes();
+    }
+
+    static std::string corpusName(const std::string& operation, const Model::MapFormat format) {
+        return "Corpus/" + operation + "/" + Model::formatName(format);
+    }
+
+    TEST(MapCorpusBenchmark, benchLoad) {
+        for (const auto format : { Model::MapFormat::Standard, Model::MapFormat::Valve, Model::MapFormat::Quake2 }) {
+            const auto data = generateMap(corpusConfig(format));
+
+            measureLambda(corpusName("Load", format), 5, [&]() {
+                IO::TestParserStatus status;
+                IO::WorldReader reader(data);
+                auto world = reader.read(format, CorpusWorldBounds, status);
+                ASSERT_EQ(0u, status.countStatus(LogLevel::Warn));
+            });
+        }
+    }
+
+    TEST(MapCorpusBenchmark, benchSave) {
+        for (const auto format : { Model::MapFormat::Standard, Model::MapFormat::Valve, Model::MapFormat::Quake2 }) {
+            auto world = generateWorld(corpusConfig(format));
+
+            measureLambda(corpusName("Save", format), 10, [&]() {
+                std::stringstream str;
+                IO::NodeWriter writer(*world, str);
+                writer.writeMap();
+            });
+        }
+    }
+
+    TEST(MapCorpusBenchmark, benchPick) {
+        static constexpr size_t NumRays = 10'000;
+
+        const auto format = Model::MapFormat::Standard;
+        auto world = generateWorld(corpusConfig(format));
+
+        // rays from random points on a sphere around the map towards random points inside of it
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+        const auto size = vm::length(world->defaultLayer()->logicalBounds().size());
+
+        std::vector<vm::ray3> rays;
+        rays.reserve(NumRays);
+        for (size_t i = 0; i < NumRays; ++i) {
+            const auto origin = vm::normalize(vm::vec3(coordinate(rng), coordinate(rng), coordinate(rng))) * size;
+            const auto target = vm::vec3(coordinate(rng), coordinate(rng), coordinate(rng)) * size / 4.0;
+            rays.emplace_back(origin, vm::normalize(target - origin));
+        }
+
+        measureLambda(corpusName("Pick", format), 10, [&]() {
+            for (const auto& ray : rays) {
+                Model::PickResult pickResult;
+                world->pick(ray, pickResult);
+            }
+        });
+    }
+
+    TEST(MapCorpusBenchmark, benchCsgSubtract) {
+        const auto format = Model::MapFormat::Standard;
+        auto world = generateWorld(corpusConfig(format));
+        const auto brushes = collectBrushes(*world);
+
+        // for each brush, a cube that cuts off one of its corners
+        Model::BrushBuilder builder(world.get(), CorpusWorldBounds);
+        std::vector<Model::Brush*> subtrahends;
+        for (size_t i = 0; i < CorpusEditCount; ++i) {
+            const auto& bounds = brushes[i]->logicalBounds();
+            subtrahends.push_back(builder.createCuboid(vm::bbox3(bounds.max - vm::vec3::fill(16.0), bounds.max + vm::vec3::fill(16.0)), "texture"));
+        }
+
+        std::vector<Model::Brush*> results;
+        measureLambda(corpusName("CsgSubtract", format), 5, [&]() {
+            kdl::vec_clear_and_delete(results);
+        }, [&]() {
+            for (size_t i = 0; i < CorpusEditCount; ++i) {
+                const auto fragments = brushes[i]->subtract(*world, CorpusWorldBounds, "texture", subtrahends[i]);
+                results.insert(std::end(results), std::begin(fragments), std::end(fragments));
+            }
+        });
+
+        kdl::vec_clear_and_delete(results);
+        kdl::vec_clear_and_delete(subtrahends);
+    }
+
+    TEST(MapCorpusBenchmark, benchMoveVertices) {
+        const auto format = Model::MapFormat::Standard;
+        auto world = generateWorld(corpusConfig(format));
+        const auto brushes = collectBrushes(*world);
+        const auto delta = vm::vec3(0.0, 0.0, 4.0);
+
+        // move the first vertex of each brush upwards, editing copies so that every iteration starts from the same state
+        std::vector<Model::Brush*> copies;
+        measureLambda(corpusName("MoveVertices", format), 5, [&]() {
+            kdl::vec_clear_and_delete(copies);
+            for (size_t i = 0; i < CorpusEditCount; ++i) {
+                copies.push_back(brushes[i]->clone(CorpusWorldBounds));
+            }
+        }, [&]() {
+            for (auto* brush : copies) {
+                const auto vertexPositions = std::vector<vm::vec3>{ brush->vertexPositions().front() };
+                if (brush->canMoveVertices(CorpusWorldBounds, vertexPositions, delta)) {
+                    brush->moveVertices(CorpusWorldBounds, vertexPositions, delta);
+                }
+            }
+        });
+
+        kdl::vec_clear_and_delete(copies);
+    }
+
+    TEST(MapCorpusBenchmark, benchValidateIssues) {
+        const auto format = Model::MapFormat::Standard;
+        auto world = generateWorld(corpusConfig(format));
+
+        // all issue generators that MapDocument registers, except for those that require a game
+        world->registerIssueGenerator(new Model::MissingClassnameIssueGenerator());
+        world->registerIssueGenerator(new Model::MissingDefinitionIssueGenerator());
+        world->registerIssueGenerator(new Model::EmptyGroupIssueGenerator());
+        world->registerIssueGenerator(new Model::EmptyBrushEntityIssueGenerator());
+        world->registerIssueGenerator(new Model::PointEntityWithBrushesIssueGenerator());
+        world->registerIssueGenerator(new Model::LinkSourceIssueGenerator());
+        world->registerIssueGenerator(new Model::LinkTargetIssueGenerator());
+        world->registerIssueGenerator(new Model::NonIntegerPlanePointsIssueGenerator());
+        world->registerIssueGenerator(new Model::NonIntegerVerticesIssueGenerator());
+        world->registerIssueGenerator(new Model::MixedBrushContentsIssueGenerator());
+        world->registerIssueGenerator(new Model::WorldBoundsIssueGenerator(CorpusWorldBounds));
+        world->registerIssueGenerator(new Model::EmptyAttributeNameIssueGenerator());
+        world->registerIssueGenerator(new Model::EmptyAttributeValueIssueGenerator());
+        world->registerIssueGenerator(new Model::LongAttributeNameIssueGenerator(1024));
+        world->registerIssueGenerator(new Model::LongAttributeValueIssueGenerator(1024));
+        world->registerIssueGenerator(new Model::AttributeNameWithDoubleQuotationMarksIssueGenerator());
+        world->registerIssueGenerator(new Model::AttributeValueWithDoubleQuotationMarksIssueGenerator());
+        world->registerIssueGenerator(new Model::InvalidTextureScaleIssueGenerator());
+
+        Model::CollectNodesVisitor collectNodes;
+        world->acceptAndRecurse(collectNodes);
+        const auto& nodes = collectNodes.nodes();
+        const auto& issueGenerators = world->registeredIssueGenerators();
+
+        measureLambda(corpusName("ValidateIssues", format), 5, [&]() {
+            for (auto* node : nodes) {
+                node->invalidateIssues();
+            }
+        }, [&]() {
+            for (auto* node : nodes) {
+                node->issues(issueGenerators);
+            }
+        });
+    }
+
+    TEST(MapCorpusBenchmark, benchPrepareBrushRenderer) {
+        const auto format = Model::MapFormat::Standard;
+        auto world = generateWorld(corpusConfig(format));
+        const auto brushes = collectBrushes(*world);
+
+        Renderer::BrushRenderer renderer;
+        measureLambda(corpusName("PrepareBrushRenderer", format), 5, [&]() {
+            renderer.clear();
+        }, [&]() {
+            renderer.addBrushes(brushes);
+            renderer.validate();
+        });
+    }
+}
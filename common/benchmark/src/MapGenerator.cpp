@@ -0,0 +1,186 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapGenerator.h"
+
+#include "Ensure.h"
+#include "FloatType.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    static constexpr long CellSize = 64;
+    static constexpr double WorldSize = 8192.0;
+    static constexpr size_t NumTextures = 64;
+
+    struct Point {
+        long x, y, z;
+    };
+
+    static std::ostream& operator<<(std::ostream& str, const Point& p) {
+        str << "( " << p.x << " " << p.y << " " << p.z << " )";
+        return str;
+    }
+
+    /**
+     * Writes a brush face through the given points, whose normal has the given x and y components and is vertical if
+     * both are 0. The normal is only used to choose the texture axes of the Valve format.
+     */
+    static void writeFace(std::ostream& str, const Model::MapFormat format, const Point& p0, const Point& p1, const Point& p2, const long nx, const long ny, const std::string& textureName) {
+        str << p0 << " " << p1 << " " << p2 << " " << textureName;
+        switch (format) {
+            case Model::MapFormat::Valve:
+                if (nx == 0 && ny == 0) {
+                    str << " [ 1 0 0 0 ] [ 0 -1 0 0 ] 0 1 1\n";
+                } else if (std::labs(nx) >= std::labs(ny)) {
+                    str << " [ 0 1 0 0 ] [ 0 0 -1 0 ] 0 1 1\n";
+                } else {
+                    str << " [ 1 0 0 0 ] [ 0 0 -1 0 ] 0 1 1\n";
+                }
+                break;
+            case Model::MapFormat::Quake2:
+            case Model::MapFormat::Quake3_Legacy:
+            case Model::MapFormat::Daikatana:
+                str << " 0 0 0 1 1 0 0 0\n";
+                break;
+            case Model::MapFormat::Hexen2:
+                str << " 0 0 0 1 1 0\n";
+                break;
+            case Model::MapFormat::Standard:
+                str << " 0 0 0 1 1\n";
+                break;
+            case Model::MapFormat::Quake3:
+            case Model::MapFormat::Unknown:
+                ensure(false, "unsupported map format");
+        }
+    }
+
+    /**
+     * Writes a prism with the given number of sides which is centered in the given grid cell.
+     */
+    static void writeBrush(std::ostream& str, const MapGeneratorConfig& config, const Point& cellCenter, const size_t sides, std::mt19937& rng) {
+        std::uniform_int_distribution<long> radiusDist(20, 28);
+        std::uniform_int_distribution<long> heightDist(8, 24);
+        std::uniform_real_distribution<double> angleDist(0.0, 2.0 * vm::C::pi());
+        std::uniform_int_distribution<size_t> textureDist(0, NumTextures - 1u);
+
+        const auto radius = static_cast<double>(radiusDist(rng));
+        const auto halfHeight = heightDist(rng);
+        const auto angle = angleDist(rng);
+        const auto z0 = cellCenter.z - halfHeight;
+        const auto z1 = cellCenter.z + halfHeight;
+
+        // The vertices are in counter-clockwise order when viewed from above. For at most 8 sides and a radius of at
+        // least 20 units, rounding them to integers keeps the polygon convex.
+        std::vector<Point> bottom;
+        std::vector<Point> top;
+        for (size_t i = 0; i < sides; ++i) {
+            const auto a = angle + 2.0 * vm::C::pi() * static_cast<double>(i) / static_cast<double>(sides);
+            const auto x = cellCenter.x + std::lround(radius * std::cos(a));
+            const auto y = cellCenter.y + std::lround(radius * std::sin(a));
+            bottom.push_back(Point{x, y, z0});
+            top.push_back(Point{x, y, z1});
+        }
+
+        const auto textureName = [&]() { return "texture_" + std::to_string(textureDist(rng)); };
+
+        str << "{\n";
+        for (size_t i = 0; i < sides; ++i) {
+            const auto j = (i + 1u) % sides;
+            const auto nx = bottom[j].y - bottom[i].y;
+            const auto ny = bottom[i].x - bottom[j].x;
+            writeFace(str, config.format, bottom[i], top[i], bottom[j], nx, ny, textureName());
+        }
+        writeFace(str, config.format, bottom[0], bottom[1], bottom[2], 0, 0, textureName());
+        writeFace(str, config.format, top[0], top[2], top[1], 0, 0, textureName());
+        str << "}\n";
+    }
+
+    std::string generateMap(const MapGeneratorConfig& config) {
+        ensure(config.minSides >= 3 && config.minSides <= config.maxSides && config.maxSides <= 8, "invalid number of sides");
+
+        const auto brushCount = config.worldBrushCount + config.brushEntityCount * config.brushesPerBrushEntity;
+        const auto cellsPerAxis = std::max(static_cast<long>(std::ceil(std::cbrt(static_cast<double>(brushCount)))), 1l);
+        ensure(static_cast<double>(cellsPerAxis * CellSize) / 2.0 < WorldSize, "too many brushes");
+
+        std::mt19937 rng(config.seed);
+        std::uniform_int_distribution<size_t> sidesDist(config.minSides, config.maxSides);
+
+        const auto offset = -cellsPerAxis * CellSize / 2 + CellSize / 2;
+        size_t nextCell = 0;
+        const auto nextCellCenter = [&]() {
+            const auto cell = static_cast<long>(nextCell++);
+            const auto x = cell % cellsPerAxis;
+            const auto y = (cell / cellsPerAxis) % cellsPerAxis;
+            const auto z = cell / (cellsPerAxis * cellsPerAxis);
+            return Point{x * CellSize + offset, y * CellSize + offset, z * CellSize + offset};
+        };
+
+        std::stringstream str;
+        str << "{\n\"classname\" \"worldspawn\"\n";
+        if (config.format == Model::MapFormat::Valve) {
+            str << "\"mapversion\" \"220\"\n";
+        }
+        for (size_t i = 0; i < config.worldBrushCount; ++i) {
+            writeBrush(str, config, nextCellCenter(), sidesDist(rng), rng);
+        }
+        str << "}\n";
+
+        for (size_t i = 0; i < config.brushEntityCount; ++i) {
+            str << "{\n\"classname\" \"func_wall\"\n\"targetname\" \"wall_" << i << "\"\n";
+            for (size_t j = 0; j < config.brushesPerBrushEntity; ++j) {
+                writeBrush(str, config, nextCellCenter(), sidesDist(rng), rng);
+            }
+            str << "}\n";
+        }
+
+        std::uniform_int_distribution<long> originDist(-cellsPerAxis * CellSize / 2, cellsPerAxis * CellSize / 2);
+        for (size_t i = 0; i < config.pointEntityCount; ++i) {
+            const auto origin = Point{originDist(rng), originDist(rng), originDist(rng)};
+            str << "{\n\"classname\" \"light\"\n";
+            str << "\"origin\" \"" << origin.x << " " << origin.y << " " << origin.z << "\"\n";
+            str << "\"light\" \"300\"\n";
+            if (config.brushEntityCount > 0u) {
+                str << "\"target\" \"wall_" << i % config.brushEntityCount << "\"\n";
+            }
+            str << "}\n";
+        }
+
+        return str.str();
+    }
+
+    std::unique_ptr<Model::World> generateWorld(const MapGeneratorConfig& config) {
+        const auto data = generateMap(config);
+
+        IO::TestParserStatus status;
+        IO::WorldReader reader(data);
+        return reader.read(config.format, vm::bbox3(WorldSize), status);
+    }
+}
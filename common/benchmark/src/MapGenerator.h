@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_MAPGENERATOR_H
+#define TRENCHBROOM_MAPGENERATOR_H
+
+#include "Model/MapFormat.h"
+
+#include <memory>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        class World;
+    }
+
+    /**
+     * Configures the maps created by generateMap.
+     *
+     * Every brush is a prism with a random number of sides between minSides and maxSides, so it has between
+     * minSides + 2 and maxSides + 2 faces. The brushes are placed in the cells of a cubic grid which is centered at the
+     * origin, and each cell contains at most one brush, so the brushes do not overlap.
+     */
+    struct MapGeneratorConfig {
+        Model::MapFormat format = Model::MapFormat::Standard;
+        size_t worldBrushCount = 10'000;
+        size_t pointEntityCount = 1'000;
+        size_t brushEntityCount = 100;
+        size_t brushesPerBrushEntity = 4;
+        size_t minSides = 4;
+        size_t maxSides = 4;
+        unsigned int seed = 0;
+    };
+
+    /**
+     * Generates the text of a map according to the given configuration. The result only depends on the configuration, so
+     * the same configuration always yields the same map.
+     *
+     * The supported formats are Standard, Quake2, Quake3_Legacy, Daikatana, Valve and Hexen2.
+     */
+    std::string generateMap(const MapGeneratorConfig& config);
+
+    /**
+     * Generates a map according to the given configuration and reads it into a world.
+     */
+    std::unique_ptr<Model::World> generateWorld(const MapGeneratorConfig& config);
+}
+
+#endif //TRENCHBROOM_MAPGENERATOR_H
@@ -0,0 +1,114 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "MapGenerator.h"
+
+#include "Model/AssortNodesVisitor.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Polyhedron.h"
+#include "Model/Polyhedron_Instantiation.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static const vm::bbox3 WorldBounds(8192.0);
+
+        /**
+         * Returns the face planes of every brush of a large generated map, in the order in which Brush adds them to its
+         * geometry.
+         */
+        static std::vector<std::vector<vm::plane3>> collectBrushPlanes(World& world) {
+            CollectBrushesVisitor visitor;
+            world.acceptAndRecurse(visitor);
+
+            std::vector<std::vector<vm::plane3>> result;
+            for (const auto* brush : visitor.brushes()) {
+                std::vector<vm::plane3> planes;
+                for (const auto* face : brush->faces()) {
+                    planes.push_back(face->boundary());
+                }
+                result.push_back(std::move(planes));
+            }
+            return result;
+        }
+
+        static MapGeneratorConfig brushConfig() {
+            MapGeneratorConfig config;
+            config.worldBrushCount = 20'000;
+            config.pointEntityCount = 0;
+            config.brushEntityCount = 0;
+            config.minSides = 3;
+            config.maxSides = 8;
+            return config;
+        }
+
+        TEST(BrushGeometryBenchmark, benchBuildGeometries) {
+            const auto world = generateWorld(brushConfig());
+            const auto brushPlanes = collectBrushPlanes(*world);
+            const auto bounds = WorldBounds.expand(1.0);
+
+            measureLambda("BrushGeometry/Clip", 5, [&]() {
+                for (const auto& planes : brushPlanes) {
+                    BrushGeometry geometry(bounds);
+                    for (const auto& plane : planes) {
+                        geometry.clip(plane);
+                    }
+                }
+            });
+
+            size_t fallbackCount = 0u;
+            measureLambda("BrushGeometry/IntersectPlanes", 5, [&]() {
+                fallbackCount = 0u;
+                for (const auto& planes : brushPlanes) {
+                    BrushGeometry geometry;
+                    if (geometry.intersectPlanes(planes, bounds).empty()) {
+                        ++fallbackCount;
+                    }
+                }
+            });
+            std::printf("%zu of %zu brushes fell back to clipping\n", fallbackCount, brushPlanes.size());
+        }
+
+        TEST(BrushGeometryBenchmark, benchBuildBrushes) {
+            const auto world = generateWorld(brushConfig());
+
+            CollectBrushesVisitor visitor;
+            world->acceptAndRecurse(visitor);
+            const auto& brushes = visitor.brushes();
+
+            measureLambda("Brush/Build", 5, [&]() {
+                for (const auto* brush : brushes) {
+                    std::unique_ptr<Brush> clone(brush->clone(WorldBounds));
+                }
+            });
+        }
+    }
+}
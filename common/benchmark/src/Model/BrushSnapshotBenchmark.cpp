@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "MapGenerator.h"
+
+#include "Model/AssortNodesVisitor.h"
+#include "Model/Brush.h"
+#include "Model/Snapshot.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static const vm::bbox3 WorldBounds(8192.0);
+
+        /**
+         * Translates the given brushes step by step, like dragging them does. Every step takes a snapshot of the brushes
+         * before it transforms them, as the transform command does. The snapshot of the first step is kept for undo,
+         * the snapshots of the other steps are discarded when the commands are collated.
+         */
+        static void translateBrushes(const std::vector<Brush*>& brushes, const size_t steps, std::unique_ptr<Snapshot>& undoSnapshot) {
+            const auto transform = vm::translation_matrix(vm::vec3(1.0, 0.0, 0.0));
+            for (size_t i = 0; i < steps; ++i) {
+                auto snapshot = std::make_unique<Snapshot>(std::begin(brushes), std::end(brushes));
+                for (auto* brush : brushes) {
+                    brush->transform(transform, false, WorldBounds);
+                }
+                if (undoSnapshot == nullptr) {
+                    undoSnapshot = std::move(snapshot);
+                }
+            }
+        }
+
+        TEST(BrushSnapshotBenchmark, benchTranslateSelection) {
+            MapGeneratorConfig config;
+            config.worldBrushCount = 5'000;
+            config.pointEntityCount = 0;
+            config.brushEntityCount = 0;
+            config.minSides = 3;
+            config.maxSides = 8;
+            const auto world = generateWorld(config);
+
+            CollectBrushesVisitor visitor;
+            world->acceptAndRecurse(visitor);
+            const auto& brushes = visitor.brushes();
+
+            measureLambda("BrushSnapshot/Take", 10, [&]() {
+                Snapshot snapshot(std::begin(brushes), std::end(brushes));
+            });
+
+            std::unique_ptr<Snapshot> undoSnapshot;
+            measureLambda("BrushSnapshot/TranslateSelection", 5, [&]() {
+                undoSnapshot.reset();
+            }, [&]() {
+                translateBrushes(brushes, 10, undoSnapshot);
+            });
+
+            measureLambda("BrushSnapshot/Restore", 5, [&]() {
+                undoSnapshot.reset();
+                translateBrushes(brushes, 1, undoSnapshot);
+            }, [&]() {
+                undoSnapshot->restoreNodes(WorldBounds);
+            });
+        }
+    }
+}
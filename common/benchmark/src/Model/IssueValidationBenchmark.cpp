@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "MapGenerator.h"
+
+#include "Model/AssortNodesVisitor.h"
+#include "Model/AttributeNameWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/AttributeValueWithDoubleQuotationMarksIssueGenerator.h"
+#include "Model/CollectNodesVisitor.h"
+#include "Model/EmptyAttributeNameIssueGenerator.h"
+#include "Model/EmptyAttributeValueIssueGenerator.h"
+#include "Model/EmptyBrushEntityIssueGenerator.h"
+#include "Model/EmptyGroupIssueGenerator.h"
+#include "Model/Entity.h"
+#include "Model/InvalidTextureScaleIssueGenerator.h"
+#include "Model/LinkSourceIssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/LongAttributeNameIssueGenerator.h"
+#include "Model/LongAttributeValueIssueGenerator.h"
+#include "Model/MissingClassnameIssueGenerator.h"
+#include "Model/MissingDefinitionIssueGenerator.h"
+#include "Model/MixedBrushContentsIssueGenerator.h"
+#include "Model/NonIntegerPlanePointsIssueGenerator.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/PointEntityWithBrushesIssueGenerator.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <cstdio>
+#include <string>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Registers the generators that MapDocument registers, except for the missing mod generator which needs a game.
+         * Registering them invalidates all issues.
+         */
+        static void registerIssueGenerators(World& world) {
+            world.unregisterAllIssueGenerators();
+            world.registerIssueGenerator(new MissingClassnameIssueGenerator());
+            world.registerIssueGenerator(new MissingDefinitionIssueGenerator());
+            world.registerIssueGenerator(new EmptyGroupIssueGenerator());
+            world.registerIssueGenerator(new EmptyBrushEntityIssueGenerator());
+            world.registerIssueGenerator(new PointEntityWithBrushesIssueGenerator());
+            world.registerIssueGenerator(new LinkSourceIssueGenerator());
+            world.registerIssueGenerator(new LinkTargetIssueGenerator());
+            world.registerIssueGenerator(new NonIntegerPlanePointsIssueGenerator());
+            world.registerIssueGenerator(new NonIntegerVerticesIssueGenerator());
+            world.registerIssueGenerator(new MixedBrushContentsIssueGenerator());
+            world.registerIssueGenerator(new WorldBoundsIssueGenerator(vm::bbox3(8192.0)));
+            world.registerIssueGenerator(new EmptyAttributeNameIssueGenerator());
+            world.registerIssueGenerator(new EmptyAttributeValueIssueGenerator());
+            world.registerIssueGenerator(new LongAttributeNameIssueGenerator(1023));
+            world.registerIssueGenerator(new LongAttributeValueIssueGenerator(1023));
+            world.registerIssueGenerator(new AttributeNameWithDoubleQuotationMarksIssueGenerator());
+            world.registerIssueGenerator(new AttributeValueWithDoubleQuotationMarksIssueGenerator());
+            world.registerIssueGenerator(new InvalidTextureScaleIssueGenerator());
+        }
+
+        TEST(IssueValidationBenchmark, benchValidateAllIssues) {
+            MapGeneratorConfig config;
+            config.worldBrushCount = 50'000;
+            config.pointEntityCount = 5'000;
+            config.brushEntityCount = 500;
+
+            const auto world = generateWorld(config);
+
+            CollectNodesVisitor visitor;
+            world->acceptAndRecurse(visitor);
+            const auto& nodes = visitor.nodes();
+
+            size_t serialIssueCount = 0u;
+            measureLambda("IssueValidation/Serial", 5, [&]() { registerIssueGenerators(*world); }, [&]() {
+                serialIssueCount = 0u;
+                for (auto* node : nodes) {
+                    serialIssueCount += node->issues(world->registeredIssueGenerators()).size();
+                }
+            });
+
+            size_t parallelIssueCount = 0u;
+            measureLambda("IssueValidation/Parallel", 5, [&]() { registerIssueGenerators(*world); }, [&]() {
+                world->validateAllIssues();
+
+                parallelIssueCount = 0u;
+                for (auto* node : nodes) {
+                    parallelIssueCount += node->issues(world->registeredIssueGenerators()).size();
+                }
+            });
+
+            ASSERT_EQ(serialIssueCount, parallelIssueCount);
+            std::printf("%zu issues in %zu nodes\n", parallelIssueCount, nodes.size());
+        }
+    
+        TEST(IssueValidationBenchmark, benchValidateAfterEdit) {
+            MapGeneratorConfig config;
+            config.worldBrushCount = 50'000;
+            config.pointEntityCount = 5'000;
+            config.brushEntityCount = 500;
+
+            const auto world = generateWorld(config);
+            registerIssueGenerators(*world);
+            world->validateAllIssues();
+
+            AssortNodesVisitor visitor;
+            world->acceptAndRecurse(visitor);
+            auto* brush = visitor.brushes().front();
+            auto* entity = visitor.entities().front();
+
+            const vm::bbox3 worldBounds(8192.0);
+            measureLambda("IssueValidation/BrushEdit", 20, [&]() {
+                brush->transform(vm::translation_matrix(vm::vec3(1.0, 0.0, 0.0)), false, worldBounds);
+            }, [&]() {
+                world->validateAllIssues();
+            });
+
+            size_t value = 0u;
+            measureLambda("IssueValidation/AttributeEdit", 20, [&]() {
+                entity->addOrUpdateAttribute("message", std::to_string(value++));
+            }, [&]() {
+                world->validateAllIssues();
+            });
+        }
+    }
+}
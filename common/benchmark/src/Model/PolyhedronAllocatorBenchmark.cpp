@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "Allocator.h"
+#include "SlabAllocator.h"
+#include "SlabPool.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Polyhedron.h"
+
+#include <kdl/parallel.h>
+
+#include <vecmath/bbox.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumGeometries = 100'000;
+        static constexpr size_t NumShuffledGeometries = 10'000;
+
+        /**
+         * Stands in for a polyhedron element of the given size, allocated by the given allocator template.
+         */
+        template <template <class> class A, size_t Size>
+        struct MockElement : public A<MockElement<A, Size>> {
+            unsigned char data[Size];
+        };
+
+        template <class T>
+        using OldAllocator = Allocator<T>;
+
+        /**
+         * Allocates the elements of the given number of cubes, i.e. 8 vertices, 12 edges, 24 half edges and 6 faces
+         * per cube, and frees them again. If shuffle is true, the elements are freed in random order, otherwise they
+         * are freed in reverse order of their allocation.
+         */
+        template <template <class> class A>
+        static void allocateCubeElements(const size_t count, const bool shuffle) {
+            using Vertex = MockElement<A, sizeof(BrushVertex)>;
+            using Edge = MockElement<A, sizeof(BrushEdge)>;
+            using HalfEdge = MockElement<A, sizeof(BrushHalfEdge)>;
+            using Face = MockElement<A, sizeof(BrushFaceGeometry)>;
+
+            std::vector<Vertex*> vertices;
+            std::vector<Edge*> edges;
+            std::vector<HalfEdge*> halfEdges;
+            std::vector<Face*> faces;
+
+            vertices.reserve(8 * count);
+            edges.reserve(12 * count);
+            halfEdges.reserve(24 * count);
+            faces.reserve(6 * count);
+
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t j = 0; j < 8; ++j) {
+                    vertices.push_back(new Vertex());
+                }
+                for (size_t j = 0; j < 12; ++j) {
+                    edges.push_back(new Edge());
+                }
+                for (size_t j = 0; j < 24; ++j) {
+                    halfEdges.push_back(new HalfEdge());
+                }
+                for (size_t j = 0; j < 6; ++j) {
+                    faces.push_back(new Face());
+                }
+            }
+
+            if (shuffle) {
+                std::mt19937 rng(0);
+                std::shuffle(std::begin(vertices), std::end(vertices), rng);
+                std::shuffle(std::begin(edges), std::end(edges), rng);
+                std::shuffle(std::begin(halfEdges), std::end(halfEdges), rng);
+                std::shuffle(std::begin(faces), std::end(faces), rng);
+            } else {
+                std::reverse(std::begin(vertices), std::end(vertices));
+                std::reverse(std::begin(edges), std::end(edges));
+                std::reverse(std::begin(halfEdges), std::end(halfEdges));
+                std::reverse(std::begin(faces), std::end(faces));
+            }
+
+            for (auto* vertex : vertices) {
+                delete vertex;
+            }
+            for (auto* edge : edges) {
+                delete edge;
+            }
+            for (auto* halfEdge : halfEdges) {
+                delete halfEdge;
+            }
+            for (auto* face : faces) {
+                delete face;
+            }
+        }
+
+        TEST(PolyhedronAllocatorBenchmark, compareAllocators) {
+            timeLambda([]() { allocateCubeElements<OldAllocator>(NumGeometries, false); },
+                       "allocate and free the elements of " + std::to_string(NumGeometries) + " cubes with the old allocator");
+            timeLambda([]() { allocateCubeElements<SlabAllocator>(NumGeometries, false); },
+                       "allocate and free the elements of " + std::to_string(NumGeometries) + " cubes with the slab allocator");
+
+            timeLambda([]() { allocateCubeElements<OldAllocator>(NumShuffledGeometries, true); },
+                       "allocate and free the elements of " + std::to_string(NumShuffledGeometries) + " cubes in random order with the old allocator");
+            timeLambda([]() { allocateCubeElements<SlabAllocator>(NumShuffledGeometries, true); },
+                       "allocate and free the elements of " + std::to_string(NumShuffledGeometries) + " cubes in random order with the slab allocator");
+        }
+
+        TEST(PolyhedronAllocatorBenchmark, buildGeometries) {
+            const auto makeBounds = [](const size_t i) {
+                const auto offset = static_cast<FloatType>(i % 1024) * 64.0;
+                return vm::bbox3(vm::vec3(offset, 0.0, 0.0), vm::vec3(offset + 32.0, 32.0, 32.0));
+            };
+
+            std::vector<std::unique_ptr<BrushGeometry>> geometries(NumGeometries);
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumGeometries; ++i) {
+                    geometries[i] = std::make_unique<BrushGeometry>(makeBounds(i));
+                }
+                geometries.clear();
+            }, "build and destroy " + std::to_string(NumGeometries) + " cube geometries");
+
+            geometries.resize(NumGeometries);
+            timeLambda([&]() {
+                kdl::parallel_for(NumGeometries, [&](const size_t i) {
+                    geometries[i] = std::make_unique<BrushGeometry>(makeBounds(i));
+                });
+                geometries.clear();
+            }, "build and destroy " + std::to_string(NumGeometries) + " cube geometries on " + std::to_string(kdl::parallel_default_thread_count()) + " threads");
+
+            geometries.resize(NumGeometries);
+            timeLambda([&]() {
+                SlabPool::Arena arena;
+                {
+                    const SlabPool::Arena::Scope scope(arena);
+                    for (size_t i = 0; i < NumGeometries; ++i) {
+                        geometries[i] = std::make_unique<BrushGeometry>(makeBounds(i));
+                    }
+                }
+                geometries.clear();
+            }, "build and destroy " + std::to_string(NumGeometries) + " cube geometries in an arena");
+
+            ASSERT_TRUE(geometries.empty());
+        }
+    }
+}
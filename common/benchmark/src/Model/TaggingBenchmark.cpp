@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "MapGenerator.h"
+
+#include "Model/AssortNodesVisitor.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/Tag.h"
+#include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
+#include "Model/World.h"
+
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Returns smart tags like those of the bundled game configurations. The texture name patterns match some of the
+         * textures of the generated maps.
+         */
+        static std::vector<SmartTag> smartTags() {
+            std::vector<SmartTag> result;
+            const auto addTag = [&](const std::string& name, std::unique_ptr<TagMatcher> matcher) {
+                result.emplace_back(name, std::vector<TagAttribute>{}, std::move(matcher));
+                result.back().setIndex(result.size() - 1u);
+            };
+
+            addTag("Trigger", std::make_unique<EntityClassNameTagMatcher>("trigger*", "trigger"));
+            addTag("Clip", std::make_unique<TextureNameTagMatcher>("clip"));
+            addTag("Skip", std::make_unique<TextureNameTagMatcher>("skip"));
+            addTag("Hint", std::make_unique<TextureNameTagMatcher>("hint*"));
+            addTag("Liquid", std::make_unique<TextureNameTagMatcher>("\\**"));
+            addTag("Sky", std::make_unique<TextureNameTagMatcher>("sky*"));
+            addTag("Texture1x", std::make_unique<TextureNameTagMatcher>("texture_1?"));
+            addTag("TextureDigits", std::make_unique<TextureNameTagMatcher>("*_%*3"));
+            addTag("Water", std::make_unique<SurfaceParmTagMatcher>("water"));
+            addTag("Detail", std::make_unique<ContentFlagsTagMatcher>(1 << 27));
+            return result;
+        }
+
+        TEST(TaggingBenchmark, benchUpdateFaceTags) {
+            MapGeneratorConfig config;
+            config.worldBrushCount = 50'000;
+            config.minSides = 3;
+            config.maxSides = 8;
+            const auto world = generateWorld(config);
+
+            CollectBrushesVisitor visitor;
+            world->acceptAndRecurse(visitor);
+
+            std::vector<BrushFace*> faces;
+            for (auto* brush : visitor.brushes()) {
+                for (auto* face : brush->faces()) {
+                    faces.push_back(face);
+                }
+            }
+
+            TagManager tagManager;
+            tagManager.registerSmartTags(smartTags());
+
+            // evaluates every smart tag against every face
+            measureLambda("Tagging/Uncached", 5, [&]() {
+                for (auto* face : faces) {
+                    for (const auto& tag : tagManager.smartTags()) {
+                        tag.update(*face);
+                    }
+                }
+            });
+
+            // evaluates the texture tags once per texture, as after loading texture collections
+            measureLambda("Tagging/Invalidated", 5, [&]() {
+                tagManager.invalidateTextureTags();
+            }, [&]() {
+                for (auto* face : faces) {
+                    tagManager.updateTags(*face);
+                }
+            });
+
+            measureLambda("Tagging/Cached", 5, [&]() {
+                for (auto* face : faces) {
+                    tagManager.updateTags(*face);
+                }
+            });
+        }
+    }
+}
@@ -21,6 +21,7 @@
 
 #include "BenchmarkUtils.h"
 
+#include "FloatType.h"
 #include "Assets/Texture.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
@@ -28,9 +29,17 @@
 #include "Model/World.h"
 #include "Model/MapFormat.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/Frustum.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
 
 #include <vector>
 #include <chrono>
+#include <cstdio>
 #include <string>
 #include <tuple>
 #include <algorithm>
@@ -39,6 +48,9 @@ namespace TrenchBroom {
     namespace Renderer {
         static constexpr size_t NumBrushes = 64'000;
         static constexpr size_t NumTextures = 256;
+        static constexpr size_t NumMovedBrushes = 1000;
+        static constexpr size_t NumGridBrushesPerAxis = 64;
+        static constexpr size_t NumCameraSteps = 64;
 
         /**
          * Both returned vectors need to be freed with VecUtils::clearAndDelete
@@ -126,6 +138,130 @@ namespace TrenchBroom {
             kdl::vec_clear_and_delete(brushes);
             kdl::vec_clear_and_delete(textures);
         }
+
+        TEST(BrushRendererBenchmark, benchValidateAllBrushes) {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::Brush*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            // after loading a map, all brushes are invalid and none of them has its vertices cached
+            BrushRenderer r;
+            measureLambda("BrushRenderer/ValidateAll", 10, [&]() {
+                r.clear();
+                r.addBrushes(brushes);
+                for (auto* brush : brushes) {
+                    brush->invalidateVertexCache();
+                }
+            }, [&]() {
+                r.validate();
+            });
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        TEST(BrushRendererBenchmark, benchMoveSelectedBrushes) {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::Brush*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+
+            BrushRenderer r;
+            r.addBrushes(brushes);
+            r.validate();
+
+            // every frame, the selected brushes are moved by one grid unit, which changes their vertices but not
+            // their vertex and index counts
+            const std::vector<Model::Brush*> selectedBrushes(std::begin(brushes), std::begin(brushes) + NumMovedBrushes);
+            const vm::bbox3 worldBounds(8192.0);
+            const auto translation = vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0));
+
+            measureLambda("BrushRenderer/MoveSelectedBrushes", 100, [&]() {
+                for (auto* brush : selectedBrushes) {
+                    brush->transform(translation, false, worldBounds);
+                }
+                r.invalidateBrushes(selectedBrushes);
+            }, [&]() {
+                r.validate();
+            });
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
+
+        /**
+         * Moves the given brushes into a horizontal grid of NumGridBrushesPerAxis^2 cells with a spacing of 128 units,
+         * stacking the remaining brushes on top of each other.
+         */
+        static void spreadBrushes(const std::vector<Model::Brush*>& brushes) {
+            const vm::bbox3 worldBounds(8192.0);
+            const auto halfExtent = static_cast<FloatType>(NumGridBrushesPerAxis * 128) / 2.0;
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                const auto x = static_cast<FloatType>(i % NumGridBrushesPerAxis) * 128.0 - halfExtent;
+                const auto y = static_cast<FloatType>((i / NumGridBrushesPerAxis) % NumGridBrushesPerAxis) * 128.0 - halfExtent;
+                const auto z = static_cast<FloatType>(i / (NumGridBrushesPerAxis * NumGridBrushesPerAxis)) * 128.0;
+                brushes[i]->transform(vm::translation_matrix(vm::vec3(x, y, z)), false, worldBounds);
+            }
+        }
+
+        TEST(BrushRendererBenchmark, benchCullCameraPaths) {
+            auto brushesTextures = makeBrushes();
+            std::vector<Model::Brush*> brushes = brushesTextures.first;
+            std::vector<Assets::Texture*> textures = brushesTextures.second;
+            spreadBrushes(brushes);
+
+            BrushRenderer r;
+            r.addBrushes(brushes);
+            r.validate();
+
+            // everything is submitted without culling
+            r.cull(Frustum());
+            const auto totalIndexCount = r.visibleIndexCount();
+
+            // each path is a list of camera positions and directions, which are interpolated in NumCameraSteps steps
+            struct CameraPath {
+                std::string name;
+                vm::vec3f fromPosition, toPosition;
+                vm::vec3f fromDirection, toDirection;
+            };
+
+            const std::vector<CameraPath> paths = {
+                { "FlyThrough", vm::vec3f(-4096.0f, 0.0f, 256.0f), vm::vec3f(4096.0f, 0.0f, 256.0f), vm::vec3f::pos_x(), vm::vec3f::pos_x() },
+                { "Turn", vm::vec3f(0.0f, 0.0f, 256.0f), vm::vec3f(0.0f, 0.0f, 256.0f), vm::vec3f::pos_x(), vm::vec3f::neg_x() },
+                { "Overview", vm::vec3f(-4096.0f, -4096.0f, 4096.0f), vm::vec3f(4096.0f, -4096.0f, 4096.0f), normalize(vm::vec3f(1.0f, 1.0f, -1.0f)), normalize(vm::vec3f(-1.0f, 1.0f, -1.0f)) },
+            };
+
+            for (const auto& path : paths) {
+                PerspectiveCamera camera;
+                camera.setFarPlane(16384.0f);
+
+                std::vector<Frustum> frustums;
+                for (size_t i = 0; i < NumCameraSteps; ++i) {
+                    const auto t = static_cast<float>(i) / static_cast<float>(NumCameraSteps - 1);
+                    auto direction = (1.0f - t) * path.fromDirection + t * path.toDirection;
+                    if (vm::is_zero(direction, vm::constants<float>::almost_zero())) {
+                        direction = vm::vec3f::pos_y();
+                    }
+
+                    camera.moveTo((1.0f - t) * path.fromPosition + t * path.toPosition);
+                    camera.setDirection(normalize(direction), vm::vec3f::pos_z());
+                    frustums.emplace_back(camera);
+                }
+
+                size_t submittedIndexCount = 0;
+                measureLambda("BrushRenderer/Cull/" + path.name, 10, [&]() {
+                    submittedIndexCount = 0;
+                    for (const auto& frustum : frustums) {
+                        r.cull(frustum);
+                        submittedIndexCount += r.visibleIndexCount();
+                    }
+                });
+
+                std::printf("%s: submitted %zu of %zu indices per frame on average\n", path.name.c_str(),
+                    submittedIndexCount / NumCameraSteps, totalIndexCount);
+            }
+
+            kdl::vec_clear_and_delete(brushes);
+            kdl::vec_clear_and_delete(textures);
+        }
     }
 }
-
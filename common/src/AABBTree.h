@@ -21,6 +21,7 @@
 #define TRENCHBROOM_AABBTREE_H
 
 #include "Exceptions.h"
+#include "RayBoxBatch.h"
 
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
@@ -30,15 +31,25 @@
 
 #include <kdl/overloaded.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iosfwd>
+#include <iterator>
+#include <limits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
 /**
  * An axis aligned bounding box tree that allows for quick ray intersection queries.
  *
+ * The queries are const, but they update a read optimized copy of the tree that is kept in mutable members. Therefore,
+ * a tree must not be queried by multiple threads at once, even if none of them modifies it.
+ *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
  * @tparam U the node data to store in the leafs
@@ -88,6 +99,90 @@ namespace TrenchBroom {
         LambdaVisitor(I_V innerNodeVisitor, L_V outerNodeVisitor) -> LambdaVisitor<I_V, L_V>;
 #endif
 
+        using FlatBoxBatch = BoxBatch<S>;
+        static constexpr size_t FlatWidth = FlatBoxBatch::Width;
+
+        // marks a child reference of a flat node as referring to a leaf
+        static constexpr std::uint32_t FlatLeafBit = 0x80000000u;
+
+        /**
+         * A node of the flattened tree that is used for queries. Each flat node has up to FlatWidth children, which
+         * are either other flat nodes or leafs, so that a ray can be tested against all children at once. The flat
+         * nodes are stored in depth first order in a contiguous array.
+         *
+         * The bounds of the children are enlarged slightly and rounded outwards to single precision. They are only
+         * used to skip subtrees, and the exact bounds of a leaf are checked before it is reported, so queries return
+         * the same results as if they were performed on the exact bounds.
+         */
+        struct FlatNode {
+            FlatBoxBatch bounds{};
+            // the index of the child's flat node, or the index of the child's leaf in the flat leaf array with
+            // FlatLeafBit set
+            std::uint32_t children[FlatWidth]{};
+            std::uint32_t childCount{0u};
+
+            void setChild(const size_t index, const Box& childBounds, const std::uint32_t child) {
+                for (size_t i = 0u; i < S; ++i) {
+                    bounds.min[i][index] = roundToFloat(childBounds.min[i] - FlatNodeSlack, -std::numeric_limits<float>::infinity());
+                    bounds.max[i][index] = roundToFloat(childBounds.max[i] + FlatNodeSlack, +std::numeric_limits<float>::infinity());
+                }
+                children[index] = child;
+            }
+
+            unsigned childMask() const {
+                return (1u << childCount) - 1u;
+            }
+
+            unsigned containsMask(const vm::vec<T,S>& point) const {
+                unsigned result = 0u;
+                for (size_t j = 0u; j < childCount; ++j) {
+                    bool contains = true;
+                    for (size_t i = 0u; i < S; ++i) {
+                        contains = contains
+                            && point[i] >= static_cast<T>(bounds.min[i][j])
+                            && point[i] <= static_cast<T>(bounds.max[i][j]);
+                    }
+                    if (contains) {
+                        result |= 1u << j;
+                    }
+                }
+                return result;
+            }
+
+            unsigned intersectsMask(const Box& box) const {
+                unsigned result = 0u;
+                for (size_t j = 0u; j < childCount; ++j) {
+                    bool intersects = true;
+                    for (size_t i = 0u; i < S; ++i) {
+                        intersects = intersects
+                            && box.max[i] >= static_cast<T>(bounds.min[i][j])
+                            && box.min[i] <= static_cast<T>(bounds.max[i][j]);
+                    }
+                    if (intersects) {
+                        result |= 1u << j;
+                    }
+                }
+                return result;
+            }
+        };
+
+        /**
+         * The amount by which the bounds of flat nodes are enlarged to absorb rounding errors of the ray test.
+         */
+        static constexpr T FlatNodeSlack = static_cast<T>(1) / static_cast<T>(1024);
+
+        /**
+         * Converts the given value to float, rounding towards the given direction if the value cannot be represented
+         * exactly.
+         */
+        static float roundToFloat(const T value, const float direction) {
+            const auto result = static_cast<float>(value);
+            if (static_cast<T>(result) == value) {
+                return result;
+            }
+            return (static_cast<T>(result) < value) == (direction > 0.0f) ? std::nextafter(result, direction) : result;
+        }
+
         class Node {
         public:
             Box m_bounds;
@@ -152,6 +247,16 @@ namespace TrenchBroom {
             virtual void appendTo(std::ostream& str, const std::string& indent, size_t level) const = 0;
 
             virtual void checkParentPointers(const Node* expectedParent) const = 0;
+
+            /**
+             * Appends the flat nodes of the subtree rooted at this node to the given array in depth first order, and
+             * appends the leafs of the subtree to the given leaf array.
+             *
+             * @param flatNodes the flat node array
+             * @param flatLeafs the flat leaf array
+             * @return the reference to this node to store in its parent flat node
+             */
+            virtual std::uint32_t flatten(std::vector<FlatNode>& flatNodes, std::vector<const LeafNode*>& flatLeafs) const = 0;
         protected:
             /**
              * Updates the bounds of this node.
@@ -368,6 +473,45 @@ namespace TrenchBroom {
                     m_right->accept(visitor);
                 }
             }
+
+            std::uint32_t flatten(std::vector<FlatNode>& flatNodes, std::vector<const LeafNode*>& flatLeafs) const override {
+                // Collapse the subtree into up to FlatWidth children by repeatedly replacing the inner node with the
+                // largest surface area by its children. The order of the children is preserved so that the flat tree
+                // is traversed in the same order as this tree.
+                const Node* children[FlatWidth] = { m_left, m_right };
+                size_t childCount = 2u;
+                while (childCount < FlatWidth) {
+                    size_t expand = childCount;
+                    for (size_t i = 0u; i < childCount; ++i) {
+                        if (children[i]->height() > 1u && (expand == childCount || halfSurfaceArea(children[i]->bounds()) > halfSurfaceArea(children[expand]->bounds()))) {
+                            expand = i;
+                        }
+                    }
+                    if (expand == childCount) {
+                        break;
+                    }
+
+                    const auto* innerNode = static_cast<const InnerNode*>(children[expand]);
+                    for (size_t i = childCount; i > expand + 1u; --i) {
+                        children[i] = children[i - 1u];
+                    }
+                    children[expand] = innerNode->m_left;
+                    children[expand + 1u] = innerNode->m_right;
+                    ++childCount;
+                }
+
+                const auto index = flatNodes.size();
+                flatNodes.emplace_back();
+
+                FlatNode flatNode;
+                flatNode.childCount = static_cast<std::uint32_t>(childCount);
+                for (size_t i = 0u; i < childCount; ++i) {
+                    flatNode.setChild(i, children[i]->bounds(), children[i]->flatten(flatNodes, flatLeafs));
+                }
+                flatNodes[index] = flatNode;
+
+                return static_cast<std::uint32_t>(index);
+            }
         public:
             void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
                 for (size_t i = 0; i < level; ++i)
@@ -451,6 +595,12 @@ namespace TrenchBroom {
                 visitor.visit(this);
             }
 
+            std::uint32_t flatten(std::vector<FlatNode>&, std::vector<const LeafNode*>& flatLeafs) const override {
+                const auto index = flatLeafs.size();
+                flatLeafs.push_back(this);
+                return static_cast<std::uint32_t>(index) | FlatLeafBit;
+            }
+
             void appendTo(std::ostream& str, const std::string& indent, const size_t level) const override {
                 for (size_t i = 0; i < level; ++i)
                     str << indent;
@@ -467,8 +617,22 @@ namespace TrenchBroom {
     private:
         Node* m_root;
         std::unordered_map<U, LeafNode*> m_leafForData;
+
+        /*
+         * A read optimized copy of the tree that is used for queries. Modifying the tree invalidates the copy, and
+         * queries traverse the tree itself until the copy is rebuilt. Rebuilding the copy takes time linear in the
+         * number of leafs, so this only happens once the queries have visited as many nodes of the tree since the last
+         * rebuild. This way, alternating modifications and queries do not flatten the entire tree for every query.
+         */
+        mutable std::vector<FlatNode> m_flatNodes;
+        mutable std::vector<const LeafNode*> m_flatLeafs;
+        mutable bool m_flatNodesValid;
+        mutable size_t m_unflattenedVisits;
     public:
-        AABBTree() : m_root(nullptr) {}
+        AABBTree() :
+        m_root(nullptr),
+        m_flatNodesValid(false),
+        m_unflattenedVisits(0u) {}
 
         ~AABBTree() {
             clear();
@@ -486,17 +650,41 @@ namespace TrenchBroom {
         }
 
         /**
-         * Clears this tree and rebuilds it by inserting given objects.
+         * Clears this tree and rebuilds it from the given objects in one go.
+         *
+         * The tree is built top down by splitting the objects recursively using a binned surface area heuristic. This
+         * is much faster than inserting the objects one by one, and the resulting tree does not depend on the order of
+         * the given objects and is usually better balanced, which speeds up queries. The read optimized copy of the
+         * tree that is used for queries is built right away.
          *
          * @param objects the objects to insert, a list of DataType
          * @param getBounds a function from DataType -> Box to compute the bounds of each object
+         *
+         * @throws NodeTreeException if the given objects contain duplicates or if any bounds contain NaN; the tree is
+         * empty in that case
          */
         template <typename DataList, typename GetBounds>
-        void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
+        void build(const DataList& objects, GetBounds&& getBounds) {
             clear();
+
+            std::vector<BuildItem> items;
+            items.reserve(static_cast<size_t>(std::distance(std::begin(objects), std::end(objects))));
+
             for (const U& object : objects) {
-                insert(getBounds(object), object);
+                const Box bounds = getBounds(object);
+                check(bounds);
+
+                if (!m_leafForData.emplace(object, nullptr).second) {
+                    m_leafForData.clear();
+                    throw NodeTreeException("Data already in tree");
+                }
+                items.push_back(BuildItem{bounds, bounds.center(), object});
             }
+
+            if (!items.empty()) {
+                m_root = buildSubtree(std::begin(items), std::end(items), 0u);
+            }
+            validateFlatNodes();
         }
 
         /**
@@ -509,6 +697,7 @@ namespace TrenchBroom {
          */
         void insert(const Box& bounds, const U& data) {
             check(bounds);
+            m_flatNodesValid = false;
 
             // Check that the data isn't already inserted
             if (m_leafForData.find(data) != m_leafForData.end()) {
@@ -543,6 +732,7 @@ namespace TrenchBroom {
             LeafNode* leaf = it->second;
             assert(leaf->data() == data);
             m_leafForData.erase(it);
+            m_flatNodesValid = false;
 
             m_root = leaf->deleteThis();
 
@@ -571,6 +761,141 @@ namespace TrenchBroom {
                 throw NodeTreeException("Cannot add node to AABB tree with invalid bounds");
             }
         }
+
+        struct BuildItem {
+            Box bounds;
+            vm::vec<T,S> center;
+            U data;
+        };
+
+        using BuildIterator = typename std::vector<BuildItem>::iterator;
+
+        // the number of buckets into which the items are sorted when searching for the best split
+        static constexpr size_t BuildBinCount = 16;
+        // below this depth, subtrees are split at the median to bound the height of degenerate trees
+        static constexpr size_t MaxSurfaceAreaSplitDepth = 32;
+
+        /**
+         * Builds a subtree containing the items in the given range and returns its root.
+         */
+        Node* buildSubtree(BuildIterator first, BuildIterator last, const size_t depth) {
+            assert(first != last);
+
+            if (std::next(first) == last) {
+                auto* leaf = new LeafNode(first->bounds, first->data);
+                m_leafForData[first->data] = leaf;
+                return leaf;
+            }
+
+            const auto mid = splitItems(first, last, depth);
+            auto* left = buildSubtree(first, mid, depth + 1u);
+            auto* right = buildSubtree(mid, last, depth + 1u);
+            return new InnerNode(left, right);
+        }
+
+        /**
+         * Partitions the items in the given range into two non empty halves and returns the start of the second half.
+         *
+         * The items are binned by the coordinate of their centers along the axis where the centers are spread out the
+         * most, and the range is split at the bin boundary that minimizes the summed surface areas of both halves
+         * weighted by their item counts.
+         */
+        static BuildIterator splitItems(BuildIterator first, BuildIterator last, const size_t depth) {
+            auto centerBounds = Box(first->center, first->center);
+            for (auto it = std::next(first); it != last; ++it) {
+                centerBounds = vm::merge(centerBounds, it->center);
+            }
+
+            const auto extents = centerBounds.size();
+            size_t axis = 0u;
+            for (size_t i = 1u; i < S; ++i) {
+                if (extents[i] > extents[axis]) {
+                    axis = i;
+                }
+            }
+
+            const auto count = static_cast<size_t>(std::distance(first, last));
+            if (count == 2u) {
+                if (std::next(first)->center[axis] < first->center[axis]) {
+                    std::iter_swap(first, std::next(first));
+                }
+                return std::next(first);
+            }
+
+            if (extents[axis] <= static_cast<T>(0) || depth >= MaxSurfaceAreaSplitDepth) {
+                const auto mid = std::next(first, static_cast<std::ptrdiff_t>(count / 2u));
+                std::nth_element(first, mid, last, [&](const auto& lhs, const auto& rhs) {
+                    return lhs.center[axis] < rhs.center[axis];
+                });
+                return mid;
+            }
+
+            const auto min = centerBounds.min[axis];
+            const auto scale = static_cast<T>(BuildBinCount) / extents[axis];
+            const auto binIndex = [&](const BuildItem& item) {
+                const auto index = static_cast<size_t>((item.center[axis] - min) * scale);
+                return std::min(index, BuildBinCount - 1u);
+            };
+
+            size_t binCounts[BuildBinCount] = {};
+            Box binBounds[BuildBinCount];
+            for (auto it = first; it != last; ++it) {
+                const auto index = binIndex(*it);
+                binBounds[index] = binCounts[index] == 0u ? it->bounds : vm::merge(binBounds[index], it->bounds);
+                ++binCounts[index];
+            }
+
+            // rightCosts[i] contains the cost of the bins i+1, ..., BuildBinCount-1
+            T rightCosts[BuildBinCount] = {};
+            size_t rightCount = 0u;
+            Box rightBounds;
+            for (size_t i = BuildBinCount - 1u; i > 0u; --i) {
+                if (binCounts[i] > 0u) {
+                    rightBounds = rightCount == 0u ? binBounds[i] : vm::merge(rightBounds, binBounds[i]);
+                    rightCount += binCounts[i];
+                }
+                rightCosts[i - 1u] = static_cast<T>(rightCount) * halfSurfaceArea(rightBounds);
+            }
+
+            size_t bestSplit = 0u;
+            auto bestCost = static_cast<T>(0);
+            size_t leftCount = 0u;
+            Box leftBounds;
+            for (size_t i = 0u; i < BuildBinCount - 1u; ++i) {
+                if (binCounts[i] > 0u) {
+                    leftBounds = leftCount == 0u ? binBounds[i] : vm::merge(leftBounds, binBounds[i]);
+                    leftCount += binCounts[i];
+                }
+                if (leftCount > 0u && leftCount < count) {
+                    const auto cost = static_cast<T>(leftCount) * halfSurfaceArea(leftBounds) + rightCosts[i];
+                    if (bestSplit == 0u || cost < bestCost) {
+                        bestSplit = i + 1u;
+                        bestCost = cost;
+                    }
+                }
+            }
+
+            // the first and the last bin are never empty, so there is always a valid split
+            assert(bestSplit > 0u);
+            return std::partition(first, last, [&](const BuildItem& item) {
+                return binIndex(item) < bestSplit;
+            });
+        }
+
+        static T halfSurfaceArea(const Box& bounds) {
+            const auto size = bounds.size();
+            if constexpr (S == 1) {
+                return size[0];
+            } else {
+                auto result = static_cast<T>(0);
+                for (size_t i = 0u; i < S; ++i) {
+                    for (size_t j = i + 1u; j < S; ++j) {
+                        result += size[i] * size[j];
+                    }
+                }
+                return result;
+            }
+        }
     public:
         /**
          * Clears this node tree.
@@ -580,6 +905,8 @@ namespace TrenchBroom {
                 delete m_root;
                 m_root = nullptr;
             }
+            m_leafForData.clear();
+            m_flatNodesValid = false;
         }
 
         /**
@@ -638,23 +965,132 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findIntersectors(const vm::ray<T,S>& ray, O out) const {
+            const auto visit = [&](const LeafNode* leaf) {
+                if (intersects(ray, leaf->bounds())) {
+                    out = leaf->data();
+                    ++out;
+                }
+            };
+
+            if (useFlatNodes()) {
+                const RayBoxBatchTest<T,S> test(ray);
+                visitFlatNodes([&](const FlatNode& flatNode) { return test.test(flatNode.bounds); }, visit);
+            } else {
+                visitNodes([&](const Box& bounds) { return intersects(ray, bounds); }, visit);
+            }
+        }
+
+        /**
+         * Finds the data items in this tree whose bounding boxes intersect with each of the given rays. The result is
+         * the same as if findIntersectors was called for each ray, but the rays are processed in packets that
+         * traverse the tree together, which is faster if the rays are coherent, e.g. when picking with adjacent rays.
+         *
+         * @param rays the rays to test
+         * @return a list of data items for each ray, in the order of the given rays
+         */
+        std::vector<List> findIntersectors(const std::vector<vm::ray<T,S>>& rays) const {
+            std::vector<List> result(rays.size());
+            if (empty()) {
+                return result;
+            }
+
+            if (!useFlatNodes()) {
+                for (size_t i = 0u; i < rays.size(); ++i) {
+                    findIntersectors(rays[i], std::back_inserter(result[i]));
+                }
+                return result;
+            }
+
+            using PacketMask = std::uint64_t;
+            static constexpr size_t PacketSize = 64u;
+
+            std::vector<RayBoxBatchTest<T,S>> tests;
+            tests.reserve(std::min(PacketSize, rays.size()));
+
+            std::vector<std::pair<std::uint32_t, PacketMask>> stack;
+            for (size_t first = 0u; first < rays.size(); first += PacketSize) {
+                const auto count = std::min(PacketSize, rays.size() - first);
+
+                tests.clear();
+                for (size_t i = 0u; i < count; ++i) {
+                    tests.emplace_back(rays[first + i]);
+                }
+
+                const auto packetTest = RayPacketBoxBatchTest<T,S>(std::next(std::begin(rays), static_cast<std::ptrdiff_t>(first)), std::next(std::begin(rays), static_cast<std::ptrdiff_t>(first + count)));
+
+                const auto all = count == PacketSize ? ~PacketMask(0) : (PacketMask(1) << count) - 1u;
+                stack.emplace_back(0u, all);
+
+                while (!stack.empty()) {
+                    const auto [child, mask] = stack.back();
+                    stack.pop_back();
+
+                    if (child & FlatLeafBit) {
+                        const auto* leaf = m_flatLeafs[child & ~FlatLeafBit];
+                        for (auto remaining = mask; remaining != 0u; remaining &= remaining - 1u) {
+                            const auto i = lowestBit(remaining);
+                            if (intersects(rays[first + i], leaf->bounds())) {
+                                result[first + i].push_back(leaf->data());
+                            }
+                        }
+                    } else {
+                        const auto& flatNode = m_flatNodes[child];
+                        if ((packetTest.test(flatNode.bounds) & flatNode.childMask()) == 0u) {
+                            continue;
+                        }
+
+                        const auto bounds = WideBoxBatch<S>(flatNode.bounds);
+
+                        PacketMask childMasks[FlatWidth] = {};
+                        for (auto remaining = mask; remaining != 0u; remaining &= remaining - 1u) {
+                            const auto i = lowestBit(remaining);
+                            const auto hits = tests[i].test(bounds);
+                            for (size_t j = 0u; j < FlatWidth; ++j) {
+                                childMasks[j] |= PacketMask((hits >> j) & 1u) << i;
+                            }
+                        }
+
+                        // push in reverse order so that the children are visited in order
+                        for (size_t j = flatNode.childCount; j > 0u; --j) {
+                            if (childMasks[j - 1u] != 0u) {
+                                stack.emplace_back(flatNode.children[j - 1u], childMasks[j - 1u]);
+                            }
+                        }
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        /**
+         * Returns the number of nodes whose bounds are tested against the given ray when finding the intersectors of
+         * the given ray. This is a measure of the quality of this tree.
+         *
+         * @param ray the ray to test
+         * @return the number of visited nodes
+         */
+        size_t countIntersectorVisits(const vm::ray<T,S>& ray) const {
+            size_t result = 0u;
             if (!empty()) {
                 LambdaVisitor visitor(
                     [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
+                        ++result;
+                        return intersects(ray, innerNode->bounds());
                     },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
-                            out = leaf->data();
-                            ++out;
-                        }
+                    [&](const LeafNode*) {
+                        ++result;
                     }
                 );
                 m_root->accept(visitor);
             }
+            return result;
         }
-
+    private:
+        static bool intersects(const vm::ray<T,S>& ray, const Box& bounds) {
+            return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+        }
+    public:
         /**
          * Finds every data item in this tree whose bounding box contains the given point and returns a list of those items.
          *
@@ -677,22 +1113,164 @@ namespace TrenchBroom {
          */
         template <typename O>
         void findContainers(const vm::vec<T,S>& point, O out) const {
-            if (!empty()) {
-                LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(point);
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(point)) {
-                            out = leaf->data();
-                            ++out;
+            const auto visit = [&](const LeafNode* leaf) {
+                if (leaf->bounds().contains(point)) {
+                    out = leaf->data();
+                    ++out;
+                }
+            };
+
+            if (useFlatNodes()) {
+                visitFlatNodes([&](const FlatNode& flatNode) { return flatNode.containsMask(point); }, visit);
+            } else {
+                visitNodes([&](const Box& bounds) { return bounds.contains(point); }, visit);
+            }
+        }
+
+        /**
+         * Finds every data item in this tree whose bounding box intersects with the given box and appends it to the
+         * given output iterator. Boxes that only touch the given box are considered to intersect it.
+         *
+         * @tparam O the output iterator type
+         * @param box the box to test
+         * @param out the output iterator to append to
+         */
+        template <typename O>
+        void findIntersectors(const Box& box, O out) const {
+            const auto visit = [&](const LeafNode* leaf) {
+                if (leaf->bounds().intersects(box)) {
+                    out = leaf->data();
+                    ++out;
+                }
+            };
+
+            if (useFlatNodes()) {
+                visitFlatNodes([&](const FlatNode& flatNode) { return flatNode.intersectsMask(box); }, visit);
+            } else {
+                visitNodes([&](const Box& bounds) { return bounds.intersects(box); }, visit);
+            }
+        }
+    private:
+        /**
+         * Indicates whether queries should traverse the flattened tree. If the flattened tree is outdated, it is
+         * rebuilt once the queries that traversed this tree instead have visited as many nodes as there are leafs.
+         */
+        bool useFlatNodes() const {
+            if (!m_flatNodesValid && m_unflattenedVisits >= m_leafForData.size()) {
+                validateFlatNodes();
+            }
+            return m_flatNodesValid;
+        }
+
+        /**
+         * Traverses this tree in depth first order. The given test is applied to the bounds of each visited inner
+         * node and decides whether its children are visited, and the given visitor is called for each visited leaf.
+         * The visited nodes are counted towards rebuilding the flattened tree.
+         *
+         * @tparam Test the type of the test, must be callable with a const Box& and return bool
+         * @tparam Visit the type of the leaf visitor, must be callable with a const LeafNode*
+         * @param test the test to apply to the inner nodes
+         * @param visit the visitor to call for each visited leaf
+         */
+        template <typename Test, typename Visit>
+        void visitNodes(const Test& test, const Visit& visit) const {
+            if (empty()) {
+                return;
+            }
+
+            LambdaVisitor visitor(
+                [&](const InnerNode* innerNode) {
+                    ++m_unflattenedVisits;
+                    return test(innerNode->bounds());
+                },
+                [&](const LeafNode* leaf) {
+                    ++m_unflattenedVisits;
+                    visit(leaf);
+                }
+            );
+            m_root->accept(visitor);
+        }
+
+        /**
+         * Traverses the flattened tree in depth first order. The given test is applied to each visited flat node and
+         * returns a bit mask of the node's children to visit, and the given visitor is called for each visited leaf.
+         * Since the bounds of the flat nodes are larger than the exact bounds, the visitor must check the exact bounds
+         * of the leaf.
+         *
+         * @tparam Test the type of the test, must be callable with a const FlatNode& and return unsigned
+         * @tparam Visit the type of the leaf visitor, must be callable with a const LeafNode*
+         * @param test the test to apply to the flat nodes
+         * @param visit the visitor to call for each visited leaf
+         */
+        template <typename Test, typename Visit>
+        void visitFlatNodes(const Test& test, const Visit& visit) const {
+            if (empty()) {
+                return;
+            }
+
+            validateFlatNodes();
+
+            std::vector<std::uint32_t> stack;
+            stack.reserve(64u);
+            stack.push_back(0u);
+
+            while (!stack.empty()) {
+                const auto child = stack.back();
+                stack.pop_back();
+
+                if (child & FlatLeafBit) {
+                    visit(m_flatLeafs[child & ~FlatLeafBit]);
+                } else {
+                    const auto& flatNode = m_flatNodes[child];
+                    const auto hits = test(flatNode) & flatNode.childMask();
+
+                    // push in reverse order so that the children are visited in order
+                    for (size_t j = flatNode.childCount; j > 0u; --j) {
+                        if (hits & (1u << (j - 1u))) {
+                            stack.push_back(flatNode.children[j - 1u]);
                         }
                     }
-                );
-                m_root->accept(visitor);
+                }
             }
         }
 
+        void validateFlatNodes() const {
+            if (!m_flatNodesValid) {
+                m_flatNodes.clear();
+                m_flatLeafs.clear();
+                if (!empty()) {
+                    m_flatLeafs.reserve(m_leafForData.size());
+                    if (m_root->height() == 1u) {
+                        // the root flat node must not be a leaf
+                        FlatNode flatNode;
+                        flatNode.childCount = 1u;
+                        flatNode.setChild(0u, m_root->bounds(), m_root->flatten(m_flatNodes, m_flatLeafs));
+                        m_flatNodes.push_back(flatNode);
+                    } else {
+                        m_root->flatten(m_flatNodes, m_flatLeafs);
+                    }
+                }
+                m_flatNodesValid = true;
+                m_unflattenedVisits = 0u;
+            }
+        }
+
+        /**
+         * Returns the index of the lowest set bit of the given mask, which must not be 0.
+         */
+        static size_t lowestBit(const std::uint64_t mask) {
+            assert(mask != 0u);
+            static constexpr std::uint64_t DeBruijn = 0x03f79d71b4cb0a89u;
+            static constexpr std::uint8_t Index[64] = {
+                 0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+                62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+                63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+                46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+            };
+            return Index[((mask & (~mask + 1u)) * DeBruijn) >> 58u];
+        }
+    public:
+
         /**
          * Prints a textual representation of this tree to the given output stream.
          *
@@ -21,6 +21,7 @@
 #define TrenchBroom_Allocator_h
 
 #include <cassert>
+#include <mutex>
 #include <stack>
 #include <vector>
 
@@ -106,15 +107,25 @@ namespace TrenchBroom {
             return chunks;
         }
 
-        static ChunkList emptyChunks() {
+        static ChunkList& emptyChunks() {
             static ChunkList chunks;
             return chunks;
         }
+
+        /**
+         * Guards the pool and the chunk lists. Polyhedra are built on several threads when loading a map, so every
+         * access to the shared allocator state must hold this lock.
+         */
+        static std::mutex& mutex() {
+            static std::mutex m;
+            return m;
+        }
     public:
 #ifdef TB_ENABLE_ALLOCATOR
         void* operator new([[maybe_unused]] size_t size) {
             assert(size == sizeof(T));
 
+            const std::lock_guard<std::mutex> lock(mutex());
             if (!pool().empty()) {
                 T* t = pool().top();
                 pool().pop();
@@ -148,6 +159,7 @@ namespace TrenchBroom {
         void operator delete(void* block) {
             T* t = reinterpret_cast<T*>(block);
 
+            const std::lock_guard<std::mutex> lock(mutex());
             if (PoolSize > 0 && pool().size() < PoolSize) {
                 pool().push(t);
                 return;
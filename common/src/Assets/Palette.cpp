@@ -28,11 +28,89 @@
 
 #include <kdl/string_format.h>
 
+#include <cstring>
+
+#if defined(__AVX2__)
+#define TB_PALETTE_AVX2 1
+#include <immintrin.h>
+#endif
+
 namespace TrenchBroom {
     namespace Assets {
         Palette::Data::Data(std::vector<unsigned char>&& data) :
         m_data(std::move(data)) {
             ensure(!m_data.empty(), "palette is empty");
+
+            for (size_t i = 0; i < 256; ++i) {
+                unsigned char rgba[4] = { 0x00, 0x00, 0x00, 0xFF };
+                for (size_t j = 0; j < 3 && i * 3 + j < m_data.size(); ++j) {
+                    rgba[j] = m_data[i * 3 + j];
+                }
+                std::memcpy(&m_opaqueRgba[i], rgba, 4);
+
+                rgba[3] = (i == 255) ? 0x00 : 0xFF;
+                std::memcpy(&m_index255TransparentRgba[i], rgba, 4);
+            }
+        }
+
+        const std::vector<unsigned char>& Palette::Data::data() const {
+            return m_data;
+        }
+
+        bool Palette::Data::indexedToRgba(const unsigned char* indices, const size_t pixelCount, unsigned char* rgbaImage, const PaletteTransparency transparency, uint64_t sums[3]) const {
+            const auto& table = transparency == PaletteTransparency::Index255Transparent ? m_index255TransparentRgba : m_opaqueRgba;
+
+            size_t i = 0;
+            bool hasIndex255 = false;
+
+#if defined(TB_PALETTE_AVX2)
+            // convert eight pixels at once and sum up each channel with SAD against zero, which adds the eight bytes of
+            // every 64 bit lane
+            const auto zero = _mm256_setzero_si256();
+            const auto channelMask = _mm256_set1_epi32(0xFF);
+            const auto index255 = _mm256_set1_epi32(255);
+            const auto* tableData = reinterpret_cast<const int*>(table.data());
+
+            auto sumR = zero, sumG = zero, sumB = zero, found = zero;
+            for (; i + 8 <= pixelCount; i += 8) {
+                const auto packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i));
+                const auto index = _mm256_cvtepu8_epi32(packed);
+                const auto rgba = _mm256_i32gather_epi32(tableData, index, 4);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgbaImage + i * 4), rgba);
+
+                sumR = _mm256_add_epi64(sumR, _mm256_sad_epu8(_mm256_and_si256(rgba, channelMask), zero));
+                sumG = _mm256_add_epi64(sumG, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(rgba, 8), channelMask), zero));
+                sumB = _mm256_add_epi64(sumB, _mm256_sad_epu8(_mm256_and_si256(_mm256_srli_epi32(rgba, 16), channelMask), zero));
+                found = _mm256_or_si256(found, _mm256_cmpeq_epi32(index, index255));
+            }
+
+            alignas(32) uint64_t lanes[3][4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[0]), sumR);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[1]), sumG);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[2]), sumB);
+            for (size_t j = 0; j < 3; ++j) {
+                sums[j] += lanes[j][0] + lanes[j][1] + lanes[j][2] + lanes[j][3];
+            }
+            hasIndex255 = !_mm256_testz_si256(found, found);
+#endif
+
+            // count how often each index occurs and compute the sums from the counts, this avoids a dependency on the
+            // sums for every pixel
+            uint32_t counts[256] = {};
+            for (; i < pixelCount; ++i) {
+                const auto index = indices[i];
+                std::memcpy(rgbaImage + i * 4, &table[index], 4);
+                ++counts[index];
+            }
+
+            for (size_t j = 0; j < 256; ++j) {
+                const auto* rgba = reinterpret_cast<const unsigned char*>(&table[j]);
+                sums[0] += uint64_t(counts[j]) * rgba[0];
+                sums[1] += uint64_t(counts[j]) * rgba[1];
+                sums[2] += uint64_t(counts[j]) * rgba[2];
+            }
+
+            return hasIndex255 || counts[255] > 0;
         }
 
         Palette::Palette() {}
@@ -88,5 +166,10 @@ namespace TrenchBroom {
         bool Palette::initialized() const {
             return m_data.get() != nullptr;
         }
+
+        const std::vector<unsigned char>& Palette::data() const {
+            ensure(initialized(), "palette is initialized");
+            return m_data->data();
+        }
     }
 }
@@ -23,7 +23,10 @@
 #include "Color.h"
 #include "IO/Reader.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -43,9 +46,14 @@ namespace TrenchBroom {
             class Data {
             private:
                 std::vector<unsigned char> m_data;
+                // the palette colors as RGBA pixels, with index 255 opaque and transparent, respectively
+                std::array<uint32_t, 256> m_opaqueRgba;
+                std::array<uint32_t, 256> m_index255TransparentRgba;
             public:
                 Data(std::vector<unsigned char>&& data);
 
+                const std::vector<unsigned char>& data() const;
+
                 /**
                  * Converts the given index buffer to an RGBA image.
                  *
@@ -79,35 +87,41 @@ namespace TrenchBroom {
                  */
                 template <typename ColorT>
                 bool indexedToRgba(IO::Reader& reader, const size_t pixelCount, std::vector<ColorT>& rgbaImage, const PaletteTransparency transparency, Color& averageColor) const {
-                    double avg[3];
-                    avg[0] = avg[1] = avg[2] = 0.0;
-                    bool hasTransparency = false;
-                    for (size_t i = 0; i < pixelCount; ++i) {
-                        const size_t index = reader.readSize<unsigned char>();
-                        assert(index < m_data.size());
-                        for (size_t j = 0; j < 3; ++j) {
-                            const unsigned char c = m_data[index * 3 + j];
-                            rgbaImage[i * 4 + j] = c;
-                            avg[j] += static_cast<double>(c);
-                        }
-                        switch (transparency) {
-                            case PaletteTransparency::Opaque:
-                                rgbaImage[i * 4 + 3] = 0xFF;
-                                break;
-                            case PaletteTransparency::Index255Transparent:
-                                rgbaImage[i * 4 + 3] = static_cast<ColorT>((index == 255) ? 0x00 : 0xFF);
-                                hasTransparency |= (index == 255);
-                                break;
-                        }
+                    static_assert(sizeof(ColorT) == 1, "pixel channels must be bytes");
+                    assert(rgbaImage.size() >= pixelCount * 4);
+
+                    // the indices are read in chunks to avoid checking the reader bounds for every pixel
+                    static constexpr size_t ChunkSize = 4096;
+                    unsigned char indices[ChunkSize];
+
+                    uint64_t sums[3] = { 0, 0, 0 };
+                    bool hasIndex255 = false;
+                    for (size_t i = 0; i < pixelCount; i += ChunkSize) {
+                        const auto count = std::min(ChunkSize, pixelCount - i);
+                        reader.read(indices, count);
+                        hasIndex255 |= indexedToRgba(indices, count, reinterpret_cast<unsigned char*>(&rgbaImage[i * 4]), transparency, sums);
                     }
 
                     for (size_t i = 0; i < 3; ++i) {
-                        averageColor[i] = static_cast<float>(avg[i] / static_cast<double>(pixelCount) / static_cast<double>(0xFF));
+                        averageColor[i] = static_cast<float>(static_cast<double>(sums[i]) / static_cast<double>(pixelCount) / static_cast<double>(0xFF));
                     }
                     averageColor[3] = 1.0f;
 
-                    return hasTransparency;
+                    return transparency == PaletteTransparency::Index255Transparent && hasIndex255;
                 }
+            private:
+                /**
+                 * Converts the given indices to RGBA pixels and adds the red, green and blue values of the pixels to
+                 * the given sums. Uses AVX2 gather instructions if they are available at compile time.
+                 *
+                 * @param indices the indices to convert
+                 * @param pixelCount the number of indices
+                 * @param rgbaImage the pixel buffer to write 4 * pixelCount bytes to
+                 * @param transparency controls whether or not index 255 is transparent
+                 * @param sums the sums of the red, green and blue channels
+                 * @return true if any of the given indices is 255
+                 */
+                bool indexedToRgba(const unsigned char* indices, size_t pixelCount, unsigned char* rgbaImage, PaletteTransparency transparency, uint64_t sums[3]) const;
             };
 
             using DataPtr = std::shared_ptr<Data>;
@@ -124,6 +138,11 @@ namespace TrenchBroom {
 
             bool initialized() const;
 
+            /**
+             * Returns the RGB values of the colors of this palette. The palette must be initialized.
+             */
+            const std::vector<unsigned char>& data() const;
+
             /**
              * Converts the given index buffer to an RGBA image.
              *
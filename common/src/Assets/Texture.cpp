@@ -39,7 +39,11 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_minFilter(0),
+        m_magFilter(0),
+        m_textureId(0),
+        m_residentSize(0),
+        m_used(false) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
@@ -58,8 +62,12 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_minFilter(0),
+        m_magFilter(0),
         m_textureId(0),
-        m_buffers(std::move(buffers)) {
+        m_buffers(std::move(buffers)),
+        m_residentSize(0),
+        m_used(false) {
             assert(m_width > 0);
             assert(m_height > 0);
 
@@ -72,6 +80,31 @@ namespace TrenchBroom {
             }
         }
 
+        Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, std::shared_ptr<const void> mipOwner, std::vector<const unsigned char*> mips, const GLenum format, const TextureType type) :
+        m_collection(nullptr),
+        m_name(name),
+        m_width(width),
+        m_height(height),
+        m_averageColor(averageColor),
+        m_usageCount(0),
+        m_overridden(false),
+        m_format(format),
+        m_type(type),
+        m_culling(TextureCulling::CullDefault),
+        m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_minFilter(0),
+        m_magFilter(0),
+        m_textureId(0),
+        m_mips(std::move(mips)),
+        m_mipOwner(std::move(mipOwner)),
+        m_residentSize(0),
+        m_used(false) {
+            assert(m_width > 0);
+            assert(m_height > 0);
+            assert(!m_mips.empty());
+            assert(m_mipOwner != nullptr);
+        }
+
         Texture::Texture(const std::string& name, const size_t width, const size_t height, const GLenum format, const TextureType type) :
         m_collection(nullptr),
         m_name(name),
@@ -84,7 +117,32 @@ namespace TrenchBroom {
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
+        m_minFilter(0),
+        m_magFilter(0),
+        m_textureId(0),
+        m_residentSize(0),
+        m_used(false) {}
+
+        Texture::Texture(const std::string& name, const size_t width, const size_t height, const Color& averageColor, const GLenum format, const TextureType type, DecodeFunction decode) :
+        m_collection(nullptr),
+        m_name(name),
+        m_width(width),
+        m_height(height),
+        m_averageColor(averageColor),
+        m_usageCount(0),
+        m_overridden(false),
+        m_format(format),
+        m_type(type),
+        m_culling(TextureCulling::CullDefault),
+        m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
+        m_decode(std::move(decode)),
+        m_minFilter(0),
+        m_magFilter(0),
+        m_textureId(0),
+        m_residentSize(0),
+        m_used(false) {
+            assert(m_decode);
+        }
 
         Texture::~Texture() {
             if (m_collection == nullptr && m_textureId != 0) {
@@ -175,58 +233,26 @@ namespace TrenchBroom {
         }
 
         bool Texture::isPrepared() const {
-            return m_textureId != 0;
+            return m_residentSize > 0;
         }
 
         void Texture::prepare(const GLuint textureId, const int minFilter, const int magFilter) {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
-            if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+            m_textureId = textureId;
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
 
-                if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
-                    // generate mipmaps if we don't have any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
-                } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
-                }
-
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
-
-                for (size_t j = 0; j < mipmapsToUpload; ++j) {
-                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
-
-                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].data());
-                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                          static_cast<GLsizei>(mipSize.x()),
-                                          static_cast<GLsizei>(mipSize.y()),
-                                          0, m_format, GL_UNSIGNED_BYTE, data));
-                }
-
-                m_buffers.clear();
-                m_textureId = textureId;
+            if (!m_decode) {
+                upload();
             }
         }
 
         void Texture::setMode(const int minFilter, const int magFilter) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+
             if (isPrepared()) {
                 activate();
                 if (m_type == TextureType::Masked) {
@@ -242,6 +268,11 @@ namespace TrenchBroom {
         }
 
         void Texture::activate() const {
+            m_used = true;
+            if (!isPrepared() && m_textureId != 0 && m_decode) {
+                upload();
+            }
+
             if (isPrepared()) {
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
@@ -292,10 +323,76 @@ namespace TrenchBroom {
             }
         }
 
+        size_t Texture::residentSize() const {
+            return m_residentSize;
+        }
+
+        bool Texture::takeUsed() const {
+            const auto result = m_used;
+            m_used = false;
+            return result;
+        }
+
+        void Texture::evict() {
+            if (!isPrepared() || !m_decode) {
+                return;
+            }
+
+            // Respecify the uploaded images as empty to release their memory. The texture name is kept because it is
+            // owned by the collection. A texture without a name was marked as resident by simulateUpload().
+            if (m_textureId != 0) {
+                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                for (size_t j = 0, width = m_width, height = m_height; width > 0 || height > 0; ++j, width /= 2, height /= 2) {
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA, 0, 0, 0, m_format, GL_UNSIGNED_BYTE, nullptr));
+                }
+                glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+            }
+
+            m_residentSize = 0;
+        }
+
         const Texture::BufferList& Texture::buffersIfUnprepared() const {
+            if (m_buffers.empty() && !m_mips.empty()) {
+                const auto bytesPerPixel = bytesPerPixelForFormat(m_format);
+                for (size_t level = 0; level < m_mips.size(); ++level) {
+                    const auto mipSize = sizeAtMipLevel(m_width, m_height, level);
+                    const auto numBytes = bytesPerPixel * mipSize.x() * mipSize.y();
+                    m_buffers.emplace_back(m_mips[level], m_mips[level] + numBytes);
+                }
+                m_mips.clear();
+                m_mipOwner.reset();
+            }
             return m_buffers;
         }
 
+        void Texture::ensureDecoded() const {
+            if (!hasPixels() && !isPrepared() && m_decode) {
+                auto decoded = m_decode();
+                if (decoded == nullptr || !decoded->hasPixels()) {
+                    // the texture could not be decoded, so there is no point in trying again
+                    m_decode = nullptr;
+                    return;
+                }
+
+                assert(decoded->m_width == m_width);
+                assert(decoded->m_height == m_height);
+                assert(decoded->m_format == m_format);
+                m_buffers = std::move(decoded->m_buffers);
+                m_mips = std::move(decoded->m_mips);
+                m_mipOwner = std::move(decoded->m_mipOwner);
+                m_averageColor = decoded->m_averageColor;
+            }
+        }
+
+        void Texture::simulateUpload() const {
+            ensureDecoded();
+            if (hasPixels()) {
+                m_residentSize = uploadedSize();
+                releasePixels();
+            }
+            m_used = true;
+        }
+
         GLenum Texture::format() const {
             return m_format;
         }
@@ -304,6 +401,83 @@ namespace TrenchBroom {
             return m_type;
         }
 
+        bool Texture::hasPixels() const {
+            return !m_buffers.empty() || !m_mips.empty();
+        }
+
+        size_t Texture::mipCount() const {
+            return m_buffers.empty() ? m_mips.size() : m_buffers.size();
+        }
+
+        const unsigned char* Texture::mipData(const size_t level) const {
+            return m_buffers.empty() ? m_mips[level] : m_buffers[level].data();
+        }
+
+        void Texture::releasePixels() const {
+            m_buffers.clear();
+            m_mips.clear();
+            m_mipOwner.reset();
+        }
+
+        void Texture::upload() const {
+            assert(m_textureId != 0);
+
+            ensureDecoded();
+            if (hasPixels()) {
+                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+                if (m_type == TextureType::Masked) {
+                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+                } else if (mipCount() == 1) {
+                    // generate mipmaps if we don't have any
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+                } else {
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipCount() - 1)));
+                }
+
+                for (size_t j = 0; j < mipmapsToUpload(); ++j) {
+                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+
+                    const GLvoid* data = reinterpret_cast<const GLvoid*>(mipData(j));
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                          static_cast<GLsizei>(mipSize.x()),
+                                          static_cast<GLsizei>(mipSize.y()),
+                                          0, m_format, GL_UNSIGNED_BYTE, data));
+                }
+
+                m_residentSize = uploadedSize();
+                releasePixels();
+            }
+        }
+
+        size_t Texture::mipmapsToUpload() const {
+            // Upload only the first mipmap for masked textures.
+            return (m_type == TextureType::Masked) ? 1u : mipCount();
+        }
+
+        size_t Texture::uploadedSize() const {
+            size_t result = 0;
+            for (size_t j = 0; j < mipmapsToUpload(); ++j) {
+                const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+                result += 4u * mipSize.x() * mipSize.y();
+            }
+            return result;
+        }
+
         void Texture::setCollection(TextureCollection* collection) {
             m_collection = collection;
         }
@@ -25,6 +25,8 @@
 
 #include <vecmath/forward.h>
 
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -59,13 +61,19 @@ namespace TrenchBroom {
         private:
             using Buffer = std::vector<unsigned char>;
             using BufferList = std::vector<Buffer>;
+        public:
+            /**
+             * Reads a lazily loaded texture in full. The pixels and the average color of the returned texture are
+             * taken over by the lazily loaded texture.
+             */
+            using DecodeFunction = std::function<std::unique_ptr<Texture>()>;
         private:
             TextureCollection* m_collection;
             std::string m_name;
 
             size_t m_width;
             size_t m_height;
-            Color m_averageColor;
+            mutable Color m_averageColor;
 
             size_t m_usageCount;
             bool m_overridden;
@@ -82,12 +90,38 @@ namespace TrenchBroom {
             // Quake 3 blend function, move to materials
             TextureBlendFunc m_blendFunc;
 
+            // decodes the pixels of a lazily loaded texture, empty if the texture was loaded in full
+            mutable DecodeFunction m_decode;
+            int m_minFilter;
+            int m_magFilter;
+
             mutable GLuint m_textureId;
             mutable BufferList m_buffers;
+            // the pixels of every mip level if they are read from memory that is not owned by this texture
+            mutable std::vector<const unsigned char*> m_mips;
+            // keeps the memory alive that m_mips points into
+            mutable std::shared_ptr<const void> m_mipOwner;
+            // the number of bytes of texture memory used by the uploaded pixels, 0 if they are not uploaded
+            mutable size_t m_residentSize;
+            mutable bool m_used;
         public:
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, Buffer&& buffer, GLenum format, TextureType type);
             Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, BufferList&& buffers, GLenum format, TextureType type);
+            /**
+             * Creates a texture whose pixels are uploaded directly from memory owned by the given object, e.g. a file
+             * mapped into memory. The owner is released once the pixels are uploaded.
+             *
+             * @param mipOwner keeps the pixels alive
+             * @param mips the pixels of every mip level, laid out like the buffers passed to the other constructors
+             */
+            Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, std::shared_ptr<const void> mipOwner, std::vector<const unsigned char*> mips, GLenum format, TextureType type);
             Texture(const std::string& name, size_t width, size_t height, GLenum format = GL_RGB, TextureType type = TextureType::Opaque);
+            /**
+             * Creates a lazily loaded texture. Its pixels are decoded using the given function when it is first
+             * activated. The given average color is used until then, and is replaced by the average color of the
+             * decoded texture.
+             */
+            Texture(const std::string& name, size_t width, size_t height, const Color& averageColor, GLenum format, TextureType type, DecodeFunction decode);
             ~Texture();
 
             static TextureType selectTextureType(bool masked);
@@ -116,15 +150,36 @@ namespace TrenchBroom {
             void setOverridden(bool overridden);
 
             bool isPrepared() const;
+            /**
+             * Uploads the pixels of this texture using the given texture name. The pixels of a lazily loaded texture
+             * are only decoded and uploaded once it is activated.
+             */
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
             void activate() const;
             void deactivate() const;
-        public: // exposed for tests only
+
+            /**
+             * Returns the number of bytes of texture memory used by the pixels of this texture, or 0 if they are not
+             * uploaded.
+             */
+            size_t residentSize() const;
+            /**
+             * Indicates whether this texture was activated since the last call to this function.
+             */
+            bool takeUsed() const;
+            /**
+             * Releases the texture memory used by the pixels of a lazily loaded texture. They are decoded and uploaded
+             * again when the texture is next activated. Does nothing if the texture was loaded in full, since its
+             * pixels cannot be restored.
+             */
+            void evict();
+
             /**
              * Returns the texture data in the format returned by format().
-             * Once prepare() is called, this will be an empty vector.
+             * Once prepare() is called, this will be an empty vector. The pixels of a texture that does not own them
+             * are copied on the first call.
              */
             const BufferList& buffersIfUnprepared() const;
             /**
@@ -132,7 +187,24 @@ namespace TrenchBroom {
              */
             GLenum format() const;
             TextureType type() const;
+        public: // exposed for tests only
+            /**
+             * Decodes the pixels of a lazily loaded texture unless they are already decoded or uploaded.
+             */
+            void ensureDecoded() const;
+            /**
+             * Decodes the pixels of a lazily loaded texture and marks them as uploaded, and marks the texture as used,
+             * just like activate() does, but without uploading anything.
+             */
+            void simulateUpload() const;
         private:
+            bool hasPixels() const;
+            size_t mipCount() const;
+            const unsigned char* mipData(size_t level) const;
+            void releasePixels() const;
+            void upload() const;
+            size_t mipmapsToUpload() const;
+            size_t uploadedSize() const;
             void setCollection(TextureCollection* collection);
             friend class TextureCollection;
         };
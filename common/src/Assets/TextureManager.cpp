@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -59,7 +60,9 @@ namespace TrenchBroom {
         m_logger(logger),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_textureBudget(std::numeric_limits<size_t>::max()),
+        m_evictionIndex(0) {}
 
         TextureManager::~TextureManager() {
             clear();
@@ -139,9 +142,14 @@ namespace TrenchBroom {
             m_resetTextureMode = true;
         }
 
+        void TextureManager::setTextureBudget(const size_t textureBudget) {
+            m_textureBudget = textureBudget;
+        }
+
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            evictTextures();
             kdl::vec_clear_and_delete(m_toRemove);
         }
 
@@ -184,6 +192,26 @@ namespace TrenchBroom {
             m_toPrepare.clear();
         }
 
+        void TextureManager::evictTextures() {
+            size_t residentSize = 0;
+            for (const auto* texture : m_textures) {
+                residentSize += texture->residentSize();
+            }
+
+            // Approximates LRU eviction with the clock algorithm: Starting where the previous call left off, we visit
+            // each texture at most once. Textures which were used since they were last visited get a second chance,
+            // so textures that are in view are never evicted.
+            for (size_t i = 0; i < m_textures.size() && residentSize > m_textureBudget; ++i) {
+                m_evictionIndex = (m_evictionIndex + 1) % m_textures.size();
+                auto* texture = m_textures[m_evictionIndex];
+                if (!texture->takeUsed()) {
+                    const auto textureSize = texture->residentSize();
+                    texture->evict();
+                    residentSize -= textureSize - texture->residentSize();
+                }
+            }
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
@@ -204,6 +232,7 @@ namespace TrenchBroom {
             }
 
             m_textures = kdl::map_values(m_texturesByName);
+            m_evictionIndex = 0;
         }
     }
 }
@@ -57,6 +57,9 @@ namespace TrenchBroom {
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+
+            size_t m_textureBudget;
+            size_t m_evictionIndex;
         public:
             Notifier<> usageCountDidChange;
         public:
@@ -72,7 +75,17 @@ namespace TrenchBroom {
             void clear();
 
             void setTextureMode(int minFilter, int magFilter);
+            /**
+             * Sets the number of bytes of texture memory that the lazily loaded textures may use. If they use more,
+             * the least recently used textures are evicted by commitChanges().
+             */
+            void setTextureBudget(size_t textureBudget);
             void commitChanges();
+            /**
+             * Evicts the least recently used lazily loaded textures until they use no more texture memory than the
+             * texture budget. Called by commitChanges().
+             */
+            void evictTextures();
 
             Texture* texture(const std::string& name) const;
             const std::vector<Texture*>& textures() const;
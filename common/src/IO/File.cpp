@@ -21,6 +21,11 @@
 
 #include "Exceptions.h"
 #include "IO/IOUtils.h"
+#include "IO/PathQt.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
 
 namespace TrenchBroom {
     namespace IO {
@@ -33,6 +38,17 @@ namespace TrenchBroom {
             return m_path;
         }
 
+        bool isModified(const FileSource& source) {
+            const auto info = QFileInfo(pathAsQString(source.path));
+            return !info.exists() ||
+                   info.lastModified().toMSecsSinceEpoch() != source.modificationTime ||
+                   static_cast<size_t>(info.size()) < source.offset + source.length;
+        }
+
+        nonstd::optional<FileSource> File::source() const {
+            return nonstd::nullopt;
+        }
+
         OwningBufferFile::OwningBufferFile(const Path& path, std::unique_ptr<char[]> buffer, const size_t size) :
         File(path),
         m_buffer(std::move(buffer)),
@@ -90,6 +106,59 @@ namespace TrenchBroom {
             return m_file;
         }
 
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_file(std::make_unique<QFile>(pathAsQString(path))),
+        m_begin(nullptr),
+        m_end(nullptr),
+        m_modificationTime(QFileInfo(*m_file).lastModified().toMSecsSinceEpoch()) {
+            if (!m_file->open(QIODevice::ReadOnly)) {
+                throw FileSystemException("Cannot open file " + path.asString());
+            }
+
+            const auto size = static_cast<size_t>(m_file->size());
+            if (size > 0) {
+                // the mapping stays valid after the file is closed
+                const auto* data = m_file->map(0, m_file->size());
+                if (data == nullptr) {
+                    throw FileSystemException("Cannot map file " + path.asString() + ": " + m_file->errorString().toStdString());
+                }
+                m_begin = reinterpret_cast<const char*>(data);
+                m_end = m_begin + size;
+            }
+            m_file->close();
+        }
+
+        // QFile unmaps the file when it is destroyed
+        MappedFile::~MappedFile() = default;
+
+        Reader MappedFile::reader() const {
+            ensureUnmodified();
+            return Reader::from(m_begin, m_end);
+        }
+
+        size_t MappedFile::size() const {
+            return static_cast<size_t>(m_end - m_begin);
+        }
+
+        nonstd::optional<FileSource> MappedFile::source() const {
+            return FileSource{path(), 0u, size(), m_modificationTime};
+        }
+
+        void MappedFile::ensureUnmodified() const {
+            if (isModified(*source())) {
+                throw FileSystemException("File " + path().asString() + " was modified on disk");
+            }
+        }
+
+        const char* MappedFile::begin() const {
+            return m_begin;
+        }
+
+        const char* MappedFile::end() const {
+            return m_end;
+        }
+
         FileView::FileView(const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length) :
         File(path),
         m_file(std::move(file)),
@@ -103,5 +172,14 @@ namespace TrenchBroom {
         size_t FileView::size() const {
             return m_length;
         }
+
+        nonstd::optional<FileSource> FileView::source() const {
+            auto result = m_file->source();
+            if (result) {
+                result->offset += m_offset;
+                result->length = m_length;
+            }
+            return result;
+        }
     }
 }
@@ -23,11 +23,34 @@
 #include "IO/Path.h"
 #include "IO/Reader.h"
 
+#include <cstdint>
 #include <cstdio>
 #include <memory>
 
+#include <nonstd/optional.hpp>
+
+class QFile;
+
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Identifies the portion of a physical file on the disk that backs a logical file, and the time at which the
+         * physical file was last modified when it was opened.
+         */
+        struct FileSource {
+            Path path;
+            size_t offset;
+            size_t length;
+            int64_t modificationTime;
+        };
+
+        /**
+         * Indicates whether the physical file of the given source was modified since the source was obtained, or is
+         * now too short to contain it. Reading a mapped file that was truncated in the meantime crashes the
+         * application, so this should be checked before reading from a file long after it was opened.
+         */
+        bool isModified(const FileSource& source);
+
         /**
          * Represents an opened (logical) file. A logical file can be backed by a physical file on the disk, a memory
          * buffer, or a portion thereof. A special case is a file that is backed by a C++ object. These files are used
@@ -60,6 +83,12 @@ namespace TrenchBroom {
              * Returns the size of this file in bytes.
              */
             virtual size_t size() const = 0;
+
+            /**
+             * Returns the portion of a physical file that backs this file, or an empty optional if this file is not
+             * backed by a physical file, e.g. because its contents were decompressed into memory.
+             */
+            virtual nonstd::optional<FileSource> source() const;
         };
 
         /**
@@ -134,6 +163,59 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. The file is mapped in the
+         * constructor and unmapped in the destructor.
+         *
+         * Readers of this file and of views into it read directly from the mapped memory, so buffering them does not
+         * copy any data. Game archives stay mapped for a long time, and reading a mapped file that was truncated on
+         * disk kills the process, so reader() checks that the file is unchanged first.
+         */
+        class MappedFile : public File {
+        private:
+            std::unique_ptr<QFile> m_file;
+            const char* m_begin;
+            const char* m_end;
+            int64_t m_modificationTime;
+        public:
+            /**
+             * Creates a new file with the given path and maps the file into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or mapped
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            /**
+             * Returns a reader for the mapped memory.
+             *
+             * @throw FileSystemException if the file was modified on disk since it was mapped
+             */
+            Reader reader() const override;
+            size_t size() const override;
+            nonstd::optional<FileSource> source() const override;
+
+            /**
+             * Checks that the file was not modified on disk since it was mapped. Must be called before reading the
+             * mapped memory directly.
+             *
+             * @throw FileSystemException if the file was modified
+             */
+            void ensureUnmodified() const;
+
+            /**
+             * Returns the beginning of the mapped memory.
+             */
+            const char* begin() const;
+
+            /**
+             * Returns the end of the mapped memory (the position after the last byte).
+             */
+            const char* end() const;
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
@@ -155,6 +237,7 @@ namespace TrenchBroom {
 
             Reader reader() const override;
             size_t size() const override;
+            nonstd::optional<FileSource> source() const override;
         };
 
         // TODO: get rid of this, it's evil
@@ -38,5 +38,10 @@ namespace TrenchBroom {
 
             return Assets::Palette(std::move(data));
         }
+
+        uint64_t HlMipTextureReader::doGetCacheSalt() const {
+            // the palette is part of the texture file
+            return 1;
+        }
     }
 }
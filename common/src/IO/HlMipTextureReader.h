@@ -31,6 +31,7 @@ namespace TrenchBroom {
             explicit HlMipTextureReader(const NameStrategy& nameStrategy);
         protected:
             Assets::Palette doGetPalette(Reader& reader, const size_t offset[], size_t width, size_t height) const override;
+            uint64_t doGetCacheSalt() const override;
         };
     }
 }
@@ -20,15 +20,27 @@
 #include "IdMipTextureReader.h"
 
 #include "Assets/Palette.h"
+#include "IO/TextureCache.h"
 
 namespace TrenchBroom {
     namespace IO {
         IdMipTextureReader::IdMipTextureReader(const NameStrategy& nameStrategy, const Assets::Palette& palette) :
         MipTextureReader(nameStrategy),
-        m_palette(palette) {}
+        m_palette(palette),
+        m_cacheSalt(0) {
+            if (m_palette.initialized()) {
+                const auto& data = m_palette.data();
+                const auto* begin = reinterpret_cast<const char*>(data.data());
+                m_cacheSalt = TextureCache::hash(begin, begin + data.size());
+            }
+        }
 
         Assets::Palette IdMipTextureReader::doGetPalette(Reader& /* reader */, const size_t /* offset */[], const size_t /* width */, const size_t /* height */) const {
             return m_palette;
         }
+
+        uint64_t IdMipTextureReader::doGetCacheSalt() const {
+            return m_cacheSalt;
+        }
     }
 }
@@ -30,10 +30,12 @@ namespace TrenchBroom {
         class IdMipTextureReader : public MipTextureReader {
         protected:
             const Assets::Palette m_palette;
+            uint64_t m_cacheSalt;
         public:
             IdMipTextureReader(const NameStrategy& nameStrategy, const Assets::Palette& palette);
         protected:
             Assets::Palette doGetPalette(Reader& reader, const size_t offset[], size_t width, size_t height) const override;
+            uint64_t doGetCacheSalt() const override;
         };
     }
 }
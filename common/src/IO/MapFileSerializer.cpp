@@ -26,8 +26,12 @@
 #include "Model/BrushFace.h"
 #include "Model/EntityAttributes.h"
 
+#include <cstdarg>
+#include <cstdio>
 #include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -36,8 +40,8 @@ namespace TrenchBroom {
             std::string FacePointFormat;
             std::string TextureInfoFormat;
         public:
-            explicit QuakeFileSerializer(FILE* stream) :
-            MapFileSerializer(stream),
+            QuakeFileSerializer(const Model::MapFormat format, FILE* stream) :
+            MapFileSerializer(format, stream),
             FacePointFormat(getFacePointFormat()),
             TextureInfoFormat(" %s %.6g %.6g %.6g %.6g %.6g") {}
         private:
@@ -56,37 +60,37 @@ namespace TrenchBroom {
                 return str.str();
             }
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
+                write("\n");
                 return 1;
             }
         protected:
-            void writeFacePoints(FILE* stream, Model::BrushFace* face) {
+            void writeFacePoints(Model::BrushFace* face) {
                 const Model::BrushFace::Points& points = face->points();
 
-                std::fprintf(stream, FacePointFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z());
+                write(FacePointFormat.c_str(),
+                      points[0].x(),
+                      points[0].y(),
+                      points[0].z(),
+                      points[1].x(),
+                      points[1].y(),
+                      points[1].z(),
+                      points[2].x(),
+                      points[2].y(),
+                      points[2].z());
             }
 
-            void writeTextureInfo(FILE* stream, Model::BrushFace* face) {
+            void writeTextureInfo(Model::BrushFace* face) {
                 const std::string& textureName = face->textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face->textureName();
-                std::fprintf(stream, TextureInfoFormat.c_str(),
-                             textureName.c_str(),
-                             static_cast<double>(face->xOffset()),
-                             static_cast<double>(face->yOffset()),
-                             static_cast<double>(face->rotation()),
-                             static_cast<double>(face->xScale()),
-                             static_cast<double>(face->yScale()));
+                write(TextureInfoFormat.c_str(),
+                      textureName.c_str(),
+                      static_cast<double>(face->xOffset()),
+                      static_cast<double>(face->yOffset()),
+                      static_cast<double>(face->rotation()),
+                      static_cast<double>(face->xScale()),
+                      static_cast<double>(face->yScale()));
             }
         };
 
@@ -94,27 +98,27 @@ namespace TrenchBroom {
         private:
             std::string SurfaceAttributesFormat;
         public:
-            explicit Quake2FileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
+            Quake2FileSerializer(const Model::MapFormat format, FILE* stream) :
+            QuakeFileSerializer(format, stream),
             SurfaceAttributesFormat(" %d %d %.6g") {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
 
                 // Neverball's "mapc" doesn't like it if surface attributes aren't present.
                 // This suggests the Radiants always output these, so it's probably a compatibility danger.
-                writeSurfaceAttributes(stream, face);
+                writeSurfaceAttributes(face);
 
-                std::fprintf(stream, "\n");
+                write("\n");
                 return 1;
             }
         protected:
-            void writeSurfaceAttributes(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceAttributesFormat.c_str(),
-                             face->surfaceContents(),
-                             face->surfaceFlags(),
-                             static_cast<double>(face->surfaceValue()));
+            void writeSurfaceAttributes(Model::BrushFace* face) {
+                write(SurfaceAttributesFormat.c_str(),
+                      face->surfaceContents(),
+                      face->surfaceFlags(),
+                      static_cast<double>(face->surfaceValue()));
             }
         };
 
@@ -123,42 +127,42 @@ namespace TrenchBroom {
         private:
             std::string SurfaceColorFormat;
         public:
-            explicit DaikatanaFileSerializer(FILE* stream) :
-            Quake2FileSerializer(stream),
+            DaikatanaFileSerializer(const Model::MapFormat format, FILE* stream) :
+            Quake2FileSerializer(format, stream),
             SurfaceColorFormat(" %d %d %d") {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
 
                 if (face->hasSurfaceAttributes() || face->hasColor()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(face);
                 }
                 if (face->hasColor()) {
-                    writeSurfaceColor(stream, face);
+                    writeSurfaceColor(face);
                 }
 
-                std::fprintf(stream, "\n");
+                write("\n");
                 return 1;
             }
         protected:
-            void writeSurfaceColor(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceColorFormat.c_str(),
-                             static_cast<int>(face->color().r()),
-                             static_cast<int>(face->color().g()),
-                             static_cast<int>(face->color().b()));
+            void writeSurfaceColor(Model::BrushFace* face) {
+                write(SurfaceColorFormat.c_str(),
+                      static_cast<int>(face->color().r()),
+                      static_cast<int>(face->color().g()),
+                      static_cast<int>(face->color().b()));
             }
         };
 
         class Hexen2FileSerializer : public QuakeFileSerializer {
         public:
-            explicit Hexen2FileSerializer(FILE* stream):
-            QuakeFileSerializer(stream) {}
+            Hexen2FileSerializer(const Model::MapFormat format, FILE* stream) :
+            QuakeFileSerializer(format, stream) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, " 0\n"); // extra value written here
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
+                write(" 0\n"); // extra value written here
                 return 1;
             }
         };
@@ -167,112 +171,183 @@ namespace TrenchBroom {
         private:
             std::string ValveTextureInfoFormat;
         public:
-            explicit ValveFileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
+            ValveFileSerializer(const Model::MapFormat format, FILE* stream) :
+            QuakeFileSerializer(format, stream),
             ValveTextureInfoFormat(" %s [ %.6g %.6g %.6g %.6g ] [ %.6g %.6g %.6g %.6g ] %.6g %.6g %.6g") {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeValveTextureInfo(face);
+                write("\n");
                 return 1;
             }
         private:
-            void writeValveTextureInfo(FILE* stream, Model::BrushFace* face) {
+            void writeValveTextureInfo(Model::BrushFace* face) {
                 const std::string& textureName = face->textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face->textureName();
                 const vm::vec3 xAxis = face->textureXAxis();
                 const vm::vec3 yAxis = face->textureYAxis();
 
-                std::fprintf(stream, ValveTextureInfoFormat.c_str(),
-                             textureName.c_str(),
+                write(ValveTextureInfoFormat.c_str(),
+                      textureName.c_str(),
 
-                             xAxis.x(),
-                             xAxis.y(),
-                             xAxis.z(),
-                             static_cast<double>(face->xOffset()),
+                      xAxis.x(),
+                      xAxis.y(),
+                      xAxis.z(),
+                      static_cast<double>(face->xOffset()),
 
-                             yAxis.x(),
-                             yAxis.y(),
-                             yAxis.z(),
-                             static_cast<double>(face->yOffset()),
+                      yAxis.x(),
+                      yAxis.y(),
+                      yAxis.z(),
+                      static_cast<double>(face->yOffset()),
 
-                             static_cast<double>(face->rotation()),
-                             static_cast<double>(face->xScale()),
-                             static_cast<double>(face->yScale()));
+                      static_cast<double>(face->rotation()),
+                      static_cast<double>(face->xScale()),
+                      static_cast<double>(face->yScale()));
             }
         };
 
         std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, FILE* stream) {
+            ensure(stream != nullptr, "stream is null");
+            return createSerializer(format, stream);
+        }
+
+        std::unique_ptr<MapFileSerializer> MapFileSerializer::createSerializer(const Model::MapFormat format, FILE* stream) {
             switch (format) {
                 case Model::MapFormat::Standard:
-                    return std::make_unique<QuakeFileSerializer>(stream);
+                    return std::make_unique<QuakeFileSerializer>(format, stream);
                 case Model::MapFormat::Quake2:
                     // TODO 2427: Implement Quake3 serializers and use them
                 case Model::MapFormat::Quake3:
                 case Model::MapFormat::Quake3_Legacy:
-                    return std::make_unique<Quake2FileSerializer>(stream);
+                    return std::make_unique<Quake2FileSerializer>(format, stream);
                 case Model::MapFormat::Daikatana:
-                    return std::make_unique<DaikatanaFileSerializer>(stream);
+                    return std::make_unique<DaikatanaFileSerializer>(format, stream);
                 case Model::MapFormat::Valve:
-                    return std::make_unique<ValveFileSerializer>(stream);
+                    return std::make_unique<ValveFileSerializer>(format, stream);
                 case Model::MapFormat::Hexen2:
-                    return std::make_unique<Hexen2FileSerializer>(stream);
+                    return std::make_unique<Hexen2FileSerializer>(format, stream);
                 case Model::MapFormat::Unknown:
                     throw FileFormatException("Unknown map file format");
                 switchDefault()
             }
         }
 
-        MapFileSerializer::MapFileSerializer(FILE* stream) :
-        m_line(1),
+        MapFileSerializer::MapFileSerializer(const Model::MapFormat format, FILE* stream) :
+        m_line(stream != nullptr ? 1 : 0),
+        m_format(format),
         m_stream(stream) {
-            ensure(m_stream != nullptr, "stream is null");
+            m_buffer.reserve(BufferSize);
+        }
+
+        void MapFileSerializer::write(const char* format, ...) {
+            char chars[512];
+
+            std::va_list args;
+            va_start(args, format);
+            std::va_list argsCopy;
+            va_copy(argsCopy, args);
+            const auto length = std::vsnprintf(chars, sizeof(chars), format, args);
+            va_end(args);
+
+            if (length < 0) {
+                va_end(argsCopy);
+                throw FileFormatException("Could not format map file output");
+            }
+
+            const auto size = static_cast<size_t>(length);
+            if (size < sizeof(chars)) {
+                m_buffer.append(chars, size);
+            } else {
+                // the output did not fit, e.g. because of a very long texture name or attribute value
+                std::vector<char> largeChars(size + 1u);
+                std::vsnprintf(largeChars.data(), largeChars.size(), format, argsCopy);
+                m_buffer.append(largeChars.data(), size);
+            }
+            va_end(argsCopy);
+        }
+
+        void MapFileSerializer::flushIfFull() {
+            if (m_stream != nullptr && m_buffer.size() >= BufferSize) {
+                flush();
+            }
+        }
+
+        void MapFileSerializer::flush() {
+            std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_stream);
+            m_buffer.clear();
         }
 
         void MapFileSerializer::doBeginFile() {}
-        void MapFileSerializer::doEndFile() {}
+
+        void MapFileSerializer::doEndFile() {
+            flush();
+        }
 
         void MapFileSerializer::doBeginEntity(const Model::Node* /* node */) {
-            std::fprintf(m_stream, "// entity %u\n", entityNo());
+            write("// entity %u\n", entityNo());
             ++m_line;
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            write("{\n");
             ++m_line;
         }
 
         void MapFileSerializer::doEndEntity(Model::Node* node) {
-            std::fprintf(m_stream, "}\n");
+            write("}\n");
             ++m_line;
             setFilePosition(node);
+            flushIfFull();
         }
 
         void MapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
-            std::fprintf(m_stream, "\"%s\" \"%s\"\n",
-                         escapeEntityAttribute( attribute.name()).c_str(),
-                         escapeEntityAttribute(attribute.value()).c_str());
+            write("\"%s\" \"%s\"\n",
+                  escapeEntityAttribute( attribute.name()).c_str(),
+                  escapeEntityAttribute(attribute.value()).c_str());
             ++m_line;
         }
 
         void MapFileSerializer::doBeginBrush(const Model::Brush* /* brush */) {
-            std::fprintf(m_stream, "// brush %u\n", brushNo());
+            write("// brush %u\n", brushNo());
             ++m_line;
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            write("{\n");
             ++m_line;
         }
 
         void MapFileSerializer::doEndBrush(Model::Brush* brush) {
-            std::fprintf(m_stream, "}\n");
+            write("}\n");
             ++m_line;
             setFilePosition(brush);
+            flushIfFull();
         }
 
         void MapFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const size_t lines = doWriteBrushFace(m_stream, face);
+            const size_t lines = doWriteBrushFace(face);
             face->setFilePosition(m_line, lines);
             m_line += lines;
         }
 
+        std::unique_ptr<NodeSerializer> MapFileSerializer::doCreateChunkSerializer() const {
+            return createSerializer(m_format, nullptr);
+        }
+
+        void MapFileSerializer::doWriteChunk(NodeSerializer& chunkSerializer, const std::vector<Model::Brush*>& brushes) {
+            auto& chunk = static_cast<MapFileSerializer&>(chunkSerializer);
+
+            // the chunk serializer started counting at line 0, which corresponds to the current line
+            for (auto* brush : brushes) {
+                brush->setFilePosition(brush->lineNumber() + m_line, brush->lineCount());
+                for (auto* face : brush->faces()) {
+                    face->setFilePosition(face->lineNumber() + m_line, face->lineCount());
+                }
+            }
+            m_line += chunk.m_line;
+            chunk.m_line = 0;
+
+            m_buffer.append(chunk.m_buffer);
+            chunk.m_buffer.clear();
+            flushIfFull();
+        }
+
         void MapFileSerializer::setFilePosition(Model::Node* node) {
             const size_t start = startLine();
             node->setFilePosition(start, m_line - start);
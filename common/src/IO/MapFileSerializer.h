@@ -25,6 +25,7 @@
 
 #include <cstdio> // for FILE*
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom {
@@ -36,16 +37,39 @@ namespace TrenchBroom {
     }
 
     namespace IO {
+        /**
+         * Writes map files to a file and records the file position of every written node and brush face.
+         *
+         * The output is collected in a buffer and written to the file whenever the buffer is full and at the end of the
+         * file. Chunk serializers, which format brushes on worker threads, have no file and count their lines from 0.
+         * When their output is appended, the file positions of the serialized brushes and their faces are moved by the
+         * number of lines written before the chunk.
+         */
         class MapFileSerializer : public NodeSerializer {
         private:
+            static const size_t BufferSize = 64 * 1024;
+
             using LineStack = std::vector<size_t>;
             LineStack m_startLineStack;
             size_t m_line;
+            Model::MapFormat m_format;
             FILE* m_stream;
+            std::string m_buffer;
         public:
             static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, FILE* stream);
+        private:
+            static std::unique_ptr<MapFileSerializer> createSerializer(Model::MapFormat format, FILE* stream);
         protected:
-            explicit MapFileSerializer(FILE* file);
+            MapFileSerializer(Model::MapFormat format, FILE* stream);
+
+            /**
+             * Formats the given arguments according to the given printf style format string and appends the result to
+             * the buffer.
+             */
+            void write(const char* format, ...);
+        private:
+            void flushIfFull();
+            void flush();
         private:
             void doBeginFile() override;
             void doEndFile() override;
@@ -56,11 +80,14 @@ namespace TrenchBroom {
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
             void doBrushFace(Model::BrushFace* face) override;
+
+            std::unique_ptr<NodeSerializer> doCreateChunkSerializer() const override;
+            void doWriteChunk(NodeSerializer& chunkSerializer, const std::vector<Model::Brush*>& brushes) override;
         private:
             void setFilePosition(Model::Node* node);
             size_t startLine();
         private:
-            virtual size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) = 0;
+            virtual size_t doWriteBrushFace(Model::BrushFace* face) = 0;
         };
     }
 }
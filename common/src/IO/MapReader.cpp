@@ -29,12 +29,16 @@
 #include "Model/ModelFactory.h"
 
 #include <kdl/map_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <exception>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -67,27 +71,43 @@ namespace TrenchBroom {
         StandardMapParser(begin, end),
         m_factory(nullptr),
         m_brushParent(nullptr),
-        m_currentNode(nullptr) {}
+        m_currentNode(nullptr),
+        m_threadCount(1u) {}
 
         MapReader::MapReader(const std::string& str) :
         StandardMapParser(str),
         m_factory(nullptr),
         m_brushParent(nullptr),
-        m_currentNode(nullptr) {}
+        m_currentNode(nullptr),
+        m_threadCount(1u) {}
 
         MapReader::~MapReader() {
             kdl::vec_clear_and_delete(m_faces);
+
+            // only non-empty if parsing failed
+            for (auto& info : m_deferredBrushes) {
+                kdl::vec_clear_and_delete(info.faces);
+            }
+            for (auto& entry : m_deferredNodes) {
+                delete entry.second;
+            }
+        }
+
+        void MapReader::setThreadCount(const size_t threadCount) {
+            m_threadCount = threadCount == 0u ? kdl::parallel_default_thread_count() : threadCount;
         }
 
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(format, status);
+            parseEntities(format, status, m_threadCount);
+            createDeferredBrushes(status);
             resolveNodes(status);
         }
 
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
             parseBrushes(format, status);
+            createDeferredBrushes(status);
         }
 
         void MapReader::readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -223,6 +243,13 @@ namespace TrenchBroom {
         }
 
         void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            if (deferBrushes()) {
+                m_deferredBrushes.push_back(BrushInfo{ m_brushParent, std::move(m_faces), startLine, lineCount, extraAttributes });
+                m_deferredNodes.emplace_back(m_brushParent, nullptr);
+                m_faces.clear();
+                return;
+            }
+
             try {
                 Model::Brush* brush = m_factory->createBrush(m_worldBounds, m_faces);
                 setFilePosition(brush, startLine, lineCount);
@@ -234,7 +261,66 @@ namespace TrenchBroom {
                 status.error(startLine, kdl::str_to_string("Skipping brush: ", e.what()));
                 m_faces.clear(); // the faces will have been deleted by the brush's constructor
             }
+        }
+
+        void MapReader::createDeferredBrushes(ParserStatus& status) {
+            if (m_deferredNodes.empty()) {
+                return;
+            }
+
+            struct BrushOrError {
+                Model::Brush* brush;
+                std::string error;
+                std::exception_ptr exception;
+            };
+
+            // No exception may escape from here, otherwise the brushes created by the other threads would be leaked.
+            const auto brushes = kdl::vec_parallel_transform(m_deferredBrushes, [&](const BrushInfo& info) {
+                try {
+                    return BrushOrError{ m_factory->createBrush(m_worldBounds, info.faces), "", nullptr };
+                } catch (const GeometryException& e) {
+                    // the faces will have been deleted by the brush's constructor
+                    return BrushOrError{ nullptr, e.what(), nullptr };
+                } catch (...) {
+                    return BrushOrError{ nullptr, "", std::current_exception() };
+                }
+            }, m_threadCount);
 
+            // the faces are now owned by the brushes or were deleted, so they must not be deleted by the destructor
+            for (auto& info : m_deferredBrushes) {
+                info.faces.clear();
+            }
+
+            const auto failed = std::find_if(std::begin(brushes), std::end(brushes), [](const auto& brush) { return brush.exception != nullptr; });
+            if (failed != std::end(brushes)) {
+                // report unexpected errors like the serial code path does, the remaining nodes are deleted by the destructor
+                for (const auto& brush : brushes) {
+                    delete brush.brush;
+                }
+                m_deferredBrushes.clear();
+                std::rethrow_exception(failed->exception);
+            }
+
+            auto brushIndex = size_t(0);
+            for (const auto& [parent, node] : m_deferredNodes) {
+                if (node != nullptr) {
+                    onNode(parent, node, status);
+                } else {
+                    const auto& info = m_deferredBrushes[brushIndex];
+                    const auto& result = brushes[brushIndex];
+                    if (result.brush != nullptr) {
+                        setFilePosition(result.brush, info.startLine, info.lineCount);
+                        setExtraAttributes(result.brush, info.extraAttributes);
+                        onBrush(parent, result.brush, status);
+                    } else {
+                        status.error(info.startLine, kdl::str_to_string("Skipping brush: ", result.error));
+                    }
+                    ++brushIndex;
+                }
+            }
+
+            m_deferredBrushes.clear();
+            m_deferredNodes.clear();
         }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, ParserStatus& status) {
@@ -246,7 +332,7 @@ namespace TrenchBroom {
                     Model::Layer* layer = kdl::map_find_or_default(m_layers, layerId,
                         static_cast<Model::Layer*>(nullptr));
                     if (layer != nullptr)
-                        onNode(layer, node, status);
+                        addNode(layer, node, status);
                     else
                         m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
                     return ParentInfo::Type_Layer;
@@ -262,7 +348,7 @@ namespace TrenchBroom {
                         Model::Group* group = kdl::map_find_or_default(m_groups, groupId,
                             static_cast<Model::Group*>(nullptr));
                         if (group != nullptr)
-                            onNode(group, node, status);
+                            addNode(group, node, status);
                         else
                             m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
                         return ParentInfo::Type_Group;
@@ -272,10 +358,22 @@ namespace TrenchBroom {
                 }
             }
 
-            onNode(nullptr, node, status);
+            addNode(nullptr, node, status);
             return ParentInfo::Type_None;
         }
 
+        bool MapReader::deferBrushes() const {
+            return m_threadCount > 1u;
+        }
+
+        void MapReader::addNode(Model::Node* parent, Model::Node* node, ParserStatus& status) {
+            if (deferBrushes()) {
+                m_deferredNodes.emplace_back(parent, node);
+            } else {
+                onNode(parent, node, status);
+            }
+        }
+
         void MapReader::stripParentAttributes(Model::AttributableNode* attributable, const ParentInfo::Type parentType) {
             switch (parentType) {
                 case ParentInfo::Type_Layer:
@@ -82,6 +82,24 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            /**
+             * The faces of a brush whose geometry has not been built yet, and the information required to create the
+             * brush node once it has.
+             */
+            struct BrushInfo {
+                Model::Node* parent;
+                std::vector<Model::BrushFace*> faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+            };
+
+            /**
+             * A node that has been read, but not yet attached to its parent. If the node is null, then the entry
+             * stands for the next brush in the list of deferred brushes.
+             */
+            using DeferredNode = std::pair<Model::Node*, Model::Node*>;
+
             vm::bbox3 m_worldBounds;
             Model::ModelFactory* m_factory;
 
@@ -92,6 +110,10 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+
+            size_t m_threadCount;
+            std::vector<BrushInfo> m_deferredBrushes;
+            std::vector<DeferredNode> m_deferredNodes;
         protected:
             MapReader(const char* begin, const char* end);
             explicit MapReader(const std::string& str);
@@ -101,6 +123,18 @@ namespace TrenchBroom {
             void readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status);
         public:
             ~MapReader() override;
+
+            /**
+             * Sets the number of threads used to build the brush geometry.
+             *
+             * If the given thread count is 1, each brush is created as soon as it has been parsed. Otherwise, parsing
+             * only collects the brush faces, and the geometry of all brushes is built in parallel once parsing is
+             * done. Afterwards, all nodes are attached to their parents in the order in which they were read, so the
+             * result is the same in both cases.
+             *
+             * @param threadCount the number of threads, 0 means the default number of threads
+             */
+            void setThreadCount(size_t threadCount);
         private: // implement MapParser interface
             void onFormatSet(Model::MapFormat format) override;
             void onBeginEntity(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) override;
@@ -113,6 +147,10 @@ namespace TrenchBroom {
             void createGroup(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const std::vector<Model::EntityAttribute>& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void createDeferredBrushes(ParserStatus& status);
+
+            bool deferBrushes() const;
+            void addNode(Model::Node* parent, Model::Node* node, ParserStatus& status);
 
             ParentInfo::Type storeNode(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
@@ -24,229 +24,313 @@
 #include "Model/BrushFace.h"
 #include "Model/EntityAttributes.h"
 
+#include <cfloat>
+#include <cstdio>
 #include <memory>
 #include <ostream>
-#include <sstream>
+#include <string>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+// std::to_chars is only available for floating point types if the library defines this macro
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define TB_HAS_FLOAT_TO_CHARS 1
+#endif
 
 namespace TrenchBroom {
     namespace IO {
         class QuakeStreamSerializer : public MapStreamSerializer {
         public:
-            explicit QuakeStreamSerializer(std::ostream& stream) :
-            MapStreamSerializer(stream) {}
+            QuakeStreamSerializer(const Model::MapFormat format, std::ostream* stream) :
+            MapStreamSerializer(format, stream) {}
         private:
-            virtual void doWriteBrushFace(std::ostream& stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                stream << " ";
-                writeTextureInfo(stream, face);
-                stream << "\n";
+            virtual void doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                write(' ');
+                writeTextureInfo(face);
+                write('\n');
             }
         protected:
-            void writeFacePoints(std::ostream& stream, Model::BrushFace* face) {
+            void writeFacePoints(Model::BrushFace* face) {
                 const Model::BrushFace::Points& points = face->points();
 
-                stream.precision(FloatPrecision);
-                stream << "( " <<
-                ftos(points[0].x(), FloatPrecision) << " " <<
-                ftos(points[0].y(), FloatPrecision) << " " <<
-                ftos(points[0].z(), FloatPrecision) <<" ) ( " <<
-                ftos(points[1].x(), FloatPrecision) << " " <<
-                ftos(points[1].y(), FloatPrecision) << " " <<
-                ftos(points[1].z(), FloatPrecision) << " ) ( " <<
-                ftos(points[2].x(), FloatPrecision) << " " <<
-                ftos(points[2].y(), FloatPrecision) << " " <<
-                ftos(points[2].z(), FloatPrecision) << " )";
+                write("( ");
+                writeFixed(points[0].x()); write(' ');
+                writeFixed(points[0].y()); write(' ');
+                writeFixed(points[0].z()); write(" ) ( ");
+                writeFixed(points[1].x()); write(' ');
+                writeFixed(points[1].y()); write(' ');
+                writeFixed(points[1].z()); write(" ) ( ");
+                writeFixed(points[2].x()); write(' ');
+                writeFixed(points[2].y()); write(' ');
+                writeFixed(points[2].z()); write(" )");
             }
 
-            void writeTextureInfo(std::ostream& stream, Model::BrushFace* face) {
+            void writeTextureInfo(Model::BrushFace* face) {
                 const std::string& textureName = face->textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face->textureName();
-                stream << textureName << " " <<
-                ftos(face->xOffset(), FloatPrecision)  << " " <<
-                ftos(face->yOffset(), FloatPrecision)  << " " <<
-                ftos(face->rotation(), FloatPrecision) << " " <<
-                ftos(face->xScale(), FloatPrecision)   << " " <<
-                ftos(face->yScale(), FloatPrecision);
+                write(textureName); write(' ');
+                writeFixed(static_cast<double>(face->xOffset())); write(' ');
+                writeFixed(static_cast<double>(face->yOffset())); write(' ');
+                writeFixed(static_cast<double>(face->rotation())); write(' ');
+                writeFixed(static_cast<double>(face->xScale())); write(' ');
+                writeFixed(static_cast<double>(face->yScale()));
             }
         };
 
         class Quake2StreamSerializer : public QuakeStreamSerializer {
         public:
-            explicit Quake2StreamSerializer(std::ostream& stream) :
-            QuakeStreamSerializer(stream) {}
+            Quake2StreamSerializer(const Model::MapFormat format, std::ostream* stream) :
+            QuakeStreamSerializer(format, stream) {}
         private:
-            virtual void doWriteBrushFace(std::ostream& stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                stream << " ";
-                writeTextureInfo(stream, face);
+            virtual void doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                write(' ');
+                writeTextureInfo(face);
                 // While it is possible to omit surface attributes, see MapFileSerializer for a description of why it's best to keep them.
-                stream << " ";
-                writeSurfaceAttributes(stream, face);
-                stream << "\n";
+                write(' ');
+                writeSurfaceAttributes(face);
+                write('\n');
             }
         protected:
-            void writeSurfaceAttributes(std::ostream& stream, Model::BrushFace* face) {
-                stream <<
-                face->surfaceContents()  << " " <<
-                face->surfaceFlags()     << " " <<
-                ftos(face->surfaceValue(), FloatPrecision);
+            void writeSurfaceAttributes(Model::BrushFace* face) {
+                writeInteger(face->surfaceContents()); write(' ');
+                writeInteger(face->surfaceFlags()); write(' ');
+                writeFixed(static_cast<double>(face->surfaceValue()));
             }
         };
 
         class DaikatanaStreamSerializer : public Quake2StreamSerializer {
         public:
-            explicit DaikatanaStreamSerializer(std::ostream& stream) :
-            Quake2StreamSerializer(stream) {}
+            DaikatanaStreamSerializer(const Model::MapFormat format, std::ostream* stream) :
+            Quake2StreamSerializer(format, stream) {}
         private:
-            virtual void doWriteBrushFace(std::ostream& stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                stream << " ";
-                writeTextureInfo(stream, face);
+            virtual void doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                write(' ');
+                writeTextureInfo(face);
                 if (face->hasSurfaceAttributes() || face->hasColor()) {
-                    stream << " ";
-                    writeSurfaceAttributes(stream, face);
+                    write(' ');
+                    writeSurfaceAttributes(face);
 
                 }
                 if (face->hasColor()) {
-                    stream << " ";
-                    writeSurfaceColor(stream, face);
+                    write(' ');
+                    writeSurfaceColor(face);
                 }
-                stream << "\n";
+                write('\n');
             }
         protected:
-            void writeSurfaceColor(std::ostream& stream, Model::BrushFace* face) {
-                stream <<
-                static_cast<int>(face->color().r()) << " " <<
-                static_cast<int>(face->color().g()) << " " <<
-                static_cast<int>(face->color().b());
+            void writeSurfaceColor(Model::BrushFace* face) {
+                writeInteger(static_cast<int>(face->color().r())); write(' ');
+                writeInteger(static_cast<int>(face->color().g())); write(' ');
+                writeInteger(static_cast<int>(face->color().b()));
             }
         };
 
         class ValveStreamSerializer : public QuakeStreamSerializer {
         public:
-            explicit ValveStreamSerializer(std::ostream& stream) :
-            QuakeStreamSerializer(stream) {}
+            ValveStreamSerializer(const Model::MapFormat format, std::ostream* stream) :
+            QuakeStreamSerializer(format, stream) {}
         private:
-            void doWriteBrushFace(std::ostream& stream, Model::BrushFace* face) override {
+            void doWriteBrushFace(Model::BrushFace* face) override {
 
-                writeFacePoints(stream, face);
-                stream << " ";
-                writeValveTextureInfo(stream, face);
-                stream << "\n";
+                writeFacePoints(face);
+                write(' ');
+                writeValveTextureInfo(face);
+                write('\n');
             }
         private:
-            void writeValveTextureInfo(std::ostream& stream, Model::BrushFace* face) {
+            void writeValveTextureInfo(Model::BrushFace* face) {
                 const std::string& textureName = face->textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face->textureName();
                 const vm::vec3& xAxis = face->textureXAxis();
                 const vm::vec3& yAxis = face->textureYAxis();
 
-                stream.precision(6);
-                stream <<
-                textureName     << " " <<
-                "[ " <<
-                xAxis.x() << " " <<
-                xAxis.y() << " " <<
-                xAxis.z() << " " <<
-                face->xOffset()   <<
-                " ] [ " <<
-                yAxis.x() << " " <<
-                yAxis.y() << " " <<
-                yAxis.z() << " " <<
-                face->yOffset()   <<
-                " ] " <<
-                face->rotation() << " " <<
-                face->xScale()   << " " <<
-                face->yScale();
+                write(textureName); write(" [ ");
+                writeGeneral(xAxis.x()); write(' ');
+                writeGeneral(xAxis.y()); write(' ');
+                writeGeneral(xAxis.z()); write(' ');
+                writeGeneral(static_cast<double>(face->xOffset())); write(" ] [ ");
+                writeGeneral(yAxis.x()); write(' ');
+                writeGeneral(yAxis.y()); write(' ');
+                writeGeneral(yAxis.z()); write(' ');
+                writeGeneral(static_cast<double>(face->yOffset())); write(" ] ");
+                writeGeneral(static_cast<double>(face->rotation())); write(' ');
+                writeGeneral(static_cast<double>(face->xScale())); write(' ');
+                writeGeneral(static_cast<double>(face->yScale()));
             }
         };
 
         class Hexen2StreamSerializer : public QuakeStreamSerializer {
         public:
-            explicit Hexen2StreamSerializer(std::ostream& stream) :
-            QuakeStreamSerializer(stream) {}
+            Hexen2StreamSerializer(const Model::MapFormat format, std::ostream* stream) :
+            QuakeStreamSerializer(format, stream) {}
         private:
-            virtual void doWriteBrushFace(std::ostream& stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                stream << " ";
-                writeTextureInfo(stream, face);
-                stream << " 0\n"; // extra value written here
+            virtual void doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                write(' ');
+                writeTextureInfo(face);
+                write(" 0\n"); // extra value written here
             }
         };
 
         std::unique_ptr<NodeSerializer> MapStreamSerializer::create(const Model::MapFormat format, std::ostream& stream) {
+            return createSerializer(format, &stream);
+        }
+
+        std::unique_ptr<MapStreamSerializer> MapStreamSerializer::createSerializer(const Model::MapFormat format, std::ostream* stream) {
             switch (format) {
                 case Model::MapFormat::Standard:
-                    return std::make_unique<QuakeStreamSerializer>(stream);
+                    return std::make_unique<QuakeStreamSerializer>(format, stream);
                 case Model::MapFormat::Quake2:
                     // TODO 2427: Implement Quake3 serializers and use them
                 case Model::MapFormat::Quake3:
                 case Model::MapFormat::Quake3_Legacy:
-                    return std::make_unique<Quake2StreamSerializer>(stream);
+                    return std::make_unique<Quake2StreamSerializer>(format, stream);
                 case Model::MapFormat::Daikatana:
-                    return std::make_unique<DaikatanaStreamSerializer>(stream);
+                    return std::make_unique<DaikatanaStreamSerializer>(format, stream);
                 case Model::MapFormat::Valve:
-                    return std::make_unique<ValveStreamSerializer>(stream);
+                    return std::make_unique<ValveStreamSerializer>(format, stream);
                 case Model::MapFormat::Hexen2:
-                    return std::make_unique<Hexen2StreamSerializer>(stream);
+                    return std::make_unique<Hexen2StreamSerializer>(format, stream);
                 case Model::MapFormat::Unknown:
                     throw FileFormatException("Unknown map file format");
                 switchDefault()
             }
         }
 
-        MapStreamSerializer::MapStreamSerializer(std::ostream& stream) :
-        m_stream(stream) {}
+        MapStreamSerializer::MapStreamSerializer(const Model::MapFormat format, std::ostream* stream) :
+        m_format(format),
+        m_stream(stream) {
+            m_buffer.reserve(BufferSize);
+        }
 
         MapStreamSerializer::~MapStreamSerializer() = default;
 
-        template <typename T, typename P>
-        std::string ftos_helper(const T v, const P precision) {
-            std::ostringstream strout;
-            strout.precision(static_cast<std::streamsize>(precision));
-            strout << std::fixed  << v;
+        void MapStreamSerializer::write(const char c) {
+            m_buffer.push_back(c);
+        }
+
+        void MapStreamSerializer::write(const char* str) {
+            m_buffer.append(str);
+        }
+
+        void MapStreamSerializer::write(const std::string& str) {
+            m_buffer.append(str);
+        }
+
+        void MapStreamSerializer::writeInteger(const long long i) {
+            // enough for the digits of any 64 bit integer and a sign
+            char chars[24];
+            auto* end = chars + sizeof(chars);
+            auto* cur = end;
+
+            auto u = i < 0 ? 0ull - static_cast<unsigned long long>(i) : static_cast<unsigned long long>(i);
+            do {
+                *--cur = static_cast<char>('0' + u % 10u);
+                u /= 10u;
+            } while (u != 0u);
+
+            if (i < 0) {
+                *--cur = '-';
+            }
+            m_buffer.append(cur, end);
+        }
 
-            std::string str = strout.str() ;
-            size_t end = str.find_last_not_of('0');
-            if (str[end] == '.') {
-                --end;
+        void MapStreamSerializer::writeFixed(const double v) {
+            // enough for the largest finite double in fixed notation with FloatPrecision decimal places
+            char chars[DBL_MAX_10_EXP + FloatPrecision + 8];
+#ifdef TB_HAS_FLOAT_TO_CHARS
+            auto* end = std::to_chars(chars, chars + sizeof(chars), v, std::chars_format::fixed, FloatPrecision).ptr;
+#else
+            auto* end = chars + std::snprintf(chars, sizeof(chars), "%.*f", FloatPrecision, v);
+#endif
+
+            // remove trailing zeros, and the decimal point if no decimals remain
+            auto* last = end;
+            while (last != chars && *(last - 1) == '0') {
+                --last;
+            }
+            if (last != chars && *(last - 1) == '.') {
+                --last;
             }
-            return str.erase(end + 1);
+            m_buffer.append(chars, last);
         }
 
-        std::string MapStreamSerializer::ftos(const float v, const int precision) {
-            return ftos_helper(v, precision);
+        void MapStreamSerializer::writeGeneral(const double v) {
+            char chars[32];
+#ifdef TB_HAS_FLOAT_TO_CHARS
+            auto* end = std::to_chars(chars, chars + sizeof(chars), v, std::chars_format::general, 6).ptr;
+#else
+            auto* end = chars + std::snprintf(chars, sizeof(chars), "%.6g", v);
+#endif
+            m_buffer.append(chars, end);
+        }
+
+        void MapStreamSerializer::flushIfFull() {
+            if (m_stream != nullptr && m_buffer.size() >= BufferSize) {
+                flush();
+            }
         }
 
-        std::string MapStreamSerializer::ftos(const double v, const int precision) {
-            return ftos_helper(v, precision);
+        void MapStreamSerializer::flush() {
+            m_stream->write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_buffer.clear();
         }
 
         void MapStreamSerializer::doBeginFile() {}
-        void MapStreamSerializer::doEndFile() {}
+
+        void MapStreamSerializer::doEndFile() {
+            flush();
+        }
 
         void MapStreamSerializer::doBeginEntity(const Model::Node* /* node */) {
-            m_stream << "// entity " << entityNo() << "\n";
-            m_stream << "{\n";
+            write("// entity ");
+            writeInteger(entityNo());
+            write("\n{\n");
         }
 
         void MapStreamSerializer::doEndEntity(Model::Node* /* node */) {
-            m_stream << "}\n";
+            write("}\n");
+            flushIfFull();
         }
 
         void MapStreamSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
-            m_stream << "\"" << escapeEntityAttribute(attribute.name()) << "\" \"" << escapeEntityAttribute(attribute.value()) << "\"\n";
+            write('"');
+            write(escapeEntityAttribute(attribute.name()));
+            write("\" \"");
+            write(escapeEntityAttribute(attribute.value()));
+            write("\"\n");
         }
 
         void MapStreamSerializer::doBeginBrush(const Model::Brush* /* brush */) {
-            m_stream << "// brush " << brushNo() << "\n";
-            m_stream << "{\n";
+            write("// brush ");
+            writeInteger(brushNo());
+            write("\n{\n");
         }
 
         void MapStreamSerializer::doEndBrush(Model::Brush* /* brush */) {
-            m_stream << "}\n";
+            write("}\n");
+            flushIfFull();
         }
 
         void MapStreamSerializer::doBrushFace(Model::BrushFace* face) {
-            doWriteBrushFace(m_stream, face);
+            doWriteBrushFace(face);
+            flushIfFull();
+        }
+
+        std::unique_ptr<NodeSerializer> MapStreamSerializer::doCreateChunkSerializer() const {
+            return createSerializer(m_format, nullptr);
+        }
+
+        void MapStreamSerializer::doWriteChunk(NodeSerializer& chunkSerializer, const std::vector<Model::Brush*>& /* brushes */) {
+            auto& chunk = static_cast<MapStreamSerializer&>(chunkSerializer);
+            m_buffer.append(chunk.m_buffer);
+            chunk.m_buffer.clear();
+            flushIfFull();
         }
     }
 }
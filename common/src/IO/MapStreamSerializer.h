@@ -26,21 +26,55 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Writes map files to a stream.
+         *
+         * The output is collected in a buffer and written to the stream in large blocks whenever the buffer is full
+         * and at the end of the file. Numbers are formatted directly into the buffer without creating temporary
+         * strings.
+         *
+         * Chunk serializers, which format brushes on worker threads, have no stream and keep their entire output in
+         * the buffer until it is appended to the buffer of the serializer that created them.
+         */
         class MapStreamSerializer : public NodeSerializer {
         private:
-            std::ostream& m_stream;
+            static const size_t BufferSize = 64 * 1024;
+
+            Model::MapFormat m_format;
+            std::ostream* m_stream;
+            std::string m_buffer;
         public:
             static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream& stream);
+        private:
+            static std::unique_ptr<MapStreamSerializer> createSerializer(Model::MapFormat format, std::ostream* stream);
         protected:
-            explicit MapStreamSerializer(std::ostream& stream);
+            MapStreamSerializer(Model::MapFormat format, std::ostream* stream);
         public:
             virtual ~MapStreamSerializer() override;
         protected:
-            static std::string ftos(float v, int precision);
-            static std::string ftos(double v, int precision);
+            void write(char c);
+            void write(const char* str);
+            void write(const std::string& str);
+            void writeInteger(long long i);
+
+            /**
+             * Writes the given value in fixed notation with FloatPrecision decimal places, and removes any trailing
+             * zeros and a trailing decimal point.
+             */
+            void writeFixed(double v);
+
+            /**
+             * Writes the given value with 6 significant digits, in the same way as a stream with its default
+             * formatting flags and a precision of 6.
+             */
+            void writeGeneral(double v);
+        private:
+            void flushIfFull();
+            void flush();
         private:
             void doBeginFile() override;
             void doEndFile() override;
@@ -51,8 +85,11 @@ namespace TrenchBroom {
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
             void doBrushFace(Model::BrushFace* face) override;
+
+            std::unique_ptr<NodeSerializer> doCreateChunkSerializer() const override;
+            void doWriteChunk(NodeSerializer& chunkSerializer, const std::vector<Model::Brush*>& brushes) override;
         private:
-            virtual void doWriteBrushFace(std::ostream& stream, Model::BrushFace* face) = 0;
+            virtual void doWriteBrushFace(Model::BrushFace* face) = 0;
         };
     }
 }
@@ -27,6 +27,7 @@
 #include "IO/File.h"
 #include "IO/Reader.h"
 #include "IO/ReaderException.h"
+#include "IO/TextureCache.h"
 
 #include <string>
 
@@ -34,6 +35,7 @@ namespace TrenchBroom {
     namespace IO {
         namespace MipLayout {
             static constexpr size_t TextureNameLength = 16;
+            static constexpr size_t MipLevels = 4;
         }
 
         MipTextureReader::MipTextureReader(const NameStrategy& nameStrategy) :
@@ -41,6 +43,10 @@ namespace TrenchBroom {
 
         MipTextureReader::~MipTextureReader() = default;
 
+        void MipTextureReader::setCache(std::shared_ptr<TextureCache> cache) {
+            m_cache = std::move(cache);
+        }
+
         size_t MipTextureReader::mipFileSize(const size_t width, const size_t height, const size_t mipLevels) {
             size_t result = 0;
             for (size_t i = 0; i < mipLevels; ++i) {
@@ -58,20 +64,90 @@ namespace TrenchBroom {
             }
         }
 
-        Assets::Texture* MipTextureReader::doReadTexture(std::shared_ptr<File> file) const {
-            static const size_t MipLevels = 4;
+        /**
+         * Textures whose names start with '{' use palette index 255 for transparent pixels.
+         */
+        static Assets::PaletteTransparency getTransparency(const std::string& name) {
+            return (!name.empty() && name.at(0) == '{')
+                   ? Assets::PaletteTransparency::Index255Transparent
+                   : Assets::PaletteTransparency::Opaque;
+        }
 
-            Color averageColor;
-            Assets::TextureBufferList buffers(MipLevels);
-            size_t offset[MipLevels];
+        Assets::Texture* MipTextureReader::doReadTextureLazily(std::shared_ptr<File> file, DecodeFunction decode) const {
+            ensure(!file->path().isEmpty(), "MipTextureReader::doReadTextureLazily requires a path");
+
+            const auto path = file->path();
+            const auto basename = path.lastComponent().deleteExtension().asString();
+            const auto name = textureName(basename, path);
+            try {
+                // only read the header and the smallest mip level, the pixels are decoded by doReadTexture once the
+                // texture is used
+                auto reader = file->reader();
+                reader.seekFromBegin(MipLayout::TextureNameLength);
+
+                const auto width = reader.readSize<int32_t>();
+                const auto height = reader.readSize<int32_t>();
+                if (width == 0 || height == 0 || !checkTextureDimensions(width, height)) {
+                    return nullptr;
+                }
 
+                size_t offset[MipLayout::MipLevels];
+                for (size_t i = 0; i < MipLayout::MipLevels; ++i) {
+                    offset[i] = reader.readSize<int32_t>();
+                }
+
+                // the average color is used before the texture is decoded, e.g. to render faces in flat shaded mode,
+                // so we compute it from the smallest mip level
+                const auto transparent = getTransparency(name);
+                auto averageColor = Color(0.0f, 0.0f, 0.0f, 1.0f);
+                const auto palette = doGetPalette(reader, offset, width, height);
+                if (palette.initialized()) {
+                    const auto level = MipLayout::MipLevels - 1;
+                    const auto size = mipSize(width, height, level);
+                    Assets::TextureBuffer buffer(4 * size);
+
+                    reader.seekFromBegin(offset[level]);
+                    palette.indexedToRgba(reader, size, buffer, transparent, averageColor);
+                }
+
+                const auto type = (transparent == Assets::PaletteTransparency::Index255Transparent)
+                                  ? Assets::TextureType::Masked
+                                  : Assets::TextureType::Opaque;
+                return new Assets::Texture(name, width, height, averageColor, GL_RGBA, type, std::move(decode));
+            } catch (const ReaderException&) {
+                return nullptr;
+            }
+        }
+
+        Assets::Texture* MipTextureReader::doReadTexture(std::shared_ptr<File> file) const {
             ensure(!file->path().isEmpty(), "MipTextureReader::doReadTexture requires a path");
 
             const auto path = file->path();
             const auto basename = path.lastComponent().deleteExtension().asString();
             const auto name = textureName(basename, path);
+            // textures that are not read directly from a file on disk, e.g. from a zip archive, are not cached
+            const auto source = file->source();
+            if (m_cache == nullptr || !source) {
+                return decodeTexture(*file, name);
+            }
+
+            const auto key = TextureCache::key(*source, doGetCacheSalt());
+            if (auto cachedTexture = m_cache->load(key, name)) {
+                return cachedTexture.release();
+            }
+
+            auto* texture = decodeTexture(*file, name);
+            m_cache->store(key, *texture);
+            return texture;
+        }
+
+        Assets::Texture* MipTextureReader::decodeTexture(const File& file, const std::string& name) const {
+            Color averageColor;
+            Assets::TextureBufferList buffers(MipLayout::MipLevels);
+            size_t offset[MipLayout::MipLevels];
+
             try {
-                auto reader = file->reader().buffer();
+                auto reader = file.reader().buffer();
 
                 // This is unused, we use the one from the wad directory (they're usually the same,
                 // but could be different in broken .wad's.)
@@ -84,22 +160,20 @@ namespace TrenchBroom {
                     return new Assets::Texture(name, 16, 16);
                 }
 
-                for (size_t i = 0; i < MipLevels; ++i) {
+                for (size_t i = 0; i < MipLayout::MipLevels; ++i) {
                     offset[i] = reader.readSize<int32_t>();
                 }
 
-                const auto transparent = (!name.empty() && name.at(0) == '{')
-                                         ? Assets::PaletteTransparency::Index255Transparent
-                                         : Assets::PaletteTransparency::Opaque;
+                const auto transparent = getTransparency(name);
 
-                Assets::setMipBufferSize(buffers, MipLevels, width, height, GL_RGBA);
+                Assets::setMipBufferSize(buffers, MipLayout::MipLevels, width, height, GL_RGBA);
                 auto palette = doGetPalette(reader, offset, width, height);
 
                 if (!palette.initialized()) {
                     return new Assets::Texture(name, width, height);
                 }
 
-                for (size_t i = 0; i < MipLevels; ++i) {
+                for (size_t i = 0; i < MipLayout::MipLevels; ++i) {
                     reader.seekFromBegin(offset[i]);
                     const size_t size = mipSize(width, height, i);
 
@@ -22,6 +22,7 @@
 
 #include "IO/TextureReader.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -34,12 +35,21 @@ namespace TrenchBroom {
         class BufferedReader;
         class File;
         class Reader;
+        class TextureCache;
 
         class MipTextureReader : public TextureReader {
+        private:
+            std::shared_ptr<TextureCache> m_cache;
         protected:
             explicit MipTextureReader(const NameStrategy& nameStrategy);
         public:
             ~MipTextureReader() override;
+
+            /**
+             * Sets the cache in which decoded textures are looked up before they are decoded, and stored after they
+             * were decoded. Pass null to disable caching.
+             */
+            void setCache(std::shared_ptr<TextureCache> cache);
         public:
             static size_t mipFileSize(size_t width, size_t height, size_t mipLevels);
             /**
@@ -49,7 +59,15 @@ namespace TrenchBroom {
             static std::string getTextureName(const BufferedReader& reader);
         protected:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture* doReadTextureLazily(std::shared_ptr<File> file, DecodeFunction decode) const override;
             virtual Assets::Palette doGetPalette(Reader& reader, const size_t offset[], size_t width, size_t height) const = 0;
+            /**
+             * Returns a value that distinguishes the textures decoded by this reader from the textures that another
+             * reader decodes from the same files, e.g. a hash of the palette.
+             */
+            virtual uint64_t doGetCacheSalt() const = 0;
+        private:
+            Assets::Texture* decodeTexture(const File& file, const std::string& name) const;
         };
     }
 }
@@ -19,6 +19,7 @@
 
 #include "NodeSerializer.h"
 
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/Group.h"
 #include "Model/EntityAttributes.h"
@@ -26,26 +27,17 @@
 #include "Model/NodeVisitor.h"
 #include "Model/World.h"
 
+#include <kdl/parallel.h>
 #include <kdl/string_format.h>
 #include <kdl/string_utils.h>
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <string>
 
 namespace TrenchBroom {
     namespace IO {
-        class NodeSerializer::BrushSerializer : public Model::NodeVisitor {
-        private:
-            NodeSerializer& m_serializer;
-        public:
-            explicit BrushSerializer(NodeSerializer& serializer) : m_serializer(serializer) {}
-
-            void doVisit(Model::World* /* world */) override   {}
-            void doVisit(Model::Layer* /* layer */) override   {}
-            void doVisit(Model::Group* /* group */) override   {}
-            void doVisit(Model::Entity* /* entity */) override {}
-            void doVisit(Model::Brush* brush) override   { m_serializer.brush(brush); }
-        };
-
         const std::string& NodeSerializer::IdManager::getId(const Model::Node* t) const {
             auto it = m_ids.find(t);
             if (it == std::end(m_ids)) {
@@ -65,10 +57,15 @@ namespace TrenchBroom {
 
         NodeSerializer::NodeSerializer() :
         m_entityNo(0),
-        m_brushNo(0) {}
+        m_brushNo(0),
+        m_threadCount(1u) {}
 
         NodeSerializer::~NodeSerializer() = default;
 
+        void NodeSerializer::setThreadCount(const size_t threadCount) {
+            m_threadCount = threadCount == 0u ? kdl::parallel_default_thread_count() : threadCount;
+        }
+
         NodeSerializer::ObjectNo NodeSerializer::entityNo() const {
             return m_entityNo;
         }
@@ -102,8 +99,9 @@ namespace TrenchBroom {
         void NodeSerializer::entity(Model::Node* node, const std::vector<Model::EntityAttribute>& attributes, const std::vector<Model::EntityAttribute>& parentAttributes, Model::Node* brushParent) {
             beginEntity(node, attributes, parentAttributes);
 
-            BrushSerializer brushSerializer(*this);
-            brushParent->iterate(brushSerializer);
+            Model::CollectBrushesVisitor collectBrushes;
+            brushParent->iterate(collectBrushes);
+            brushes(collectBrushes.brushes());
 
             endEntity(node);
         }
@@ -141,8 +139,58 @@ namespace TrenchBroom {
         }
 
         void NodeSerializer::brushes(const std::vector<Model::Brush*>& brushes) {
-            for (auto* brush : brushes) {
-                this->brush(brush);
+            if (m_threadCount > 1u && brushes.size() > BrushesPerChunk) {
+                brushesInParallel(brushes);
+            } else {
+                for (auto* brush : brushes) {
+                    this->brush(brush);
+                }
+            }
+        }
+
+        void NodeSerializer::brushesInParallel(const std::vector<Model::Brush*>& brushes) {
+            const auto chunkCount = (brushes.size() + BrushesPerChunk - 1u) / BrushesPerChunk;
+
+            // Only a limited number of chunks is held in memory at a time, and their serializers are reused for every
+            // batch of chunks.
+            const auto chunksPerBatch = std::min(ChunksPerThread * m_threadCount, chunkCount);
+
+            std::vector<std::unique_ptr<NodeSerializer>> chunkSerializers;
+            chunkSerializers.reserve(chunksPerBatch);
+            for (size_t i = 0u; i < chunksPerBatch; ++i) {
+                auto chunkSerializer = doCreateChunkSerializer();
+                if (chunkSerializer == nullptr) {
+                    // this serializer can only write brushes one after another
+                    for (auto* brush : brushes) {
+                        this->brush(brush);
+                    }
+                    return;
+                }
+                chunkSerializers.push_back(std::move(chunkSerializer));
+            }
+
+            std::vector<std::vector<Model::Brush*>> chunks(chunksPerBatch);
+            for (size_t batchBegin = 0u; batchBegin < chunkCount; batchBegin += chunksPerBatch) {
+                const auto batchSize = std::min(chunksPerBatch, chunkCount - batchBegin);
+                for (size_t i = 0u; i < batchSize; ++i) {
+                    const auto first = (batchBegin + i) * BrushesPerChunk;
+                    const auto last = std::min(first + BrushesPerChunk, brushes.size());
+                    chunks[i].assign(std::next(std::begin(brushes), static_cast<std::ptrdiff_t>(first)),
+                                     std::next(std::begin(brushes), static_cast<std::ptrdiff_t>(last)));
+                }
+
+                kdl::parallel_for(batchSize, [&](const size_t i) {
+                    auto& chunkSerializer = *chunkSerializers[i];
+                    chunkSerializer.m_brushNo = m_brushNo + static_cast<ObjectNo>(i * BrushesPerChunk);
+                    for (auto* brush : chunks[i]) {
+                        chunkSerializer.brush(brush);
+                    }
+                }, m_threadCount);
+
+                for (size_t i = 0u; i < batchSize; ++i) {
+                    doWriteChunk(*chunkSerializers[i], chunks[i]);
+                    m_brushNo += static_cast<ObjectNo>(chunks[i].size());
+                }
             }
         }
 
@@ -171,6 +219,12 @@ namespace TrenchBroom {
             doBrushFace(face);
         }
 
+        std::unique_ptr<NodeSerializer> NodeSerializer::doCreateChunkSerializer() const {
+            return nullptr;
+        }
+
+        void NodeSerializer::doWriteChunk(NodeSerializer& /* chunkSerializer */, const std::vector<Model::Brush*>& /* brushes */) {}
+
         class NodeSerializer::GetParentAttributes : public Model::ConstNodeVisitor {
         private:
             const IdManager& m_layerIds;
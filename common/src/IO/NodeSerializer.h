@@ -22,6 +22,7 @@
 
 #include "Model/IdType.h"
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -39,12 +40,13 @@ namespace TrenchBroom {
 
     namespace IO {
         class NodeSerializer {
-        private:
-            class BrushSerializer;
         protected:
             static const int FloatPrecision = 17;
             using ObjectNo = unsigned int;
         private:
+            static const size_t BrushesPerChunk = 256;
+            static const size_t ChunksPerThread = 4;
+
             class IdManager {
             private:
                 using IdMap = std::unordered_map<const Model::Node*, std::string>;
@@ -61,9 +63,23 @@ namespace TrenchBroom {
 
             ObjectNo m_entityNo;
             ObjectNo m_brushNo;
+
+            size_t m_threadCount;
         public:
             NodeSerializer();
             virtual ~NodeSerializer();
+
+            /**
+             * Sets the number of threads used to serialize the brushes of an entity.
+             *
+             * If the thread count is greater than 1 and this serializer supports it, the brushes of an entity are split
+             * into chunks, and each chunk is serialized into memory by a separate chunk serializer on a worker thread.
+             * The chunks are then written in their original order, so the result is the same as if the brushes had been
+             * serialized one after another.
+             *
+             * @param threadCount the number of threads, 0 means the default number of threads
+             */
+            void setThreadCount(size_t threadCount);
         protected:
             ObjectNo entityNo() const;
             ObjectNo brushNo() const;
@@ -86,6 +102,7 @@ namespace TrenchBroom {
             void entityAttribute(const Model::EntityAttribute& attribute);
 
             void brushes(const std::vector<Model::Brush*>& brushes);
+            void brushesInParallel(const std::vector<Model::Brush*>& brushes);
             void brush(Model::Brush* brush);
 
             void beginBrush(const Model::Brush* brush);
@@ -114,6 +131,19 @@ namespace TrenchBroom {
             virtual void doBeginBrush(const Model::Brush* brush) = 0;
             virtual void doEndBrush(Model::Brush* brush) = 0;
             virtual void doBrushFace(Model::BrushFace* face) = 0;
+
+            /**
+             * Creates a serializer for the same format which collects its output in memory and can therefore be used to
+             * serialize brushes on a worker thread. Returns null if this serializer does not support this, in which
+             * case brushes are always serialized on the calling thread.
+             */
+            virtual std::unique_ptr<NodeSerializer> doCreateChunkSerializer() const;
+
+            /**
+             * Writes the output of the given chunk serializer, which was created by doCreateChunkSerializer and has
+             * serialized the given brushes.
+             */
+            virtual void doWriteChunk(NodeSerializer& chunkSerializer, const std::vector<Model::Brush*>& brushes);
         };
     }
 }
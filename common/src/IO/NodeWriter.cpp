@@ -102,15 +102,25 @@ namespace TrenchBroom {
 
         NodeWriter::NodeWriter(Model::World& world, FILE* stream) :
         m_world(world),
-        m_serializer(MapFileSerializer::create(m_world.format(), stream)) {}
+        m_serializer(MapFileSerializer::create(m_world.format(), stream)) {
+            setThreadCount(0u);
+        }
 
         NodeWriter::NodeWriter(Model::World& world, std::ostream& stream) :
         m_world(world),
-        m_serializer(MapStreamSerializer::create(m_world.format(), stream)) {}
+        m_serializer(MapStreamSerializer::create(m_world.format(), stream)) {
+            setThreadCount(0u);
+        }
 
         NodeWriter::NodeWriter(Model::World& world, NodeSerializer* serializer) :
         m_world(world),
-        m_serializer(serializer) {}
+        m_serializer(serializer) {
+            setThreadCount(0u);
+        }
+
+        void NodeWriter::setThreadCount(const size_t threadCount) {
+            m_serializer->setThreadCount(threadCount);
+        }
 
         void NodeWriter::writeMap() {
             m_serializer->beginFile();
@@ -51,6 +51,14 @@ namespace TrenchBroom {
             NodeWriter(Model::World& world, std::ostream& stream);
             NodeWriter(Model::World& world, NodeSerializer* serializer);
 
+            /**
+             * Sets the number of threads used to serialize the brushes of each entity. By default, the default number
+             * of threads is used. The output does not depend on the number of threads.
+             *
+             * @param threadCount the number of threads, 0 means the default number of threads
+             */
+            void setThreadCount(size_t threadCount);
+
             void writeMap();
         private:
             void writeDefaultLayer();
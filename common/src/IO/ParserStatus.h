@@ -55,6 +55,12 @@ namespace TrenchBroom {
             void warn(const std::string& str);
             void error(const std::string& str);
             [[noreturn]] void errorAndThrow(const std::string& str);
+
+            /**
+             * Logs a message that was built by another parser status without a prefix, e.g. one that recorded the
+             * messages of a parser running on a worker thread. The message is prefixed with this status's prefix.
+             */
+            void relay(LogLevel level, const std::string& message);
         private:
             void log(LogLevel level, size_t line, size_t column, const std::string& str);
             std::string buildMessage(size_t line, size_t column, const std::string& str) const;
@@ -26,11 +26,21 @@
 #include <cerrno>
 #include <cstring>
 #include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Guards the seek positions of all underlying C files, since several file sources on different threads may
+         * share one file, e.g. when the textures of a WAD file are decoded in parallel.
+         */
+        static std::mutex& fileSourceMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
         Reader::Source::~Source() = default;
 
         size_t Reader::Source::size() const {
@@ -76,6 +86,8 @@ namespace TrenchBroom {
         m_length(length),
         m_position(0) {
             assert(m_file != nullptr);
+
+            std::lock_guard<std::mutex> lock(fileSourceMutex());
             std::rewind(m_file);
         }
 
@@ -93,6 +105,7 @@ namespace TrenchBroom {
             // of this reader and that no other reader will access the file while this reader is in use. This may be a
             // reasonable assumption, since we usually read files one by one.
 
+            std::lock_guard<std::mutex> lock(fileSourceMutex());
             const auto pos = std::ftell(m_file);
             if (pos < 0) {
                 throwError("ftell failed");
@@ -117,6 +130,7 @@ namespace TrenchBroom {
         }
 
         std::tuple<const char*, const char*, std::unique_ptr<char[]>> Reader::FileSource::doBuffer() const {
+            std::lock_guard<std::mutex> lock(fileSourceMutex());
             std::fseek(m_file, static_cast<long>(m_offset), SEEK_SET);
 
             auto buffer = std::make_unique<char[]>(m_length);
@@ -123,7 +123,7 @@ namespace TrenchBroom {
             /**
              * A reader source that reads directly from a file. Note that the seek position of the underlying C file
              * is kept in sync with this file source's position automatically, that is, two readers can read from the
-             * same underlying file without causing problems.
+             * same underlying file without causing problems, even if they are used on different threads.
              */
             class FileSource : public Source {
             private:
@@ -19,24 +19,34 @@
 
 #include "StandardMapParser.h"
 
+#include "Logger.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/EntityAttributes.h"
 
 #include <kdl/invoke.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_set.h>
 
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
-        const std::string& QuakeMapTokenizer::NumberDelim() {
-            static const std::string numberDelim(Whitespace() + ")");
-            return numberDelim;
+        const CharSet& QuakeMapTokenizer::WhitespaceDelims() {
+            static const CharSet whitespaceDelims(Whitespace());
+            return whitespaceDelims;
+        }
+
+        const CharSet& QuakeMapTokenizer::NumberDelims() {
+            static const CharSet numberDelims(Whitespace() + ")");
+            return numberDelims;
         }
 
         QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end) :
@@ -107,20 +117,20 @@ namespace TrenchBroom {
                         switchFallthrough();
                     case ' ':
                     case '\t':
-                        discardWhile(Whitespace());
+                        discardWhile(WhitespaceDelims());
                         break;
                     default: { // whitespace, integer, decimal or word
-                        const auto* e = readInteger(NumberDelim());
+                        const auto* e = readInteger(NumberDelims());
                         if (e != nullptr) {
                             return Token(QuakeMapToken::Integer, c, e, offset(c), startLine, startColumn);
                         }
 
-                        e = readDecimal(NumberDelim());
+                        e = readDecimal(NumberDelims());
                         if (e != nullptr) {
                             return Token(QuakeMapToken::Decimal, c, e, offset(c), startLine, startColumn);
                         }
 
-                        e = readUntil(Whitespace());
+                        e = readUntil(WhitespaceDelims());
                         if (e == nullptr) {
                             throw ParserException(startLine, startColumn, "Unexpected character: " + std::string(c, 1));
                         }
@@ -135,13 +145,163 @@ namespace TrenchBroom {
         const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
         const std::string StandardMapParser::PatchId = "patchDef2";
 
+        /**
+         * Parses a range of brushes on a worker thread and records the resulting callbacks and status messages so
+         * that they can be replayed on the calling thread later.
+         */
+        class StandardMapParser::BrushRangeParser : public StandardMapParser {
+        private:
+            enum class EventType {
+                BeginBrush,
+                EndBrush,
+                BrushFace,
+                Log
+            };
+
+            struct Event {
+                EventType type;
+                size_t index;
+            };
+
+            struct BrushEvent {
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+            };
+
+            struct FaceEvent {
+                size_t line;
+                vm::vec3 point1;
+                vm::vec3 point2;
+                vm::vec3 point3;
+                Model::BrushFaceAttributes attribs;
+                vm::vec3 texAxisX;
+                vm::vec3 texAxisY;
+            };
+
+            struct LogEvent {
+                LogLevel level;
+                std::string message;
+            };
+
+            class RecordingStatus : public ParserStatus {
+            private:
+                static NullLogger s_logger;
+                BrushRangeParser& m_parser;
+            public:
+                explicit RecordingStatus(BrushRangeParser& parser) :
+                ParserStatus(s_logger, ""),
+                m_parser(parser) {}
+            private:
+                void doProgress(double /* progress */) override {}
+
+                void doLog(const LogLevel level, const std::string& str) override {
+                    m_parser.m_events.push_back({ EventType::Log, m_parser.m_logs.size() });
+                    m_parser.m_logs.push_back({ level, str });
+                }
+            };
+
+            std::vector<Event> m_events;
+            std::vector<BrushEvent> m_brushes;
+            std::vector<FaceEvent> m_faces;
+            std::vector<LogEvent> m_logs;
+            bool m_failed;
+        public:
+            explicit BrushRangeParser(const TokenizerState::Snapshot& range) :
+            StandardMapParser(range.cur, range.end),
+            m_failed(false) {
+                m_tokenizer.restore(range);
+            }
+
+            void parse(const Model::MapFormat format) {
+                RecordingStatus status(*this);
+                try {
+                    parseBrushes(format, status);
+                } catch (...) {
+                    m_failed = true;
+                }
+            }
+
+            bool failed() const {
+                return m_failed;
+            }
+
+            void replay(StandardMapParser& parser, ParserStatus& status) const {
+                for (const auto& event : m_events) {
+                    switch (event.type) {
+                        case EventType::BeginBrush:
+                            parser.beginBrush(m_brushes[event.index].startLine, status);
+                            break;
+                        case EventType::EndBrush: {
+                            const auto& brush = m_brushes[event.index];
+                            parser.endBrush(brush.startLine, brush.lineCount, brush.extraAttributes, status);
+                            break;
+                        }
+                        case EventType::BrushFace: {
+                            const auto& face = m_faces[event.index];
+                            parser.brushFace(face.line, face.point1, face.point2, face.point3, face.attribs, face.texAxisX, face.texAxisY, status);
+                            break;
+                        }
+                        case EventType::Log: {
+                            const auto& log = m_logs[event.index];
+                            status.relay(log.level, log.message);
+                            break;
+                        }
+                    }
+                }
+            }
+        private:
+            void onFormatSet(Model::MapFormat /* format */) override {}
+
+            void onBeginEntity(size_t /* line */, const std::vector<Model::EntityAttribute>& /* attributes */, const ExtraAttributes& /* extraAttributes */, ParserStatus& /* status */) override {
+                // brush ranges never contain entities
+                assert(false);
+            }
+
+            void onEndEntity(size_t /* startLine */, size_t /* lineCount */, ParserStatus& /* status */) override {
+                assert(false);
+            }
+
+            void onBeginBrush(const size_t line, ParserStatus& /* status */) override {
+                m_events.push_back({ EventType::BeginBrush, m_brushes.size() });
+                m_brushes.push_back({ line, 0u, ExtraAttributes() });
+            }
+
+            void onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& /* status */) override {
+                m_events.push_back({ EventType::EndBrush, m_brushes.size() });
+                m_brushes.push_back({ startLine, lineCount, extraAttributes });
+            }
+
+            void onBrushFace(const size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& /* status */) override {
+                m_events.push_back({ EventType::BrushFace, m_faces.size() });
+                m_faces.push_back({ line, point1, point2, point3, attribs, texAxisX, texAxisY });
+            }
+        };
+
+        NullLogger StandardMapParser::BrushRangeParser::RecordingStatus::s_logger;
+
+        /**
+         * A range of consecutive brushes within an entity. The begin snapshot is the tokenizer position at the opening
+         * brace of the first brush, limited to the end of the range, and the end snapshot is the position after the
+         * closing brace of the last brush.
+         */
+        struct StandardMapParser::BrushRange {
+            TokenizerState::Snapshot begin;
+            TokenizerState::Snapshot end;
+            std::unique_ptr<BrushRangeParser> parser;
+        };
+
         StandardMapParser::StandardMapParser(const char* begin, const char* end) :
         m_tokenizer(QuakeMapTokenizer(begin, end)),
-        m_format(Model::MapFormat::Unknown) {}
+        m_format(Model::MapFormat::Unknown),
+        m_threadCount(1u),
+        m_nextBrushRange(0u) {}
 
         StandardMapParser::StandardMapParser(const std::string& str) :
         m_tokenizer(QuakeMapTokenizer(str)),
-        m_format(Model::MapFormat::Unknown) {}
+        m_format(Model::MapFormat::Unknown),
+        m_threadCount(1u),
+        m_nextBrushRange(0u) {}
 
         StandardMapParser::~StandardMapParser() = default;
 
@@ -198,15 +358,24 @@ namespace TrenchBroom {
             return format;
         }
 
-        void StandardMapParser::parseEntities(const Model::MapFormat format, ParserStatus& status) {
+        void StandardMapParser::parseEntities(const Model::MapFormat format, ParserStatus& status, const size_t threadCount) {
             setFormat(format);
 
+            m_threadCount = threadCount;
+            m_brushRanges.clear();
+            m_nextBrushRange = 0u;
+            if (m_threadCount > 1u) {
+                findBrushRanges();
+            }
+
             auto token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
                 expect(QuakeMapToken::OBrace, token);
                 parseEntity(status);
                 token = m_tokenizer.peekToken();
             }
+
+            m_brushRanges.clear();
         }
 
         void StandardMapParser::parseBrushes(const Model::MapFormat format, ParserStatus& status) {
@@ -273,7 +442,9 @@ namespace TrenchBroom {
                             beginEntity(startLine, attributes, extraAttributes, status);
                             beginEntityCalled = true;
                         }
-                        parseBrushOrBrushPrimitiveOrPatch(status);
+                        if (!replayBrushRange(token, status)) {
+                            parseBrushOrBrushPrimitiveOrPatch(status);
+                        }
                         break;
                     case QuakeMapToken::CBrace:
                         m_tokenizer.nextToken();
@@ -309,6 +480,170 @@ namespace TrenchBroom {
             }
         }
 
+        static bool isBlank(const char c) {
+            return c == ' ' || c == '\t';
+        }
+
+        static const char* skipBlanks(const char* cur, const char* end) {
+            while (cur < end && isBlank(*cur)) {
+                ++cur;
+            }
+            return cur;
+        }
+
+        /**
+         * Checks whether the given line consists only of quoted strings, and that none of these strings continues on
+         * the next line. The strings are delimited in the same way as the tokenizer does it, including its handling of
+         * paths with trailing backslashes.
+         */
+        static bool isAttributeLine(const char* cur, const char* lineEnd, const char* end) {
+            cur = skipBlanks(cur, lineEnd);
+            while (cur < lineEnd) {
+                if (*cur != '"') {
+                    return false;
+                }
+
+                ++cur;
+                auto escaped = false;
+                while (cur < lineEnd && (*cur != '"' || escaped)) {
+                    if (*cur == '"' && cur + 1 < end && (cur[1] == '\n' || cur[1] == '}')) {
+                        break;
+                    }
+                    escaped = *cur == '\\' && !escaped;
+                    ++cur;
+                }
+                if (cur == lineEnd) {
+                    return false;
+                }
+
+                cur = skipBlanks(cur + 1, lineEnd);
+            }
+            return true;
+        }
+
+        /**
+         * Scans the remainder of the file for ranges of consecutive brushes within entities. The scan relies on the
+         * braces that open and close entities and brushes being on lines of their own, which is how all common
+         * editors write map files. If the file does not follow this layout, no ranges are found and the entire file
+         * will be parsed serially.
+         */
+        void StandardMapParser::findBrushRanges() {
+            const auto state = m_tokenizer.snapshot();
+
+            // aim for enough ranges to keep all threads busy even if the brushes are distributed unevenly
+            const auto targetSize = std::max(static_cast<size_t>(state.end - state.cur) / (m_threadCount * 64u), size_t(1));
+
+            auto ranges = std::vector<BrushRange>();
+            auto brushBegin = state;
+            auto inRange = false;
+            size_t depth = 0u;
+
+            auto line = state.line;
+            auto firstColumn = state.column;
+            const auto* cur = state.cur;
+            while (cur < state.end) {
+                const auto* lineEnd = cur;
+                while (lineEnd < state.end && *lineEnd != '\n' && *lineEnd != '\r') {
+                    ++lineEnd;
+                }
+
+                const auto* c = skipBlanks(cur, lineEnd);
+                const auto column = firstColumn + static_cast<size_t>(c - cur);
+                if (c < lineEnd) {
+                    if (*c == '{' || *c == '}') {
+                        if (skipBlanks(c + 1, lineEnd) != lineEnd) {
+                            return;
+                        }
+
+                        if (*c == '{') {
+                            if (depth == 1u) {
+                                brushBegin = { state.begin, c, state.end, line, column, false };
+                            }
+                            ++depth;
+                        } else if (depth == 0u) {
+                            return;
+                        } else if (--depth == 1u) {
+                            if (!inRange) {
+                                ranges.push_back({ brushBegin, brushBegin, nullptr });
+                                inRange = true;
+                            }
+
+                            auto& range = ranges.back();
+                            range.end = { state.begin, c + 1, state.end, line, column + 1u, false };
+                            range.begin.end = c + 1;
+                            if (static_cast<size_t>(range.end.cur - range.begin.cur) >= targetSize) {
+                                inRange = false;
+                            }
+                        } else if (depth == 0u) {
+                            inRange = false;
+                        }
+                    } else if (*c == '/') {
+                        // comments starting with "/// " contain extra attributes, other comments are ignored
+                        if (c + 1 == lineEnd || c[1] != '/') {
+                            return;
+                        }
+                        if (c + 3 < lineEnd && c[2] == '/' && c[3] == ' ') {
+                            if (depth == 0u) {
+                                return;
+                            } else if (depth == 1u) {
+                                inRange = false;
+                            }
+                        }
+                    } else if (depth == 1u) {
+                        if (!isAttributeLine(c, lineEnd, state.end)) {
+                            return;
+                        }
+                        inRange = false;
+                    } else if (depth == 0u) {
+                        return;
+                    }
+                }
+
+                cur = lineEnd;
+                if (cur < state.end) {
+                    if (*cur == '\r' && cur + 1 < state.end && cur[1] == '\n') {
+                        ++cur;
+                    }
+                    ++cur;
+                    ++line;
+                }
+                firstColumn = 1u;
+            }
+
+            if (depth == 0u) {
+                m_brushRanges = std::move(ranges);
+            }
+        }
+
+        bool StandardMapParser::replayBrushRange(const Token& token, ParserStatus& status) {
+            if (m_nextBrushRange == m_brushRanges.size() || token.begin() != m_brushRanges[m_nextBrushRange].begin.cur) {
+                return false;
+            }
+
+            if (m_brushRanges[m_nextBrushRange].parser == nullptr) {
+                // parse the ranges in batches to limit the memory used for the recorded events
+                const auto first = m_nextBrushRange;
+                const auto count = std::min(m_threadCount * 4u, m_brushRanges.size() - first);
+                const auto format = m_format;
+                kdl::parallel_for(count, [&](const size_t i) {
+                    auto& range = m_brushRanges[first + i];
+                    range.parser = std::make_unique<BrushRangeParser>(range.begin);
+                    range.parser->parse(format);
+                }, m_threadCount);
+            }
+
+            auto& range = m_brushRanges[m_nextBrushRange++];
+            const auto parser = std::move(range.parser);
+            if (parser->failed()) {
+                // let the caller parse the brushes again so that it reports the error
+                return false;
+            }
+
+            parser->replay(*this, status);
+            m_tokenizer.restore(range.end);
+            return true;
+        }
+
         void StandardMapParser::parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status) {
             // consume initial opening brace
             auto token = expect(QuakeMapToken::OBrace | QuakeMapToken::CBrace | QuakeMapToken::Eof, m_tokenizer.nextToken());
@@ -638,7 +973,7 @@ namespace TrenchBroom {
         }
 
         std::string StandardMapParser::parseTextureName(ParserStatus& /* status */) {
-            auto textureName = m_tokenizer.readAnyString(QuakeMapTokenizer::Whitespace());
+            auto textureName = m_tokenizer.readAnyString(QuakeMapTokenizer::WhitespaceDelims());
             if (textureName == Model::BrushFaceAttributes::NoTextureName) {
                 textureName = "";
             }
@@ -30,6 +30,7 @@
 
 #include <vecmath/forward.h>
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -57,9 +58,11 @@ namespace TrenchBroom {
 
         class QuakeMapTokenizer : public Tokenizer<QuakeMapToken::Type> {
         private:
-            static const std::string& NumberDelim();
+            static const CharSet& NumberDelims();
             bool m_skipEol;
         public:
+            static const CharSet& WhitespaceDelims();
+
             QuakeMapTokenizer(const char* begin, const char* end);
             explicit QuakeMapTokenizer(const std::string& str);
 
@@ -76,8 +79,15 @@ namespace TrenchBroom {
             static const std::string BrushPrimitiveId;
             static const std::string PatchId;
 
+            class BrushRangeParser;
+            struct BrushRange;
+
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat m_format;
+
+            size_t m_threadCount;
+            std::vector<BrushRange> m_brushRanges;
+            size_t m_nextBrushRange;
         public:
             StandardMapParser(const char* begin, const char* end);
             explicit StandardMapParser(const std::string& str);
@@ -86,7 +96,20 @@ namespace TrenchBroom {
         protected:
             Model::MapFormat detectFormat();
 
-            void parseEntities(Model::MapFormat format, ParserStatus& status);
+            /**
+             * Parses all entities in the file.
+             *
+             * If the given thread count is greater than 1, the file is first scanned for ranges of consecutive brushes
+             * within the entities, and these ranges are parsed on worker threads. The results are replayed in file
+             * order once the ranges are reached while parsing the entities on the calling thread, so the callbacks
+             * and status messages are the same as when parsing serially. If the file cannot be split safely, or if
+             * a range cannot be parsed on its own, it is parsed serially instead.
+             *
+             * @param format the map format
+             * @param status the parser status
+             * @param threadCount the number of threads to use for parsing brushes
+             */
+            void parseEntities(Model::MapFormat format, ParserStatus& status, size_t threadCount = 1u);
             void parseBrushes(Model::MapFormat format, ParserStatus& status);
             void parseBrushFaces(Model::MapFormat format, ParserStatus& status);
 
@@ -97,6 +120,9 @@ namespace TrenchBroom {
             void parseEntity(ParserStatus& status);
             void parseEntityAttribute(std::vector<Model::EntityAttribute>& attributes, AttributeNames& names, ParserStatus& status);
 
+            void findBrushRanges();
+            bool replayBrushRange(const Token& token, ParserStatus& status);
+
             void parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status);
             void parseBrushPrimitive(ParserStatus& status, size_t startLine);
             void parseBrush(ParserStatus& status, size_t startLine, bool primitive);
@@ -0,0 +1,344 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Color.h"
+#include "Exceptions.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "IO/File.h"
+#include "IO/PathQt.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace TrenchBroom {
+    namespace IO {
+        namespace CacheLayout {
+            static constexpr uint32_t Magic = 0x43544254; // "TBTC"
+            static constexpr size_t HeaderSize = 56;
+            static constexpr size_t MipEntrySize = 16;
+            static constexpr size_t MaxMipCount = 16;
+            static constexpr size_t Alignment = 8;
+            static const QString EntrySuffix = ".tex";
+        }
+
+        // the maximum number of bytes of entries that are waiting to be written
+        static constexpr size_t MaxPendingSize = 64u * 1024u * 1024u;
+
+        static size_t align(const size_t offset) {
+            return (offset + CacheLayout::Alignment - 1) / CacheLayout::Alignment * CacheLayout::Alignment;
+        }
+
+        template <typename T>
+        static void write(std::string& buffer, const T value) {
+            buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static std::mutex& defaultCacheMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+        static std::shared_ptr<TextureCache>& defaultCacheInstance() {
+            static std::shared_ptr<TextureCache> instance;
+            return instance;
+        }
+
+        TextureCache::TextureCache(const Path& directory, const size_t sizeLimit) :
+        m_directory(directory),
+        m_sizeLimit(sizeLimit),
+        m_pendingSize(0),
+        m_writing(true),
+        m_stopped(false),
+        m_size(0),
+        m_tempFileCount(0) {
+            QDir(pathAsQString(m_directory)).mkpath(".");
+            m_writer = std::thread([this]() { runWriter(); });
+        }
+
+        TextureCache::~TextureCache() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+            }
+            m_condition.notify_all();
+            m_writer.join();
+        }
+
+        std::shared_ptr<TextureCache> TextureCache::defaultCache() {
+            std::lock_guard<std::mutex> lock(defaultCacheMutex());
+            return defaultCacheInstance();
+        }
+
+        void TextureCache::setDefaultCache(std::shared_ptr<TextureCache> cache) {
+            std::lock_guard<std::mutex> lock(defaultCacheMutex());
+            defaultCacheInstance() = std::move(cache);
+        }
+
+        uint64_t TextureCache::hash(const char* begin, const char* end, uint64_t seed) {
+            for (const auto* cur = begin; cur != end; ++cur) {
+                seed ^= static_cast<unsigned char>(*cur);
+                seed *= 1099511628211ull;
+            }
+            return seed;
+        }
+
+        uint64_t TextureCache::key(const FileSource& source, const uint64_t salt) {
+            const auto path = source.path.asString();
+            const uint64_t location[] = {
+                salt,
+                static_cast<uint64_t>(source.offset),
+                static_cast<uint64_t>(source.length),
+                static_cast<uint64_t>(source.modificationTime)
+            };
+
+            const auto result = hash(reinterpret_cast<const char*>(location), reinterpret_cast<const char*>(location) + sizeof(location));
+            return hash(path.data(), path.data() + path.size(), result);
+        }
+
+        size_t TextureCache::size() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_size;
+        }
+
+        std::unique_ptr<Assets::Texture> TextureCache::load(const uint64_t key, const std::string& name) const {
+            const auto path = entryPath(key);
+            if (!QFileInfo::exists(pathAsQString(path))) {
+                return nullptr;
+            }
+
+            try {
+                // the mapped file is owned by the texture until its pixels are uploaded
+                const auto file = std::make_shared<MappedFile>(path);
+                auto reader = file->reader();
+                if (reader.read<uint32_t, uint32_t>() != CacheLayout::Magic ||
+                    reader.read<uint32_t, uint32_t>() != Version ||
+                    reader.read<uint64_t, uint64_t>() != key) {
+                    return nullptr;
+                }
+
+                const auto width = reader.readSize<uint32_t>();
+                const auto height = reader.readSize<uint32_t>();
+                const auto format = static_cast<GLenum>(reader.read<uint32_t, uint32_t>());
+                const auto type = reader.read<uint32_t, uint32_t>();
+                const auto averageColor = reader.readVec<float, 4>();
+                const auto mipCount = reader.readSize<uint32_t>();
+                reader.seekForward(4);
+
+                if (width == 0 || height == 0 || mipCount == 0 || mipCount > CacheLayout::MaxMipCount ||
+                    type > static_cast<uint32_t>(Assets::TextureType::Masked) ||
+                    (format != GL_RGB && format != GL_BGR && format != GL_RGBA && format != GL_BGRA)) {
+                    return nullptr;
+                }
+
+                const auto bytesPerPixel = Assets::bytesPerPixelForFormat(format);
+                std::vector<const unsigned char*> mips(mipCount);
+                for (size_t i = 0; i < mipCount; ++i) {
+                    const auto offset = reader.readSize<uint64_t>();
+                    const auto size = reader.readSize<uint64_t>();
+
+                    const auto mipSize = Assets::sizeAtMipLevel(width, height, i);
+                    if (size < bytesPerPixel * mipSize.x() * mipSize.y()) {
+                        return nullptr;
+                    }
+
+                    // throws if the mip level is not within the file
+                    reader.subReaderFromBegin(offset, size);
+                    mips[i] = reinterpret_cast<const unsigned char*>(file->begin() + offset);
+                }
+
+                return std::make_unique<Assets::Texture>(name, width, height, Color(averageColor), file, std::move(mips), format, static_cast<Assets::TextureType>(type));
+            } catch (const ReaderException&) {
+                return nullptr;
+            } catch (const FileSystemException&) {
+                return nullptr;
+            }
+        }
+
+        void TextureCache::store(const uint64_t key, const Assets::Texture& texture) {
+            const auto& buffers = texture.buffersIfUnprepared();
+            if (buffers.empty() || buffers.size() > CacheLayout::MaxMipCount) {
+                return;
+            }
+
+            std::string contents;
+            write<uint32_t>(contents, CacheLayout::Magic);
+            write<uint32_t>(contents, Version);
+            write<uint64_t>(contents, key);
+            write<uint32_t>(contents, static_cast<uint32_t>(texture.width()));
+            write<uint32_t>(contents, static_cast<uint32_t>(texture.height()));
+            write<uint32_t>(contents, static_cast<uint32_t>(texture.format()));
+            write<uint32_t>(contents, static_cast<uint32_t>(texture.type()));
+            for (size_t i = 0; i < 4; ++i) {
+                write<float>(contents, texture.averageColor()[i]);
+            }
+            write<uint32_t>(contents, static_cast<uint32_t>(buffers.size()));
+            write<uint32_t>(contents, 0);
+            assert(contents.size() == CacheLayout::HeaderSize);
+
+            auto offset = align(CacheLayout::HeaderSize + buffers.size() * CacheLayout::MipEntrySize);
+            for (const auto& buffer : buffers) {
+                write<uint64_t>(contents, offset);
+                write<uint64_t>(contents, buffer.size());
+                offset = align(offset + buffer.size());
+            }
+
+            for (const auto& buffer : buffers) {
+                contents.resize(align(contents.size()), '\0');
+                contents.append(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_pendingSize + contents.size() > MaxPendingSize) {
+                // the writer thread has fallen behind, so we drop the entry rather than holding on to its memory
+                return;
+            }
+
+            m_pendingSize += contents.size();
+            m_pendingEntries.push_back(PendingEntry{key, std::move(contents)});
+            m_condition.notify_all();
+        }
+
+        void TextureCache::flush() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return !m_writing && m_pendingEntries.empty(); });
+        }
+
+        Path TextureCache::entryPath(const uint64_t key) const {
+            std::stringstream name;
+            name << std::hex;
+            name.width(16);
+            name.fill('0');
+            name << key;
+            return m_directory + Path(name.str() + CacheLayout::EntrySuffix.toStdString());
+        }
+
+        void TextureCache::runWriter() {
+            // count the existing entries on this thread so that creating the cache does not block
+            const auto dir = QDir(pathAsQString(m_directory));
+            size_t size = 0;
+            for (const auto& info : dir.entryInfoList({ "*" + CacheLayout::EntrySuffix }, QDir::Files)) {
+                size += static_cast<size_t>(info.size());
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_size += size;
+            }
+            evict();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true) {
+                m_writing = false;
+                m_condition.notify_all();
+                m_condition.wait(lock, [this]() { return m_stopped || !m_pendingEntries.empty(); });
+                if (m_pendingEntries.empty()) {
+                    return;
+                }
+
+                auto entry = std::move(m_pendingEntries.front());
+                m_pendingEntries.pop_front();
+                m_pendingSize -= entry.contents.size();
+                m_writing = true;
+
+                lock.unlock();
+                writeEntry(entry.key, entry.contents);
+                evict();
+                lock.lock();
+            }
+        }
+
+        void TextureCache::writeEntry(const uint64_t key, const std::string& contents) {
+            const auto path = entryPath(key);
+            std::stringstream tempName;
+            tempName << path.asString() << "." << m_tempFileCount++ << ".tmp";
+            const auto tempPath = Path(tempName.str());
+
+            {
+                std::ofstream stream(tempPath.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!stream.is_open()) {
+                    return;
+                }
+                stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+                if (!stream) {
+                    stream.close();
+                    QFile::remove(pathAsQString(tempPath));
+                    return;
+                }
+            }
+
+            // write to a temporary file first so that other threads or processes never read a partial entry
+            const auto entry = pathAsQString(path);
+            const auto existingSize = QFileInfo(entry).exists() ? static_cast<size_t>(QFileInfo(entry).size()) : 0;
+            QFile::remove(entry);
+            const auto renamed = QFile::rename(pathAsQString(tempPath), entry);
+            if (!renamed) {
+                QFile::remove(pathAsQString(tempPath));
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_size -= std::min(m_size, existingSize);
+            if (renamed) {
+                m_size += contents.size();
+            }
+        }
+
+        void TextureCache::evict() {
+            // only the writer thread adds or removes entries, so the directory can be scanned without holding the lock
+            size_t size;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                size = m_size;
+            }
+
+            if (size <= m_sizeLimit) {
+                return;
+            }
+
+            // evict down to three quarters of the limit so that we don't have to evict again on the next store
+            const auto targetSize = m_sizeLimit / 4 * 3;
+
+            size_t removedSize = 0;
+            const auto dir = QDir(pathAsQString(m_directory));
+            for (const auto& info : dir.entryInfoList({ "*" + CacheLayout::EntrySuffix }, QDir::Files, QDir::Time | QDir::Reversed)) {
+                if (size - removedSize <= targetSize) {
+                    break;
+                }
+                if (QFile::remove(info.absoluteFilePath())) {
+                    removedSize += std::min(size - removedSize, static_cast<size_t>(info.size()));
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_size -= std::min(m_size, removedSize);
+        }
+    }
+}
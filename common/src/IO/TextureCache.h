@@ -0,0 +1,160 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureCache_h
+#define TrenchBroom_TextureCache_h
+
+#include "IO/Path.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace IO {
+        struct FileSource;
+
+        /**
+         * A persistent cache of decoded textures in a directory on disk.
+         *
+         * Every entry is stored in its own file which is named after a key that is computed from the location of the
+         * texture on disk, i.e. the path, the offset and length within that file and its modification time. If the
+         * file changes, the key changes, too, and the stale entry is eventually evicted when the cache grows larger
+         * than its size limit. The oldest entries are evicted first.
+         *
+         * An entry consists of a header, a table containing the offset and size of every mip level, and the pixels of
+         * the mip levels, each aligned to 8 bytes so that an entry can be mapped into memory and uploaded as is.
+         * Entries are replaced by renaming a new file over them, so a mapped entry never changes. Entries that were
+         * written by a different version of the cache are ignored.
+         *
+         * Entries are written and evicted by a thread owned by the cache, so storing a texture does not block the
+         * calling thread, which is usually the render thread, on disk I/O.
+         *
+         * All functions may be called from several threads at once.
+         */
+        class TextureCache {
+        public:
+            static constexpr uint32_t Version = 1;
+        private:
+            struct PendingEntry {
+                uint64_t key;
+                std::string contents;
+            };
+
+            Path m_directory;
+            size_t m_sizeLimit;
+
+            mutable std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::deque<PendingEntry> m_pendingEntries;
+            size_t m_pendingSize;
+            bool m_writing;
+            bool m_stopped;
+            size_t m_size;
+            // only accessed by the writer thread
+            size_t m_tempFileCount;
+
+            std::thread m_writer;
+        public:
+            /**
+             * Creates a cache that stores its entries in the given directory. The directory is created if it does not
+             * exist.
+             *
+             * @param directory the cache directory
+             * @param sizeLimit the maximum number of bytes that the entries may occupy
+             */
+            TextureCache(const Path& directory, size_t sizeLimit);
+            /**
+             * Writes the pending entries and stops the writer thread.
+             */
+            ~TextureCache();
+
+            TextureCache(const TextureCache&) = delete;
+            TextureCache& operator=(const TextureCache&) = delete;
+
+            /**
+             * Returns the cache used when loading textures, or null if textures are not cached.
+             */
+            static std::shared_ptr<TextureCache> defaultCache();
+            static void setDefaultCache(std::shared_ptr<TextureCache> cache);
+
+            /**
+             * Returns a 64 bit FNV-1a hash of the given bytes.
+             */
+            static uint64_t hash(const char* begin, const char* end, uint64_t seed = 14695981039346656037ull);
+
+            /**
+             * Computes the key of the texture read from the given location. Only the location is hashed and not the
+             * contents, so computing a key is cheap.
+             *
+             * @param source the location of the texture on disk
+             * @param salt distinguishes textures that are decoded differently from the same file, e.g. with different
+             * palettes
+             */
+            static uint64_t key(const FileSource& source, uint64_t salt);
+
+            /**
+             * Returns the number of bytes occupied by the entries of this cache. Entries that are not written yet are
+             * not counted.
+             */
+            size_t size() const;
+
+            /**
+             * Loads the texture with the given key. The entry is mapped into memory and the pixels of the returned texture
+             * are uploaded from there without copying them.
+             *
+             * @param key the key of the texture
+             * @param name the name of the texture
+             * @return the texture, or null if there is no valid entry with the given key
+             */
+            std::unique_ptr<Assets::Texture> load(uint64_t key, const std::string& name) const;
+
+            /**
+             * Stores the given texture under the given key, and evicts the oldest entries if the cache grows larger
+             * than its size limit. The pixels are copied, and the entry is written by the writer thread later on.
+             * Textures without pixels are not stored. Errors writing the entry are ignored, and the entry is dropped
+             * if too many entries are waiting to be written.
+             *
+             * @param key the key of the texture
+             * @param texture the texture to store, must not be prepared yet
+             */
+            void store(uint64_t key, const Assets::Texture& texture);
+
+            /**
+             * Blocks until all entries that were stored before are written.
+             */
+            void flush();
+        private:
+            Path entryPath(uint64_t key) const;
+            void runWriter();
+            void writeEntry(uint64_t key, const std::string& contents);
+            void evict();
+        };
+    }
+}
+
+#endif
@@ -20,6 +20,7 @@
 #include "TextureCollectionLoader.h"
 
 #include "Logger.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
@@ -28,6 +29,9 @@
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
 #include <memory>
 #include <vector>
 
@@ -39,16 +43,21 @@ namespace TrenchBroom {
 
         TextureCollectionLoader::~TextureCollectionLoader() = default;
 
-        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader) {
+        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader) {
             auto collection = std::make_unique<Assets::TextureCollection>(path);
 
-            for (const auto& file : doFindTextures(path, textureExtensions)) {
-                const auto name = file->path().lastComponent().deleteExtension().asString();
-                if (shouldExclude(name)) {
-                    continue;
-                }
-                auto* texture = textureReader.readTexture(file);
-                collection->addTexture(texture);
+            auto files = doFindTextures(path, textureExtensions);
+            kdl::vec_erase_if(files, [&](const auto& file) {
+                return shouldExclude(file->path().lastComponent().deleteExtension().asString());
+            });
+
+            // decoding dominates the loading time of textures which cannot be loaded lazily, so the textures are read in
+            // parallel and added in their original order
+            auto textures = kdl::vec_parallel_transform(files, [&](const auto& file) {
+                return std::unique_ptr<Assets::Texture>(TextureReader::readTextureLazily(textureReader, file));
+            });
+            for (auto& texture : textures) {
+                collection->addTexture(texture.release());
             }
 
             return collection;
@@ -49,7 +49,11 @@ namespace TrenchBroom {
         public:
             virtual ~TextureCollectionLoader();
         public:
-            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, const TextureReader& textureReader);
+            /**
+             * Loads the textures of the collection at the given path. The textures are loaded lazily if the texture
+             * format supports it, in which case they keep the given reader alive.
+             */
+            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const std::vector<std::string>& textureExtensions, std::shared_ptr<const TextureReader> textureReader);
         private:
             bool shouldExclude(const std::string& textureName);
             virtual FileList doFindTextures(const Path& path, const std::vector<std::string>& extensions) = 0;
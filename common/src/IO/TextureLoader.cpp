@@ -29,6 +29,7 @@
 #include "IO/HlMipTextureReader.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/Quake3ShaderTextureReader.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureCollectionLoader.h"
 #include "IO/WalTextureReader.h"
 #include "IO/Path.h"
@@ -56,10 +57,14 @@ namespace TrenchBroom {
         std::unique_ptr<TextureReader> TextureLoader::createTextureReader(const FileSystem& gameFS, const Model::TextureConfig& textureConfig, Logger& logger) {
             if (textureConfig.format.format == "idmip") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(1, true);
-                return std::make_unique<IdMipTextureReader>(nameStrategy, loadPalette(gameFS, textureConfig, logger));
+                auto textureReader = std::make_unique<IdMipTextureReader>(nameStrategy, loadPalette(gameFS, textureConfig, logger));
+                textureReader->setCache(TextureCache::defaultCache());
+                return textureReader;
             } else if (textureConfig.format.format == "hlmip") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(1, true);
-                return std::make_unique<HlMipTextureReader>(nameStrategy);
+                auto textureReader = std::make_unique<HlMipTextureReader>(nameStrategy);
+                textureReader->setCache(TextureCache::defaultCache());
+                return textureReader;
             } else if (textureConfig.format.format == "wal") {
                 TextureReader::PathSuffixNameStrategy nameStrategy(2, true);
                 return std::make_unique<WalTextureReader>(nameStrategy, loadPalette(gameFS, textureConfig, logger));
@@ -103,7 +108,7 @@ namespace TrenchBroom {
         }
 
         std::unique_ptr<Assets::TextureCollection> TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, m_textureReader);
         }
 
         void TextureLoader::loadTextures(const std::vector<Path>& paths, Assets::TextureManager& textureManager) {
@@ -48,7 +48,7 @@ namespace TrenchBroom {
         class TextureLoader {
         private:
             std::vector<std::string> m_textureExtensions;
-            std::unique_ptr<TextureReader> m_textureReader;
+            std::shared_ptr<TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
             TextureLoader(const FileSystem& gameFS, const std::vector<Path>& fileSearchPaths, const Model::TextureConfig& textureConfig, Logger& logger);
@@ -19,8 +19,10 @@
 
 #include "TextureReader.h"
 
+#include "Exceptions.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureBuffer.h"
+#include "IO/File.h"
 #include "IO/FileSystem.h"
 
 #include <algorithm>
@@ -86,6 +88,26 @@ namespace TrenchBroom {
             return doReadTexture(file);
         }
 
+        Assets::Texture* TextureReader::readTextureLazily(std::shared_ptr<const TextureReader> reader, std::shared_ptr<File> file) {
+            auto decode = [reader, file]() {
+                // the file may have been changed on disk since the texture was loaded, in which case reading it fails
+                try {
+                    return std::unique_ptr<Assets::Texture>(reader->readTexture(file));
+                } catch (const FileSystemException&) {
+                    return std::unique_ptr<Assets::Texture>();
+                }
+            };
+
+            if (auto* texture = reader->doReadTextureLazily(file, std::move(decode))) {
+                return texture;
+            }
+            return reader->readTexture(file);
+        }
+
+        Assets::Texture* TextureReader::doReadTextureLazily(std::shared_ptr<File> /* file */, DecodeFunction /* decode */) const {
+            return nullptr;
+        }
+
         std::string TextureReader::textureName(const std::string& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
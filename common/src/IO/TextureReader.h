@@ -22,6 +22,7 @@
 
 #include "Macros.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -94,6 +95,20 @@ namespace TrenchBroom {
             virtual ~TextureReader();
 
             Assets::Texture* readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Reads only the name and size of a texture if the texture format supports that, and defers decoding its
+             * pixels until the texture is first used. The returned texture keeps the given reader and file alive until
+             * it is deleted. If the format does not support lazy loading, the texture is read in full. If the file is
+             * modified on disk before the texture is decoded, the texture is not decoded at all.
+             *
+             * @param reader the reader to read the texture with
+             * @param file the file containing the texture
+             * @return an Assets::Texture object allocated with new
+             */
+            static Assets::Texture* readTextureLazily(std::shared_ptr<const TextureReader> reader, std::shared_ptr<File> file);
+        protected:
+            using DecodeFunction = std::function<std::unique_ptr<Assets::Texture>()>;
         protected:
             std::string textureName(const std::string& textureName, const Path& path) const;
             std::string textureName(const Path& path) const;
@@ -107,6 +122,17 @@ namespace TrenchBroom {
              * @return an Assets::Texture object allocated with new
              */
             virtual Assets::Texture* doReadTexture(std::shared_ptr<File> file) const = 0;
+
+            /**
+             * Reads the metadata of a texture and returns a lazily loaded Assets::Texture object allocated with new,
+             * which uses the given function to decode its pixels. Returns nullptr if the texture should be read in
+             * full instead, which is the default.
+             *
+             * @param file the file containing the texture
+             * @param decode the function that decodes the texture in full
+             * @return an Assets::Texture object allocated with new or nullptr
+             */
+            virtual Assets::Texture* doReadTextureLazily(std::shared_ptr<File> file, DecodeFunction decode) const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
@@ -22,6 +22,7 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 
 #include <kdl/string_utils.h>
 
@@ -75,6 +76,14 @@ namespace TrenchBroom {
                 return std::string(m_begin, length());
             }
 
+            /**
+             * Returns a view of this token's characters without copying them. The view is only valid as long as the
+             * tokenizer's input is.
+             */
+            std::string_view view() const {
+                return std::string_view(m_begin, length());
+            }
+
             size_t position() const {
                 return m_position;
             }
@@ -93,12 +102,12 @@ namespace TrenchBroom {
 
             template <typename T>
             T toFloat() const {
-                return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+                return static_cast<T>(kdl::str_to_double(m_begin, m_end).value_or(0.0));
             }
 
             template <typename T>
             T toInteger() const {
-                return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+                return static_cast<T>(kdl::str_to_long(m_begin, m_end).value_or(0l));
             }
         };
     }
@@ -20,19 +20,56 @@
 #ifndef TrenchBroom_Tokenizer_h
 #define TrenchBroom_Tokenizer_h
 
+#include "Exceptions.h"
+#include "Macros.h"
 #include "Token.h"
 
+#include <array>
+#include <cassert>
 #include <memory>
 #include <string>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * A set of characters that can be tested for membership with a single table lookup.
+         */
+        class CharSet {
+        private:
+            std::array<bool, 256> m_contains;
+        public:
+            explicit CharSet(const std::string& chars) :
+            m_contains{} {
+                for (const auto c : chars) {
+                    m_contains[static_cast<unsigned char>(c)] = true;
+                }
+            }
+
+            bool contains(const char c) const {
+                return m_contains[static_cast<unsigned char>(c)];
+            }
+        };
+
         class TokenizerState {
+        public:
+            /**
+             * The position of a tokenizer. Snapshots are trivially copyable, so they can be taken and restored
+             * without any allocations.
+             */
+            struct Snapshot {
+                const char* begin;
+                const char* cur;
+                const char* end;
+                size_t line;
+                size_t column;
+                bool escaped;
+            };
         private:
             const char* m_begin;
             const char* m_cur;
             const char* m_end;
             std::string m_escapableChars;
+            CharSet m_escapableCharSet;
             char m_escapeChar;
             size_t m_line;
             size_t m_column;
@@ -46,31 +83,101 @@ namespace TrenchBroom {
             const char* begin() const;
             const char* end() const;
 
-            const char* curPos() const;
-            char curChar() const;
+            const char* curPos() const {
+                return m_cur;
+            }
+
+            char curChar() const {
+                return *m_cur;
+            }
+
+            char lookAhead(const size_t offset = 1) const {
+                return eof(m_cur + offset) ? 0 : *(m_cur + offset);
+            }
 
-            char lookAhead(size_t offset = 1) const;
+            size_t line() const {
+                return m_line;
+            }
 
-            size_t line() const;
-            size_t column() const;
+            size_t column() const {
+                return m_column;
+            }
+
+            bool escaped() const {
+                return !eof() && m_escaped && m_escapableCharSet.contains(curChar());
+            }
 
-            bool escaped() const;
             std::string unescape(const std::string& str);
             void resetEscaped();
 
-            bool eof() const;
-            bool eof(const char* ptr) const;
+            bool eof() const {
+                return eof(m_cur);
+            }
 
-            size_t offset(const char* ptr) const;
+            bool eof(const char* ptr) const {
+                return ptr >= m_end;
+            }
+
+            size_t offset(const char* ptr) const {
+                assert(ptr >= m_begin);
+                return static_cast<size_t>(ptr - m_begin);
+            }
+
+            void advance(const size_t offset) {
+                for (size_t i = 0; i < offset; ++i) {
+                    advance();
+                }
+            }
+
+            void advance() {
+                errorIfEof();
+
+                switch (curChar()) {
+                    case '\r':
+                        if (lookAhead() == '\n') {
+                            ++m_column;
+                            break;
+                        }
+                        // handle carriage return without consecutive line feed
+                        // by falling through into the line feed case
+                        switchFallthrough();
+                    case '\n':
+                        ++m_line;
+                        m_column = 1;
+                        m_escaped = false;
+                        break;
+                    default:
+                        ++m_column;
+                        if (curChar() == m_escapeChar) {
+                            m_escaped = !m_escaped;
+                        } else {
+                            m_escaped = false;
+                        }
+                        break;
+                }
+                ++m_cur;
+            }
 
-            void advance(size_t offset);
-            void advance();
             void reset();
 
-            void errorIfEof() const;
+            void errorIfEof() const {
+                if (eof()) {
+                    throw ParserException("Unexpected end of file");
+                }
+            }
+
+            Snapshot snapshot() const {
+                return Snapshot{ m_begin, m_cur, m_end, m_line, m_column, m_escaped };
+            }
 
-            TokenizerState snapshot() const;
-            void restore(const TokenizerState& snapshot);
+            void restore(const Snapshot& snapshot) {
+                m_begin = snapshot.begin;
+                m_cur = snapshot.cur;
+                m_end = snapshot.end;
+                m_line = snapshot.line;
+                m_column = snapshot.column;
+                m_escaped = snapshot.escaped;
+            }
         };
 
         template <typename TokenType>
@@ -82,16 +189,18 @@ namespace TrenchBroom {
 
             class SaveState {
             private:
-                StatePtr m_state;
-                TokenizerState m_snapshot;
+                TokenizerState& m_state;
+                TokenizerState::Snapshot m_snapshot;
             public:
-                explicit SaveState(StatePtr state) :
+                explicit SaveState(TokenizerState& state) :
                 m_state(state),
-                m_snapshot(m_state->snapshot()) {}
+                m_snapshot(m_state.snapshot()) {}
 
                 ~SaveState() {
-                    m_state->restore(m_snapshot);
+                    m_state.restore(m_snapshot);
                 }
+
+                deleteCopyAndMove(SaveState)
             };
 
             StatePtr m_state;
@@ -127,7 +236,7 @@ namespace TrenchBroom {
             }
 
             Token peekToken(const TokenType skipTokens = 0u) {
-                SaveState oldState(m_state);
+                SaveState oldState(*m_state);
                 return nextToken(skipTokens);
             }
 
@@ -158,7 +267,8 @@ namespace TrenchBroom {
                 return std::string(startPos, static_cast<size_t>(endPos - startPos));
             }
 
-            std::string readAnyString(const std::string& delims) {
+            template <typename Delims>
+            std::string readAnyString(const Delims& delims) {
                 while (isWhitespace(curChar())) {
                     advance();
                 }
@@ -200,7 +310,7 @@ namespace TrenchBroom {
                 return m_state->length();
             }
         public:
-            TokenizerState snapshot() const {
+            TokenizerState::Snapshot snapshot() const {
                 return m_state->snapshot();
             }
 
@@ -208,7 +318,7 @@ namespace TrenchBroom {
                 m_state.reset(m_state->clone(begin, end));
             }
 
-            void restore(const TokenizerState& snapshot) {
+            void restore(const TokenizerState::Snapshot& snapshot) {
                 m_state->restore(snapshot);
             }
         protected:
@@ -225,7 +335,7 @@ namespace TrenchBroom {
                     return 0;
                 }
 
-                return *curPos();
+                return m_state->curChar();
             }
 
             char lookAhead(const size_t offset = 1) const {
@@ -249,19 +359,20 @@ namespace TrenchBroom {
             }
 
             bool isWhitespace(const char c) const {
-                return isAnyOf(c, Whitespace());
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
             }
 
             bool isEscaped() const {
                 return m_state->escaped();
             }
 
-            const char* readInteger(const std::string& delims) {
+            template <typename Delims>
+            const char* readInteger(const Delims& delims) {
                 if (curChar() != '+' && curChar() != '-' && !isDigit(curChar())) {
                     return nullptr;
                 }
 
-                const auto previousState = *m_state;
+                const auto previousState = m_state->snapshot();
                 if (curChar() == '+' || curChar() == '-') {
                     advance();
                 }
@@ -272,16 +383,17 @@ namespace TrenchBroom {
                     return curPos();
                 }
 
-                *m_state = previousState;
+                m_state->restore(previousState);
                 return nullptr;
             }
 
-            const char* readDecimal(const std::string& delims) {
+            template <typename Delims>
+            const char* readDecimal(const Delims& delims) {
                 if (curChar() != '+' && curChar() != '-' && curChar() != '.' && !isDigit(curChar())) {
                     return nullptr;
                 }
 
-                const auto previousState = *m_state;
+                const auto previousState = m_state->snapshot();
                 if (curChar() != '.') {
                     advance();
                     readDigits();
@@ -304,7 +416,7 @@ namespace TrenchBroom {
                     return curPos();
                 }
 
-                *m_state = previousState;
+                m_state->restore(previousState);
                 return nullptr;
             }
 
@@ -315,7 +427,8 @@ namespace TrenchBroom {
                 }
             }
         protected:
-            const char* readUntil(const std::string& delims) {
+            template <typename Delims>
+            const char* readUntil(const Delims& delims) {
                 if (!eof()) {
                     do {
                         advance();
@@ -324,7 +437,8 @@ namespace TrenchBroom {
                 return curPos();
             }
 
-            const char* readWhile(const std::string& allow) {
+            template <typename Delims>
+            const char* readWhile(const Delims& allow) {
                 while (!eof() && isAnyOf(curChar(), allow)) {
                     advance();
                 }
@@ -346,14 +460,16 @@ namespace TrenchBroom {
                 return end;
             }
 
-            const char* discardWhile(const std::string& allow) {
+            template <typename Delims>
+            const char* discardWhile(const Delims& allow) {
                 while (!eof() && isAnyOf(curChar(), allow)) {
                     advance();
                 }
                 return curPos();
             }
 
-            const char* discardUntil(const std::string& delims) {
+            template <typename Delims>
+            const char* discardUntil(const Delims& delims) {
                 while (!eof() && !isAnyOf(curChar(), delims)) {
                     advance();
                 }
@@ -414,6 +530,19 @@ namespace TrenchBroom {
                 return false;
             }
 
+            bool isAnyOf(const char c, const char* allow) const {
+                for (; *allow != 0; ++allow) {
+                    if (c == *allow) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool isAnyOf(const char c, const CharSet& allow) const {
+                return allow.contains(c);
+            }
+
             virtual Token emitToken() = 0;
         };
     }
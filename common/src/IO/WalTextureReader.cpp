@@ -59,9 +59,9 @@ namespace TrenchBroom {
 
         Assets::Texture* WalTextureReader::readQ2Wal(Reader& reader, const Path& path) const {
             static const size_t MaxMipLevels = 4;
-            static Color averageColor;
-            static Assets::TextureBufferList buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBufferList buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const std::string name = reader.readString(WalLayout::TextureNameLength);
             const size_t width = reader.readSize<uint32_t>();
@@ -83,9 +83,9 @@ namespace TrenchBroom {
 
         Assets::Texture* WalTextureReader::readDkWal(Reader& reader, const Path& path) const {
             static const size_t MaxMipLevels = 9;
-            static Color averageColor;
-            static Assets::TextureBufferList buffers(MaxMipLevels);
-            static size_t offsets[MaxMipLevels];
+            Color averageColor;
+            Assets::TextureBufferList buffers(MaxMipLevels);
+            size_t offsets[MaxMipLevels];
 
             const char version = reader.readChar<char>();
             ensure(version == 3, "Unknown WAL texture version");
@@ -128,7 +128,7 @@ namespace TrenchBroom {
         }
 
         bool WalTextureReader::readMips(const Assets::Palette& palette, const size_t mipLevels, const size_t offsets[], const size_t width, const size_t height, Reader& reader, Assets::TextureBufferList& buffers, Color& averageColor, const Assets::PaletteTransparency transparency) {
-            static Color tempColor;
+            Color tempColor;
 
             auto hasTransparency = false;
             for (size_t i = 0; i < mipLevels; ++i) {
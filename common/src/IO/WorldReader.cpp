@@ -32,10 +32,14 @@
 namespace TrenchBroom {
     namespace IO {
         WorldReader::WorldReader(const char* begin, const char* end) :
-        MapReader(begin, end) {}
+        MapReader(begin, end) {
+            setThreadCount(0u);
+        }
 
         WorldReader::WorldReader(const std::string& str) :
-        MapReader(str) {}
+        MapReader(str) {
+            setThreadCount(0u);
+        }
 
         std::unique_ptr<Model::World> WorldReader::read(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             readEntities(format, worldBounds, status);
@@ -23,6 +23,7 @@
 #include "IO/DiskFileSystem.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace TrenchBroom {
@@ -34,6 +35,9 @@ namespace TrenchBroom {
         m_fileIndex(fileIndex) {}
 
         std::shared_ptr<File> ZipFileSystem::ZipCompressedFile::doOpen() const {
+            std::lock_guard<std::mutex> lock(m_owner->m_archiveMutex);
+            m_owner->m_file->ensureUnmodified();
+
             const auto path = Path(m_owner->filename(m_fileIndex));
 
             mz_zip_archive_file_stat stat;
@@ -69,8 +73,8 @@ namespace TrenchBroom {
         void ZipFileSystem::doReadDirectory() {
             mz_zip_zero_struct(&m_archive);
 
-            if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-                throw FileSystemException("Error calling mz_zip_reader_init_cfile");
+            if (mz_zip_reader_init_mem(&m_archive, m_file->begin(), m_file->size(), 0) != MZ_TRUE) {
+                throw FileSystemException("Error calling mz_zip_reader_init_mem");
             }
 
             const mz_uint numFiles = mz_zip_reader_get_num_files(&m_archive);
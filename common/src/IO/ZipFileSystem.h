@@ -23,6 +23,7 @@
 #include "IO/ImageFileSystem.h"
 
 #include <memory>
+#include <mutex>
 
 #include <miniz/miniz.h>
 
@@ -33,6 +34,10 @@ namespace TrenchBroom {
         class ZipFileSystem : public ImageFileSystem {
         private:
             mz_zip_archive m_archive;
+            /**
+             * Guards the archive, since compressed files may be opened on several threads at once.
+             */
+            std::mutex m_archiveMutex;
         private:
             class ZipCompressedFile : public FileEntry {
             private:
@@ -263,7 +263,7 @@ namespace TrenchBroom {
         }
 
         AttributableNode::NotifyAttributeChange::NotifyAttributeChange(AttributableNode* node) :
-        m_nodeChange(node),
+        m_nodeChange(node, IssueDependency::Attributes),
         m_node(node),
         m_oldPhysicalBounds(node->physicalBounds()) {
             ensure(m_node != nullptr, "node is null");
@@ -531,7 +531,7 @@ namespace TrenchBroom {
                 target->addLinkSource(this);
                 m_linkTargets.push_back(target);
             }
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::addKillTargets(const std::vector<AttributableNode*>& targets) {
@@ -540,7 +540,7 @@ namespace TrenchBroom {
                 target->addKillSource(this);
                 m_killTargets.push_back(target);
             }
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::addLinkSources(const std::vector<AttributableNode*>& sources) {
@@ -549,7 +549,7 @@ namespace TrenchBroom {
                 linkSource->addLinkTarget(this);
                 m_linkSources.push_back(linkSource);
             }
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::addKillSources(const std::vector<AttributableNode*>& sources) {
@@ -558,35 +558,35 @@ namespace TrenchBroom {
                 killSource->addKillTarget(this);
                 m_killSources.push_back(killSource);
             }
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeAllLinkSources() {
             for (AttributableNode* linkSource : m_linkSources)
                 linkSource->removeLinkTarget(this);
             m_linkSources.clear();
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeAllLinkTargets() {
             for (AttributableNode* linkTarget : m_linkTargets)
                 linkTarget->removeLinkSource(this);
             m_linkTargets.clear();
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeAllKillSources() {
             for (AttributableNode* killSource : m_killSources)
                 killSource->removeKillTarget(this);
             m_killSources.clear();
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeAllKillTargets() {
             for (AttributableNode* killTarget : m_killTargets)
                 killTarget->removeKillSource(this);
             m_killTargets.clear();
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeAllLinks() {
@@ -620,43 +620,43 @@ namespace TrenchBroom {
         void AttributableNode::addLinkSource(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             m_linkSources.push_back(attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::addLinkTarget(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             m_linkTargets.push_back(attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::addKillSource(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             m_killSources.push_back(attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::addKillTarget(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             m_killTargets.push_back(attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeLinkSource(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             kdl::vec_erase(m_linkSources, attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeLinkTarget(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             kdl::vec_erase(m_linkTargets, attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         void AttributableNode::removeKillSource(AttributableNode* attributable) {
             ensure(attributable != nullptr, "attributable is null");
             kdl::vec_erase(m_killSources, attributable);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Links);
         }
 
         AttributableNode::AttributableNode() :
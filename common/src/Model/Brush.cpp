@@ -19,6 +19,7 @@
 
 #include "Brush.h"
 
+#include "AABBTree.h"
 #include "Exceptions.h"
 #include "FloatType.h"
 #include "Polyhedron.h"
@@ -122,18 +123,17 @@ namespace TrenchBroom {
             bool m_brushEmpty;
             bool m_brushValid;
         public:
-            AddFacesToGeometry(BrushGeometry& geometry, std::vector<BrushFace*> facesToAdd) :
+            AddFacesToGeometry(BrushGeometry& geometry, const vm::bbox3& bounds, std::vector<BrushFace*> facesToAdd) :
             m_geometry(geometry),
             m_brushEmpty(false),
             m_brushValid(true) {
+                assert(m_geometry.empty());
+
                 // sort the faces by the weight of their plane normals like QBSP does
                 Model::BrushFace::sortFaces(facesToAdd);
 
-                for (auto it = std::begin(facesToAdd), end = std::end(facesToAdd); it != end && !m_brushEmpty; ++it) {
-                    auto* brushFace = *it;
-                    AddFaceToGeometryCallback addCallback(brushFace);
-                    const auto result = m_geometry.clip(brushFace->boundary(), addCallback);
-                    m_brushEmpty = result.empty();
+                if (!intersectFaces(bounds, facesToAdd)) {
+                    clipFaces(bounds, facesToAdd);
                 }
                 if (!m_brushEmpty && m_brushValid) {
                     m_geometry.correctVertexPositions();
@@ -150,6 +150,44 @@ namespace TrenchBroom {
             bool brushValid() const {
                 return m_brushValid;
             }
+        private:
+            /**
+             * Builds the geometry directly from the intersections of the face planes. Returns false if that fails, in
+             * which case the geometry is left empty.
+             */
+            bool intersectFaces(const vm::bbox3& bounds, const std::vector<BrushFace*>& faces) {
+                std::vector<vm::plane3> planes;
+                planes.reserve(faces.size());
+                for (const auto* brushFace : faces) {
+                    planes.push_back(brushFace->boundary());
+                }
+
+                const auto geometries = m_geometry.intersectPlanes(planes, bounds);
+                if (geometries.empty()) {
+                    return false;
+                }
+
+                for (size_t i = 0u; i < faces.size(); ++i) {
+                    if (geometries[i] != nullptr) {
+                        faces[i]->setGeometry(geometries[i]);
+                    }
+                }
+                return true;
+            }
+
+            /**
+             * Builds the geometry by clipping the given bounds with each face plane.
+             */
+            void clipFaces(const vm::bbox3& bounds, const std::vector<BrushFace*>& faces) {
+                m_geometry = BrushGeometry(bounds);
+
+                for (auto it = std::begin(faces), end = std::end(faces); it != end && !m_brushEmpty; ++it) {
+                    auto* brushFace = *it;
+                    AddFaceToGeometryCallback addCallback(brushFace);
+                    const auto result = m_geometry.clip(brushFace->boundary(), addCallback);
+                    m_brushEmpty = result.empty();
+                }
+            }
         };
 
         class Brush::MoveVerticesCallback : public BrushGeometry::Callback {
@@ -297,11 +335,16 @@ namespace TrenchBroom {
         m_geometry(nullptr),
         m_transparent(false),
         m_brushRendererBrushCache(std::make_unique<Renderer::BrushRendererBrushCache>()) {
-            addFaces(faces);
             try {
+                addFaces(faces);
                 buildGeometry(worldBounds);
-            } catch (const GeometryException&) {
-                cleanup();
+            } catch (...) {
+                // this brush owns the given faces even if it cannot be created, and they may not all have been added
+                deleteGeometry();
+                m_faces.clear();
+                for (auto* face : faces) {
+                    delete face;
+                }
                 throw;
             }
         }
@@ -401,7 +444,7 @@ namespace TrenchBroom {
         }
 
         void Brush::setFaces(const vm::bbox3& worldBounds, const std::vector<BrushFace*>& faces) {
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
 
             const vm::bbox3 oldBounds = physicalBounds();
             deleteGeometry();
@@ -431,7 +474,7 @@ namespace TrenchBroom {
         }
 
         void Brush::faceDidChange() {
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Geometry);
         }
 
         void Brush::addFaces(const std::vector<BrushFace*>& faces) {
@@ -524,7 +567,7 @@ namespace TrenchBroom {
         }
 
         bool Brush::clip(const vm::bbox3& worldBounds, BrushFace* face) {
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
             try {
                 addFace(face);
                 rebuildGeometry(worldBounds);
@@ -562,7 +605,7 @@ namespace TrenchBroom {
         void Brush::moveBoundary(const vm::bbox3& worldBounds, BrushFace* face, const vm::vec3& delta, const bool lockTexture) {
             assert(canMoveBoundary(worldBounds, face, delta));
 
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
             face->transform(vm::translation_matrix(delta), lockTexture);
             rebuildGeometry(worldBounds);
         }
@@ -576,7 +619,7 @@ namespace TrenchBroom {
         }
 
         bool Brush::expand(const vm::bbox3& worldBounds, const FloatType delta, const bool lockTexture) {
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
 
             // move the faces
             for (BrushFace* face : m_faces) {
@@ -1157,34 +1200,82 @@ namespace TrenchBroom {
                 }
             });
 
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
             kdl::vec_clear_and_delete(m_faces);
             updateFacesFromGeometry(worldBounds, newGeometry);
             rebuildGeometry(worldBounds);
         }
 
         std::vector<Brush*> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<Brush*>& subtrahends) const {
-            auto result = std::vector<BrushGeometry>{*m_geometry};
+            return createBrushes(factory, worldBounds, defaultTextureName, subtractGeometry(subtrahends), subtrahends);
+        }
+
+        std::vector<Brush*> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, Brush* subtrahend) const {
+            return subtract(factory, worldBounds, defaultTextureName, std::vector<Brush*>{subtrahend});
+        }
+
+        std::vector<BrushGeometry> Brush::subtractGeometry(const std::vector<Brush*>& subtrahends) const {
+            // A fragment whose bounds are disjoint from a subtrahend's bounds is passed through unchanged, which is
+            // what Polyhedron::subtract would return for it anyway. The bounds are expanded slightly so that
+            // subtrahends which merely touch a fragment are still subtracted.
+            const auto epsilon = vm::constants<FloatType>::almost_zero();
+            const auto minuendBounds = m_geometry->bounds().expand(epsilon);
+
+            std::vector<vm::bbox3> subtrahendBounds;
+            subtrahendBounds.reserve(subtrahends.size());
+
+            std::vector<size_t> candidates;
+            for (size_t i = 0; i < subtrahends.size(); ++i) {
+                subtrahendBounds.push_back(subtrahends[i]->m_geometry->bounds().expand(epsilon));
+                if (minuendBounds.intersects(subtrahendBounds.back())) {
+                    candidates.push_back(i);
+                }
+            }
 
-            for (auto* subtrahend : subtrahends) {
-                auto nextResults = std::vector<BrushGeometry>();
+            // the subtrahends that intersect a fragment are looked up in a tree instead of testing all of them
+            AABBTree<FloatType, 3, size_t> subtrahendTree;
+            subtrahendTree.build(candidates, [&](const size_t i) { return subtrahendBounds[i]; });
 
-                for (const BrushGeometry& fragment : result) {
-                    auto subFragments = fragment.subtract(*subtrahend->m_geometry);
+            // Every fragment is subtracted by the intersecting subtrahends in order, and its sub fragments by the
+            // subtrahends that follow. The fragments are processed depth first, so the result is in the same order as
+            // if all fragments were subtracted by one subtrahend after another.
+            std::vector<BrushGeometry> result;
+            std::vector<std::pair<BrushGeometry, size_t>> stack;
+            stack.emplace_back(*m_geometry, 0u);
 
-                    nextResults.reserve(nextResults.size() + subFragments.size());
-                    for (auto& subFragment : subFragments) {
-                        nextResults.push_back(std::move(subFragment));
+            std::vector<size_t> intersectors;
+            while (!stack.empty()) {
+                auto [fragment, first] = std::move(stack.back());
+                stack.pop_back();
+
+                intersectors.clear();
+                subtrahendTree.findIntersectors(fragment.bounds(), std::back_inserter(intersectors));
+
+                auto next = subtrahends.size();
+                for (const auto i : intersectors) {
+                    if (i >= first && i < next) {
+                        next = i;
                     }
                 }
 
-                result = std::move(nextResults);
+                if (next == subtrahends.size()) {
+                    result.push_back(std::move(fragment));
+                } else {
+                    auto subFragments = fragment.subtract(*subtrahends[next]->m_geometry);
+                    for (auto it = subFragments.rbegin(); it != subFragments.rend(); ++it) {
+                        stack.emplace_back(std::move(*it), next + 1u);
+                    }
+                }
             }
 
+            return result;
+        }
+
+        std::vector<Brush*> Brush::createBrushes(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<BrushGeometry>& fragments, const std::vector<Brush*>& subtrahends) const {
             std::vector<Brush*> brushes;
-            brushes.reserve(result.size());
+            brushes.reserve(fragments.size());
 
-            for (const auto& geometry : result) {
+            for (const auto& geometry : fragments) {
                 try {
                     auto* brush = createBrush(factory, worldBounds, defaultTextureName, geometry, subtrahends);
                     brushes.push_back(brush);
@@ -1194,10 +1285,6 @@ namespace TrenchBroom {
             return brushes;
         }
 
-        std::vector<Brush*> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, Brush* subtrahend) const {
-            return subtract(factory, worldBounds, defaultTextureName, std::vector<Brush*>{subtrahend});
-        }
-
         void Brush::intersect(const vm::bbox3& worldBounds, const Brush* brush) {
             for (const auto* face : brush->faces()) {
                 addFace(face->clone());
@@ -1283,9 +1370,9 @@ namespace TrenchBroom {
         void Brush::buildGeometry(const vm::bbox3& worldBounds) {
             assert(m_geometry == nullptr);
 
-            m_geometry = new BrushGeometry(worldBounds.expand(1.0));
+            m_geometry = new BrushGeometry();
 
-            AddFacesToGeometry addFacesToGeometry(*m_geometry, m_faces);
+            AddFacesToGeometry addFacesToGeometry(*m_geometry, worldBounds.expand(1.0), m_faces);
             updateFacesFromGeometry(worldBounds, *m_geometry);
 
             if (addFacesToGeometry.brushEmpty()) {
@@ -1331,7 +1418,7 @@ namespace TrenchBroom {
         }
 
         void Brush::findIntegerPlanePoints(const vm::bbox3& worldBounds) {
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
 
             for (auto* face : m_faces) {
                 face->findIntegerPlanePoints();
@@ -1450,7 +1537,7 @@ namespace TrenchBroom {
         }
 
         void Brush::doTransform(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds) {
-            const NotifyNodeChange nodeChange(this);
+            const NotifyNodeChange nodeChange(this, IssueDependency::Geometry);
 
             for (auto* face : m_faces) {
                 face->transform(transformation, lockTextures);
@@ -226,6 +226,8 @@ namespace TrenchBroom {
             /**
              * Subtracts the given subtrahends from `this`, returning the result but without modifying `this`.
              *
+             * Subtrahends and intermediate fragments whose bounds do not intersect are skipped.
+             *
              * @param subtrahends brushes to subtract from `this`. The passed-in brushes are not modified.
              * @return the subtraction result
              */
@@ -233,6 +235,31 @@ namespace TrenchBroom {
             std::vector<Brush*> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, Brush* subtrahend) const;
             void intersect(const vm::bbox3& worldBounds, const Brush* brush);
 
+            /**
+             * Subtracts the geometries of the given subtrahends from the geometry of `this` and returns the resulting
+             * fragments. Unlike `subtract`, this only reads the geometries and creates no faces, so it can be called
+             * for several minuends concurrently. Turn the fragments into brushes by calling `createBrushes` on the
+             * calling thread afterwards, because copying the face attributes updates the usage counts of the shared
+             * textures.
+             *
+             * @param subtrahends brushes to subtract from `this`. The passed-in brushes are not modified.
+             * @return the geometries of the fragments
+             */
+            std::vector<BrushGeometry> subtractGeometry(const std::vector<Brush*>& subtrahends) const;
+
+            /**
+             * Creates a brush for each of the given fragments, which must have been returned by `subtractGeometry`
+             * for the same subtrahends. Fragments that don't yield a valid brush are skipped.
+             *
+             * @param factory the model factory
+             * @param worldBounds the world bounds
+             * @param defaultTextureName default texture name
+             * @param fragments the geometries of the fragments
+             * @param subtrahends used as a source of texture alignment only
+             * @return the newly created brushes
+             */
+            std::vector<Brush*> createBrushes(const ModelFactory& factory, const vm::bbox3& worldBounds, const std::string& defaultTextureName, const std::vector<BrushGeometry>& fragments, const std::vector<Brush*>& subtrahends) const;
+
             // transformation
             bool canTransform(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const;
         private:
@@ -57,19 +57,45 @@ namespace TrenchBroom {
             return halfEdge->edge();
         }
 
+        BrushFace::Data::Data(std::unique_ptr<TexCoordSystem> i_texCoordSystem) :
+        texCoordSystem(std::move(i_texCoordSystem)) {
+            ensure(texCoordSystem != nullptr, "texCoordSystem is null");
+        }
+
+        BrushFace::Data::Data(const Data& other) :
+        boundary(other.boundary),
+        texCoordSystem(other.texCoordSystem->clone()) {
+            for (size_t i = 0; i < 3; ++i) {
+                points[i] = other.points[i];
+            }
+        }
+
+        BrushFace::Data::~Data() = default;
+
         BrushFace::BrushFace(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, std::unique_ptr<TexCoordSystem> texCoordSystem) :
         m_brush(nullptr),
+        m_data(std::make_shared<Data>(std::move(texCoordSystem))),
         m_lineNumber(0),
         m_lineCount(0),
         m_selected(false),
-        m_texCoordSystem(std::move(texCoordSystem)),
         m_geometry(nullptr),
         m_markedToRenderFace(false),
         m_attribs(attribs) {
-            ensure(m_texCoordSystem != nullptr, "texCoordSystem is null");
             setPoints(point0, point1, point2);
         }
 
+        BrushFace::BrushFace(std::shared_ptr<const Data> data, const BrushFaceAttributes& attribs) :
+        m_brush(nullptr),
+        m_data(std::move(data)),
+        m_lineNumber(0),
+        m_lineCount(0),
+        m_selected(false),
+        m_geometry(nullptr),
+        m_markedToRenderFace(false),
+        m_attribs(attribs) {
+            ensure(m_data != nullptr, "data is null");
+        }
+
         BrushFace* BrushFace::createParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName) {
             const BrushFaceAttributes attribs(textureName);
             return new BrushFace(point0, point1, point2, attribs, std::make_unique<ParaxialTexCoordSystem>(point0, point1, point2, attribs));
@@ -102,54 +128,56 @@ namespace TrenchBroom {
         }
 
         BrushFace::~BrushFace() {
-            for (size_t i = 0; i < 3; ++i) {
-                m_points[i] = vm::vec3::zero();
-            }
             m_brush = nullptr;
+            m_data = nullptr;
             m_lineNumber = 0;
             m_lineCount = 0;
             m_selected = false;
-            m_texCoordSystem = nullptr;
             m_geometry = nullptr;
         }
 
         BrushFace* BrushFace::clone() const {
-            BrushFace* result = new BrushFace(points()[0], points()[1], points()[2], textureName(), m_texCoordSystem->clone());
-            result->m_attribs = m_attribs;
+            BrushFace* result = new BrushFace(m_data, m_attribs);
             result->setFilePosition(m_lineNumber, m_lineCount);
             if (m_selected)
                 result->select();
             return result;
         }
 
+        std::shared_ptr<const BrushFace::Data> BrushFace::data() const {
+            return m_data;
+        }
+
         BrushFaceSnapshot* BrushFace::takeSnapshot() {
-            return new BrushFaceSnapshot(this, *m_texCoordSystem);
+            return new BrushFaceSnapshot(this, *m_data->texCoordSystem);
         }
 
         std::unique_ptr<TexCoordSystemSnapshot> BrushFace::takeTexCoordSystemSnapshot() const {
-            return m_texCoordSystem->takeSnapshot();
+            return m_data->texCoordSystem->takeSnapshot();
         }
 
         void BrushFace::restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot) {
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(*mutableData().texCoordSystem);
             invalidateVertexCache();
         }
 
         void BrushFace::copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, const WrapStyle wrapStyle) {
+            auto& data = mutableData();
+
             // Get a line, and a reference point, that are on both the source face's plane and our plane
-            const auto seam = vm::intersect_plane_plane(sourceFacePlane, m_boundary);
+            const auto seam = vm::intersect_plane_plane(sourceFacePlane, data.boundary);
             const auto refPoint = vm::project_point(seam, center());
 
-            coordSystemSnapshot.restore(*m_texCoordSystem);
+            coordSystemSnapshot.restore(*data.texCoordSystem);
 
             // Get the texcoords at the refPoint using the source face's attribs and tex coord system
-            const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, attribs) * attribs.textureSize();
+            const auto desriedCoords = data.texCoordSystem->getTexCoords(refPoint, attribs) * attribs.textureSize();
 
-            m_texCoordSystem->updateNormal(sourceFacePlane.normal, m_boundary.normal, m_attribs, wrapStyle);
+            data.texCoordSystem->updateNormal(sourceFacePlane.normal, data.boundary.normal, m_attribs, wrapStyle);
 
             // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
             if (!vm::is_zero(seam.direction, vm::C::almost_zero())) {
-                const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
+                const auto currentCoords = data.texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
                 const auto offsetChange = desriedCoords - currentCoords;
                 m_attribs.setOffset(correct(m_attribs.modOffset(m_attribs.offset() + offsetChange), 4));
             }
@@ -167,18 +195,18 @@ namespace TrenchBroom {
         }
 
         const BrushFace::Points& BrushFace::points() const {
-            return m_points;
+            return m_data->points;
         }
 
         bool BrushFace::arePointsOnPlane(const vm::plane3& plane) const {
             for (size_t i = 0; i < 3; i++)
-                if (plane.point_status(m_points[i]) != vm::plane_status::inside)
+                if (plane.point_status(m_data->points[i]) != vm::plane_status::inside)
                     return false;
             return true;
         }
 
         const vm::plane3& BrushFace::boundary() const {
-            return m_boundary;
+            return m_data->boundary;
         }
 
         const vm::vec3& BrushFace::normal() const {
@@ -194,7 +222,8 @@ namespace TrenchBroom {
         vm::vec3 BrushFace::boundsCenter() const {
             ensure(m_geometry != nullptr, "geometry is null");
 
-            const auto toPlane = vm::plane_projection_matrix(m_boundary.distance, m_boundary.normal);
+            const auto& boundary = m_data->boundary;
+            const auto toPlane = vm::plane_projection_matrix(boundary.distance, boundary.normal);
             const auto [invertible, fromPlane] = vm::invert(toPlane);
             assert(invertible); unused(invertible);
 
@@ -245,14 +274,15 @@ namespace TrenchBroom {
         void BrushFace::setAttribs(const BrushFaceAttributes& attribs) {
             const float oldRotation = m_attribs.rotation();
             m_attribs = attribs;
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attribs.rotation());
+
+            auto& data = mutableData();
+            data.texCoordSystem->setRotation(data.boundary.normal, oldRotation, m_attribs.rotation());
             updateBrush();
         }
 
         void BrushFace::resetTexCoordSystemCache() {
-            if (m_texCoordSystem != nullptr) {
-                m_texCoordSystem->resetCache(m_points[0], m_points[1], m_points[2], m_attribs);
-            }
+            auto& data = mutableData();
+            data.texCoordSystem->resetCache(data.points[0], data.points[1], data.points[2], m_attribs);
         }
 
         const std::string& BrushFace::textureName() const {
@@ -404,7 +434,9 @@ namespace TrenchBroom {
 
             const auto oldRotation = m_attribs.rotation();
             m_attribs.setRotation(rotation);
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, rotation);
+
+            auto& data = mutableData();
+            data.texCoordSystem->setRotation(data.boundary.normal, oldRotation, rotation);
             updateBrush();
             return true;
         }
@@ -454,60 +486,67 @@ namespace TrenchBroom {
         }
 
         vm::vec3 BrushFace::textureXAxis() const {
-            return m_texCoordSystem->xAxis();
+            return m_data->texCoordSystem->xAxis();
         }
 
         vm::vec3 BrushFace::textureYAxis() const {
-            return m_texCoordSystem->yAxis();
+            return m_data->texCoordSystem->yAxis();
         }
 
         void BrushFace::resetTextureAxes() {
-            m_texCoordSystem->resetTextureAxes(m_boundary.normal);
+            auto& data = mutableData();
+            data.texCoordSystem->resetTextureAxes(data.boundary.normal);
             invalidateVertexCache();
         }
 
         void BrushFace::moveTexture(const vm::vec3& up, const vm::vec3& right, const vm::vec2f& offset) {
-            m_texCoordSystem->moveTexture(m_boundary.normal, up, right, offset, m_attribs);
+            auto& data = mutableData();
+            data.texCoordSystem->moveTexture(data.boundary.normal, up, right, offset, m_attribs);
             invalidateVertexCache();
         }
 
         void BrushFace::rotateTexture(const float angle) {
             const float oldRotation = m_attribs.rotation();
-            m_texCoordSystem->rotateTexture(m_boundary.normal, angle, m_attribs);
-            m_texCoordSystem->setRotation(m_boundary.normal, oldRotation, m_attribs.rotation());
+
+            auto& data = mutableData();
+            data.texCoordSystem->rotateTexture(data.boundary.normal, angle, m_attribs);
+            data.texCoordSystem->setRotation(data.boundary.normal, oldRotation, m_attribs.rotation());
             invalidateVertexCache();
         }
 
         void BrushFace::shearTexture(const vm::vec2f& factors) {
-            m_texCoordSystem->shearTexture(m_boundary.normal, factors);
+            auto& data = mutableData();
+            data.texCoordSystem->shearTexture(data.boundary.normal, factors);
             invalidateVertexCache();
         }
 
         void BrushFace::transform(const vm::mat4x4& transform, const bool lockTexture) {
             using std::swap;
 
-            const vm::vec3 invariant = m_geometry != nullptr ? center() : m_boundary.anchor();
-            const vm::plane3 oldBoundary = m_boundary;
+            auto& data = mutableData();
+            const vm::vec3 invariant = m_geometry != nullptr ? center() : data.boundary.anchor();
+            const vm::plane3 oldBoundary = data.boundary;
 
-            m_boundary = m_boundary.transform(transform);
+            data.boundary = data.boundary.transform(transform);
             for (size_t i = 0; i < 3; ++i) {
-                m_points[i] = transform * m_points[i];
+                data.points[i] = transform * data.points[i];
             }
 
-            if (dot(cross(m_points[2] - m_points[0], m_points[1] - m_points[0]), m_boundary.normal) < 0.0) {
-                swap(m_points[1], m_points[2]);
+            if (dot(cross(data.points[2] - data.points[0], data.points[1] - data.points[0]), data.boundary.normal) < 0.0) {
+                swap(data.points[1], data.points[2]);
             }
 
-            setPoints(m_points[0], m_points[1], m_points[2]);
+            setPoints(data.points[0], data.points[1], data.points[2]);
 
-            m_texCoordSystem->transform(oldBoundary, m_boundary, transform, m_attribs, lockTexture, invariant);
+            data.texCoordSystem->transform(oldBoundary, data.boundary, transform, m_attribs, lockTexture, invariant);
         }
 
         void BrushFace::invert() {
             using std::swap;
 
-            m_boundary = m_boundary.flip();
-            swap(m_points[1], m_points[2]);
+            auto& data = mutableData();
+            data.boundary = data.boundary.flip();
+            swap(data.points[1], data.points[2]);
             invalidateVertexCache();
         }
 
@@ -515,66 +554,72 @@ namespace TrenchBroom {
             ensure(m_geometry != nullptr, "geometry is null");
 
             const auto* first = m_geometry->boundary().front();
-            const auto oldPlane = m_boundary;
+            const auto oldPlane = m_data->boundary;
             setPoints(first->next()->origin()->position(),
                       first->origin()->position(),
                       first->previous()->origin()->position());
 
+            // setPoints has made the data unique to this face
+            auto& data = mutableData();
+
             // Get a line, and a reference point, that are on both the old plane
             // (before moving the face) and after moving the face.
-            const auto seam = vm::intersect_plane_plane(oldPlane, m_boundary);
+            const auto seam = vm::intersect_plane_plane(oldPlane, data.boundary);
             if (!vm::is_zero(seam.direction, vm::C::almost_zero())) {
                 const auto refPoint = project_point(seam, center());
 
                 // Get the texcoords at the refPoint using the old face's attribs and tex coord system
-                const auto desriedCoords = m_texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
+                const auto desriedCoords = data.texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
 
-                m_texCoordSystem->updateNormal(oldPlane.normal, m_boundary.normal, m_attribs, WrapStyle::Projection);
+                data.texCoordSystem->updateNormal(oldPlane.normal, data.boundary.normal, m_attribs, WrapStyle::Projection);
 
                 // Adjust the offset on this face so that the texture coordinates at the refPoint stay the same
-                const auto currentCoords = m_texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
+                const auto currentCoords = data.texCoordSystem->getTexCoords(refPoint, m_attribs) * m_attribs.textureSize();
                 const auto offsetChange = desriedCoords - currentCoords;
                 m_attribs.setOffset(correct(m_attribs.modOffset(m_attribs.offset() + offsetChange), 4));
             }
         }
 
         void BrushFace::snapPlanePointsToInteger() {
+            auto& data = mutableData();
             for (size_t i = 0; i < 3; ++i) {
-                m_points[i] = round(m_points[i]);
+                data.points[i] = round(data.points[i]);
             }
-            setPoints(m_points[0], m_points[1], m_points[2]);
+            setPoints(data.points[0], data.points[1], data.points[2]);
         }
 
         void BrushFace::findIntegerPlanePoints() {
-            PlanePointFinder::findPoints(m_boundary, m_points, 3);
-            setPoints(m_points[0], m_points[1], m_points[2]);
+            auto& data = mutableData();
+            PlanePointFinder::findPoints(data.boundary, data.points, 3);
+            setPoints(data.points[0], data.points[1], data.points[2]);
         }
 
         vm::mat4x4 BrushFace::projectToBoundaryMatrix() const {
-            const auto texZAxis = m_texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
-            const auto worldToPlaneMatrix = vm::plane_projection_matrix(m_boundary.distance, m_boundary.normal, texZAxis);
+            const auto& boundary = m_data->boundary;
+            const auto texZAxis = m_data->texCoordSystem->fromMatrix(vm::vec2f::zero(), vm::vec2f::one()) * vm::vec3::pos_z();
+            const auto worldToPlaneMatrix = vm::plane_projection_matrix(boundary.distance, boundary.normal, texZAxis);
             const auto [invertible, planeToWorldMatrix] = vm::invert(worldToPlaneMatrix); assert(invertible); unused(invertible);
             return planeToWorldMatrix * vm::mat4x4::zero_out<2>() * worldToPlaneMatrix;
         }
 
         vm::mat4x4 BrushFace::toTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, const bool project) const {
             if (project) {
-                return vm::mat4x4::zero_out<2>() * m_texCoordSystem->toMatrix(offset, scale);
+                return vm::mat4x4::zero_out<2>() * m_data->texCoordSystem->toMatrix(offset, scale);
             } else {
-                return m_texCoordSystem->toMatrix(offset, scale);
+                return m_data->texCoordSystem->toMatrix(offset, scale);
             }
         }
 
         vm::mat4x4 BrushFace::fromTexCoordSystemMatrix(const vm::vec2f& offset, const vm::vec2f& scale, const bool project) const {
             if (project) {
-                return projectToBoundaryMatrix() * m_texCoordSystem->fromMatrix(offset, scale);
+                return projectToBoundaryMatrix() * m_data->texCoordSystem->fromMatrix(offset, scale);
             } else {
-                return m_texCoordSystem->fromMatrix(offset, scale);
+                return m_data->texCoordSystem->fromMatrix(offset, scale);
             }
         }
 
         float BrushFace::measureTextureAngle(const vm::vec2f& center, const vm::vec2f& point) const {
-            return m_texCoordSystem->measureAngle(m_attribs.rotation(), center, point);
+            return m_data->texCoordSystem->measureAngle(m_attribs.rotation(), center, point);
         }
 
         size_t BrushFace::vertexCount() const {
@@ -630,6 +675,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -656,44 +705,56 @@ namespace TrenchBroom {
         }
 
         vm::vec2f BrushFace::textureCoords(const vm::vec3& point) const {
-            return m_texCoordSystem->getTexCoords(point, m_attribs);
+            return m_data->texCoordSystem->getTexCoords(point, m_attribs);
         }
 
         FloatType BrushFace::intersectWithRay(const vm::ray3& ray) const {
             ensure(m_geometry != nullptr, "geometry is null");
 
-            const FloatType cos = dot(m_boundary.normal, ray.direction);
+            const auto& boundary = m_data->boundary;
+            const FloatType cos = dot(boundary.normal, ray.direction);
             if (cos >= FloatType(0.0)) {
                 return vm::nan<FloatType>();
             } else {
-                return vm::intersect_ray_polygon(ray, m_boundary, m_geometry->boundary().begin(), m_geometry->boundary().end(), BrushGeometry::GetVertexPosition());
+                return vm::intersect_ray_polygon(ray, boundary, m_geometry->boundary().begin(), m_geometry->boundary().end(), BrushGeometry::GetVertexPosition());
             }
         }
 
+        BrushFace::Data& BrushFace::mutableData() {
+            if (m_data.use_count() > 1) {
+                m_data = std::make_shared<Data>(*m_data);
+            }
+
+            // the data is not shared, and it was not created const
+            return const_cast<Data&>(*m_data);
+        }
+
         void BrushFace::setPoints(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2) {
-            m_points[0] = point0;
-            m_points[1] = point1;
-            m_points[2] = point2;
+            auto& data = mutableData();
+            data.points[0] = point0;
+            data.points[1] = point1;
+            data.points[2] = point2;
             correctPoints();
 
-            const auto [result, plane] = vm::from_points(m_points[0], m_points[1], m_points[2]);
+            const auto [result, plane] = vm::from_points(data.points[0], data.points[1], data.points[2]);
             if (!result) {
                 auto str = std::stringstream();
                 str << "Colinear face points: (" <<
-                m_points[0] << ") (" <<
-                m_points[1] << ") (" <<
-                m_points[2] << ")";
+                data.points[0] << ") (" <<
+                data.points[1] << ") (" <<
+                data.points[2] << ")";
                 throw GeometryException(str.str());
             } else {
-                m_boundary = plane;
+                data.boundary = plane;
             }
 
             invalidateVertexCache();
         }
 
         void BrushFace::correctPoints() {
+            auto& data = mutableData();
             for (size_t i = 0; i < 3; ++i) {
-                m_points[i] = correct(m_points[i]);
+                data.points[i] = correct(data.points[i]);
             }
         }
 
@@ -62,6 +62,23 @@ namespace TrenchBroom {
              * 0-----------2
              */
             using Points = vm::vec3[3];
+
+            /**
+             * The plane points, the boundary plane and the texture coordinate system of a face. Brush snapshots share
+             * this data with the faces they were taken of, so it is never modified while it is shared. Instead, a face
+             * copies its data before modifying it.
+             */
+            struct Data {
+                Points points;
+                vm::plane3 boundary;
+                std::unique_ptr<TexCoordSystem> texCoordSystem;
+
+                explicit Data(std::unique_ptr<TexCoordSystem> texCoordSystem);
+                Data(const Data& other);
+                ~Data();
+
+                Data& operator=(const Data& other) = delete;
+            };
         private:
             /**
              * For use in VertexList transformation below.
@@ -81,13 +98,11 @@ namespace TrenchBroom {
             using EdgeList = kdl::transform_adapter<BrushHalfEdgeList, TransformHalfEdgeToEdge>;
         private:
             Brush* m_brush;
-            BrushFace::Points m_points;
-            vm::plane3 m_boundary;
+            std::shared_ptr<const Data> m_data;
             size_t m_lineNumber;
             size_t m_lineCount;
             bool m_selected;
 
-            std::unique_ptr<TexCoordSystem> m_texCoordSystem;
             BrushFaceGeometry* m_geometry;
 
             // brush renderer
@@ -97,6 +112,14 @@ namespace TrenchBroom {
         public:
             BrushFace(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const BrushFaceAttributes& attribs, std::unique_ptr<TexCoordSystem> texCoordSystem);
 
+            /**
+             * Creates a face that shares the given data until either of them is modified.
+             *
+             * @param data the plane points, boundary and texture coordinate system of the face
+             * @param attribs the face attributes
+             */
+            BrushFace(std::shared_ptr<const Data> data, const BrushFaceAttributes& attribs);
+
             static BrushFace* createParaxial(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName = "");
             static BrushFace* createParallel(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2, const std::string& textureName = "");
 
@@ -106,6 +129,12 @@ namespace TrenchBroom {
 
             BrushFace* clone() const;
 
+            /**
+             * Returns the plane points, boundary and texture coordinate system of this face. The returned data is
+             * shared with this face and never changes; this face copies it before it is modified.
+             */
+            std::shared_ptr<const Data> data() const;
+
             BrushFaceSnapshot* takeSnapshot();
             std::unique_ptr<TexCoordSystemSnapshot> takeTexCoordSystemSnapshot() const;
             void restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot);
@@ -198,6 +227,7 @@ namespace TrenchBroom {
             void invalidate();
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
 
             bool selected() const;
@@ -208,6 +238,8 @@ namespace TrenchBroom {
 
             FloatType intersectWithRay(const vm::ray3& ray) const;
         private:
+            Data& mutableData();
+
             void setPoints(const vm::vec3& point0, const vm::vec3& point1, const vm::vec3& point2);
             void correctPoints();
 
@@ -38,5 +38,14 @@ namespace TrenchBroom {
                 face->restoreTexCoordSystemSnapshot(*m_coordSystemSnapshot);
             }
         }
+
+        size_t BrushFaceSnapshot::memorySize() const {
+            auto result = sizeof(BrushFaceSnapshot) + m_attribs.textureName().capacity();
+            if (m_coordSystemSnapshot != nullptr) {
+                // only the parallel texture coordinate system takes snapshots, it stores its two texture axes
+                result += sizeof(TexCoordSystemSnapshot) + 2u * sizeof(vm::vec3);
+            }
+            return result;
+        }
     }
 }
@@ -21,8 +21,9 @@
 
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/TexCoordSystem.h"
 
-#include <kdl/vector_utils.h>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -31,21 +32,42 @@ namespace TrenchBroom {
             takeSnapshot(brush);
         }
 
-        BrushSnapshot::~BrushSnapshot() {
-            kdl::vec_clear_and_delete(m_faces);
-        }
+        BrushSnapshot::~BrushSnapshot() = default;
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
-            for (BrushFace* face : brush->faces()) {
-                BrushFace *faceClone = face->clone();
-                faceClone->setTexture(nullptr);
-                m_faces.push_back(faceClone);
+            m_faces.reserve(brush->faceCount());
+            for (const BrushFace* face : brush->faces()) {
+                // don't keep the texture, it might be unloaded while this snapshot exists
+                m_faces.push_back(FaceSnapshot{face->data(), face->attribs().takeSnapshot(), face->lineNumber(), face->lineCount(), face->selected()});
             }
         }
 
         void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
+            std::vector<BrushFace*> faces;
+            faces.reserve(m_faces.size());
+            for (const auto& snapshot : m_faces) {
+                auto* face = new BrushFace(snapshot.data, snapshot.attribs);
+                face->setFilePosition(snapshot.lineNumber, snapshot.lineCount);
+                if (snapshot.selected) {
+                    face->select();
+                }
+                faces.push_back(face);
+            }
             m_faces.clear();
+
+            m_brush->setFaces(worldBounds, faces);
+        }
+
+        size_t BrushSnapshot::doGetMemorySize() const {
+            // the face data is counted even while it is shared with the brush so that the size of a snapshot doesn't
+            // change when the brush is modified
+            auto result = sizeof(BrushSnapshot) + m_faces.capacity() * sizeof(FaceSnapshot);
+            for (const auto& snapshot : m_faces) {
+                result += sizeof(BrushFace::Data);
+                result += snapshot.data->texCoordSystem->memorySize();
+                result += snapshot.attribs.textureName().capacity();
+            }
+            return result;
         }
     }
 }
@@ -20,25 +20,40 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
 #include "Model/NodeSnapshot.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         class Brush;
-        class BrushFace;
 
+        /**
+         * Restores the faces of a brush. The plane points, boundaries and texture coordinate systems of the faces are
+         * shared with the brush until the brush modifies them, so taking a snapshot doesn't copy them.
+         */
         class BrushSnapshot : public NodeSnapshot {
         private:
+            struct FaceSnapshot {
+                std::shared_ptr<const BrushFace::Data> data;
+                BrushFaceAttributes attribs;
+                size_t lineNumber;
+                size_t lineCount;
+                bool selected;
+            };
+
             Brush* m_brush;
-            std::vector<BrushFace*> m_faces;
+            std::vector<FaceSnapshot> m_faces;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot() override;
         private:
             void takeSnapshot(Brush* brush);
             void doRestore(const vm::bbox3& worldBounds) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
@@ -66,7 +66,7 @@ namespace TrenchBroom {
         };
 
         EmptyAttributeNameIssueGenerator::EmptyAttributeNameIssueGenerator() :
-        IssueGenerator(EmptyAttributeNameIssue::Type, "Empty property name") {
+        IssueGenerator(EmptyAttributeNameIssue::Type, "Empty property name", IssueDependency::Attributes, true) {
             addQuickFix(new EmptyAttributeNameIssueQuickFix());
         }
 
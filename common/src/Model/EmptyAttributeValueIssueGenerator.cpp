@@ -77,7 +77,7 @@ namespace TrenchBroom {
         };
 
         EmptyAttributeValueIssueGenerator::EmptyAttributeValueIssueGenerator() :
-        IssueGenerator(EmptyAttributeValueIssue::Type, "Empty property value") {
+        IssueGenerator(EmptyAttributeValueIssue::Type, "Empty property value", IssueDependency::Attributes, true) {
             addQuickFix(new EmptyAttributeValueIssueQuickFix());
         }
 
@@ -61,7 +61,7 @@ namespace TrenchBroom {
         };
 
         EmptyBrushEntityIssueGenerator::EmptyBrushEntityIssueGenerator() :
-        IssueGenerator(EmptyBrushEntityIssue::Type, "Empty brush entity") {
+        IssueGenerator(EmptyBrushEntityIssue::Type, "Empty brush entity", IssueDependency::Attributes | IssueDependency::Children, true) {
             addQuickFix(new EmptyBrushEntityIssueQuickFix());
         }
 
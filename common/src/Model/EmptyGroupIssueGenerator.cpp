@@ -60,7 +60,7 @@ namespace TrenchBroom {
         };
 
         EmptyGroupIssueGenerator::EmptyGroupIssueGenerator() :
-        IssueGenerator(EmptyGroupIssue::Type, "Empty group") {
+        IssueGenerator(EmptyGroupIssue::Type, "Empty group", IssueDependency::Children, true) {
             addQuickFix(new EmptyGroupIssueQuickFix());
         }
 
@@ -371,7 +371,7 @@ namespace TrenchBroom {
 
         void Entity::doTransform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
             if (hasChildren()) {
-                const NotifyNodeChange nodeChange(this);
+                const NotifyNodeChange nodeChange(this, IssueDependency::Children);
                 TransformEntity visitor(transformation, lockTextures, worldBounds);
                 iterate(visitor);
             } else {
@@ -48,5 +48,11 @@ namespace TrenchBroom {
             restoreAttribute(m_entity, m_origin);
             restoreAttribute(m_entity, m_rotation);
         }
+
+        size_t EntitySnapshot::doGetMemorySize() const {
+            return sizeof(EntitySnapshot)
+                + m_origin.name().capacity() + m_origin.value().capacity()
+                + m_rotation.name().capacity() + m_rotation.value().capacity();
+        }
     }
 }
@@ -47,5 +47,13 @@ namespace TrenchBroom {
             for (NodeSnapshot* snapshot : m_snapshots)
                 snapshot->restore(worldBounds);
         }
+
+        size_t GroupSnapshot::doGetMemorySize() const {
+            auto result = sizeof(GroupSnapshot) + m_snapshots.capacity() * sizeof(NodeSnapshot*);
+            for (const NodeSnapshot* snapshot : m_snapshots) {
+                result += snapshot->memorySize();
+            }
+            return result;
+        }
     }
 }
@@ -79,7 +79,7 @@ namespace TrenchBroom {
         };
 
         InvalidTextureScaleIssueGenerator::InvalidTextureScaleIssueGenerator() :
-        IssueGenerator(InvalidTextureScaleIssue::Type, "Invalid texture scale") {
+        IssueGenerator(InvalidTextureScaleIssue::Type, "Invalid texture scale", IssueDependency::Geometry, true) {
             addQuickFix(new InvalidTextureScaleIssueQuickFix());
         }
 
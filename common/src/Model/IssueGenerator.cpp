@@ -43,6 +43,14 @@ namespace TrenchBroom {
             return m_description;
         }
 
+        IssueDependency::Type IssueGenerator::dependencies() const {
+            return m_dependencies;
+        }
+
+        bool IssueGenerator::threadSafe() const {
+            return m_threadSafe;
+        }
+
         const std::vector<IssueQuickFix*>& IssueGenerator::quickFixes() const {
             return m_quickFixes;
         }
@@ -67,9 +75,11 @@ namespace TrenchBroom {
             doGenerate(brush, issues);
         }
 
-        IssueGenerator::IssueGenerator(const IssueType type, const std::string& description) :
+        IssueGenerator::IssueGenerator(const IssueType type, const std::string& description, const IssueDependency::Type dependencies, const bool threadSafe) :
         m_type(type),
-        m_description(description) {}
+        m_description(description),
+        m_dependencies(dependencies),
+        m_threadSafe(threadSafe) {}
 
         void IssueGenerator::addQuickFix(IssueQuickFix* quickFix) {
             ensure(quickFix != nullptr, "quickFix is null");
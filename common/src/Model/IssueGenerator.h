@@ -43,12 +43,25 @@ namespace TrenchBroom {
         private:
             IssueType m_type;
             std::string m_description;
+            IssueDependency::Type m_dependencies;
+            bool m_threadSafe;
             IssueQuickFixList m_quickFixes;
         public:
             virtual ~IssueGenerator();
 
             IssueType type() const;
             const std::string& description() const;
+
+            /**
+             * Returns the parts of a node that the issues generated by this generator depend on.
+             */
+            IssueDependency::Type dependencies() const;
+
+            /**
+             * Indicates whether this generator may generate issues for several nodes at once. A thread safe generator
+             * must only read the node it is given, its children and its own immutable state.
+             */
+            bool threadSafe() const;
             const IssueQuickFixList& quickFixes() const;
 
             void generate(World* world,   IssueList& issues) const;
@@ -57,7 +70,7 @@ namespace TrenchBroom {
             void generate(Entity* entity, IssueList& issues) const;
             void generate(Brush* brush,   IssueList& issues) const;
         protected:
-            IssueGenerator(IssueType type, const std::string& description);
+            IssueGenerator(IssueType type, const std::string& description, IssueDependency::Type dependencies = IssueDependency::All, bool threadSafe = false);
             void addQuickFix(IssueQuickFix* quickFix);
         private:
             virtual void doGenerate(World* world,           IssueList& issues) const;
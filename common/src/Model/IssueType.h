@@ -23,6 +23,19 @@
 namespace TrenchBroom {
     namespace Model {
         using IssueType = int;
+
+        /**
+         * The parts of a node that the issues of a generator depend on. When a part of a node changes, only the
+         * generators that depend on it are run again for that node.
+         */
+        namespace IssueDependency {
+            using Type = unsigned int;
+            static const Type Attributes  = 1 << 0; // attributes and entity definition
+            static const Type Geometry    = 1 << 1; // brush faces and vertices
+            static const Type Children    = 1 << 2; // children and their descendants
+            static const Type Links       = 1 << 3; // link sources and targets, also changes when other entities change
+            static const Type All         = Attributes | Geometry | Children | Links;
+        }
     }
 }
 
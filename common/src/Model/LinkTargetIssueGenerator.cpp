@@ -78,7 +78,7 @@ namespace TrenchBroom {
         };
 
         LinkTargetIssueGenerator::LinkTargetIssueGenerator() :
-        IssueGenerator(LinkTargetIssue::Type, "Missing entity link source") {
+        IssueGenerator(LinkTargetIssue::Type, "Missing entity link source", IssueDependency::Attributes | IssueDependency::Links, true) {
             addQuickFix(new LinkTargetIssueQuickFix());
         }
 
@@ -56,7 +56,7 @@ namespace TrenchBroom {
         const IssueType LongAttributeNameIssueGenerator::LongAttributeNameIssue::Type = Issue::freeType();
 
         LongAttributeNameIssueGenerator::LongAttributeNameIssueGenerator(const size_t maxLength) :
-        IssueGenerator(LongAttributeNameIssue::Type, "Long entity property keys"),
+        IssueGenerator(LongAttributeNameIssue::Type, "Long entity property keys", IssueDependency::Attributes, true),
         m_maxLength(maxLength) {
             addQuickFix(new RemoveEntityAttributesQuickFix(LongAttributeNameIssue::Type));
         }
@@ -82,7 +82,7 @@ namespace TrenchBroom {
         };
 
         LongAttributeValueIssueGenerator::LongAttributeValueIssueGenerator(const size_t maxLength) :
-        IssueGenerator(LongAttributeValueIssue::Type, "Long entity property value"),
+        IssueGenerator(LongAttributeValueIssue::Type, "Long entity property value", IssueDependency::Attributes, true),
         m_maxLength(maxLength) {
             addQuickFix(new RemoveEntityAttributesQuickFix(LongAttributeValueIssue::Type));
             addQuickFix(new TruncateLongAttributeValueIssueQuickFix(m_maxLength));
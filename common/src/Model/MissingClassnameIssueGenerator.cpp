@@ -59,7 +59,7 @@ namespace TrenchBroom {
         };
 
         MissingClassnameIssueGenerator::MissingClassnameIssueGenerator() :
-        IssueGenerator(MissingClassnameIssue::Type, "Missing entity classname") {
+        IssueGenerator(MissingClassnameIssue::Type, "Missing entity classname", IssueDependency::Attributes, true) {
             addQuickFix(new MissingClassnameIssueQuickFix());
         }
 
@@ -60,7 +60,7 @@ namespace TrenchBroom {
         };
 
         MissingDefinitionIssueGenerator::MissingDefinitionIssueGenerator() :
-        IssueGenerator(MissingDefinitionIssue::Type, "Missing entity definition") {
+        IssueGenerator(MissingDefinitionIssue::Type, "Missing entity definition", IssueDependency::Attributes, true) {
             addQuickFix(new MissingDefinitionIssueQuickFix());
         }
 
@@ -94,7 +94,7 @@ namespace TrenchBroom {
         };
 
         MissingModIssueGenerator::MissingModIssueGenerator(std::weak_ptr<Game> game) :
-        IssueGenerator(MissingModIssue::Type, "Missing mod directory"),
+        IssueGenerator(MissingModIssue::Type, "Missing mod directory", IssueDependency::Attributes),
         m_game(std::move(game)) {
             addQuickFix(new MissingModIssueQuickFix());
         }
@@ -50,7 +50,7 @@ namespace TrenchBroom {
         const IssueType MixedBrushContentsIssueGenerator::MixedBrushContentsIssue::Type = Issue::freeType();
 
         MixedBrushContentsIssueGenerator::MixedBrushContentsIssueGenerator() :
-        IssueGenerator(MixedBrushContentsIssue::Type, "Mixed brush content flags") {}
+        IssueGenerator(MixedBrushContentsIssue::Type, "Mixed brush content flags", IssueDependency::Geometry, true) {}
 
         void MixedBrushContentsIssueGenerator::doGenerate(Brush* brush, IssueList& issues) const {
             const std::vector<BrushFace*>& faces = brush->faces();
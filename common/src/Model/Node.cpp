@@ -26,6 +26,7 @@
 #include "Model/LockState.h"
 #include "Model/VisibilityState.h"
 
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
@@ -47,7 +48,7 @@ namespace TrenchBroom {
         m_lockState(LockState::Lock_Inherited),
         m_lineNumber(0),
         m_lineCount(0),
-        m_issuesValid(false),
+        m_staleIssueDependencies(IssueDependency::All),
         m_hiddenIssues(0) {}
 
         Node::~Node() {
@@ -257,7 +258,7 @@ namespace TrenchBroom {
             doDescendantWasAdded(node, depth);
             if (shouldPropagateDescendantEvents() && m_parent != nullptr)
                 m_parent->descendantWasAdded(node, depth + 1);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Children);
         }
 
         void Node::descendantWillBeRemoved(Node* node, const size_t depth) {
@@ -270,7 +271,7 @@ namespace TrenchBroom {
             doDescendantWasRemoved(oldParent, node, depth);
             if (shouldPropagateDescendantEvents() && m_parent != nullptr)
                 m_parent->descendantWasRemoved(oldParent, node, depth + 1);
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Children);
         }
 
         bool Node::shouldPropagateDescendantEvents() const {
@@ -331,26 +332,27 @@ namespace TrenchBroom {
             invalidateIssues();
         }
 
-        void Node::nodeWillChange() {
+        void Node::nodeWillChange(const IssueDependency::Type issueDependencies) {
             if (m_parent != nullptr)
                 m_parent->childWillChange(this);
-            invalidateIssues();
+            invalidateIssues(issueDependencies);
         }
 
-        void Node::nodeDidChange() {
+        void Node::nodeDidChange(const IssueDependency::Type issueDependencies) {
             if (m_parent != nullptr)
                 m_parent->childDidChange(this);
-            invalidateIssues();
+            invalidateIssues(issueDependencies);
         }
 
-        Node::NotifyNodeChange::NotifyNodeChange(Node* node) :
-        m_node(node) {
+        Node::NotifyNodeChange::NotifyNodeChange(Node* node, const IssueDependency::Type issueDependencies) :
+        m_node(node),
+        m_issueDependencies(issueDependencies) {
             ensure(m_node != nullptr, "node is null");
-            m_node->nodeWillChange();
+            m_node->nodeWillChange(m_issueDependencies);
         }
 
         Node::NotifyNodeChange::~NotifyNodeChange() {
-            m_node->nodeDidChange();
+            m_node->nodeDidChange(m_issueDependencies);
         }
 
         // notice that we take a copy here so that we can safely propagate the old bounds up
@@ -375,7 +377,7 @@ namespace TrenchBroom {
             if (shouldPropagateDescendantEvents() && m_parent != nullptr) {
                 m_parent->descendantWillChange(node);
             }
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Children);
         }
 
         void Node::descendantDidChange(Node* node) {
@@ -383,7 +385,7 @@ namespace TrenchBroom {
             if (shouldPropagateDescendantEvents() && m_parent != nullptr) {
                 m_parent->descendantDidChange(node);
             }
-            invalidateIssues();
+            invalidateIssues(IssueDependency::Children);
         }
 
         void Node::childPhysicalBoundsDidChange(Node* node, const vm::bbox3& oldBounds) {
@@ -582,6 +584,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t Node::lineCount() const {
+            return m_lineCount;
+        }
+
         void Node::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
@@ -609,17 +615,82 @@ namespace TrenchBroom {
         }
 
         void Node::validateIssues(const std::vector<IssueGenerator*>& issueGenerators) {
-            if (!m_issuesValid) {
-                for (const auto* generator : issueGenerators) {
-                    doGenerateIssues(generator, m_issues);
+            if (m_staleIssueDependencies != 0) {
+                removeStaleIssues(issueGenerators);
+                generateStaleIssues(issueGenerators);
+                m_staleIssueDependencies = 0;
+            }
+        }
+
+        void Node::validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators) {
+            std::vector<Node*> invalidNodes;
+            for (auto* node : nodes) {
+                if (node->m_staleIssueDependencies != 0) {
+                    invalidNodes.push_back(node);
                 }
-                m_issuesValid = true;
+            }
+
+            std::vector<IssueGenerator*> threadSafeGenerators;
+            std::vector<IssueGenerator*> otherGenerators;
+            for (auto* generator : issueGenerators) {
+                if (generator->threadSafe()) {
+                    threadSafeGenerators.push_back(generator);
+                } else {
+                    otherGenerators.push_back(generator);
+                }
+            }
+
+            kdl::parallel_for(invalidNodes.size(), [&](const size_t i) {
+                auto* node = invalidNodes[i];
+                node->removeStaleIssues(issueGenerators);
+                node->generateStaleIssues(threadSafeGenerators);
+            });
+
+            for (auto* node : invalidNodes) {
+                node->generateStaleIssues(otherGenerators);
+                node->m_staleIssueDependencies = 0;
             }
         }
 
-        void Node::invalidateIssues() const {
-            clearIssues();
-            m_issuesValid = false;
+        void Node::invalidateIssues(const IssueDependency::Type dependencies) const {
+            m_staleIssueDependencies |= dependencies;
+        }
+
+        bool Node::issueGeneratorStale(const IssueGenerator* generator) const {
+            return (generator->dependencies() & m_staleIssueDependencies) != 0;
+        }
+
+        void Node::removeStaleIssues(const std::vector<IssueGenerator*>& issueGenerators) {
+            if (m_staleIssueDependencies == IssueDependency::All) {
+                clearIssues();
+                return;
+            }
+
+            // every generator has its own issue type, so we can tell which issues a stale generator has generated
+            IssueType staleTypes = 0;
+            for (const auto* generator : issueGenerators) {
+                if (issueGeneratorStale(generator)) {
+                    staleTypes |= generator->type();
+                }
+            }
+
+            std::vector<Issue*> remainingIssues;
+            for (auto* issue : m_issues) {
+                if ((issue->type() & staleTypes) != 0) {
+                    delete issue;
+                } else {
+                    remainingIssues.push_back(issue);
+                }
+            }
+            m_issues = std::move(remainingIssues);
+        }
+
+        void Node::generateStaleIssues(const std::vector<IssueGenerator*>& issueGenerators) {
+            for (const auto* generator : issueGenerators) {
+                if (issueGeneratorStale(generator)) {
+                    doGenerateIssues(generator, m_issues);
+                }
+            }
         }
 
         void Node::clearIssues() const {
@@ -58,7 +58,7 @@ namespace TrenchBroom {
             size_t m_lineCount;
 
             mutable std::vector<Issue*> m_issues;
-            mutable bool m_issuesValid;
+            mutable IssueDependency::Type m_staleIssueDependencies;
             IssueType m_hiddenIssues;
         protected:
             Node();
@@ -208,14 +208,19 @@ namespace TrenchBroom {
             class NotifyNodeChange {
             private:
                 Node* m_node;
+                IssueDependency::Type m_issueDependencies;
             public:
-                explicit NotifyNodeChange(Node* node);
+                /**
+                 * Notifies the given node and its ancestors of a change. The issues of the node that depend on the
+                 * given parts are invalidated, and the issues of its ancestors that depend on their children.
+                 */
+                explicit NotifyNodeChange(Node* node, IssueDependency::Type issueDependencies = IssueDependency::All);
                 ~NotifyNodeChange();
             };
 
             // call these methods via the NotifyNodeChange class, it's much safer
-            void nodeWillChange();
-            void nodeDidChange();
+            void nodeWillChange(IssueDependency::Type issueDependencies);
+            void nodeDidChange(IssueDependency::Type issueDependencies);
 
             void nodePhysicalBoundsDidChange(vm::bbox3 oldBounds);
         private:
@@ -276,6 +281,7 @@ namespace TrenchBroom {
             void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
         public: // file position
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
             bool containsLine(size_t lineNumber) const;
         public: // issue management
@@ -284,9 +290,26 @@ namespace TrenchBroom {
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
         public: // should only be called from this and from the world
-            void invalidateIssues() const;
+            /**
+             * Invalidates the issues of this node that depend on the given parts. They are generated again the next
+             * time that the issues of this node are validated.
+             */
+            void invalidateIssues(IssueDependency::Type dependencies = IssueDependency::All) const;
+
+            /**
+             * Validates the issues of every given node that has invalid issues. Thread safe issue generators are run
+             * for several nodes in parallel, each node collecting its issues in its own list. The remaining generators
+             * are run afterwards on the calling thread. The nodes must not be modified while this function runs.
+             *
+             * Afterwards, every node has the same issues as if it had been validated on its own, but their sequence
+             * ids may be in a different order.
+             */
+            static void validateIssues(const std::vector<Node*>& nodes, const std::vector<IssueGenerator*>& issueGenerators);
         private:
             void validateIssues(const std::vector<IssueGenerator*>& issueGenerators);
+            bool issueGeneratorStale(const IssueGenerator* generator) const;
+            void removeStaleIssues(const std::vector<IssueGenerator*>& issueGenerators);
+            void generateStaleIssues(const std::vector<IssueGenerator*>& issueGenerators);
             void clearIssues() const;
         public: // visitors
             template <class V>
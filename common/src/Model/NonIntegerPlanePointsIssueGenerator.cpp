@@ -61,7 +61,7 @@ namespace TrenchBroom {
         };
 
         NonIntegerPlanePointsIssueGenerator::NonIntegerPlanePointsIssueGenerator() :
-        IssueGenerator(NonIntegerPlanePointsIssue::Type, "Non-integer plane points") {
+        IssueGenerator(NonIntegerPlanePointsIssue::Type, "Non-integer plane points", IssueDependency::Geometry, true) {
             addQuickFix(new NonIntegerPlanePointsIssueQuickFix());
         }
 
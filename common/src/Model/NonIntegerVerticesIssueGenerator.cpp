@@ -61,7 +61,7 @@ namespace TrenchBroom {
         };
 
         NonIntegerVerticesIssueGenerator::NonIntegerVerticesIssueGenerator() :
-        IssueGenerator(NonIntegerVerticesIssue::Type, "Non-integer vertices") {
+        IssueGenerator(NonIntegerVerticesIssue::Type, "Non-integer vertices", IssueDependency::Geometry, true) {
             addQuickFix(new NonIntegerVerticesIssueQuickFix());
         }
 
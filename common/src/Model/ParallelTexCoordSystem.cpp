@@ -77,6 +77,10 @@ namespace TrenchBroom {
             snapshot.doRestore(*this);
         }
 
+        size_t ParallelTexCoordSystem::doGetMemorySize() const {
+            return sizeof(ParallelTexCoordSystem);
+        }
+
         vm::vec3 ParallelTexCoordSystem::getXAxis() const {
             return m_xAxis;
         }
@@ -57,6 +57,7 @@ namespace TrenchBroom {
             std::unique_ptr<TexCoordSystem> doClone() const override;
             std::unique_ptr<TexCoordSystemSnapshot> doTakeSnapshot() const override;
             void doRestoreSnapshot(const TexCoordSystemSnapshot& snapshot) override;
+            size_t doGetMemorySize() const override;
 
             vm::vec3 getXAxis() const override;
             vm::vec3 getYAxis() const override;
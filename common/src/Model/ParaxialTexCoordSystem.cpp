@@ -90,6 +90,10 @@ namespace TrenchBroom {
             ensure(false, "unsupported");
         }
 
+        size_t ParaxialTexCoordSystem::doGetMemorySize() const {
+            return sizeof(ParaxialTexCoordSystem);
+        }
+
         vm::vec3 ParaxialTexCoordSystem::getXAxis() const {
             return m_xAxis;
         }
@@ -77,7 +77,7 @@ namespace TrenchBroom {
         };
 
         PointEntityWithBrushesIssueGenerator::PointEntityWithBrushesIssueGenerator() :
-        IssueGenerator(PointEntityWithBrushesIssue::Type, "Point entity with brushes") {
+        IssueGenerator(PointEntityWithBrushesIssue::Type, "Point entity with brushes", IssueDependency::Attributes | IssueDependency::Children, true) {
             addQuickFix(new PointEntityWithBrushesIssueQuickFix());
         }
 
@@ -20,7 +20,7 @@
 #ifndef TrenchBroom_Polyhedron_h
 #define TrenchBroom_Polyhedron_h
 
-#include "Allocator.h"
+#include "SlabAllocator.h"
 
 #include "Polyhedron_Forward.h"
 
@@ -60,7 +60,7 @@ namespace TrenchBroom {
          * The payload of a vertex can be used to store user data.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_Vertex : public Allocator<Polyhedron_Vertex<T,FP,VP>> {
+        class Polyhedron_Vertex : public SlabAllocator<Polyhedron_Vertex<T,FP,VP>> {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Edge<T,FP,VP>;
@@ -192,7 +192,7 @@ namespace TrenchBroom {
          * list.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_Edge : public Allocator<Polyhedron_Edge<T,FP,VP>> {
+        class Polyhedron_Edge : public SlabAllocator<Polyhedron_Edge<T,FP,VP>> {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Vertex<T,FP,VP>;
@@ -464,7 +464,7 @@ namespace TrenchBroom {
          * belongs to.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_HalfEdge : public Allocator<Polyhedron_HalfEdge<T,FP,VP>> {
+        class Polyhedron_HalfEdge : public SlabAllocator<Polyhedron_HalfEdge<T,FP,VP>> {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Vertex<T,FP,VP>;
@@ -670,7 +670,7 @@ namespace TrenchBroom {
          * list.
          */
         template <typename T, typename FP, typename VP>
-        class Polyhedron_Face : public Allocator<Polyhedron_Face<T,FP,VP>> {
+        class Polyhedron_Face : public SlabAllocator<Polyhedron_Face<T,FP,VP>> {
         private:
             friend class Polyhedron<T,FP,VP>;
             friend class Polyhedron_Vertex<T,FP,VP>;
@@ -2062,6 +2062,43 @@ namespace TrenchBroom {
              */
             HalfEdge* findNextIntersectingEdge(HalfEdge* searchFrom, const vm::plane<T,3>& plane) const;
 
+            /* ====================== Implementation in Polyhedron_Planes.h ====================== */
+        public: // Construction from planes
+            /**
+             * Builds this polyhedron as the intersection of the half spaces below the given planes. This polyhedron
+             * must be empty.
+             *
+             * Unlike clipping a bounding box with one plane after another, this computes the vertices directly as the
+             * intersection points of all triples of planes and assembles the faces, edges and half edges in one pass.
+             * A plane that contains fewer than three vertices is redundant and does not produce a face.
+             *
+             * If the planes do not bound a closed polyhedron within the given bounds, or if the resulting topology is
+             * inconsistent due to floating point inaccuracies, this polyhedron is left empty and an empty vector is
+             * returned. In that case, the caller should fall back to clipping.
+             *
+             * @param planes the planes to intersect, at most MaxIntersectPlaneCount
+             * @param bounds the bounds that must contain every vertex
+             * @return a vector containing the face created for each of the given planes, or null for each redundant
+             * plane, or an empty vector if the polyhedron could not be built
+             */
+            std::vector<Face*> intersectPlanes(const std::vector<vm::plane<T,3>>& planes, const vm::bbox<T,3>& bounds);
+        private:
+            /**
+             * The maximum number of planes accepted by intersectPlanes. The number of plane triples grows with the
+             * third power of the number of planes, so for larger numbers, clipping is faster.
+             */
+            static constexpr const size_t MaxIntersectPlaneCount = 16u;
+
+            /**
+             * Sorts the given vertex indices counter clockwise around the given normal.
+             *
+             * @param normal the normal of the plane that contains the vertices
+             * @param positions the vertex positions
+             * @param indices the indices of the vertices to sort
+             * @return false if the vertices are degenerate and true otherwise
+             */
+            static bool sortCounterClockwise(const vm::vec<T,3>& normal, const std::vector<vm::vec<T,3>>& positions, std::vector<size_t>& indices);
+
             /* ====================== Implementation in Polyhedron_CSG.h ====================== */
         public: // Intersection
             /**
@@ -0,0 +1,255 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_Polyhedron_Planes_h
+#define TrenchBroom_Polyhedron_Planes_h
+
+#include "Polyhedron.h"
+
+#include <vecmath/vec.h>
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/scalar.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        template <typename T, typename FP, typename VP>
+        std::vector<typename Polyhedron<T,FP,VP>::Face*> Polyhedron<T,FP,VP>::intersectPlanes(const std::vector<vm::plane<T,3>>& planes, const vm::bbox<T,3>& bounds) {
+            static_assert(MaxIntersectPlaneCount <= 64u, "plane masks must fit into 64 bits");
+            assert(empty());
+
+            const auto planeCount = planes.size();
+            if (planeCount < 4u || planeCount > MaxIntersectPlaneCount) {
+                return {};
+            }
+
+            const auto planeBit = [](const size_t i) { return std::uint64_t(1) << i; };
+            const auto epsilon = vm::constants<T>::point_status_epsilon();
+
+            // Every intersection point of three planes that is not above any plane is a vertex. For each vertex,
+            // we remember the planes that contain it as a bit mask.
+            std::vector<vm::vec<T,3>> positions;
+            std::vector<std::uint64_t> vertexPlanes;
+
+            for (size_t i = 0u; i < planeCount; ++i) {
+                const auto& p1 = planes[i];
+                for (size_t j = i + 1u; j < planeCount; ++j) {
+                    const auto& p2 = planes[j];
+                    const auto n1xn2 = cross(p1.normal, p2.normal);
+                    for (size_t k = j + 1u; k < planeCount; ++k) {
+                        const auto& p3 = planes[k];
+
+                        // vertices where more than three planes meet are found for several triples
+                        const auto tripleMask = planeBit(i) | planeBit(j) | planeBit(k);
+                        if (std::any_of(std::begin(vertexPlanes), std::end(vertexPlanes), [&](const std::uint64_t mask) { return (mask & tripleMask) == tripleMask; })) {
+                            continue;
+                        }
+
+                        const auto det = dot(n1xn2, p3.normal);
+                        if (vm::abs(det) < vm::constants<T>::colinear_epsilon()) {
+                            continue;
+                        }
+
+                        const auto position = (cross(p2.normal, p3.normal) * p1.distance +
+                                               cross(p3.normal, p1.normal) * p2.distance +
+                                               n1xn2 * p3.distance) / det;
+
+                        std::uint64_t mask = 0u;
+                        bool inside = true;
+                        for (size_t l = 0u; l < planeCount && inside; ++l) {
+                            const auto distance = planes[l].point_distance(position);
+                            if (distance > epsilon) {
+                                inside = false;
+                            } else if (distance >= -epsilon) {
+                                mask |= planeBit(l);
+                            }
+                        }
+
+                        if (inside) {
+                            if (!bounds.contains(position)) {
+                                // clipping would retain some faces of the bounds
+                                return {};
+                            }
+                            positions.push_back(position);
+                            vertexPlanes.push_back(mask);
+                        }
+                    }
+                }
+            }
+
+            const auto vertexCount = positions.size();
+            if (vertexCount < 4u) {
+                return {};
+            }
+
+            // Each plane that contains at least three vertices becomes a face. We check the topology before creating
+            // anything: every directed edge must occur exactly once and must have a twin, and every vertex must
+            // belong to at least three faces.
+            std::vector<std::vector<size_t>> faceVertices(planeCount);
+            std::vector<unsigned char> halfEdgeCounts(vertexCount * vertexCount, 0u);
+            std::vector<size_t> vertexFaceCounts(vertexCount, 0u);
+            size_t faceCount = 0u;
+            size_t halfEdgeCount = 0u;
+
+            for (size_t i = 0u; i < planeCount; ++i) {
+                auto& indices = faceVertices[i];
+                for (size_t v = 0u; v < vertexCount; ++v) {
+                    if (vertexPlanes[v] & planeBit(i)) {
+                        indices.push_back(v);
+                    }
+                }
+
+                // like clipping, a plane that coincides with a previous plane does not produce another face
+                const auto previous = std::next(std::begin(faceVertices), static_cast<std::ptrdiff_t>(i));
+                if (indices.size() < 3u || std::find(std::begin(faceVertices), previous, indices) != previous) {
+                    indices.clear();
+                }
+            }
+
+            for (size_t i = 0u; i < planeCount; ++i) {
+                auto& indices = faceVertices[i];
+                if (indices.empty()) {
+                    continue;
+                }
+
+                if (!sortCounterClockwise(planes[i].normal, positions, indices)) {
+                    return {};
+                }
+
+                for (size_t v = 0u; v < indices.size(); ++v) {
+                    const auto origin = indices[v];
+                    const auto destination = indices[(v + 1u) % indices.size()];
+                    if (halfEdgeCounts[origin * vertexCount + destination]++ != 0u) {
+                        return {};
+                    }
+                    ++vertexFaceCounts[origin];
+                }
+
+                ++faceCount;
+                halfEdgeCount += indices.size();
+            }
+
+            for (const auto& indices : faceVertices) {
+                for (size_t v = 0u; v < indices.size(); ++v) {
+                    const auto origin = indices[v];
+                    const auto destination = indices[(v + 1u) % indices.size()];
+                    if (halfEdgeCounts[destination * vertexCount + origin] == 0u) {
+                        return {};
+                    }
+                }
+            }
+
+            if (std::any_of(std::begin(vertexFaceCounts), std::end(vertexFaceCounts), [](const size_t count) { return count < 3u; })) {
+                return {};
+            }
+
+            // Euler characteristic
+            const auto edgeCount = halfEdgeCount / 2u;
+            if (vertexCount + faceCount != edgeCount + 2u) {
+                return {};
+            }
+
+            // The topology is consistent, so we can now create the vertices, faces, half edges and edges.
+            std::vector<Vertex*> vertices;
+            vertices.reserve(vertexCount);
+            for (const auto& position : positions) {
+                auto* vertex = new Vertex(position);
+                vertices.push_back(vertex);
+                m_vertices.push_back(vertex);
+            }
+
+            std::vector<HalfEdge*> halfEdges(vertexCount * vertexCount, nullptr);
+            std::vector<Face*> result(planeCount, nullptr);
+            for (size_t i = 0u; i < planeCount; ++i) {
+                const auto& indices = faceVertices[i];
+                if (indices.empty()) {
+                    continue;
+                }
+
+                HalfEdgeList boundary;
+                for (size_t v = 0u; v < indices.size(); ++v) {
+                    const auto origin = indices[v];
+                    const auto destination = indices[(v + 1u) % indices.size()];
+                    auto* halfEdge = new HalfEdge(vertices[origin]);
+                    halfEdges[origin * vertexCount + destination] = halfEdge;
+                    boundary.push_back(halfEdge);
+                }
+
+                auto* face = new Face(std::move(boundary));
+                m_faces.push_back(face);
+                result[i] = face;
+            }
+
+            for (const auto& indices : faceVertices) {
+                for (size_t v = 0u; v < indices.size(); ++v) {
+                    const auto origin = indices[v];
+                    const auto destination = indices[(v + 1u) % indices.size()];
+                    if (origin < destination) {
+                        m_edges.push_back(new Edge(halfEdges[origin * vertexCount + destination], halfEdges[destination * vertexCount + origin]));
+                    }
+                }
+            }
+
+            updateBounds();
+            assert(checkInvariant());
+
+            return result;
+        }
+
+        template <typename T, typename FP, typename VP>
+        bool Polyhedron<T,FP,VP>::sortCounterClockwise(const vm::vec<T,3>& normal, const std::vector<vm::vec<T,3>>& positions, std::vector<size_t>& indices) {
+            auto center = vm::vec<T,3>::zero();
+            for (const auto index : indices) {
+                center = center + positions[index];
+            }
+            center = center / static_cast<T>(indices.size());
+
+            const auto axis = positions[indices.front()] - center;
+            if (vm::is_zero(axis, vm::constants<T>::almost_zero())) {
+                return false;
+            }
+
+            const auto xAxis = normalize(axis);
+            const auto yAxis = cross(normal, xAxis);
+
+            std::vector<std::pair<T, size_t>> angles;
+            angles.reserve(indices.size());
+            for (const auto index : indices) {
+                const auto offset = positions[index] - center;
+                angles.emplace_back(std::atan2(dot(offset, yAxis), dot(offset, xAxis)), index);
+            }
+            std::sort(std::begin(angles), std::end(angles));
+
+            for (size_t i = 0u; i < angles.size(); ++i) {
+                indices[i] = angles[i].second;
+            }
+            return true;
+        }
+    }
+}
+
+#endif
@@ -43,6 +43,19 @@ namespace TrenchBroom {
                 snapshot->restore();
         }
 
+        size_t Snapshot::memorySize() const {
+            auto result = sizeof(Snapshot);
+            result += m_nodeSnapshots.capacity() * sizeof(NodeSnapshot*);
+            result += m_brushFaceSnapshots.capacity() * sizeof(BrushFaceSnapshot*);
+            for (const NodeSnapshot* snapshot : m_nodeSnapshots) {
+                result += snapshot->memorySize();
+            }
+            for (const BrushFaceSnapshot* snapshot : m_brushFaceSnapshots) {
+                result += snapshot->memorySize();
+            }
+            return result;
+        }
+
         void Snapshot::takeSnapshot(Node* node) {
             NodeSnapshot* snapshot = node->takeSnapshot();
             if (snapshot != nullptr)
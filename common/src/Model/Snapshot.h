@@ -48,6 +48,11 @@ namespace TrenchBroom {
 
             void restoreNodes(const vm::bbox3& worldBounds);
             void restoreBrushFaces();
+
+            /**
+             * Returns an estimate of the number of bytes occupied by this snapshot.
+             */
+            size_t memorySize() const;
         private:
             void takeSnapshot(Node* node);
             void takeSnapshot(BrushFace* face);
@@ -30,6 +30,10 @@
 #include <vector>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
         class ConstTagVisitor;
         class TagManager;
@@ -296,6 +300,24 @@ namespace TrenchBroom {
              */
             virtual bool matches(const Taggable& taggable) const = 0;
 
+            /**
+             * Indicates whether this tag matcher matches brush faces by their texture name and their texture only and
+             * never matches any other taggable. The results of such matchers can be cached per texture.
+             *
+             * @return true if this tag matcher only depends on the texture of a brush face and false otherwise
+             */
+            virtual bool matchesByTexture() const;
+
+            /**
+             * Evaluates this tag matcher against a brush face with the given texture name and texture. Only called if
+             * this matcher matches by texture.
+             *
+             * @param textureName the texture name of the brush face
+             * @param texture the texture of the brush face, may be null
+             * @return true if this matcher matches a brush face with the given texture and false otherwise
+             */
+            virtual bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const;
+
             /**
              * Modifies the current selection so that this tag matcher would match it.
              *
@@ -362,6 +384,20 @@ namespace TrenchBroom {
              */
             bool matches(const Taggable& taggable) const;
 
+            /**
+             * Indicates whether the matcher of this smart tag matches brush faces by their texture only.
+             *
+             * @see TagMatcher::matchesByTexture
+             */
+            bool matchesByTexture() const;
+
+            /**
+             * Indicates whether this smart tag matches a brush face with the given texture name and texture.
+             *
+             * @see TagMatcher::matchesTexture
+             */
+            bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const;
+
             /**
              * Updates the given tag depending on whether or not the matcher matches against it.
              *
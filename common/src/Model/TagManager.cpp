@@ -20,15 +20,36 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "Model/BrushFace.h"
 #include "Model/Tag.h"
 #include "Model/TagType.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 
 namespace TrenchBroom {
     namespace Model {
+        static const size_t MaxTextureTagCount = 64u;
+
+        class FindBrushFaceVisitor : public ConstTagVisitor {
+        private:
+            const BrushFace* m_face;
+        public:
+            FindBrushFaceVisitor() :
+            m_face(nullptr) {}
+
+            void visit(const BrushFace& face) override {
+                m_face = &face;
+            }
+
+            const BrushFace* face() const {
+                return m_face;
+            }
+        };
+
         bool TagManager::TagCmp::operator()(const SmartTag& lhs, const SmartTag& rhs) const {
             return lhs.name() < rhs.name();
         }
@@ -86,16 +107,66 @@ namespace TrenchBroom {
                     throw std::logic_error("Smart tag already registered");
                 }
             }
+            invalidateTextureTags();
         }
 
         void TagManager::clearSmartTags() {
             m_smartTags.clear();
+            invalidateTextureTags();
+        }
+
+        void TagManager::invalidateTextureTags() {
+            m_textureTags.clear();
         }
 
         void TagManager::updateTags(Taggable& taggable) const {
-            for (const auto& tag : m_smartTags) {
-                tag.update(taggable);
+            FindBrushFaceVisitor visitor;
+            static_cast<const Taggable&>(taggable).accept(visitor);
+
+            const auto* face = visitor.face();
+            if (face == nullptr) {
+                for (const auto& tag : m_smartTags) {
+                    tag.update(taggable);
+                }
+                return;
+            }
+
+            const auto textureTags = this->textureTags(*face);
+            for (size_t i = 0u; i < m_smartTags.size(); ++i) {
+                const auto& tag = m_smartTags.get_data()[i];
+                if (i >= MaxTextureTagCount || !tag.matchesByTexture()) {
+                    tag.update(taggable);
+                } else if ((textureTags & (std::uint64_t(1) << i)) != 0u) {
+                    taggable.addTag(tag);
+                } else {
+                    taggable.removeTag(tag);
+                }
+            }
+        }
+
+        std::uint64_t TagManager::textureTags(const BrushFace& face) const {
+            const auto& textureName = face.textureName();
+            const auto* texture = face.texture();
+
+            auto it = m_textureTags.find(textureName);
+            if (it != std::end(m_textureTags) && it->second.texture == texture) {
+                return it->second.mask;
+            }
+
+            std::uint64_t mask = 0u;
+            for (size_t i = 0u; i < std::min(m_smartTags.size(), MaxTextureTagCount); ++i) {
+                const auto& tag = m_smartTags.get_data()[i];
+                if (tag.matchesByTexture() && tag.matchesTexture(textureName, texture)) {
+                    mask |= std::uint64_t(1) << i;
+                }
+            }
+
+            if (it != std::end(m_textureTags)) {
+                it->second = TextureTags{texture, mask};
+            } else {
+                m_textureTags.emplace(textureName, TextureTags{texture, mask});
             }
+            return mask;
         }
 
         size_t TagManager::freeTagIndex() {
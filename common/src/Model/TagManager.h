@@ -24,10 +24,18 @@
 
 #include <kdl/vector_set.h>
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
     namespace Model {
+        class BrushFace;
+
         /**
          * Manages the tags used in a document and updates smart tags on taggable objects.
          */
@@ -41,6 +49,21 @@ namespace TrenchBroom {
             };
 
             kdl::vector_set<SmartTag, TagCmp> m_smartTags;
+
+            /**
+             * The smart tags that match brush faces by texture, and the texture for which they were evaluated. Bit i
+             * of the mask is set if the i-th registered smart tag matches.
+             */
+            struct TextureTags {
+                const Assets::Texture* texture;
+                std::uint64_t mask;
+            };
+
+            /**
+             * Caches the smart tags that match brush faces by texture per texture name, so that updating the tags of
+             * many faces with the same texture only evaluates these tags once.
+             */
+            mutable std::unordered_map<std::string, TextureTags> m_textureTags;
         public:
             /**
              * Returns a vector containing all smart tags registered with this manager.
@@ -99,6 +122,13 @@ namespace TrenchBroom {
              */
             void clearSmartTags();
 
+            /**
+             * Discards the cached results of the smart tags that match brush faces by texture. Must be called whenever
+             * the textures that brush face texture names resolve to change, e.g. when texture collections are loaded or
+             * unloaded.
+             */
+            void invalidateTextureTags();
+
             /**
              * Update the smart tags of the given taggable object.
              *
@@ -106,6 +136,7 @@ namespace TrenchBroom {
              */
             void updateTags(Taggable& taggable) const;
         private:
+            std::uint64_t textureTags(const BrushFace& face) const;
             size_t freeTagIndex();
         };
     }
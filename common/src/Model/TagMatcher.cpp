@@ -67,18 +67,26 @@ namespace TrenchBroom {
         m_pattern(pattern) {}
 
         std::unique_ptr<TagMatcher> TextureNameTagMatcher::clone() const {
-            return std::make_unique<TextureNameTagMatcher>(m_pattern);
+            return std::make_unique<TextureNameTagMatcher>(m_pattern.pattern());
         }
 
         bool TextureNameTagMatcher::matches(const Taggable& taggable) const {
             BrushFaceMatchVisitor visitor([this](const BrushFace& face) {
-                return matchesTextureName(face.textureName());
+                return matchesTexture(face.textureName(), face.texture());
             });
 
             taggable.accept(visitor);
             return visitor.matches();
         }
 
+        bool TextureNameTagMatcher::matchesByTexture() const {
+            return true;
+        }
+
+        bool TextureNameTagMatcher::matchesTexture(const std::string& textureName, const Assets::Texture* /* texture */) const {
+            return matchesTextureName(textureName);
+        }
+
         void TextureNameTagMatcher::enable(TagMatcherCallback& callback, MapFacade& facade) const {
             const auto& textureManager = facade.textureManager();
             const auto& allTextures = textureManager.textures();
@@ -124,7 +132,7 @@ namespace TrenchBroom {
                 textureName = textureName.substr(pos + 1);
             }
 
-            return kdl::ci::str_matches_glob(textureName, m_pattern);
+            return m_pattern.matches(textureName);
         }
 
         SurfaceParmTagMatcher::SurfaceParmTagMatcher(const std::string& parameter) :
@@ -136,20 +144,27 @@ namespace TrenchBroom {
 
         bool SurfaceParmTagMatcher::matches(const Taggable& taggable) const {
             BrushFaceMatchVisitor visitor([this](const BrushFace& face) {
-                const auto* texture = face.texture();
-                if (texture != nullptr) {
-                    const auto& surfaceParms = texture->surfaceParms();
-                    if (surfaceParms.count(m_parameter) > 0) {
-                        return true;
-                    }
-                }
-                return false;
+                return matchesTexture(face.textureName(), face.texture());
             });
 
             taggable.accept(visitor);
             return visitor.matches();
         }
 
+        bool SurfaceParmTagMatcher::matchesByTexture() const {
+            return true;
+        }
+
+        bool SurfaceParmTagMatcher::matchesTexture(const std::string& /* textureName */, const Assets::Texture* texture) const {
+            if (texture != nullptr) {
+                const auto& surfaceParms = texture->surfaceParms();
+                if (surfaceParms.count(m_parameter) > 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
         FlagsTagMatcher::FlagsTagMatcher(const int flags, GetFlags getFlags, SetFlags setFlags, SetFlags unsetFlags, GetFlagNames getFlagNames) :
         m_flags(flags),
         m_getFlags(std::move(getFlags)),
@@ -252,7 +267,7 @@ namespace TrenchBroom {
 
 
         std::unique_ptr<TagMatcher> EntityClassNameTagMatcher::clone() const {
-            return std::make_unique<EntityClassNameTagMatcher>(m_pattern, m_texture);
+            return std::make_unique<EntityClassNameTagMatcher>(m_pattern.pattern(), m_texture);
         }
 
         bool EntityClassNameTagMatcher::matches(const Taggable& taggable) const {
@@ -341,7 +356,7 @@ namespace TrenchBroom {
         }
 
         bool EntityClassNameTagMatcher::matchesClassname(const std::string& classname) const {
-            return kdl::ci::str_matches_glob(classname, m_pattern);
+            return m_pattern.matches(classname);
         }
     }
 }
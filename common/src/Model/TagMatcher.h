@@ -23,6 +23,8 @@
 #include "Model/Tag.h"
 #include "Model/TagVisitor.h"
 
+#include <kdl/string_compare.h>
+
 #include <functional>
 #include <memory>
 #include <string>
@@ -70,12 +72,14 @@ namespace TrenchBroom {
 
         class TextureNameTagMatcher : public TagMatcher {
         private:
-            std::string m_pattern;
+            kdl::ci::glob_matcher m_pattern;
         public:
             explicit TextureNameTagMatcher(const std::string& pattern);
             std::unique_ptr<TagMatcher> clone() const override;
         public:
             bool matches(const Taggable& taggable) const override;
+            bool matchesByTexture() const override;
+            bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const override;
             void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
             bool canEnable() const override;
         private:
@@ -90,6 +94,8 @@ namespace TrenchBroom {
             std::unique_ptr<TagMatcher> clone() const override;
         private:
             bool matches(const Taggable& taggable) const override;
+            bool matchesByTexture() const override;
+            bool matchesTexture(const std::string& textureName, const Assets::Texture* texture) const override;
         };
 
         class FlagsTagMatcher : public TagMatcher {
@@ -127,7 +133,7 @@ namespace TrenchBroom {
 
         class EntityClassNameTagMatcher : public TagMatcher {
         private:
-            std::string m_pattern;
+            kdl::ci::glob_matcher m_pattern;
             /**
              * The texture to set when this tag is enabled.
              */
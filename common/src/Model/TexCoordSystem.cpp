@@ -48,6 +48,10 @@ namespace TrenchBroom {
             return doTakeSnapshot();
         }
 
+        size_t TexCoordSystem::memorySize() const {
+            return doGetMemorySize();
+        }
+
         vm::vec3 TexCoordSystem::xAxis() const {
             return getXAxis();
         }
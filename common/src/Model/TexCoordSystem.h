@@ -60,6 +60,10 @@ namespace TrenchBroom {
 
             std::unique_ptr<TexCoordSystem> clone() const;
             std::unique_ptr<TexCoordSystemSnapshot> takeSnapshot() const;
+            /**
+             * Returns the number of bytes occupied by this texture coordinate system.
+             */
+            size_t memorySize() const;
 
             vm::vec3 xAxis() const;
             vm::vec3 yAxis() const;
@@ -87,6 +91,7 @@ namespace TrenchBroom {
             virtual std::unique_ptr<TexCoordSystemSnapshot> doTakeSnapshot() const = 0;
             virtual void doRestoreSnapshot(const TexCoordSystemSnapshot& snapshot) = 0;
             friend class TexCoordSystemSnapshot;
+            virtual size_t doGetMemorySize() const = 0;
 
             virtual vm::vec3 getXAxis() const = 0;
             virtual vm::vec3 getYAxis() const = 0;
@@ -25,6 +25,7 @@
 #include "Model/AttributableNodeIndex.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
+#include "Model/CollectNodesVisitor.h"
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
 #include "Model/IssueGenerator.h"
 #include "Model/IssueGeneratorRegistry.h"
@@ -81,6 +82,17 @@ namespace TrenchBroom {
             return *m_attributableIndex;
         }
 
+        void World::pick(const std::vector<vm::ray3>& rays, std::vector<PickResult>& pickResults) {
+            assert(rays.size() == pickResults.size());
+
+            const auto intersectors = m_nodeTree->findIntersectors(rays);
+            for (size_t i = 0; i < rays.size(); ++i) {
+                for (auto* node : intersectors[i]) {
+                    node->pick(rays[i], pickResults[i]);
+                }
+            }
+        }
+
         const std::vector<IssueGenerator*>& World::registeredIssueGenerators() const {
             return m_issueGeneratorRegistry->registeredGenerators();
         }
@@ -99,6 +111,12 @@ namespace TrenchBroom {
             invalidateAllIssues();
         }
 
+        void World::validateAllIssues() {
+            CollectNodesVisitor visitor;
+            acceptAndRecurse(visitor);
+            Node::validateIssues(visitor.nodes(), registeredIssueGenerators());
+        }
+
         class World::AddNodeToNodeTree : public NodeVisitor {
         private:
             NodeTree& m_nodeTree;
@@ -168,7 +186,14 @@ namespace TrenchBroom {
             CollectTreeNodes collect;
             acceptAndRecurse(collect);
 
-            m_nodeTree->clearAndBuild(collect.nodes(), [](const auto* node){ return node->physicalBounds(); });
+            m_nodeTree->build(collect.nodes(), [](const auto* node){ return node->physicalBounds(); });
+        }
+
+        bool World::shouldRebuildNodeTree(const size_t nodeCount) const {
+            // bulk loading is several times faster than inserting, so rebuilding pays off once the number of new
+            // nodes is a sizeable fraction of the existing nodes
+            static const size_t MinNodeCount = 1024u;
+            return nodeCount >= MinNodeCount && nodeCount >= familySize() / 4u;
         }
 
         class World::InvalidateAllIssuesVisitor : public NodeVisitor {
@@ -61,12 +61,29 @@ namespace TrenchBroom {
             void createDefaultLayer();
         public: // index
             const AttributableNodeIndex& attributableNodeIndex() const;
+        public: // picking
+            using Node::pick;
+
+            /**
+             * Picks the given rays at once. This is faster than picking the rays one by one if the rays are coherent,
+             * e.g. if they are cast through adjacent pixels of a viewport.
+             *
+             * @param rays the rays to pick
+             * @param pickResults the pick results, one for each ray; must have the same size as the given rays
+             */
+            void pick(const std::vector<vm::ray3>& rays, std::vector<PickResult>& pickResults);
         public: // selection
             // issue generator registration
             const std::vector<IssueGenerator*>& registeredIssueGenerators() const;
             std::vector<IssueQuickFix*> quickFixes(IssueType issueTypes) const;
             void registerIssueGenerator(IssueGenerator* issueGenerator);
             void unregisterAllIssueGenerators();
+
+            /**
+             * Validates the issues of every node of this world whose issues are invalid, using the registered issue
+             * generators. Most generators run for several nodes in parallel, see Node::validateIssues.
+             */
+            void validateAllIssues();
         private:
             class AddNodeToNodeTree;
             class RemoveNodeFromNodeTree;
@@ -76,6 +93,12 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+
+            /**
+             * Indicates whether it is faster to rebuild the node tree than to insert the given number of nodes into
+             * it one by one.
+             */
+            bool shouldRebuildNodeTree(size_t nodeCount) const;
         private:
             class InvalidateAllIssuesVisitor;
             void invalidateAllIssues();
@@ -60,7 +60,7 @@ namespace TrenchBroom {
         const IssueType WorldBoundsIssueGenerator::WorldBoundsIssue::Type = Issue::freeType();
 
         WorldBoundsIssueGenerator::WorldBoundsIssueGenerator(const vm::bbox3& bounds) :
-        IssueGenerator(WorldBoundsIssue::Type, "Objects out of world bounds"),
+        IssueGenerator(WorldBoundsIssue::Type, "Objects out of world bounds", IssueDependency::Attributes | IssueDependency::Geometry | IssueDependency::Children, true),
         m_bounds(bounds) {
             addQuickFix(new WorldBoundsIssueQuickFix());
         }
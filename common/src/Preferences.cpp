@@ -120,6 +120,13 @@ namespace TrenchBroom {
 
         Preference<int> TextureMinFilter(IO::Path("Renderer/Texture mode min filter"), 0x2700);
         Preference<int> TextureMagFilter(IO::Path("Renderer/Texture mode mag filter"), 0x2600);
+        // in megabytes
+        Preference<int> TextureMemoryBudget(IO::Path("Renderer/Texture memory budget"), 512);
+        // in megabytes, 0 disables the cache
+        Preference<int> TextureCacheSize(IO::Path("Renderer/Texture cache size"), 256);
+
+        // in megabytes
+        Preference<int> UndoMemoryBudget(IO::Path("Editor/Undo memory budget"), 1024);
 
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
@@ -247,6 +254,9 @@ namespace TrenchBroom {
                 &GridColor2D,
                 &TextureMinFilter,
                 &TextureMagFilter,
+                &TextureMemoryBudget,
+                &TextureCacheSize,
+                &UndoMemoryBudget,
                 &TextureLock,
                 &UVLock,
                 &RendererFontPath(),
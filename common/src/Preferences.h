@@ -116,6 +116,10 @@ namespace TrenchBroom {
 
         extern Preference<int> TextureMinFilter;
         extern Preference<int> TextureMagFilter;
+        extern Preference<int> TextureMemoryBudget;
+        extern Preference<int> TextureCacheSize;
+
+        extern Preference<int> UndoMemoryBudget;
 
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
@@ -0,0 +1,374 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRENCHBROOM_RAYBOXBATCH_H
+#define TRENCHBROOM_RAYBOXBATCH_H
+
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX__)
+#define TB_RAY_BOX_BATCH_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TB_RAY_BOX_BATCH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace TrenchBroom {
+    /**
+     * The bounds of a batch of up to Width boxes in single precision. The bounds are stored as a structure of arrays
+     * so that a ray can be tested against all boxes of the batch at once.
+     *
+     * @tparam S the number of dimensions
+     */
+    template <size_t S>
+    struct BoxBatch {
+        static constexpr size_t Width = 4;
+
+        alignas(16) float min[S][Width];
+        alignas(16) float max[S][Width];
+    };
+
+    /**
+     * The bounds of a batch of boxes converted to double precision. Testing many rays against the same batch is
+     * faster if the batch is converted once up front.
+     *
+     * @tparam S the number of dimensions
+     */
+    template <size_t S>
+    struct WideBoxBatch {
+        static constexpr size_t Width = BoxBatch<S>::Width;
+
+        alignas(32) double min[S][Width];
+        alignas(32) double max[S][Width];
+
+        explicit WideBoxBatch(const BoxBatch<S>& boxes) {
+            for (size_t i = 0u; i < S; ++i) {
+                for (size_t j = 0u; j < Width; ++j) {
+                    min[i][j] = static_cast<double>(boxes.min[i][j]);
+                    max[i][j] = static_cast<double>(boxes.max[i][j]);
+                }
+            }
+        }
+    };
+
+    /**
+     * Tests a ray against batches of boxes using the slab method.
+     *
+     * The reciprocal of the ray direction is computed once when the test is created, and axes to which the ray is
+     * parallel are handled separately so that no NaN values can occur. The computations are done in the ray's
+     * precision. If T is double and SSE2 or AVX is available at compile time, all boxes of a batch are tested at once
+     * using SIMD instructions, otherwise the boxes are tested one by one. Both paths produce identical results.
+     *
+     * @tparam T the floating point type of the ray
+     * @tparam S the number of dimensions
+     */
+    template <typename T, size_t S>
+    class RayBoxBatchTest {
+    private:
+        using Batch = BoxBatch<S>;
+        using WideBatch = WideBoxBatch<S>;
+        static constexpr unsigned AllBoxes = (1u << Batch::Width) - 1u;
+
+        vm::vec<T,S> m_origin;
+        vm::vec<T,S> m_invDirection;
+        bool m_parallel[S];
+    public:
+        explicit RayBoxBatchTest(const vm::ray<T,S>& ray) :
+        m_origin(ray.origin) {
+            for (size_t i = 0u; i < S; ++i) {
+                m_parallel[i] = ray.direction[i] == static_cast<T>(0);
+                m_invDirection[i] = m_parallel[i] ? static_cast<T>(0) : static_cast<T>(1) / ray.direction[i];
+            }
+        }
+
+        /**
+         * Tests the ray against the boxes of the given batch.
+         *
+         * @param boxes the boxes to test
+         * @return a bit mask where bit i is set if the ray hits box i or if its origin is contained in box i
+         */
+        unsigned test(const Batch& boxes) const {
+#if defined(TB_RAY_BOX_BATCH_AVX) || defined(TB_RAY_BOX_BATCH_SSE2)
+            if constexpr (std::is_same_v<T, double>) {
+                return testSimd(boxes);
+            }
+#endif
+            return testScalar(boxes);
+        }
+
+        /**
+         * Tests the ray against the given boxes that were converted to double precision. The result is the same as
+         * if the ray was tested against the original boxes.
+         *
+         * @param boxes the boxes to test
+         * @return a bit mask where bit i is set if the ray hits box i or if its origin is contained in box i
+         */
+        unsigned test(const WideBatch& boxes) const {
+#if defined(TB_RAY_BOX_BATCH_AVX) || defined(TB_RAY_BOX_BATCH_SSE2)
+            if constexpr (std::is_same_v<T, double>) {
+                return testSimd(boxes);
+            }
+#endif
+            return testScalar(boxes);
+        }
+
+        /**
+         * Tests the ray against the boxes of the given batch one by one.
+         *
+         * @param boxes the boxes to test
+         * @return a bit mask where bit i is set if the ray hits box i or if its origin is contained in box i
+         */
+        template <typename B>
+        unsigned testScalar(const B& boxes) const {
+            unsigned result = 0u;
+            for (size_t j = 0u; j < Batch::Width; ++j) {
+                if (testScalar(boxes, j)) {
+                    result |= 1u << j;
+                }
+            }
+            return result;
+        }
+    private:
+        template <typename B>
+        bool testScalar(const B& boxes, const size_t j) const {
+            auto tMin = static_cast<T>(0);
+            auto tMax = std::numeric_limits<T>::max();
+            for (size_t i = 0u; i < S; ++i) {
+                const auto min = static_cast<T>(boxes.min[i][j]);
+                const auto max = static_cast<T>(boxes.max[i][j]);
+                if (m_parallel[i]) {
+                    if (m_origin[i] < min || m_origin[i] > max) {
+                        return false;
+                    }
+                } else {
+                    const auto t1 = (min - m_origin[i]) * m_invDirection[i];
+                    const auto t2 = (max - m_origin[i]) * m_invDirection[i];
+                    tMin = std::max(tMin, std::min(t1, t2));
+                    tMax = std::min(tMax, std::max(t1, t2));
+                }
+            }
+            return tMin <= tMax;
+        }
+
+#if defined(TB_RAY_BOX_BATCH_AVX)
+        unsigned testSimd(const Batch& boxes) const {
+            return testSimd([&](const size_t i, __m256d& min, __m256d& max) {
+                min = _mm256_cvtps_pd(_mm_load_ps(boxes.min[i]));
+                max = _mm256_cvtps_pd(_mm_load_ps(boxes.max[i]));
+            });
+        }
+
+        unsigned testSimd(const WideBatch& boxes) const {
+            return testSimd([&](const size_t i, __m256d& min, __m256d& max) {
+                min = _mm256_load_pd(boxes.min[i]);
+                max = _mm256_load_pd(boxes.max[i]);
+            });
+        }
+
+        template <typename Load>
+        unsigned testSimd(const Load& load) const {
+            auto tMin = _mm256_setzero_pd();
+            auto tMax = _mm256_set1_pd(std::numeric_limits<double>::max());
+            auto result = AllBoxes;
+
+            for (size_t i = 0u; i < S; ++i) {
+                __m256d min, max;
+                load(i, min, max);
+
+                const auto origin = _mm256_set1_pd(m_origin[i]);
+                if (m_parallel[i]) {
+                    const auto inside = _mm256_and_pd(_mm256_cmp_pd(origin, min, _CMP_GE_OQ), _mm256_cmp_pd(origin, max, _CMP_LE_OQ));
+                    result &= static_cast<unsigned>(_mm256_movemask_pd(inside));
+                } else {
+                    const auto invDirection = _mm256_set1_pd(m_invDirection[i]);
+                    const auto t1 = _mm256_mul_pd(_mm256_sub_pd(min, origin), invDirection);
+                    const auto t2 = _mm256_mul_pd(_mm256_sub_pd(max, origin), invDirection);
+                    tMin = _mm256_max_pd(tMin, _mm256_min_pd(t1, t2));
+                    tMax = _mm256_min_pd(tMax, _mm256_max_pd(t1, t2));
+                }
+            }
+
+            return result & static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(tMin, tMax, _CMP_LE_OQ)));
+        }
+#elif defined(TB_RAY_BOX_BATCH_SSE2)
+        unsigned testSimd(const Batch& boxes) const {
+            return testSimd([&](const size_t i, __m128d* min, __m128d* max) {
+                const auto minPs = _mm_load_ps(boxes.min[i]);
+                const auto maxPs = _mm_load_ps(boxes.max[i]);
+                min[0] = _mm_cvtps_pd(minPs);
+                min[1] = _mm_cvtps_pd(_mm_movehl_ps(minPs, minPs));
+                max[0] = _mm_cvtps_pd(maxPs);
+                max[1] = _mm_cvtps_pd(_mm_movehl_ps(maxPs, maxPs));
+            });
+        }
+
+        unsigned testSimd(const WideBatch& boxes) const {
+            return testSimd([&](const size_t i, __m128d* min, __m128d* max) {
+                min[0] = _mm_load_pd(boxes.min[i]);
+                min[1] = _mm_load_pd(boxes.min[i] + 2);
+                max[0] = _mm_load_pd(boxes.max[i]);
+                max[1] = _mm_load_pd(boxes.max[i] + 2);
+            });
+        }
+
+        template <typename Load>
+        unsigned testSimd(const Load& load) const {
+            // the four boxes are processed in two halves of two boxes each
+            __m128d tMin[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+            __m128d tMax[2] = { _mm_set1_pd(std::numeric_limits<double>::max()), _mm_set1_pd(std::numeric_limits<double>::max()) };
+            auto result = AllBoxes;
+
+            for (size_t i = 0u; i < S; ++i) {
+                __m128d min[2], max[2];
+                load(i, min, max);
+
+                const auto origin = _mm_set1_pd(m_origin[i]);
+                if (m_parallel[i]) {
+                    const auto insideLo = _mm_and_pd(_mm_cmpge_pd(origin, min[0]), _mm_cmple_pd(origin, max[0]));
+                    const auto insideHi = _mm_and_pd(_mm_cmpge_pd(origin, min[1]), _mm_cmple_pd(origin, max[1]));
+                    result &= static_cast<unsigned>(_mm_movemask_pd(insideLo) | (_mm_movemask_pd(insideHi) << 2));
+                } else {
+                    const auto invDirection = _mm_set1_pd(m_invDirection[i]);
+                    for (size_t k = 0u; k < 2u; ++k) {
+                        const auto t1 = _mm_mul_pd(_mm_sub_pd(min[k], origin), invDirection);
+                        const auto t2 = _mm_mul_pd(_mm_sub_pd(max[k], origin), invDirection);
+                        tMin[k] = _mm_max_pd(tMin[k], _mm_min_pd(t1, t2));
+                        tMax[k] = _mm_min_pd(tMax[k], _mm_max_pd(t1, t2));
+                    }
+                }
+            }
+
+            const auto hitLo = _mm_movemask_pd(_mm_cmple_pd(tMin[0], tMax[0]));
+            const auto hitHi = _mm_movemask_pd(_mm_cmple_pd(tMin[1], tMax[1]));
+            return result & static_cast<unsigned>(hitLo | (hitHi << 2));
+        }
+#endif
+    };
+
+    /**
+     * Conservatively tests a packet of rays against batches of boxes. If the test reports that a box is missed, then
+     * every ray of the packet misses the box according to RayBoxBatchTest. The converse does not hold, so a box that
+     * is reported as hit may still be missed by all rays.
+     *
+     * The test bounds the origins and the reciprocal directions of the rays by intervals and performs the slab test
+     * using interval arithmetic. If the rays do not all point in the same direction along an axis, or if any ray is
+     * parallel to an axis, no box is ever reported as missed.
+     *
+     * @tparam T the floating point type of the rays
+     * @tparam S the number of dimensions
+     */
+    template <typename T, size_t S>
+    class RayPacketBoxBatchTest {
+    private:
+        using Batch = BoxBatch<S>;
+        static constexpr unsigned AllBoxes = (1u << Batch::Width) - 1u;
+
+        // the bounds are mirrored along axes where the rays point in negative direction
+        bool m_negative[S];
+        vm::vec<T,S> m_originMin;
+        vm::vec<T,S> m_originMax;
+        vm::vec<T,S> m_invDirectionMin;
+        vm::vec<T,S> m_invDirectionMax;
+        bool m_valid;
+    public:
+        /**
+         * Creates a test for the rays in the given range, which must not be empty.
+         */
+        template <typename I>
+        RayPacketBoxBatchTest(I cur, I end) :
+        m_valid(true) {
+            assert(cur != end);
+            for (size_t i = 0u; i < S; ++i) {
+                m_negative[i] = cur->direction[i] < static_cast<T>(0);
+                m_originMin[i] = m_originMax[i] = flip(i, cur->origin[i]);
+                m_invDirectionMin[i] = std::numeric_limits<T>::max();
+                m_invDirectionMax[i] = static_cast<T>(0);
+            }
+
+            for (; cur != end && m_valid; ++cur) {
+                const auto& ray = *cur;
+                for (size_t i = 0u; i < S; ++i) {
+                    const auto direction = flip(i, ray.direction[i]);
+                    if (!(direction > static_cast<T>(0))) {
+                        m_valid = false;
+                        break;
+                    }
+
+                    // must be computed like in RayBoxBatchTest to obtain the same rounding
+                    const auto invDirection = flip(i, static_cast<T>(1) / ray.direction[i]);
+                    const auto origin = flip(i, ray.origin[i]);
+                    m_originMin[i] = std::min(m_originMin[i], origin);
+                    m_originMax[i] = std::max(m_originMax[i], origin);
+                    m_invDirectionMin[i] = std::min(m_invDirectionMin[i], invDirection);
+                    m_invDirectionMax[i] = std::max(m_invDirectionMax[i], invDirection);
+                }
+            }
+        }
+
+        /**
+         * Tests the rays against the boxes of the given batch.
+         *
+         * @param boxes the boxes to test
+         * @return a bit mask where bit i is cleared if all rays miss box i
+         */
+        unsigned test(const Batch& boxes) const {
+            if (!m_valid) {
+                return AllBoxes;
+            }
+
+            unsigned result = 0u;
+            for (size_t j = 0u; j < Batch::Width; ++j) {
+                if (test(boxes, j)) {
+                    result |= 1u << j;
+                }
+            }
+            return result;
+        }
+    private:
+        T flip(const size_t i, const T value) const {
+            return m_negative[i] ? -value : value;
+        }
+
+        bool test(const Batch& boxes, const size_t j) const {
+            // lower bound of the entry distance and upper bound of the exit distance of all rays
+            auto tMin = static_cast<T>(0);
+            auto tMax = std::numeric_limits<T>::max();
+            for (size_t i = 0u; i < S; ++i) {
+                const auto nearBound = m_negative[i] ? -static_cast<T>(boxes.max[i][j]) : static_cast<T>(boxes.min[i][j]);
+                const auto farBound = m_negative[i] ? -static_cast<T>(boxes.min[i][j]) : static_cast<T>(boxes.max[i][j]);
+
+                const auto nearDistance = nearBound - m_originMax[i];
+                const auto farDistance = farBound - m_originMin[i];
+                tMin = std::max(tMin, nearDistance * (nearDistance >= static_cast<T>(0) ? m_invDirectionMin[i] : m_invDirectionMax[i]));
+                tMax = std::min(tMax, farDistance * (farDistance >= static_cast<T>(0) ? m_invDirectionMax[i] : m_invDirectionMin[i]));
+            }
+            return tMin <= tMax;
+        }
+    };
+}
+
+#endif //TRENCHBROOM_RAYBOXBATCH_H
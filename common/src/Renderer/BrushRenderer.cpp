@@ -28,10 +28,16 @@
 #include "Model/TagAttribute.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/Frustum.h"
 #include "Renderer/RenderContext.h"
 
+#include <kdl/parallel.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -109,6 +115,17 @@ namespace TrenchBroom {
                                    EdgeRenderPolicy::RenderAll);
         }
 
+        // BrushRenderer::Cluster
+
+        BrushRenderer::Cluster::Cluster(std::shared_ptr<BrushVertexArray> vertexArray, const Color& faceColor) :
+        brushCount(0),
+        edgeIndices(std::make_shared<BrushIndexArray>()),
+        transparentFaces(std::make_shared<TextureToBrushIndicesMap>()),
+        opaqueFaces(std::make_shared<TextureToBrushIndicesMap>()),
+        opaqueFaceRenderer(vertexArray, opaqueFaces, faceColor),
+        transparentFaceRenderer(vertexArray, transparentFaces, faceColor),
+        edgeRenderer(vertexArray, edgeIndices) {}
+
         // BrushRenderer
 
         BrushRenderer::BrushRenderer() :
@@ -158,8 +175,9 @@ namespace TrenchBroom {
             m_invalidBrushes = m_allBrushes;
 
             assert(m_brushInfo.empty());
-            assert(m_transparentFaces->empty());
-            assert(m_opaqueFaces->empty());
+            assert(std::all_of(std::begin(m_clusters), std::end(m_clusters), [](const auto& entry) {
+                return entry.second->transparentFaces->empty() && entry.second->opaqueFaces->empty();
+            }));
         }
 
         void BrushRenderer::invalidateBrushes(const std::vector<Model::Brush*>& brushes) {
@@ -170,10 +188,9 @@ namespace TrenchBroom {
                     assert(m_invalidBrushes.find(brush) == std::end(m_invalidBrushes));
                     continue;
                 }
-                // if it's not in the invalid set, put it in
-                if (m_invalidBrushes.insert(brush).second) {
-                    removeBrushFromVbo(brush);
-                }
+                // if it's not in the invalid set, put it in. The brush keeps its VBO blocks so that validateBrush
+                // can overwrite them in place if its layout did not change.
+                m_invalidBrushes.insert(brush);
             }
         }
 
@@ -187,17 +204,18 @@ namespace TrenchBroom {
             m_invalidBrushes.clear();
 
             m_vertexArray = std::make_shared<BrushVertexArray>();
-            m_edgeIndices = std::make_shared<BrushIndexArray>();
-            m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
-            m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_clusters.clear();
+            m_visibleClusters.clear();
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
-            m_faceColor = faceColor;
+            if (faceColor != m_faceColor) {
+                m_faceColor = faceColor;
+                for (auto& [key, cluster] : m_clusters) {
+                    cluster->opaqueFaceRenderer = FaceRenderer(m_vertexArray, cluster->opaqueFaces, m_faceColor);
+                    cluster->transparentFaceRenderer = FaceRenderer(m_vertexArray, cluster->transparentFaces, m_faceColor);
+                }
+            }
         }
 
         void BrushRenderer::setShowEdges(const bool showEdges) {
@@ -259,6 +277,7 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                cull(Frustum(renderContext.camera()));
                 if (renderContext.showFaces()) {
                     renderOpaqueFaces(renderBatch);
                 }
@@ -273,6 +292,7 @@ namespace TrenchBroom {
                 if (!valid()) {
                     validate();
                 }
+                cull(Frustum(renderContext.camera()));
                 if (renderContext.showFaces()) {
                     renderTransparentFaces(renderBatch);
                 }
@@ -280,25 +300,44 @@ namespace TrenchBroom {
         }
 
         void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
-            m_opaqueFaceRenderer.setGrayscale(m_grayscale);
-            m_opaqueFaceRenderer.setTint(m_tint);
-            m_opaqueFaceRenderer.setTintColor(m_tintColor);
-            m_opaqueFaceRenderer.render(renderBatch);
+            for (auto* cluster : m_visibleClusters) {
+                if (!cluster->opaqueFaces->empty()) {
+                    auto& faceRenderer = cluster->opaqueFaceRenderer;
+                    faceRenderer.setGrayscale(m_grayscale);
+                    faceRenderer.setTint(m_tint);
+                    faceRenderer.setTintColor(m_tintColor);
+                    faceRenderer.render(renderBatch);
+                }
+            }
         }
 
         void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch) {
-            m_transparentFaceRenderer.setGrayscale(m_grayscale);
-            m_transparentFaceRenderer.setTint(m_tint);
-            m_transparentFaceRenderer.setTintColor(m_tintColor);
-            m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
-            m_transparentFaceRenderer.render(renderBatch);
+            for (auto* cluster : m_visibleClusters) {
+                if (!cluster->transparentFaces->empty()) {
+                    auto& faceRenderer = cluster->transparentFaceRenderer;
+                    faceRenderer.setGrayscale(m_grayscale);
+                    faceRenderer.setTint(m_tint);
+                    faceRenderer.setTintColor(m_tintColor);
+                    faceRenderer.setAlpha(m_transparencyAlpha);
+                    faceRenderer.render(renderBatch);
+                }
+            }
         }
 
         void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
+            // render all occluded edges before any visible edges, as if there was just one edge renderer
             if (m_showOccludedEdges) {
-                m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+                for (auto* cluster : m_visibleClusters) {
+                    if (cluster->edgeIndices->hasValidIndices()) {
+                        cluster->edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+                    }
+                }
+            }
+            for (auto* cluster : m_visibleClusters) {
+                if (cluster->edgeIndices->hasValidIndices()) {
+                    cluster->edgeRenderer.render(renderBatch, m_edgeColor);
+                }
             }
-            m_edgeRenderer.render(renderBatch, m_edgeColor);
         }
 
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
@@ -324,20 +363,6 @@ namespace TrenchBroom {
             }
         };
 
-        void BrushRenderer::validate() {
-            assert(!valid());
-
-            for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
-            }
-            m_invalidBrushes.clear();
-            assert(valid());
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
-        }
-
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
             assert(vertexCount >= 3);
             const size_t indexCount = 3 * (vertexCount - 2);
@@ -424,56 +449,118 @@ namespace TrenchBroom {
             return false;
         }
 
-        void BrushRenderer::validateBrush(const Model::Brush* brush) {
-            assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
-            assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
-            assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
+        /**
+         * Returns the number of threads to use for validating the given number of brushes. Small batches, such as the
+         * brushes touched by a single edit, are validated on the calling thread.
+         */
+        static size_t validateThreadCount(const size_t brushCount, const size_t maxThreadCount) {
+            static constexpr size_t MinBrushesPerThread = 256;
+            return std::max(std::min(maxThreadCount, brushCount / MinBrushesPerThread), size_t(1));
+        }
+
+        void BrushRenderer::validate() {
+            validate(kdl::parallel_default_thread_count());
+        }
+
+        void BrushRenderer::validate(const size_t maxThreadCount) {
+            assert(!valid());
+
+            const auto brushes = std::vector<const Model::Brush*>(std::begin(m_invalidBrushes), std::end(m_invalidBrushes));
+            const auto threadCount = validateThreadCount(brushes.size(), maxThreadCount);
+
+            // Evaluating the filter and building the vertex cache only touch the brush itself, so we can do this
+            // concurrently.
+            const auto settings = kdl::vec_parallel_transform(brushes, [&](const Model::Brush* brush) {
+                return prepareBrush(brush);
+            }, threadCount);
+
+            // Allocating VBO blocks modifies the arrays, so this must be done serially. Afterwards, every brush owns
+            // disjoint blocks which we can fill concurrently.
+            std::vector<size_t> pendingBrushes;
+            std::vector<const BrushInfo*> pendingInfos;
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if (const auto* info = validateBrush(brushes[i], settings[i])) {
+                    pendingBrushes.push_back(i);
+                    pendingInfos.push_back(info);
+                }
+            }
+
+            kdl::parallel_for(pendingBrushes.size(), [&](const size_t i) {
+                const auto index = pendingBrushes[i];
+                writeBrush(brushes[index], std::get<1>(settings[index]), *pendingInfos[i]);
+            }, threadCount);
 
+            m_invalidBrushes.clear();
+            assert(valid());
+        }
+
+        BrushRenderer::Filter::RenderSettings BrushRenderer::prepareBrush(const Model::Brush* brush) const {
             const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
 
             // evaluate filter. only evaluate the filter once per brush.
             const auto settings = wrapper.markFaces(brush);
             const auto [facePolicy, edgePolicy] = settings;
 
+            if (facePolicy != Filter::FaceRenderPolicy::RenderNone ||
+                edgePolicy != Filter::EdgeRenderPolicy::RenderNone) {
+                auto& brushCache = brush->brushRendererBrushCache();
+                brushCache.validateVertexCache(brush);
+                ensure(!brushCache.cachedVertices().empty(), "Brush must have cached vertices");
+            }
+
+            return settings;
+        }
+
+        BrushRenderer::BrushInfo* BrushRenderer::validateBrush(const Model::Brush* brush, const Filter::RenderSettings& settings) {
+            assert(m_allBrushes.find(brush) != std::end(m_allBrushes));
+            assert(m_invalidBrushes.find(brush) != std::end(m_invalidBrushes));
+
+            const auto [facePolicy, edgePolicy] = settings;
+
             if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
                 edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
-                // NOTE: this skips inserting the brush into m_brushInfo
-                return;
+                // NOTE: this skips inserting the brush into m_brushInfo, and frees its blocks if it was in the VBO
+                removeBrushFromVbo(brush);
+                return nullptr;
+            }
+
+            const auto bounds = vm::bbox3f(brush->logicalBounds());
+            auto& cluster = findOrCreateCluster(brush->logicalBounds());
+
+            const auto it = m_brushInfo.find(brush);
+            if (it != std::end(m_brushInfo)) {
+                if (it->second.cluster == &cluster && updateBrushInVbo(brush, edgePolicy, it->second)) {
+                    cluster.bounds = vm::merge(cluster.bounds, bounds);
+                    return nullptr;
+                }
+                removeBrushFromVbo(brush);
             }
 
             BrushInfo& info = m_brushInfo[brush];
+            info.cluster = &cluster;
+            cluster.bounds = cluster.brushCount == 0 ? bounds : vm::merge(cluster.bounds, bounds);
+            ++cluster.brushCount;
 
-            // collect vertices
-            auto& brushCache = brush->brushRendererBrushCache();
-            brushCache.validateVertexCache(brush);
-            const auto& cachedVertices = brushCache.cachedVertices();
-            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+            const auto& brushCache = brush->brushRendererBrushCache();
 
+            // allocate vertices
             assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-            std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-            info.vertexHolderKey = vertBlock;
-
-            const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
-
-            // insert edge indices into VBO
-            {
-                const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
-                if (edgeIndexCount > 0) {
-                    auto [key, insertDest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-                    info.edgeIndicesKey = key;
-                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, insertDest);
-                } else {
-                    // it's possible to have no edges to render
-                    // e.g. select all faces of a brush, and the unselected brush renderer
-                    // will hit this branch.
-                    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
-                }
+            info.vertexHolderKey = m_vertexArray->allocateVertices(brushCache.cachedVertices().size());
+
+            // allocate edge indices
+            const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
+            if (edgeIndexCount > 0) {
+                info.edgeIndicesKey = cluster.edgeIndices->allocateElements(edgeIndexCount);
+            } else {
+                // it's possible to have no edges to render
+                // e.g. select all faces of a brush, and the unselected brush renderer
+                // will hit this branch.
+                ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
             }
 
-            // insert face indices
+            // allocate face indices
 
-            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
             const size_t facesSortedByTexSize = facesSortedByTex.size();
 
             size_t nextI;
@@ -500,59 +587,176 @@ namespace TrenchBroom {
                 }
 
                 if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
+                    TextureToBrushIndicesMap& faceVboMap = *cluster.transparentFaces;
                     auto& holderPtr = faceVboMap[texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
                         holderPtr = std::make_shared<BrushIndexArray>();
                     }
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-                    info.transparentFaceIndicesKeys.push_back({texture, key});
-
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && shouldDrawFaceInTransparentPass(brush, cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
-
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
-                    assert(currentDest == (insertDest + transparentIndexCount));
+                    info.transparentFaceIndicesKeys.push_back({texture, holderPtr->allocateElements(transparentIndexCount)});
                 }
 
                 if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
+                    TextureToBrushIndicesMap& faceVboMap = *cluster.opaqueFaces;
                     auto& holderPtr = faceVboMap[texture];
                     if (holderPtr == nullptr) {
                         // inserts into map!
                         holderPtr = std::make_shared<BrushIndexArray>();
                     }
 
-                    auto [key, insertDest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-                    info.opaqueFaceIndicesKeys.push_back({texture, key});
+                    info.opaqueFaceIndicesKeys.push_back({texture, holderPtr->allocateElements(opaqueIndexCount)});
+                }
+            }
+
+            return &info;
+        }
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = insertDest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && !shouldDrawFaceInTransparentPass(brush, cache.face)) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+        void BrushRenderer::writeBrush(const Model::Brush* brush, const Filter::EdgeRenderPolicy edgePolicy, const BrushInfo& info) const {
+            const auto& brushCache = brush->brushRendererBrushCache();
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
+            // write vertices
+            const auto& cachedVertices = brushCache.cachedVertices();
+            auto* vertexDest = m_vertexArray->getPointerToVerticesWithKey(info.vertexHolderKey);
+            std::memcpy(vertexDest, cachedVertices.data(), cachedVertices.size() * sizeof(*vertexDest));
+
+            const auto brushVerticesStartIndex = static_cast<GLuint>(info.vertexHolderKey->pos);
+
+            // write edge indices
+            if (info.edgeIndicesKey != nullptr) {
+                getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, info.cluster->edgeIndices->getPointerToElementsWithKey(info.edgeIndicesKey));
+            }
+
+            // write face indices, visiting the textures in the same order in which validateBrush allocated the blocks
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            const size_t facesSortedByTexSize = facesSortedByTex.size();
+
+            auto nextOpaqueKey = std::begin(info.opaqueFaceIndicesKeys);
+            auto nextTransparentKey = std::begin(info.transparentFaceIndicesKeys);
+
+            size_t nextI;
+            for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
+                const Assets::Texture* texture = facesSortedByTex[i].texture;
+
+                // find the i value for the next texture
+                for (nextI = i + 1; nextI < facesSortedByTexSize && facesSortedByTex[nextI].texture == texture; ++nextI) {}
+
+                GLuint* opaqueDest = nullptr;
+                if (nextOpaqueKey != std::end(info.opaqueFaceIndicesKeys) && nextOpaqueKey->first == texture) {
+                    opaqueDest = info.cluster->opaqueFaces->at(texture)->getPointerToElementsWithKey(nextOpaqueKey->second);
+                    ++nextOpaqueKey;
+                }
+
+                GLuint* transparentDest = nullptr;
+                if (nextTransparentKey != std::end(info.transparentFaceIndicesKeys) && nextTransparentKey->first == texture) {
+                    transparentDest = info.cluster->transparentFaces->at(texture)->getPointerToElementsWithKey(nextTransparentKey->second);
+                    ++nextTransparentKey;
+                }
+
+                // process all faces with this texture (they'll be consecutive)
+                for (size_t j = i; j < nextI; ++j) {
+                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
+                    if (cache.face->isMarked()) {
+                        GLuint*& currentDest = shouldDrawFaceInTransparentPass(brush, cache.face) ? transparentDest : opaqueDest;
+                        assert(currentDest != nullptr);
+
+                        addTriIndicesForPolygon(currentDest,
+                                                static_cast<GLuint>(brushVerticesStartIndex +
+                                                                    cache.indexOfFirstVertexRelativeToBrush),
+                                                cache.vertexCount);
+
+                        currentDest += triIndicesCountForPolygon(cache.vertexCount);
                     }
-                    assert(currentDest == (insertDest + opaqueIndexCount));
                 }
             }
+
+            assert(nextOpaqueKey == std::end(info.opaqueFaceIndicesKeys));
+            assert(nextTransparentKey == std::end(info.transparentFaceIndicesKeys));
+        }
+
+        bool BrushRenderer::updateBrushInVbo(const Model::Brush* brush, const Filter::EdgeRenderPolicy edgePolicy, BrushInfo& info) {
+            const auto& brushCache = brush->brushRendererBrushCache();
+            const auto& cachedVertices = brushCache.cachedVertices();
+            if (cachedVertices.size() != info.vertexHolderKey->size) {
+                return false;
+            }
+
+            const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
+            const size_t oldEdgeIndexCount = info.edgeIndicesKey != nullptr ? info.edgeIndicesKey->size : 0u;
+            if (edgeIndexCount != oldEdgeIndexCount) {
+                return false;
+            }
+
+            // Collect the face indices per texture in the same order in which validateBrush allocates their blocks.
+            // The vertices keep their position in the VBO, so the indices can be computed before we know whether
+            // the blocks can be reused.
+            const auto brushVerticesStartIndex = static_cast<GLuint>(info.vertexHolderKey->pos);
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            const size_t facesSortedByTexSize = facesSortedByTex.size();
+
+            using TextureIndices = std::pair<const Assets::Texture*, std::vector<GLuint>>;
+            std::vector<TextureIndices> opaqueIndices;
+            std::vector<TextureIndices> transparentIndices;
+
+            size_t nextI;
+            for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
+                const Assets::Texture* texture = facesSortedByTex[i].texture;
+
+                std::vector<GLuint> opaque;
+                std::vector<GLuint> transparent;
+
+                for (nextI = i; nextI < facesSortedByTexSize && facesSortedByTex[nextI].texture == texture; ++nextI) {
+                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[nextI];
+                    if (cache.face->isMarked()) {
+                        auto& indices = shouldDrawFaceInTransparentPass(brush, cache.face) ? transparent : opaque;
+                        const auto offset = indices.size();
+                        indices.resize(offset + triIndicesCountForPolygon(cache.vertexCount));
+                        addTriIndicesForPolygon(indices.data() + offset,
+                                                static_cast<GLuint>(brushVerticesStartIndex +
+                                                                    cache.indexOfFirstVertexRelativeToBrush),
+                                                cache.vertexCount);
+                    }
+                }
+
+                if (!transparent.empty()) {
+                    transparentIndices.emplace_back(texture, std::move(transparent));
+                }
+                if (!opaque.empty()) {
+                    opaqueIndices.emplace_back(texture, std::move(opaque));
+                }
+            }
+
+            const auto sameBlocks = [](const std::vector<TextureIndices>& indices, const std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>>& keys) {
+                return std::equal(std::begin(indices), std::end(indices), std::begin(keys), std::end(keys), [](const auto& lhs, const auto& rhs) {
+                    return lhs.first == rhs.first && lhs.second.size() == rhs.second->size;
+                });
+            };
+
+            if (!sameBlocks(opaqueIndices, info.opaqueFaceIndicesKeys) ||
+                !sameBlocks(transparentIndices, info.transparentFaceIndicesKeys)) {
+                return false;
+            }
+
+            // The layout is unchanged, so we overwrite the existing blocks. Only the ranges whose contents differ
+            // are uploaded; e.g., moving a brush only changes its vertices, but not its indices.
+            m_vertexArray->updateVerticesWithKey(info.vertexHolderKey, cachedVertices.data());
+
+            if (edgeIndexCount > 0) {
+                std::vector<GLuint> edgeIndices(edgeIndexCount);
+                getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, edgeIndices.data());
+                info.cluster->edgeIndices->updateElementsWithKey(info.edgeIndicesKey, edgeIndices.data());
+            }
+
+            for (size_t i = 0; i < opaqueIndices.size(); ++i) {
+                const auto& [texture, indices] = opaqueIndices[i];
+                info.cluster->opaqueFaces->at(texture)->updateElementsWithKey(info.opaqueFaceIndicesKeys[i].second, indices.data());
+            }
+            for (size_t i = 0; i < transparentIndices.size(); ++i) {
+                const auto& [texture, indices] = transparentIndices[i];
+                info.cluster->transparentFaces->at(texture)->updateElementsWithKey(info.transparentFaceIndicesKeys[i].second, indices.data());
+            }
+
+            return true;
         }
 
         void BrushRenderer::addBrush(const Model::Brush* brush) {
@@ -568,12 +772,8 @@ namespace TrenchBroom {
             // update m_brushValid
             assertResult(m_allBrushes.erase(brush) > 0u);
 
-            if (m_invalidBrushes.erase(brush) > 0u) {
-                // invalid brushes are not in the VBO, so we can return  now.
-                assert(m_brushInfo.find(brush) == std::end(m_brushInfo));
-                return;
-            }
-
+            // invalid brushes may still occupy their VBO blocks, so we always remove the brush from the VBO
+            m_invalidBrushes.erase(brush);
             removeBrushFromVbo(brush);
         }
 
@@ -587,33 +787,108 @@ namespace TrenchBroom {
             }
 
             const BrushInfo& info = it->second;
+            Cluster& cluster = *info.cluster;
 
             // update Vbo's
             m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
             if (info.edgeIndicesKey != nullptr) {
-                m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+                cluster.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
             }
 
             for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_opaqueFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = cluster.opaqueFaces->at(texture);
                 faceIndexHolder->zeroElementsWithKey(opaqueKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_opaqueFaces->erase(texture);
+                    cluster.opaqueFaces->erase(texture);
                 }
             }
             for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_transparentFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = cluster.transparentFaces->at(texture);
                 faceIndexHolder->zeroElementsWithKey(transparentKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_transparentFaces->erase(texture);
+                    cluster.transparentFaces->erase(texture);
                 }
             }
 
+            // the cluster's bounds are recomputed from scratch once it becomes empty
+            assert(cluster.brushCount > 0);
+            --cluster.brushCount;
+
             m_brushInfo.erase(it);
         }
+
+        /**
+         * The size of the grid cells which determine the clusters of brushes.
+         */
+        static constexpr FloatType ClusterSize = 1024.0;
+
+        BrushRenderer::Cluster& BrushRenderer::findOrCreateCluster(const vm::bbox3& bounds) {
+            const auto center = bounds.center() / ClusterSize;
+            const auto key = ClusterKey(static_cast<int>(std::floor(center.x())),
+                                        static_cast<int>(std::floor(center.y())),
+                                        static_cast<int>(std::floor(center.z())));
+
+            auto& cluster = m_clusters[key];
+            if (cluster == nullptr) {
+                cluster = std::make_unique<Cluster>(m_vertexArray, m_faceColor);
+            }
+            return *cluster;
+        }
+
+        void BrushRenderer::cull(const Frustum& frustum) {
+            assert(valid());
+
+            m_visibleClusters.clear();
+            for (auto& [key, cluster] : m_clusters) {
+                if (cluster->brushCount > 0 && frustum.intersects(cluster->bounds)) {
+                    m_visibleClusters.push_back(cluster.get());
+                }
+            }
+        }
+
+        size_t BrushRenderer::visibleClusterCount() const {
+            return m_visibleClusters.size();
+        }
+
+        size_t BrushRenderer::visibleIndexCount() const {
+            size_t result = 0;
+            for (const auto* cluster : m_visibleClusters) {
+                result += cluster->edgeIndices->indexCount();
+                for (const auto& [texture, indices] : *cluster->opaqueFaces) {
+                    result += indices->indexCount();
+                }
+                for (const auto& [texture, indices] : *cluster->transparentFaces) {
+                    result += indices->indexCount();
+                }
+            }
+            return result;
+        }
+
+        BrushRenderer::Arrays BrushRenderer::arrays() const {
+            assert(valid());
+
+            Arrays result;
+            result.vertices = m_vertexArray->vertices();
+            for (const auto& [key, cluster] : m_clusters) {
+                const auto& edgeIndices = cluster->edgeIndices->indices();
+                result.edgeIndices.insert(std::end(result.edgeIndices), std::begin(edgeIndices), std::end(edgeIndices));
+
+                for (const auto& [texture, indexArray] : *cluster->opaqueFaces) {
+                    const auto& indices = indexArray->indices();
+                    auto& resultIndices = result.opaqueFaceIndices[texture];
+                    resultIndices.insert(std::end(resultIndices), std::begin(indices), std::end(indices));
+                }
+                for (const auto& [texture, indexArray] : *cluster->transparentFaces) {
+                    const auto& indices = indexArray->indices();
+                    auto& resultIndices = result.transparentFaceIndices[texture];
+                    resultIndices.insert(std::end(resultIndices), std::begin(indices), std::end(indices));
+                }
+            }
+            return result;
+        }
     }
 }
@@ -25,7 +25,12 @@
 #include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
+#include "Renderer/GL.h"
+#include "Renderer/GLVertexType.h"
 
+#include <vecmath/bbox.h>
+
+#include <map>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -40,6 +45,8 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class Frustum;
+
         class BrushRenderer {
         public:
             class Filter {
@@ -118,7 +125,37 @@ namespace TrenchBroom {
         private:
             std::unique_ptr<Filter> m_filter;
 
+            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
+
+            /**
+             * Brushes are grouped into clusters by the grid cell that contains the center of their bounds. Each
+             * cluster owns the face and edge indices of its brushes, so that clusters which are outside of the view
+             * frustum can be skipped when rendering. The vertices of all brushes share one vertex array.
+             *
+             * Clusters are only deleted by clear(), so that renderers which were added to a render batch remain valid.
+             */
+            struct Cluster {
+                /**
+                 * The union of the bounds of the brushes that were added to this cluster since it was last empty.
+                 */
+                vm::bbox3f bounds;
+                size_t brushCount;
+
+                std::shared_ptr<BrushIndexArray> edgeIndices;
+                std::shared_ptr<TextureToBrushIndicesMap> transparentFaces;
+                std::shared_ptr<TextureToBrushIndicesMap> opaqueFaces;
+
+                FaceRenderer opaqueFaceRenderer;
+                FaceRenderer transparentFaceRenderer;
+                IndexedEdgeRenderer edgeRenderer;
+
+                Cluster(std::shared_ptr<BrushVertexArray> vertexArray, const Color& faceColor);
+            };
+
+            using ClusterKey = std::tuple<int, int, int>;
+
             struct BrushInfo {
+                Cluster* cluster;
                 AllocationTracker::Block* vertexHolderKey;
                 AllocationTracker::Block* edgeIndicesKey;
                 std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> opaqueFaceIndicesKeys;
@@ -131,7 +168,7 @@ namespace TrenchBroom {
             std::unordered_map<const Model::Brush*, BrushInfo> m_brushInfo;
 
             /**
-             * If a brush is in the VBO, it's always valid.
+             * If a brush is invalid, it might still be in the VBO; its blocks are reused or freed when it is validated.
              * If a brush is valid, it might not be in the VBO if it was hidden by the Filter.
              *
              * Do not attempt to use vector_set here, it turns out to be slower.
@@ -140,15 +177,12 @@ namespace TrenchBroom {
             std::unordered_set<const Model::Brush*> m_invalidBrushes;
 
             std::shared_ptr<BrushVertexArray> m_vertexArray;
-            std::shared_ptr<BrushIndexArray> m_edgeIndices;
 
-            using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
-            std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
-            std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
-
-            FaceRenderer m_opaqueFaceRenderer;
-            FaceRenderer m_transparentFaceRenderer;
-            IndexedEdgeRenderer m_edgeRenderer;
+            std::map<ClusterKey, std::unique_ptr<Cluster>> m_clusters;
+            /**
+             * The clusters which passed the last call to cull(). Only these are rendered.
+             */
+            std::vector<Cluster*> m_visibleClusters;
 
             Color m_faceColor;
             bool m_showEdges;
@@ -195,10 +229,14 @@ namespace TrenchBroom {
              *
              * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the Brush object for modification.
              *
-             * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces, and m_opaqueFaces
-             * maps will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
+             * Additionally, calling `invalidate()` guarantees the m_brushInfo map and the face index maps of all clusters
+             * will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
              */
             void invalidate();
+            /**
+             * Marks the given brushes as invalid. Unlike `invalidate()`, this keeps the brushes' VBO blocks so that
+             * brushes whose vertex and index counts did not change can be updated in place when they are validated.
+             */
             void invalidateBrushes(const std::vector<Model::Brush*>& brushes);
             bool valid() const;
 
@@ -280,9 +318,88 @@ namespace TrenchBroom {
              * Only exposed for benchmarking.
              */
             void validate();
+
+            /**
+             * Validates the invalid brushes using at most the given number of threads. The contents of the arrays do
+             * not depend on the number of threads.
+             *
+             * Only exposed for testing.
+             */
+            void validate(size_t maxThreadCount);
+
+            /**
+             * Determines which clusters of brushes intersect the given frustum. Until the next call, only the brushes
+             * in these clusters are rendered. The brushes must be valid.
+             *
+             * Only exposed for testing and benchmarking; the render methods cull against the camera's frustum.
+             */
+            void cull(const Frustum& frustum);
+
+            /**
+             * Returns the number of clusters which passed the last call to cull().
+             */
+            size_t visibleClusterCount() const;
+
+            /**
+             * Returns the number of face and edge indices which are submitted for the clusters which passed the last
+             * call to cull(). This includes indices of removed brushes, which are zeroed but still submitted.
+             */
+            size_t visibleIndexCount() const;
+
+            /**
+             * The contents of the vertex array and of the index arrays of all clusters. The indices of the clusters
+             * are concatenated in the order of their keys.
+             */
+            struct Arrays {
+                std::vector<GLVertexTypes::P3NT2::Vertex> vertices;
+                std::vector<GLuint> edgeIndices;
+                std::map<const Assets::Texture*, std::vector<GLuint>> opaqueFaceIndices;
+                std::map<const Assets::Texture*, std::vector<GLuint>> transparentFaceIndices;
+            };
+
+            /**
+             * Returns a copy of the arrays that would be uploaded. The brushes must be valid.
+             *
+             * Only exposed for testing.
+             */
+            Arrays arrays() const;
         private:
             bool shouldDrawFaceInTransparentPass(const Model::Brush* brush, const Model::BrushFace* face) const;
-            void validateBrush(const Model::Brush* brush);
+            /**
+             * First phase of validation: evaluates the filter for the given brush and builds its vertex cache. This
+             * only modifies the brush's own faces and cache, so it may be called for different brushes concurrently.
+             */
+            Filter::RenderSettings prepareBrush(const Model::Brush* brush) const;
+
+            /**
+             * Second phase of validation: updates the brush in place if possible, or otherwise allocates new VBO
+             * blocks for it. Must be called serially.
+             *
+             * @return the info of the brush if its blocks were newly allocated and must be written by writeBrush, and
+             * null otherwise
+             */
+            BrushInfo* validateBrush(const Model::Brush* brush, const Filter::RenderSettings& settings);
+
+            /**
+             * Final phase of validation: writes the vertices and indices of the given brush into the blocks that were
+             * allocated by validateBrush. Brushes own disjoint blocks, so this may be called for different brushes
+             * concurrently.
+             */
+            void writeBrush(const Model::Brush* brush, Filter::EdgeRenderPolicy edgePolicy, const BrushInfo& info) const;
+
+            /**
+             * Overwrites the VBO blocks of a brush that is already in the VBO with its current vertices and indices.
+             * This requires that the brush still needs exactly the blocks it has, i.e., that its vertex count, its
+             * edge index count and its index counts per texture are unchanged.
+             *
+             * @return true if the brush was updated in place, and false if its blocks must be reallocated
+             */
+            bool updateBrushInVbo(const Model::Brush* brush, Filter::EdgeRenderPolicy edgePolicy, BrushInfo& info);
+
+            /**
+             * Returns the cluster for a brush with the given bounds, creating it if necessary.
+             */
+            Cluster& findOrCreateCluster(const vm::bbox3& bounds);
             void addBrush(const Model::Brush* brush);
             void removeBrush(const Model::Brush* brush);
 
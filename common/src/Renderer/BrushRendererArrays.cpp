@@ -56,6 +56,17 @@ namespace TrenchBroom {
                 throw std::invalid_argument("markDirty provided range out of bounds");
             }
 
+            if (size == 0) {
+                return;
+            }
+
+            // a clean tracker has no range to merge with
+            if (clean()) {
+                m_dirtyPos = pos;
+                m_dirtySize = size;
+                return;
+            }
+
             const size_t newPos = std::min(pos, m_dirtyPos);
             const size_t newEnd = std::max(pos + size, m_dirtyPos + m_dirtySize);
 
@@ -101,25 +112,39 @@ namespace TrenchBroom {
             return m_allocationTracker.hasAllocations();
         }
 
+        size_t BrushIndexArray::indexCount() const {
+            return m_indexHolder.size();
+        }
+
+        const std::vector<GLuint>& BrushIndexArray::indices() const {
+            return m_indexHolder.elements();
+        }
+
         std::pair<AllocationTracker::Block*, GLuint*> BrushIndexArray::getPointerToInsertElementsAt(const size_t elementCount) {
+            auto* block = allocateElements(elementCount);
+            return {block, getPointerToElementsWithKey(block)};
+        }
+
+        AllocationTracker::Block* BrushIndexArray::allocateElements(const size_t elementCount) {
             auto block = m_allocationTracker.allocate(elementCount);
-            if (block != nullptr) {
-                GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-                return {block, dest};
+            if (block == nullptr) {
+                // retry
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + elementCount);
+                m_allocationTracker.expand(newSize);
+                m_indexHolder.resize(newSize);
+
+                // insert again
+                block = m_allocationTracker.allocate(elementCount);
+                assert(block != nullptr);
             }
 
-            // retry
-            const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
-                                            m_allocationTracker.capacity() + elementCount);
-            m_allocationTracker.expand(newSize);
-            m_indexHolder.resize(newSize);
-
-            // insert again
-            block = m_allocationTracker.allocate(elementCount);
-            assert(block != nullptr);
+            m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
+            return block;
+        }
 
-            GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-            return {block, dest};
+        GLuint* BrushIndexArray::getPointerToElementsWithKey(AllocationTracker::Block* key) {
+            return m_indexHolder.getPointerToElements(key->pos);
         }
 
         void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key) {
@@ -130,6 +155,10 @@ namespace TrenchBroom {
             m_indexHolder.zeroRange(pos, size);
         }
 
+        void BrushIndexArray::updateElementsWithKey(AllocationTracker::Block* key, const GLuint* elements) {
+            m_indexHolder.updateElements(key->pos, key->size, elements);
+        }
+
         void BrushIndexArray::render(const PrimType primType) const {
             assert(m_indexHolder.prepared());
             m_indexHolder.render(primType, 0, m_indexHolder.size());
@@ -157,25 +186,35 @@ namespace TrenchBroom {
         BrushVertexArray::BrushVertexArray() : m_vertexHolder(),
                                                m_allocationTracker(0) {}
 
+        const std::vector<BrushVertexArray::Vertex>& BrushVertexArray::vertices() const {
+            return m_vertexHolder.elements();
+        }
+
         std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::getPointerToInsertVerticesAt(const size_t vertexCount) {
+            auto* block = allocateVertices(vertexCount);
+            return {block, getPointerToVerticesWithKey(block)};
+        }
+
+        AllocationTracker::Block* BrushVertexArray::allocateVertices(const size_t vertexCount) {
             auto block = m_allocationTracker.allocate(vertexCount);
-            if (block != nullptr) {
-                Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-                return {block, dest};
+            if (block == nullptr) {
+                // retry
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + vertexCount);
+                m_allocationTracker.expand(newSize);
+                m_vertexHolder.resize(newSize);
+
+                // insert again
+                block = m_allocationTracker.allocate(vertexCount);
+                assert(block != nullptr);
             }
 
-            // retry
-            const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
-                                            m_allocationTracker.capacity() + vertexCount);
-            m_allocationTracker.expand(newSize);
-            m_vertexHolder.resize(newSize);
-
-            // insert again
-            block = m_allocationTracker.allocate(vertexCount);
-            assert(block != nullptr);
+            m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+            return block;
+        }
 
-            Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-            return {block, dest};
+        BrushVertexArray::Vertex* BrushVertexArray::getPointerToVerticesWithKey(AllocationTracker::Block* key) {
+            return m_vertexHolder.getPointerToElements(key->pos);
         }
 
         void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key) {
@@ -187,6 +226,10 @@ namespace TrenchBroom {
             // us to re-use the space later
         }
 
+        void BrushVertexArray::updateVerticesWithKey(AllocationTracker::Block* key, const Vertex* vertices) {
+            m_vertexHolder.updateElements(key->pos, key->size, vertices);
+        }
+
         bool BrushVertexArray::setupVertices() {
             return m_vertexHolder.setupVertices();
         }
@@ -31,6 +31,7 @@
 #include <vecmath/vec.h>
 
 #include <cassert>
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -149,6 +150,42 @@ namespace TrenchBroom {
                 return m_snapshot.data() + offsetWithinBlock;
             }
 
+            /**
+             * Returns a pointer to the element at the given offset without marking anything dirty. The range that is
+             * written through the returned pointer must have been marked dirty before, e.g. by
+             * getPointerToWriteElementsTo(). The pointer is invalidated by resize().
+             */
+            T* getPointerToElements(const size_t offsetWithinBlock) {
+                assert(offsetWithinBlock < m_snapshot.size());
+                return m_snapshot.data() + offsetWithinBlock;
+            }
+
+            /**
+             * Overwrites the given range with the given elements. Only the part of the range whose contents actually
+             * change is marked dirty, so rewriting unchanged elements does not cause an upload.
+             */
+            void updateElements(const size_t offsetWithinBlock, const size_t elementCount, const T* elements) {
+                assert(offsetWithinBlock + elementCount <= m_snapshot.size());
+
+                T* dest = m_snapshot.data() + offsetWithinBlock;
+
+                size_t first = 0;
+                while (first < elementCount && std::memcmp(dest + first, elements + first, sizeof(T)) == 0) {
+                    ++first;
+                }
+                if (first == elementCount) {
+                    return;
+                }
+
+                size_t last = elementCount;
+                while (std::memcmp(dest + last - 1, elements + last - 1, sizeof(T)) == 0) {
+                    --last;
+                }
+
+                std::memcpy(dest + first, elements + first, (last - first) * sizeof(T));
+                m_dirtyRange.markDirty(offsetWithinBlock + first, last - first);
+            }
+
             bool prepared() const {
                 // NOTE: this returns true if the capacity is 0
                 return m_dirtyRange.clean();
@@ -202,6 +239,13 @@ namespace TrenchBroom {
                 return m_snapshot.size();
             }
 
+            /**
+             * Returns the local copy of the elements. Only exposed for testing.
+             */
+            const std::vector<T>& elements() const {
+                return m_snapshot;
+            }
+
             void bindBlock() {
                 m_vbo->bind();
             }
@@ -242,6 +286,16 @@ namespace TrenchBroom {
              */
             bool hasValidIndices() const;
 
+            /**
+             * Returns the number of indices that are rendered, including the zeroed ones.
+             */
+            size_t indexCount() const;
+
+            /**
+             * Returns all indices, including the zeroed ones. Only exposed for testing.
+             */
+            const std::vector<GLuint>& indices() const;
+
             /**
              * Call this to request writing the given number of indices.
              *
@@ -252,11 +306,28 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(size_t elementCount);
 
+            /**
+             * Allocates the given number of indices and marks them dirty without writing them. The indices must be
+             * written through getPointerToElementsWithKey() before the array is prepared.
+             */
+            AllocationTracker::Block* allocateElements(size_t elementCount);
+
+            /**
+             * Returns a pointer to the indices of the given allocation. The pointer is invalidated by the next
+             * allocation. Distinct allocations may be written concurrently.
+             */
+            GLuint* getPointerToElementsWithKey(AllocationTracker::Block* key);
+
             /**
              * Deletes indices for the given brush and marks the allocation as free.
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Overwrites the indices of the given allocation in place. `elements` must point to `key->size` indices.
+             */
+            void updateElementsWithKey(AllocationTracker::Block* key, const GLuint* elements);
+
             void render(const PrimType primType) const;
             bool prepared() const;
             void prepare(VboManager& vboManager);
@@ -311,14 +382,19 @@ namespace TrenchBroom {
          * the deleted memory in the VBO, while BrushIndexArray's does.
          */
         class BrushVertexArray {
-        private:
+        public:
             using Vertex = Renderer::GLVertexTypes::P3NT2::Vertex;
-
+        private:
             VertexHolder<Vertex> m_vertexHolder;
             AllocationTracker m_allocationTracker;
         public:
             BrushVertexArray();
 
+            /**
+             * Returns all vertices, including those of freed allocations. Only exposed for testing.
+             */
+            const std::vector<Vertex>& vertices() const;
+
             /**
              * Call this to request writing the given number of vertices.
              *
@@ -329,8 +405,25 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(size_t vertexCount);
 
+            /**
+             * Allocates the given number of vertices and marks them dirty without writing them. The vertices must be
+             * written through getPointerToVerticesWithKey() before the array is prepared.
+             */
+            AllocationTracker::Block* allocateVertices(size_t vertexCount);
+
+            /**
+             * Returns a pointer to the vertices of the given allocation. The pointer is invalidated by the next
+             * allocation. Distinct allocations may be written concurrently.
+             */
+            Vertex* getPointerToVerticesWithKey(AllocationTracker::Block* key);
+
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
+            /**
+             * Overwrites the vertices of the given allocation in place. `vertices` must point to `key->size` vertices.
+             */
+            void updateVerticesWithKey(AllocationTracker::Block* key, const Vertex* vertices);
+
             // setting up GL attributes
             bool setupVertices();
             void cleanupVertices();
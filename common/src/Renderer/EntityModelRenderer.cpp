@@ -27,6 +27,7 @@
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Renderer/ActiveShader.h"
+#include "Renderer/Frustum.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/Shaders.h"
@@ -34,6 +35,7 @@
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Transformation.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
 
 namespace TrenchBroom {
@@ -124,11 +126,15 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
+            const Frustum frustum(renderContext.camera());
             for (const auto& entry : m_entities) {
                 auto* entity = entry.first;
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (!frustum.intersects(vm::bbox3f(entity->physicalBounds()))) {
+                    continue;
+                }
 
                 auto* renderer = entry.second;
 
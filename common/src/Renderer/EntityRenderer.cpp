@@ -28,6 +28,7 @@
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Renderer/Camera.h"
+#include "Renderer/Frustum.h"
 #include "Renderer/PrimType.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
@@ -36,6 +37,7 @@
 #include "Renderer/GLVertexType.h"
 
 #include <vecmath/forward.h>
+#include <vecmath/bbox.h>
 #include <vecmath/vec.h>
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
@@ -212,8 +214,12 @@ namespace TrenchBroom {
                 renderService.setForegroundColor(m_overlayTextColor);
                 renderService.setBackgroundColor(m_overlayBackgroundColor);
 
+                const Frustum frustum(renderContext.camera());
                 for (const Model::Entity* entity : m_entities) {
                     if (m_showHiddenEntities || m_editorContext.visible(entity)) {
+                        if (!frustum.intersects(vm::bbox3f(entity->logicalBounds()))) {
+                            continue;
+                        }
                         if (entity->group() == nullptr || entity->group() == m_editorContext.currentGroup()) {
                             if (m_showOccludedOverlays)
                                 renderService.setShowOccludedObjects();
@@ -238,11 +244,15 @@ namespace TrenchBroom {
             renderService.setShowOccludedObjectsTransparent();
             renderService.setForegroundColor(m_angleColor);
 
+            const Frustum frustum(renderContext.camera());
             std::vector<vm::vec3f> vertices(3);
             for (const auto* entity : m_entities) {
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                if (!frustum.intersects(vm::bbox3f(entity->logicalBounds()))) {
+                    continue;
+                }
 
                 const auto rotation = vm::mat4x4f(entity->rotation());
                 const auto direction = rotation * vm::vec3f::pos_x();
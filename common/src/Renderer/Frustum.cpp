@@ -0,0 +1,53 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Frustum.h"
+
+#include "Renderer/Camera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        Frustum::Frustum() {}
+
+        Frustum::Frustum(const Camera& camera) :
+        m_planes(4) {
+            camera.frustumPlanes(m_planes[0], m_planes[1], m_planes[2], m_planes[3]);
+        }
+
+        Frustum::Frustum(const vm::plane3f& topPlane, const vm::plane3f& rightPlane, const vm::plane3f& bottomPlane, const vm::plane3f& leftPlane) :
+        m_planes({ topPlane, rightPlane, bottomPlane, leftPlane }) {}
+
+        bool Frustum::intersects(const vm::bbox3f& bounds) const {
+            for (const auto& plane : m_planes) {
+                // the corner of the box which is furthest inside of the plane
+                vm::vec3f corner;
+                for (size_t i = 0; i < 3; ++i) {
+                    corner[i] = plane.normal[i] > 0.0f ? bounds.min[i] : bounds.max[i];
+                }
+                if (plane.point_distance(corner) > 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+}
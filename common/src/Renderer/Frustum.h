@@ -0,0 +1,56 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_Frustum
+#define TrenchBroom_Frustum
+
+#include <vecmath/forward.h>
+#include <vecmath/plane.h>
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class Camera;
+
+        /**
+         * The side planes of a camera's view frustum, used to skip objects which are not in view. The normals of the
+         * planes point out of the frustum. The near and far planes are not considered.
+         */
+        class Frustum {
+        private:
+            std::vector<vm::plane3f> m_planes;
+        public:
+            /**
+             * Creates an unbounded frustum which intersects everything.
+             */
+            Frustum();
+            explicit Frustum(const Camera& camera);
+            Frustum(const vm::plane3f& topPlane, const vm::plane3f& rightPlane, const vm::plane3f& bottomPlane, const vm::plane3f& leftPlane);
+
+            /**
+             * Indicates whether the given bounds may intersect this frustum. This is conservative: a box that is
+             * outside of the frustum but intersects all of its planes' inner half spaces is considered intersecting.
+             */
+            bool intersects(const vm::bbox3f& bounds) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_Frustum) */
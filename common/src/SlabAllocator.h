@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_SlabAllocator_h
+#define TrenchBroom_SlabAllocator_h
+
+#include "SlabPool.h"
+
+#include <cassert>
+#include <cstddef>
+
+// Undefine this to prevent false positives when looking for memory leaks.
+#define TB_ENABLE_SLAB_ALLOCATOR 1
+
+namespace TrenchBroom {
+    /**
+     * Base class for small objects that are allocated in large numbers, such as the elements of a polyhedron. The
+     * instances of the given type are allocated from the SlabPool.
+     *
+     * @tparam T the type of the allocated objects
+     */
+    template <class T>
+    class SlabAllocator {
+    public:
+#ifdef TB_ENABLE_SLAB_ALLOCATOR
+        void* operator new([[maybe_unused]] const size_t size) {
+            static_assert(sizeof(T) <= SlabPool::MaxBlockSize, "type is too large for the slab pool");
+            assert(size == sizeof(T));
+            return SlabPool::allocate(sizeof(T));
+        }
+
+        void operator delete(void* block) {
+            SlabPool::deallocate(block);
+        }
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,387 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SlabPool.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace TrenchBroom {
+    namespace {
+        constexpr size_t Granularity = 16;
+        constexpr size_t SizeClassCount = SlabPool::MaxBlockSize / Granularity;
+
+        static_assert((SlabPool::ChunkSize & (SlabPool::ChunkSize - 1)) == 0, "chunk size must be a power of two");
+        static_assert(SlabPool::MaxBlockSize % Granularity == 0, "max block size must be a multiple of the granularity");
+
+        enum class ChunkType {
+            Slab,
+            Arena
+        };
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        /**
+         * The header at the start of every chunk. Apart from the type and the size class, which are set when the chunk
+         * is created, all members of a slab chunk are guarded by the shared pool's mutex. The members of an arena chunk
+         * are only accessed by the arena.
+         */
+        struct ChunkHeader {
+            ChunkType type;
+            size_t sizeClass;
+            size_t usedCount;
+            FreeBlock* freeList;
+            unsigned char* unused;
+            ChunkHeader* previous;
+            ChunkHeader* next;
+        };
+
+        constexpr size_t HeaderSize = (sizeof(ChunkHeader) + Granularity - 1) / Granularity * Granularity;
+
+        size_t blockSize(const size_t sizeClass) {
+            return (sizeClass + 1) * Granularity;
+        }
+
+        size_t sizeClass(const size_t size) {
+            assert(size > 0 && size <= SlabPool::MaxBlockSize);
+            return (size - 1) / Granularity;
+        }
+
+        ChunkHeader* createChunk(const ChunkType type, const size_t sizeClass) {
+            void* memory = nullptr;
+#ifdef _WIN32
+            memory = _aligned_malloc(SlabPool::ChunkSize, SlabPool::ChunkSize);
+#else
+            if (posix_memalign(&memory, SlabPool::ChunkSize, SlabPool::ChunkSize) != 0) {
+                memory = nullptr;
+            }
+#endif
+            if (memory == nullptr) {
+                throw std::bad_alloc();
+            }
+
+            auto* chunk = static_cast<ChunkHeader*>(memory);
+            chunk->type = type;
+            chunk->sizeClass = sizeClass;
+            chunk->usedCount = 0;
+            chunk->freeList = nullptr;
+            chunk->unused = static_cast<unsigned char*>(memory) + HeaderSize;
+            chunk->previous = nullptr;
+            chunk->next = nullptr;
+            return chunk;
+        }
+
+        void destroyChunk(ChunkHeader* chunk) {
+#ifdef _WIN32
+            _aligned_free(chunk);
+#else
+            free(chunk);
+#endif
+        }
+
+        ChunkHeader* findChunk(const void* block) {
+            const auto address = reinterpret_cast<std::uintptr_t>(block);
+            return reinterpret_cast<ChunkHeader*>(address & ~static_cast<std::uintptr_t>(SlabPool::ChunkSize - 1));
+        }
+
+        unsigned char* chunkEnd(ChunkHeader* chunk) {
+            return reinterpret_cast<unsigned char*>(chunk) + SlabPool::ChunkSize;
+        }
+
+        bool hasFreeBlock(ChunkHeader* chunk) {
+            return chunk->freeList != nullptr || chunk->unused + blockSize(chunk->sizeClass) <= chunkEnd(chunk);
+        }
+
+        /**
+         * The pool shared by all threads. It keeps a list of the chunks that have free blocks for each size class.
+         */
+        class SharedPool {
+        private:
+            struct SizeClass {
+                ChunkHeader* chunks = nullptr;
+                ChunkHeader* emptyChunk = nullptr;
+            };
+
+            std::mutex m_mutex;
+            SizeClass m_sizeClasses[SizeClassCount];
+            SlabPool::Stats m_stats = { 0, 0 };
+        public:
+            /**
+             * Takes up to the given number of free blocks of the given size class and prepends them to the given
+             * list. Returns the number of blocks taken.
+             */
+            size_t take(const size_t sizeClass, const size_t count, FreeBlock*& blocks) {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+
+                auto& sc = m_sizeClasses[sizeClass];
+                for (size_t i = 0; i < count; ++i) {
+                    if (sc.chunks == nullptr) {
+                        if (sc.emptyChunk != nullptr) {
+                            sc.chunks = sc.emptyChunk;
+                            sc.emptyChunk = nullptr;
+                        } else {
+                            sc.chunks = createChunk(ChunkType::Slab, sizeClass);
+                            ++m_stats.chunkCount;
+                        }
+                    }
+
+                    ChunkHeader* chunk = sc.chunks;
+                    FreeBlock* block = chunk->freeList;
+                    if (block != nullptr) {
+                        chunk->freeList = block->next;
+                    } else {
+                        block = reinterpret_cast<FreeBlock*>(chunk->unused);
+                        chunk->unused += blockSize(sizeClass);
+                    }
+                    ++chunk->usedCount;
+                    ++m_stats.usedBlockCount;
+
+                    if (!hasFreeBlock(chunk)) {
+                        unlink(sc, chunk);
+                    }
+
+                    block->next = blocks;
+                    blocks = block;
+                }
+                return count;
+            }
+
+            /**
+             * Returns the given list of blocks to their chunks. Chunks that become empty are released.
+             */
+            void give(FreeBlock* blocks) {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+
+                while (blocks != nullptr) {
+                    FreeBlock* block = blocks;
+                    blocks = blocks->next;
+
+                    ChunkHeader* chunk = findChunk(block);
+                    assert(chunk->type == ChunkType::Slab);
+                    assert(chunk->usedCount > 0);
+
+                    auto& sc = m_sizeClasses[chunk->sizeClass];
+                    if (!hasFreeBlock(chunk)) {
+                        link(sc, chunk);
+                    }
+
+                    block->next = chunk->freeList;
+                    chunk->freeList = block;
+                    --m_stats.usedBlockCount;
+
+                    if (--chunk->usedCount == 0) {
+                        unlink(sc, chunk);
+                        if (sc.emptyChunk == nullptr) {
+                            chunk->freeList = nullptr;
+                            chunk->unused = reinterpret_cast<unsigned char*>(chunk) + HeaderSize;
+                            sc.emptyChunk = chunk;
+                        } else {
+                            destroyChunk(chunk);
+                            --m_stats.chunkCount;
+                        }
+                    }
+                }
+            }
+
+            SlabPool::Stats stats() {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                return m_stats;
+            }
+        private:
+            static void link(SizeClass& sc, ChunkHeader* chunk) {
+                chunk->previous = nullptr;
+                chunk->next = sc.chunks;
+                if (sc.chunks != nullptr) {
+                    sc.chunks->previous = chunk;
+                }
+                sc.chunks = chunk;
+            }
+
+            static void unlink(SizeClass& sc, ChunkHeader* chunk) {
+                if (chunk->previous != nullptr) {
+                    chunk->previous->next = chunk->next;
+                } else {
+                    sc.chunks = chunk->next;
+                }
+                if (chunk->next != nullptr) {
+                    chunk->next->previous = chunk->previous;
+                }
+                chunk->previous = nullptr;
+                chunk->next = nullptr;
+            }
+        };
+
+        SharedPool& sharedPool() {
+            // never destroyed so that blocks can still be freed during static destruction
+            static auto* pool = new SharedPool();
+            return *pool;
+        }
+
+        /**
+         * A cache of free blocks for each size class, owned by a single thread.
+         */
+        class ThreadCache {
+        private:
+            struct SizeClass {
+                FreeBlock* blocks = nullptr;
+                size_t count = 0;
+            };
+
+            SizeClass m_sizeClasses[SizeClassCount];
+        public:
+            ~ThreadCache();
+
+            void* allocate(const size_t sizeClass) {
+                auto& sc = m_sizeClasses[sizeClass];
+                if (sc.count == 0) {
+                    sc.count = sharedPool().take(sizeClass, SlabPool::BatchSize, sc.blocks);
+                }
+
+                FreeBlock* block = sc.blocks;
+                sc.blocks = block->next;
+                --sc.count;
+                return block;
+            }
+
+            void deallocate(void* memory, const size_t sizeClass) {
+                auto& sc = m_sizeClasses[sizeClass];
+
+                auto* block = static_cast<FreeBlock*>(memory);
+                block->next = sc.blocks;
+                sc.blocks = block;
+
+                if (++sc.count > SlabPool::MaxCachedBlocks) {
+                    // keep the first BatchSize blocks and return the others
+                    FreeBlock* last = sc.blocks;
+                    for (size_t i = 1; i < SlabPool::BatchSize; ++i) {
+                        last = last->next;
+                    }
+                    sharedPool().give(last->next);
+                    last->next = nullptr;
+                    sc.count = SlabPool::BatchSize;
+                }
+            }
+        };
+
+        // trivially destructible, so it can be checked after the thread cache has been destroyed
+        thread_local bool threadCacheDestroyed = false;
+
+        ThreadCache::~ThreadCache() {
+            for (auto& sc : m_sizeClasses) {
+                sharedPool().give(sc.blocks);
+            }
+            threadCacheDestroyed = true;
+        }
+
+        ThreadCache* threadCache() {
+            if (threadCacheDestroyed) {
+                return nullptr;
+            }
+            thread_local ThreadCache cache;
+            return &cache;
+        }
+
+        thread_local SlabPool::Arena* currentArena = nullptr;
+    }
+
+    void* SlabPool::allocate(const size_t size) {
+        if (currentArena != nullptr) {
+            return currentArena->allocate(size);
+        }
+
+        const auto sc = sizeClass(size);
+        if (auto* cache = threadCache()) {
+            return cache->allocate(sc);
+        }
+
+        FreeBlock* block = nullptr;
+        sharedPool().take(sc, 1, block);
+        return block;
+    }
+
+    void SlabPool::deallocate(void* block) {
+        if (block == nullptr) {
+            return;
+        }
+
+        ChunkHeader* chunk = findChunk(block);
+        if (chunk->type == ChunkType::Arena) {
+            return;
+        }
+
+        if (auto* cache = threadCache()) {
+            cache->deallocate(block, chunk->sizeClass);
+        } else {
+            auto* freeBlock = static_cast<FreeBlock*>(block);
+            freeBlock->next = nullptr;
+            sharedPool().give(freeBlock);
+        }
+    }
+
+    SlabPool::Stats SlabPool::stats() {
+        return sharedPool().stats();
+    }
+
+    SlabPool::Arena::Scope::Scope(Arena& arena) :
+    m_previous(currentArena) {
+        currentArena = &arena;
+    }
+
+    SlabPool::Arena::Scope::~Scope() {
+        currentArena = m_previous;
+    }
+
+    SlabPool::Arena::Arena() :
+    m_chunks(nullptr),
+    m_current(nullptr),
+    m_end(nullptr) {}
+
+    SlabPool::Arena::~Arena() {
+        auto* chunk = static_cast<ChunkHeader*>(m_chunks);
+        while (chunk != nullptr) {
+            auto* next = chunk->next;
+            destroyChunk(chunk);
+            chunk = next;
+        }
+    }
+
+    void* SlabPool::Arena::allocate(const size_t size) {
+        const auto alignedSize = blockSize(sizeClass(size));
+        if (m_current == nullptr || m_current + alignedSize > m_end) {
+            auto* chunk = createChunk(ChunkType::Arena, 0);
+            chunk->next = static_cast<ChunkHeader*>(m_chunks);
+            m_chunks = chunk;
+            m_current = chunk->unused;
+            m_end = chunkEnd(chunk);
+        }
+
+        void* block = m_current;
+        m_current += alignedSize;
+        return block;
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_SlabPool_h
+#define TrenchBroom_SlabPool_h
+
+#include "Macros.h"
+
+#include <cstddef>
+
+namespace TrenchBroom {
+    /**
+     * A thread safe pool for small, fixed size memory blocks.
+     *
+     * Blocks are carved out of chunks of ChunkSize bytes. Every chunk is aligned to its own size and begins with a
+     * header, so the chunk that owns a block is found in constant time by masking the block's address.
+     *
+     * Blocks are grouped into size classes. Each thread keeps a small cache of free blocks per size class, so that
+     * most allocations and deallocations do not need any synchronization. Only when a thread's cache runs empty or
+     * overflows, a batch of blocks is exchanged with a shared pool that is guarded by a mutex. Blocks may be freed on
+     * a different thread than the one that allocated them.
+     *
+     * While an Arena::Scope is active on the current thread, blocks are allocated from the scope's arena instead. Such
+     * blocks are not reused when they are freed, but their memory is released all at once when the arena is
+     * destroyed.
+     */
+    class SlabPool {
+    public:
+        static constexpr size_t ChunkSize = 16 * 1024;
+        static constexpr size_t MaxBlockSize = 256;
+
+        /**
+         * The number of blocks exchanged between a thread's cache and the shared pool at once.
+         */
+        static constexpr size_t BatchSize = 32;
+
+        /**
+         * The maximum number of free blocks that a thread caches per size class.
+         */
+        static constexpr size_t MaxCachedBlocks = 2 * BatchSize;
+
+        class Arena;
+
+        struct Stats {
+            /**
+             * The number of slab chunks, including the empty chunks kept for reuse. Arena chunks are not counted.
+             */
+            size_t chunkCount;
+            /**
+             * The number of blocks taken from the shared pool, whether they are in use or cached by a thread.
+             */
+            size_t usedBlockCount;
+        };
+    public:
+        /**
+         * Allocates a block of the given size, which must not be greater than MaxBlockSize.
+         */
+        static void* allocate(size_t size);
+
+        /**
+         * Returns the given block to the pool. If the block was allocated from an arena, nothing happens.
+         */
+        static void deallocate(void* block);
+
+        /**
+         * Returns statistics about the shared pool.
+         */
+        static Stats stats();
+    };
+
+    /**
+     * A bump allocator that releases all of its memory at once when it is destroyed. All blocks allocated from an
+     * arena must be freed before the arena is destroyed.
+     *
+     * Arenas are not thread safe and must only be used by one thread at a time.
+     */
+    class SlabPool::Arena {
+    public:
+        /**
+         * While a scope exists, all allocations on the current thread are served by the scope's arena.
+         */
+        class Scope {
+        private:
+            Arena* m_previous;
+        public:
+            explicit Scope(Arena& arena);
+            ~Scope();
+
+            deleteCopyAndMove(Scope)
+        };
+    private:
+        void* m_chunks;
+        unsigned char* m_current;
+        unsigned char* m_end;
+    public:
+        Arena();
+        ~Arena();
+
+        void* allocate(size_t size);
+
+        deleteCopyAndMove(Arena)
+    };
+}
+
+#endif
@@ -19,12 +19,15 @@
 
 #include "TrenchBroomApp.h"
 
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "RecoverableExceptions.h"
 #include "TrenchBroomStackWalker.h"
 #include "IO/Path.h"
 #include "IO/PathQt.h"
 #include "IO/DiskIO.h"
 #include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "Model/GameFactory.h"
 #include "Model/MapFormat.h"
 #include "View/AboutDialog.h"
@@ -113,6 +116,7 @@ namespace TrenchBroom {
                 return;
             }
 
+            initializeTextureCache();
             loadStyleSheets();
 
             // these must be initialized here and not earlier
@@ -317,6 +321,14 @@ namespace TrenchBroom {
             return true;
         }
 
+        void TrenchBroomApp::initializeTextureCache() {
+            const auto megabytes = pref(Preferences::TextureCacheSize);
+            if (megabytes > 0) {
+                const auto directory = IO::SystemPaths::userDataDirectory() + IO::Path("Cache/Textures");
+                IO::TextureCache::setDefaultCache(std::make_shared<IO::TextureCache>(directory, static_cast<size_t>(megabytes) * 1024u * 1024u));
+            }
+        }
+
         static std::string makeCrashReport(const std::string &stacktrace, const std::string &reason) {
             std::stringstream ss;
             ss << "OS:\t" << QSysInfo::prettyProductName().toStdString() << std::endl;
@@ -73,6 +73,7 @@ namespace TrenchBroom {
             void openPreferences();
             void openAbout();
             bool initializeGameFactory();
+            void initializeTextureCache();
         public:
             bool newDocument();
             void openDocument();
@@ -21,7 +21,15 @@
 
 #include "Ensure.h"
 #include "Macros.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
 #include "Model/Node.h"
+#include "Model/NodeVisitor.h"
+#include "Model/Polyhedron.h"
 #include "View/MapDocumentCommandFacade.h"
 
 #include <kdl/map_utils.h>
@@ -116,5 +124,55 @@ namespace TrenchBroom {
         bool AddRemoveNodesCommand::doCollateWith(UndoableCommand*) {
             return false;
         }
+
+        /**
+         * Estimates the number of bytes occupied by the visited nodes, taking only the brush geometry and faces and
+         * the entity attributes into account.
+         */
+        class EstimateNodeMemorySize : public Model::ConstNodeVisitor {
+        private:
+            size_t m_result;
+        public:
+            EstimateNodeMemorySize() :
+            m_result(0u) {}
+
+            size_t result() const {
+                return m_result;
+            }
+        private:
+            void doVisit(const Model::World*) override {}
+
+            void doVisit(const Model::Layer*) override {
+                m_result += sizeof(Model::Layer);
+            }
+
+            void doVisit(const Model::Group*) override {
+                m_result += sizeof(Model::Group);
+            }
+
+            void doVisit(const Model::Entity* entity) override {
+                m_result += sizeof(Model::Entity);
+                for (const auto& attribute : entity->attributes()) {
+                    m_result += sizeof(attribute) + attribute.name().capacity() + attribute.value().capacity();
+                }
+            }
+
+            void doVisit(const Model::Brush* brush) override {
+                m_result += sizeof(Model::Brush);
+                m_result += brush->faceCount() * (sizeof(Model::BrushFace) + sizeof(Model::BrushFace::Data) + sizeof(Model::BrushFaceGeometry));
+                m_result += brush->vertexCount() * sizeof(Model::BrushVertex);
+                m_result += brush->edgeCount() * (sizeof(Model::BrushEdge) + 2u * sizeof(Model::BrushHalfEdge));
+            }
+        };
+
+        size_t AddRemoveNodesCommand::doGetMemorySize() const {
+            // only the nodes to add are owned by this command, the nodes to remove are owned by the document
+            EstimateNodeMemorySize visitor;
+            for (const auto& entry : m_nodesToAdd) {
+                const auto& nodes = entry.second;
+                Model::Node::acceptAndRecurse(std::begin(nodes), std::end(nodes), visitor);
+            }
+            return visitor.result();
+        }
     }
 }
@@ -29,6 +29,7 @@
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
+#include <iterator>
 
 #include <QDateTime>
 
@@ -142,13 +143,23 @@ namespace TrenchBroom {
             bool doCollateWith(UndoableCommand*) override {
                 return false;
             }
+
+            size_t doGetMemorySize() const override {
+                size_t result = m_commands.capacity() * sizeof(std::unique_ptr<UndoableCommand>);
+                for (const auto& command : m_commands) {
+                    result += command->memorySize();
+                }
+                return result;
+            }
         };
 
         const Command::CommandType CommandProcessor::TransactionCommand::Type = Command::freeType();
 
-        CommandProcessor::CommandProcessor(MapDocumentCommandFacade* document, const std::chrono::milliseconds collationInterval) :
+        CommandProcessor::CommandProcessor(MapDocumentCommandFacade* document, const std::chrono::milliseconds collationInterval, const size_t memoryLimit) :
         m_document(document),
         m_collationInterval(collationInterval),
+        m_memoryLimit(memoryLimit),
+        m_undoStackMemorySize(0u),
         m_lastCommandTimestamp(std::chrono::time_point<std::chrono::system_clock>()) {}
 
         CommandProcessor::~CommandProcessor() = default;
@@ -177,6 +188,19 @@ namespace TrenchBroom {
             }
         }
 
+        size_t CommandProcessor::memoryLimit() const {
+            return m_memoryLimit;
+        }
+
+        void CommandProcessor::setMemoryLimit(const size_t memoryLimit) {
+            m_memoryLimit = memoryLimit;
+            limitUndoStackMemorySize();
+        }
+
+        size_t CommandProcessor::undoStackMemorySize() const {
+            return m_undoStackMemorySize;
+        }
+
         void CommandProcessor::startTransaction(const std::string& name) {
             m_transactionStack.push_back(TransactionState(name));
         }
@@ -206,6 +230,7 @@ namespace TrenchBroom {
             if (result->success()) {
                 m_undoStack.clear();
                 m_redoStack.clear();
+                m_undoStackMemorySize = 0u;
             }
             return result;
         }
@@ -281,6 +306,7 @@ namespace TrenchBroom {
             clearRepeatStack();
             m_undoStack.clear();
             m_redoStack.clear();
+            m_undoStackMemorySize = 0u;
             m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
         }
 
@@ -378,7 +404,10 @@ namespace TrenchBroom {
 
             if (collatable(collate, timestamp)) {
                 auto& lastCommand = m_undoStack.back();
+                const auto lastCommandMemorySize = lastCommand->memorySize();
                 if (lastCommand->collateWith(command.get())) {
+                    m_undoStackMemorySize = m_undoStackMemorySize - lastCommandMemorySize + lastCommand->memorySize();
+                    limitUndoStackMemorySize();
                     return false;
                 }
             }
@@ -387,7 +416,9 @@ namespace TrenchBroom {
                 pushToRepeatStack(command.get());
             }
 
+            m_undoStackMemorySize += command->memorySize();
             m_undoStack.push_back(std::move(command));
+            limitUndoStackMemorySize();
             return true;
         }
 
@@ -396,10 +427,27 @@ namespace TrenchBroom {
             assert(!m_undoStack.empty());
 
             auto lastCommand = kdl::vec_pop_back(m_undoStack);
+            m_undoStackMemorySize -= lastCommand->memorySize();
             popFromRepeatStack(lastCommand.get());
             return lastCommand;
         }
 
+        void CommandProcessor::limitUndoStackMemorySize() {
+            if (m_undoStackMemorySize <= m_memoryLimit || m_undoStack.size() <= 1u) {
+                return;
+            }
+
+            // drop the oldest commands, but always keep the most recent one so that it can be undone
+            auto end = std::begin(m_undoStack);
+            while (m_undoStackMemorySize > m_memoryLimit && std::next(end) != std::end(m_undoStack)) {
+                auto& command = *end;
+                m_undoStackMemorySize -= command->memorySize();
+                m_repeatStack.erase(std::remove(std::begin(m_repeatStack), std::end(m_repeatStack), command.get()), std::end(m_repeatStack));
+                ++end;
+            }
+            m_undoStack.erase(std::begin(m_undoStack), end);
+        }
+
         bool CommandProcessor::collatable(const bool collate, const std::chrono::system_clock::time_point timestamp) const {
             return collate && !m_undoStack.empty() && timestamp - m_lastCommandTimestamp <= m_collationInterval;
         }
@@ -23,6 +23,7 @@
 #include "Notifier.h"
 
 #include <chrono>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,6 +51,10 @@ namespace TrenchBroom {
          *
          * The command processor supports nested transactions. Each transaction can be committed or rolled back
          * individually. Committing a nested transaction adds it as a command to the containing transaction.
+         *
+         * The memory occupied by the undo stack can be limited. Each command estimates the number of bytes that it
+         * occupies, including the snapshots and removed nodes it keeps for undo, and the command processor drops the
+         * oldest commands from the undo stack once the sum of these estimates exceeds the limit.
          */
         class CommandProcessor {
         private:
@@ -63,6 +68,17 @@ namespace TrenchBroom {
              */
             std::chrono::milliseconds m_collationInterval;
 
+            /**
+             * Limits the estimated number of bytes occupied by the commands on the undo stack. If the limit is
+             * exceeded, the oldest commands are dropped from the undo stack.
+             */
+            size_t m_memoryLimit;
+
+            /**
+             * The sum of the estimated number of bytes occupied by the commands on the undo stack.
+             */
+            size_t m_undoStackMemorySize;
+
             /**
              * Holds the commands that were executed so far, with the most recently executed command at the
              * end of the vector.
@@ -101,8 +117,10 @@ namespace TrenchBroom {
              * executed, undone or repeated.
              *
              * @param document the document to pass to commands, may be null
+             * @param collationInterval the maximum time between two commands that can be collated
+             * @param memoryLimit the maximum number of bytes that the commands on the undo stack may occupy
              */
-            explicit CommandProcessor(MapDocumentCommandFacade* document, std::chrono::milliseconds collationInterval = std::chrono::milliseconds(1000));
+            explicit CommandProcessor(MapDocumentCommandFacade* document, std::chrono::milliseconds collationInterval = std::chrono::milliseconds(1000), size_t memoryLimit = std::numeric_limits<size_t>::max());
 
             ~CommandProcessor();
 
@@ -167,6 +185,24 @@ namespace TrenchBroom {
              */
             const std::string& redoCommandName() const;
 
+            /**
+             * Returns the maximum number of bytes that the commands on the undo stack may occupy.
+             */
+            size_t memoryLimit() const;
+
+            /**
+             * Sets the maximum number of bytes that the commands on the undo stack may occupy, and drops the oldest
+             * commands from the undo stack if they occupy more than that.
+             *
+             * @param memoryLimit the memory limit to set
+             */
+            void setMemoryLimit(size_t memoryLimit);
+
+            /**
+             * Returns an estimate of the number of bytes occupied by the commands on the undo stack.
+             */
+            size_t undoStackMemorySize() const;
+
             /**
              * Starts a new transaction. If a transaction is currently executing, then the newly started transaction
              * becomes a nested transaction and will be added as a command to its parent transaction upon commit.
@@ -394,6 +430,13 @@ namespace TrenchBroom {
              */
             std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+            /**
+             * Drops the oldest commands from the undo stack until the commands on the undo stack occupy at most as
+             * many bytes as the memory limit allows. The most recently executed command is never dropped, even if it
+             * alone exceeds the memory limit. Commands that are dropped are removed from the repeat stack, too.
+             */
+            void limitUndoStackMemorySize();
+
             bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
             /**
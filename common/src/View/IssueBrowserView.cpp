@@ -132,6 +132,8 @@ namespace TrenchBroom {
             auto document = kdl::mem_lock(m_document);
             Model::World* world = document->world();
             if (world != nullptr) {
+                world->validateAllIssues();
+
                 const std::vector<Model::IssueGenerator*>& issueGenerators = world->registeredIssueGenerators();
                 Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
                 world->acceptAndRecurse(visitor);
@@ -118,6 +118,7 @@
 #include <kdl/collection_utils.h>
 #include <kdl/map_utils.h>
 #include <kdl/memory_utils.h>
+#include <kdl/parallel.h>
 #include <kdl/vector_utils.h>
 
 #include <vecmath/polygon.h>
@@ -125,6 +126,7 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <sstream>
@@ -137,6 +139,11 @@ namespace TrenchBroom {
         const vm::bbox3 MapDocument::DefaultWorldBounds(-16384.0, 16384.0);
         const std::string MapDocument::DefaultDocumentName("unnamed.map");
 
+        static size_t textureMemoryBudget() {
+            const auto megabytes = std::max(pref(Preferences::TextureMemoryBudget), 0);
+            return static_cast<size_t>(megabytes) * 1024u * 1024u;
+        }
+
         MapDocument::MapDocument() :
         m_worldBounds(DefaultWorldBounds),
         m_world(nullptr),
@@ -162,6 +169,7 @@ namespace TrenchBroom {
         m_lastSelectionBounds(0.0, 32.0),
         m_selectionBoundsValid(true),
         m_viewEffectsService(nullptr) {
+                m_textureManager->setTextureBudget(textureMemoryBudget());
                 bindObservers();
         }
 
@@ -1185,8 +1193,16 @@ namespace TrenchBroom {
                 toRemove.push_back(subtrahend);
             }
 
-            for (auto* minuend : minuends) {
-                const std::vector<Model::Brush*> result = minuend->subtract(*m_world, m_worldBounds, currentTextureName(), subtrahends);
+            // the minuends are independent of each other, so we can subtract their geometries concurrently, but the
+            // brushes must be created here because copying the face attributes updates the texture usage counts
+            const auto fragments = kdl::vec_parallel_transform(minuends, [&](const Model::Brush* minuend) {
+                return minuend->subtractGeometry(subtrahends);
+            });
+
+            const auto& textureName = currentTextureName();
+            for (size_t i = 0u; i < minuends.size(); ++i) {
+                auto* minuend = minuends[i];
+                const auto result = minuend->createBrushes(*m_world, m_worldBounds, textureName, fragments[i], subtrahends);
 
                 if (!result.empty()) {
                     kdl::vec_append(toAdd[minuend->parent()], result);
@@ -2053,6 +2069,9 @@ namespace TrenchBroom {
         };
 
         void MapDocument::updateAllFaceTags() {
+            // the textures that the face texture names resolve to may have changed
+            m_tagManager->invalidateTextureTags();
+
             InitializeFaceTagsVisitor visitor(*m_tagManager);
             m_world->acceptAndRecurse(visitor);
         }
@@ -2147,6 +2166,8 @@ namespace TrenchBroom {
                        path == Preferences::TextureMagFilter.path()) {
                 m_entityModelManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
                 m_textureManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+            } else if (path == Preferences::TextureMemoryBudget.path()) {
+                m_textureManager->setTextureBudget(textureMemoryBudget());
             }
         }
 
@@ -53,6 +53,8 @@
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 
+#include <algorithm>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -65,8 +67,13 @@ namespace TrenchBroom {
             return std::shared_ptr<MapDocument>(new MapDocumentCommandFacade());
         }
 
+        static size_t undoMemoryBudget() {
+            const auto megabytes = std::max(pref(Preferences::UndoMemoryBudget), 0);
+            return static_cast<size_t>(megabytes) * 1024u * 1024u;
+        }
+
         MapDocumentCommandFacade::MapDocumentCommandFacade() :
-        m_commandProcessor(std::make_unique<CommandProcessor>(this)) {
+        m_commandProcessor(std::make_unique<CommandProcessor>(this, std::chrono::milliseconds(1000), undoMemoryBudget())) {
             bindObservers();
         }
 
@@ -280,6 +287,19 @@ namespace TrenchBroom {
             const std::vector<Model::Node*> parents = collectParents(nodes);
             Notifier<const std::vector<Model::Node*>&>::NotifyBeforeAndAfter notifyParents(nodesWillChangeNotifier, nodesDidChangeNotifier, parents);
 
+            size_t addedNodeCount = 0u;
+            for (const auto& entry : nodes) {
+                for (const Model::Node* child : entry.second) {
+                    addedNodeCount += child->familySize();
+                }
+            }
+
+            // when many nodes are pasted or duplicated, bulk load the node tree once they have all been added
+            const bool rebuildNodeTree = m_world->shouldRebuildNodeTree(addedNodeCount);
+            if (rebuildNodeTree) {
+                m_world->disableNodeTreeUpdates();
+            }
+
             std::vector<Model::Node*> addedNodes;
             for (const auto& entry : nodes) {
                 Model::Node* parent = entry.first;
@@ -288,6 +308,11 @@ namespace TrenchBroom {
                 kdl::vec_append(addedNodes, children);
             }
 
+            if (rebuildNodeTree) {
+                m_world->rebuildNodeTree();
+                m_world->enableNodeTreeUpdates();
+            }
+
             setEntityDefinitions(addedNodes);
             setEntityModels(addedNodes);
             setTextures(addedNodes);
@@ -988,10 +1013,12 @@ namespace TrenchBroom {
 
         void MapDocumentCommandFacade::documentWasNewed(MapDocument*) {
             m_commandProcessor->clear();
+            m_commandProcessor->setMemoryLimit(undoMemoryBudget());
         }
 
         void MapDocumentCommandFacade::documentWasLoaded(MapDocument*) {
             m_commandProcessor->clear();
+            m_commandProcessor->setMemoryLimit(undoMemoryBudget());
         }
 
         bool MapDocumentCommandFacade::doCanUndoCommand() const {
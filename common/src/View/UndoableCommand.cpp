@@ -60,10 +60,18 @@ namespace TrenchBroom {
             return doCollateWith(command);
         }
 
+        size_t UndoableCommand::memorySize() const {
+            return sizeof(UndoableCommand) + m_name.capacity() + doGetMemorySize();
+        }
+
         bool UndoableCommand::doIsRepeatDelimiter() const {
             return false;
         }
 
+        size_t UndoableCommand::doGetMemorySize() const {
+            return 0u;
+        }
+
         std::unique_ptr<UndoableCommand> UndoableCommand::doRepeat(MapDocumentCommandFacade*) const {
             throw CommandProcessorException("Command is not repeatable");
         }
@@ -157,6 +157,10 @@ namespace TrenchBroom {
             return false;
         }
 
+        size_t VertexCommand::doGetMemorySize() const {
+            return m_snapshot != nullptr ? m_snapshot->memorySize() : 0u;
+        }
+
         void VertexCommand::takeSnapshot() {
             assert(m_snapshot == nullptr);
             m_snapshot = std::make_unique<Model::Snapshot>(std::begin(m_brushes), std::end(m_brushes));
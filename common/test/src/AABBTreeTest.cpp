@@ -484,6 +484,285 @@ L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 1
         assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
     }
 
+    TEST(AABBTreeTest, findIntersectorsAfterModification) {
+        AABB tree;
+        tree.insert(BOX(VEC(-2.0, -1.0, -1.0), VEC(-1.0, +1.0, +1.0)), 1u);
+
+        const auto ray = RAY(VEC(-3.0, 0.0, 0.0), VEC::pos_x());
+        assertIntersectors(tree, ray, { 1u });
+
+        tree.insert(BOX(VEC(+1.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0)), 2u);
+        assertIntersectors(tree, ray, { 1u, 2u });
+
+        tree.update(BOX(VEC(+1.0, +2.0, -1.0), VEC(+2.0, +3.0, +1.0)), 2u);
+        assertIntersectors(tree, ray, { 1u });
+
+        tree.remove(1u);
+        assertIntersectors(tree, ray, {});
+
+        tree.clear();
+        assertIntersectors(tree, ray, {});
+    }
+
+    TEST(AABBTreeTest, findIntersectorsWithBoundsNotRepresentableAsFloat) {
+        AABB tree;
+        tree.insert(BOX(VEC(0.1, 0.1, 0.1), VEC(0.3, 0.3, 0.3)), 1u);
+        tree.insert(BOX(VEC(0.3000001, 0.1, 0.1), VEC(0.7, 0.3, 0.3)), 2u);
+
+        assertIntersectors(tree, RAY(VEC(0.1, 0.2, -1.0), VEC::pos_z()), { 1u });
+        assertIntersectors(tree, RAY(VEC(0.3, 0.2, -1.0), VEC::pos_z()), { 1u });
+        assertIntersectors(tree, RAY(VEC(0.300000005, 0.2, -1.0), VEC::pos_z()), {});
+        assertIntersectors(tree, RAY(VEC(0.0999999999, 0.2, -1.0), VEC::pos_z()), {});
+
+        const auto containers = tree.findContainers(VEC(0.3000001, 0.2, 0.2));
+        ASSERT_EQ(std::vector<AABB::DataType>({ 2u }), containers);
+    }
+
+    TEST(AABBTreeTest, findIntersectorsOfBox) {
+        std::vector<BOX> bounds;
+        std::vector<AABB::DataType> data;
+        for (size_t x = 0u; x < 6u; ++x) {
+            for (size_t y = 0u; y < 6u; ++y) {
+                for (size_t z = 0u; z < 6u; ++z) {
+                    const auto min = VEC(static_cast<double>(x * 3u), static_cast<double>(y * 3u), static_cast<double>(z * 3u));
+                    data.push_back(bounds.size());
+                    bounds.emplace_back(min, min + VEC(2.0, 2.0, 2.0));
+                }
+            }
+        }
+
+        AABB incrementalTree;
+        for (const auto i : data) {
+            incrementalTree.insert(bounds[i], i);
+        }
+
+        AABB bulkTree;
+        bulkTree.build(data, [&](const auto i) { return bounds[i]; });
+
+        const std::vector<BOX> queries {
+            BOX(VEC(-2.0, -2.0, -2.0), VEC(-1.0, -1.0, -1.0)), // outside of all boxes
+            BOX(VEC(2.5, 2.5, 2.5), VEC(2.75, 2.75, 2.75)),    // in a gap between boxes
+            BOX(VEC(2.0, 0.5, 0.5), VEC(3.0, 1.5, 1.5)),       // touching two boxes
+            BOX(VEC(1.0, 1.0, 1.0), VEC(10.0, 4.0, 7.0)),      // overlapping several boxes
+            BOX(VEC(-1.0, -1.0, -1.0), VEC(20.0, 20.0, 20.0)), // containing all boxes
+        };
+
+        for (const auto& query : queries) {
+            std::set<AABB::DataType> expected;
+            for (const auto i : data) {
+                if (bounds[i].intersects(query)) {
+                    expected.insert(i);
+                }
+            }
+
+            std::set<AABB::DataType> incrementalResult;
+            incrementalTree.findIntersectors(query, std::inserter(incrementalResult, std::end(incrementalResult)));
+            ASSERT_EQ(expected, incrementalResult);
+
+            std::set<AABB::DataType> bulkResult;
+            bulkTree.findIntersectors(query, std::inserter(bulkResult, std::end(bulkResult)));
+            ASSERT_EQ(expected, bulkResult);
+        }
+    }
+
+    TEST(AABBTreeTest, buildEmptyTree) {
+        AABB tree;
+        tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 1u);
+        tree.build(std::vector<AABB::DataType>{}, [](const auto) { return BOX(); });
+
+        ASSERT_TRUE(tree.empty());
+        ASSERT_FALSE(tree.contains(1u));
+    }
+
+    TEST(AABBTreeTest, buildTreeWithThreeNodes) {
+        const std::vector<BOX> bounds {
+            BOX(VEC(+2.0, -1.0, -1.0), VEC(+3.0, +1.0, +1.0)),
+            BOX(VEC(-3.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)),
+            BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)),
+        };
+
+        AABB tree;
+        tree.build(std::vector<AABB::DataType>{ 0u, 1u, 2u }, [&](const auto i) { return bounds[i]; });
+
+        assertTree(R"(
+O [ ( -3 -1 -1 ) ( 3 1 1 ) ]
+  L [ ( -3 -1 -1 ) ( -2 1 1 ) ]: 1
+  O [ ( -1 -1 -1 ) ( 3 1 1 ) ]
+    L [ ( -1 -1 -1 ) ( 1 1 1 ) ]: 2
+    L [ ( 2 -1 -1 ) ( 3 1 1 ) ]: 0
+)" , tree);
+
+        for (size_t i = 0u; i < bounds.size(); ++i) {
+            assertTreeContains(tree, bounds[i], i);
+        }
+    }
+
+    TEST(AABBTreeTest, buildTreeWithDuplicateNode) {
+        AABB tree;
+        ASSERT_THROW(tree.build(std::vector<AABB::DataType>{ 1u, 2u, 1u }, [](const auto i) {
+            return makeBounds(static_cast<int>(i), static_cast<int>(i) + 1);
+        }), NodeTreeException);
+
+        ASSERT_TRUE(tree.empty());
+        ASSERT_FALSE(tree.contains(2u));
+    }
+
+    TEST(AABBTreeTest, buildTreeWithCoincidentNodes) {
+        std::vector<AABB::DataType> data;
+        for (size_t i = 0u; i < 100u; ++i) {
+            data.push_back(i);
+        }
+
+        const auto bounds = BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0));
+
+        AABB tree;
+        tree.build(data, [&](const auto) { return bounds; });
+
+        ASSERT_EQ(8u, tree.height());
+        for (const auto i : data) {
+            assertTreeContains(tree, bounds, i);
+        }
+    }
+
+    TEST(AABBTreeTest, buildTreeFindsSameIntersectorsAsIncrementalTree) {
+        std::vector<BOX> bounds;
+        std::vector<AABB::DataType> data;
+        for (size_t x = 0u; x < 10u; ++x) {
+            for (size_t y = 0u; y < 10u; ++y) {
+                for (size_t z = 0u; z < 10u; ++z) {
+                    const auto min = VEC(static_cast<double>(x * 4u), static_cast<double>(y * 4u), static_cast<double>(z * 4u));
+                    const auto max = min + VEC(static_cast<double>(1u + x % 3u), static_cast<double>(1u + y % 5u), static_cast<double>(1u + z % 2u));
+                    data.push_back(bounds.size());
+                    bounds.emplace_back(min, max);
+                }
+            }
+        }
+
+        AABB incrementalTree;
+        for (const auto i : data) {
+            incrementalTree.insert(bounds[i], i);
+        }
+
+        AABB bulkTree;
+        bulkTree.build(data, [&](const auto i) { return bounds[i]; });
+
+        ASSERT_EQ(incrementalTree.bounds(), bulkTree.bounds());
+        for (const auto i : data) {
+            ASSERT_TRUE(bulkTree.contains(i));
+        }
+
+        for (size_t i = 0u; i < 10u; ++i) {
+            for (size_t j = 0u; j < 10u; ++j) {
+                const auto ray = RAY(VEC(static_cast<double>(i * 4u) + 0.5, static_cast<double>(j * 4u) + 0.5, -10.0), VEC::pos_z());
+
+                std::set<AABB::DataType> expected;
+                incrementalTree.findIntersectors(ray, std::inserter(expected, std::end(expected)));
+
+                std::set<AABB::DataType> actual;
+                bulkTree.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+
+                ASSERT_FALSE(expected.empty());
+                ASSERT_EQ(expected, actual);
+            }
+        }
+    }
+
+    TEST(AABBTreeTest, findIntersectorsForRayPacket) {
+        AABB tree;
+        ASSERT_TRUE(tree.findIntersectors(std::vector<RAY>{ RAY(VEC::zero(), VEC::pos_x()) }).front().empty());
+
+        std::vector<BOX> bounds;
+        for (size_t x = 0u; x < 8u; ++x) {
+            for (size_t y = 0u; y < 8u; ++y) {
+                for (size_t z = 0u; z < 8u; ++z) {
+                    const auto min = VEC(static_cast<double>(x * 3u), static_cast<double>(y * 3u), static_cast<double>(z * 3u));
+                    const auto max = min + VEC(static_cast<double>(1u + x % 3u), static_cast<double>(1u + y % 2u), 2.0);
+                    bounds.emplace_back(min, max);
+                }
+            }
+        }
+
+        std::vector<AABB::DataType> data(bounds.size());
+        for (size_t i = 0u; i < data.size(); ++i) {
+            data[i] = i;
+        }
+        tree.build(data, [&](const auto i) { return bounds[i]; });
+
+        // more rays than fit into a single packet, including axis parallel rays, diagonal rays and rays that start
+        // inside of a box
+        std::vector<RAY> rays;
+        for (size_t i = 0u; i < 12u; ++i) {
+            for (size_t j = 0u; j < 12u; ++j) {
+                const auto u = static_cast<double>(i) * 2.0 + 0.25;
+                const auto v = static_cast<double>(j) * 2.0 + 0.25;
+                rays.emplace_back(VEC(u, v, -10.0), VEC::pos_z());
+                rays.emplace_back(VEC(-10.0, u, v), VEC::pos_x());
+                rays.emplace_back(VEC(u, -5.0, v), vm::normalize(VEC(0.1, 1.0, 0.3)));
+                rays.emplace_back(VEC(u, v, 1.0), VEC::neg_z());
+            }
+        }
+
+        const auto actual = tree.findIntersectors(rays);
+        ASSERT_EQ(rays.size(), actual.size());
+
+        bool anyHits = false;
+        for (size_t i = 0u; i < rays.size(); ++i) {
+            AABB::List expected;
+            tree.findIntersectors(rays[i], std::back_inserter(expected));
+
+            ASSERT_EQ(expected, actual[i]);
+            anyHits |= !expected.empty();
+        }
+        ASSERT_TRUE(anyHits);
+    }
+
+    TEST(AABBTreeTest, findIntersectorsWhileAlternatingUpdatesAndQueries) {
+        std::vector<BOX> bounds;
+        std::vector<AABB::DataType> data;
+        for (size_t x = 0u; x < 10u; ++x) {
+            for (size_t y = 0u; y < 10u; ++y) {
+                const auto min = VEC(static_cast<double>(x * 4u), static_cast<double>(y * 4u), 0.0);
+                data.push_back(bounds.size());
+                bounds.emplace_back(min, min + VEC(2.0, 2.0, 2.0));
+            }
+        }
+
+        AABB tree;
+        tree.build(data, [&](const auto i) { return bounds[i]; });
+
+        // Every update invalidates the flattened tree, which is only rebuilt after a number of queries, so that some
+        // of these queries traverse the tree itself and others traverse its flattened copy.
+        for (size_t i = 0u; i < 500u; ++i) {
+            const auto index = (i * 37u) % bounds.size();
+            const auto offset = (i % 3u == 0u) ? VEC(0.0, 0.0, -3.0) : VEC(1.0, 0.0, 1.5);
+            bounds[index] = bounds[index].translate(offset);
+            tree.update(bounds[index], index);
+
+            for (const auto j : { index, (index + 11u) % bounds.size() }) {
+                const auto ray = RAY(bounds[j].center() + VEC(0.0, 0.0, -100.0), VEC::pos_z());
+
+                std::set<AABB::DataType> expectedIntersectors;
+                std::set<AABB::DataType> expectedContainers;
+                for (const auto k : data) {
+                    if (bounds[k].contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds[k]))) {
+                        expectedIntersectors.insert(k);
+                    }
+                    if (bounds[k].contains(bounds[j].center())) {
+                        expectedContainers.insert(k);
+                    }
+                }
+
+                std::set<AABB::DataType> actualIntersectors;
+                tree.findIntersectors(ray, std::inserter(actualIntersectors, std::end(actualIntersectors)));
+                ASSERT_EQ(expectedIntersectors, actualIntersectors);
+
+                std::set<AABB::DataType> actualContainers;
+                tree.findContainers(bounds[j].center(), std::inserter(actualContainers, std::end(actualContainers)));
+                ASSERT_EQ(expectedContainers, actualContainers);
+            }
+        }
+    }
+
     void assertTree(const std::string& exp, const AABB& actual) {
         std::stringstream str;
         actual.print(str);
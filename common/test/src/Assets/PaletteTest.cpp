@@ -0,0 +1,82 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Color.h"
+#include "Assets/Palette.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static std::vector<unsigned char> makePaletteData() {
+            std::vector<unsigned char> data(768);
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<unsigned char>((i * 37u) % 256u);
+            }
+            return data;
+        }
+
+        static void assertIndexedToRgba(const size_t pixelCount, const PaletteTransparency transparency, const bool withIndex255) {
+            const auto paletteData = makePaletteData();
+            const Palette palette(paletteData);
+
+            std::vector<unsigned char> indices(pixelCount);
+            for (size_t i = 0; i < pixelCount; ++i) {
+                indices[i] = static_cast<unsigned char>((i * 7u) % 255u);
+            }
+            if (withIndex255) {
+                indices[pixelCount / 2] = 255;
+            }
+
+            std::vector<unsigned char> rgbaImage(pixelCount * 4);
+            Color averageColor;
+            const auto hasTransparency = palette.indexedToRgba(indices, pixelCount, rgbaImage, transparency, averageColor);
+
+            double sums[3] = { 0.0, 0.0, 0.0 };
+            for (size_t i = 0; i < pixelCount; ++i) {
+                const size_t index = indices[i];
+                for (size_t j = 0; j < 3; ++j) {
+                    ASSERT_EQ(paletteData[index * 3 + j], rgbaImage[i * 4 + j]);
+                    sums[j] += static_cast<double>(paletteData[index * 3 + j]);
+                }
+
+                const auto transparent = transparency == PaletteTransparency::Index255Transparent && index == 255;
+                ASSERT_EQ(transparent ? 0x00 : 0xFF, rgbaImage[i * 4 + 3]);
+            }
+
+            for (size_t j = 0; j < 3; ++j) {
+                ASSERT_FLOAT_EQ(static_cast<float>(sums[j] / static_cast<double>(pixelCount) / 255.0), averageColor[j]);
+            }
+            ASSERT_EQ(1.0f, averageColor[3]);
+            ASSERT_EQ(transparency == PaletteTransparency::Index255Transparent && withIndex255, hasTransparency);
+        }
+
+        TEST(PaletteTest, indexedToRgba) {
+            // include sizes that are not multiples of the SIMD width and that span several chunks
+            for (const size_t pixelCount : { 1u, 7u, 8u, 9u, 64u * 64u, 64u * 64u + 3u, 256u * 256u }) {
+                assertIndexedToRgba(pixelCount, PaletteTransparency::Opaque, false);
+                assertIndexedToRgba(pixelCount, PaletteTransparency::Opaque, true);
+                assertIndexedToRgba(pixelCount, PaletteTransparency::Index255Transparent, false);
+                assertIndexedToRgba(pixelCount, PaletteTransparency::Index255Transparent, true);
+            }
+        }
+    }
+}
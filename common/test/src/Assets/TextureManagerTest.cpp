@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TextureReader.h"
+#include "IO/WadFileSystem.h"
+#include "Renderer/GL.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static const std::vector<std::string> TextureNames = {
+            "cr8_czg_1", "cr8_czg_2", "cr8_czg_3", "cr8_czg_4", "cr8_czg_5", "speedM_1", "cap4can-o-jam",
+            "can-o-jam", "eat_me", "coffin1", "coffin2", "czg_fronthole", "czg_backhole", "u_get_this",
+            "for_sux-m-ass", "dex_5", "polished_turd", "crackpipes", "bongs2", "blowjob_machine", "lasthopeofhuman"
+        };
+
+        static size_t residentSize(const TextureManager& manager) {
+            size_t result = 0;
+            for (const auto* texture : manager.textures()) {
+                result += texture->residentSize();
+            }
+            return result;
+        }
+
+        TEST(TextureManagerTest, evictTexturesToFitBudget) {
+            IO::DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const auto palette = Palette::loadFile(fs, IO::Path("fixture/test/palette.lmp"));
+
+            IO::TextureReader::TextureNameStrategy nameStrategy;
+            const auto reader = std::make_shared<IO::IdMipTextureReader>(nameStrategy, palette);
+
+            NullLogger logger;
+            const auto wadPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/test/IO/Wad/cr8_czg.wad");
+            IO::WadFileSystem wadFS(wadPath, logger);
+
+            std::vector<Texture*> textures;
+            std::map<std::string, std::unique_ptr<const Texture>> decodedTextures;
+            for (const auto& name : TextureNames) {
+                const auto file = wadFS.openFile(IO::Path(name + ".D"));
+                textures.push_back(IO::TextureReader::readTextureLazily(reader, file));
+                decodedTextures[name] = std::unique_ptr<const Texture>(reader->readTexture(file));
+            }
+
+            TextureManager manager(GL_NEAREST, GL_NEAREST, logger);
+            manager.setTextureCollections({ new TextureCollection(wadPath, textures) });
+            ASSERT_EQ(TextureNames.size(), manager.textures().size());
+
+            size_t totalSize = 0;
+            for (const auto* texture : manager.textures()) {
+                texture->simulateUpload();
+                ASSERT_GT(texture->residentSize(), 0u);
+                totalSize += texture->residentSize();
+            }
+
+            const auto budget = totalSize / 2;
+            manager.setTextureBudget(budget);
+
+            // every texture was used since the last call, so every texture gets a second chance
+            manager.evictTextures();
+            ASSERT_EQ(totalSize, residentSize(manager));
+
+            manager.evictTextures();
+            ASSERT_LE(residentSize(manager), budget);
+            ASSERT_GT(residentSize(manager), 0u);
+
+            // a texture that was used since the last call is not evicted even if it exceeds the budget
+            Texture* usedTexture = nullptr;
+            for (auto* texture : manager.textures()) {
+                if (texture->residentSize() > 0u) {
+                    usedTexture = texture;
+                    break;
+                }
+            }
+            ASSERT_TRUE(usedTexture != nullptr);
+            usedTexture->simulateUpload();
+
+            manager.setTextureBudget(0u);
+            manager.evictTextures();
+            ASSERT_EQ(usedTexture->residentSize(), residentSize(manager));
+            ASSERT_GT(usedTexture->residentSize(), 0u);
+
+            // evicted textures are decoded again when they are used
+            for (const auto* texture : manager.textures()) {
+                if (texture == usedTexture) {
+                    continue;
+                }
+
+                ASSERT_EQ(0u, texture->residentSize());
+                texture->ensureDecoded();
+
+                const auto& decodedTexture = decodedTextures.at(texture->name());
+                ASSERT_EQ(decodedTexture->buffersIfUnprepared(), texture->buffersIfUnprepared());
+                ASSERT_EQ(decodedTexture->averageColor(), texture->averageColor());
+
+                texture->simulateUpload();
+                ASSERT_GT(texture->residentSize(), 0u);
+            }
+        }
+    }
+}
@@ -27,11 +27,16 @@
 #include "IO/DiskIO.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/Path.h"
+#include "IO/PathQt.h"
+#include "IO/TestEnvironment.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <memory>
 #include <string>
 
+#include <QFile>
+
 namespace TrenchBroom {
     namespace IO {
         static void assertTexture(const std::string& name, const size_t width, const size_t height, const FileSystem& fs, const TextureReader& loader) {
@@ -77,5 +82,63 @@ namespace TrenchBroom {
             assertTexture("blowjob_machine",   128, 128, wadFS, textureLoader);
             assertTexture("lasthopeofhuman",   128, 128, wadFS, textureLoader);
         }
+
+        TEST(IdMipTextureReaderTest, testLoadWadLazily) {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            auto textureLoader = std::make_shared<IdMipTextureReader>(nameStrategy, palette);
+
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem wadFS(wadPath, logger);
+
+            const auto file = wadFS.openFile(Path("cr8_czg_3.D"));
+            std::unique_ptr<const Assets::Texture> eager(textureLoader->readTexture(file));
+            std::unique_ptr<const Assets::Texture> lazy(TextureReader::readTextureLazily(textureLoader, file));
+
+            ASSERT_TRUE(lazy != nullptr);
+            ASSERT_EQ("cr8_czg_3", lazy->name());
+            ASSERT_EQ(64u, lazy->width());
+            ASSERT_EQ(128u, lazy->height());
+            ASSERT_EQ(eager->type(), lazy->type());
+            ASSERT_TRUE(lazy->buffersIfUnprepared().empty());
+
+            // the average color is estimated from the smallest mip level until the texture is decoded
+            for (size_t i = 0; i < 3; ++i) {
+                ASSERT_NEAR(eager->averageColor()[i], lazy->averageColor()[i], 0.05f);
+            }
+
+            lazy->ensureDecoded();
+            ASSERT_EQ(eager->buffersIfUnprepared(), lazy->buffersIfUnprepared());
+            ASSERT_EQ(eager->averageColor(), lazy->averageColor());
+        }
+
+        TEST(IdMipTextureReaderTest, testDoNotDecodeTruncatedWadLazily) {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            auto textureLoader = std::make_shared<IdMipTextureReader>(nameStrategy, palette);
+
+            TestEnvironment env("idmiptexturereadertest");
+            const auto wadPath = env.dir() + Path("cr8_czg.wad");
+            ASSERT_TRUE(QFile::copy(pathAsQString(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad")), pathAsQString(wadPath)));
+
+            std::unique_ptr<const Assets::Texture> lazy;
+            {
+                NullLogger logger;
+                WadFileSystem wadFS(wadPath, logger);
+                lazy.reset(TextureReader::readTextureLazily(textureLoader, wadFS.openFile(Path("lasthopeofhuman.D"))));
+            }
+            ASSERT_TRUE(lazy != nullptr);
+
+            // the texture keeps the wad file mapped into memory, and reading past its new end would crash
+            ASSERT_TRUE(QFile::resize(pathAsQString(wadPath), 1024));
+
+            lazy->ensureDecoded();
+            ASSERT_TRUE(lazy->buffersIfUnprepared().empty());
+        }
     }
 }
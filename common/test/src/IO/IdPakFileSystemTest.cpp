@@ -22,10 +22,15 @@
 #include "Exceptions.h"
 #include "IO/DiskIO.h"
 #include "IO/FileMatcher.h"
+#include "IO/File.h"
 #include "IO/IdPakFileSystem.h"
+#include "IO/PathQt.h"
+#include "IO/TestEnvironment.h"
 
 #include <algorithm>
 
+#include <QFile>
+
 namespace TrenchBroom {
     namespace IO {
         TEST(IdPakFileSystemTest, directoryExists) {
@@ -138,5 +143,21 @@ namespace TrenchBroom {
 
             ASSERT_TRUE(fs.openFile(Path("amnet.cfg")) != nullptr);
         }
+
+        TEST(IdPakFileSystemTest, openFileAfterTruncatingPak) {
+            TestEnvironment env("idpakfilesystemtest");
+            const auto pakPath = env.dir() + Path("pak1.pak");
+            ASSERT_TRUE(QFile::copy(pathAsQString(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Pak/pak1.pak")), pathAsQString(pakPath)));
+
+            const IdPakFileSystem fs(pakPath);
+            const auto file = fs.openFile(Path("amnet.cfg"));
+            ASSERT_NO_THROW(file->reader());
+
+            // the pak file stays mapped into memory, and reading past its new end would crash
+            ASSERT_TRUE(QFile::resize(pathAsQString(pakPath), 16));
+
+            ASSERT_THROW(file->reader(), FileSystemException);
+            ASSERT_THROW(fs.openFile(Path("amnet.cfg"))->reader(), FileSystemException);
+        }
     }
 }
@@ -148,6 +148,35 @@ R"(// entity 0
             ASSERT_EQ(expected, actual);
         }
 
+        TEST(NodeWriterTest, writeMapWithManyBrushesInParallel) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Valve);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            for (size_t i = 0; i < 1000; ++i) {
+                const auto min = vm::vec3(static_cast<double>(i) * 16.0 - 4096.0, 0.0, 0.0);
+                map.defaultLayer()->addChild(builder.createCuboid(vm::bbox3(min, min + vm::vec3(8.0, 8.0, 8.0)), "some_texture"));
+            }
+
+            const auto writeMap = [&](const size_t threadCount) {
+                std::stringstream str;
+                NodeWriter writer(map, str);
+                writer.setThreadCount(threadCount);
+                writer.writeMap();
+                return str.str();
+            };
+
+            const auto expected = writeMap(1u);
+            ASSERT_TRUE(kdl::cs::str_is_prefix(expected, "// entity 0\n{\n\"classname\" \"worldspawn\"\n// brush 0\n{\n"));
+            ASSERT_NE(std::string::npos, expected.find("// brush 999\n"));
+
+            for (const size_t threadCount : { 2u, 3u, 8u }) {
+                ASSERT_EQ(expected, writeMap(threadCount));
+            }
+        }
+
         TEST(NodeWriterTest, writeWorldspawnWithBrushInCustomLayer) {
             const vm::bbox3 worldBounds(8192.0);
 
@@ -24,6 +24,8 @@
 #include "IO/Reader.h"
 #include "IO/ReaderException.h"
 
+#include <kdl/parallel.h>
+
 #include <memory>
 #include <string>
 
@@ -31,6 +33,7 @@ namespace TrenchBroom {
     namespace IO {
         const char* buff();
         std::shared_ptr<File> file();
+        std::shared_ptr<MappedFile> mappedFile();
         void createEmpty(Reader&& r);
         void createNonEmpty(Reader&& r);
         void seekFromBegin(Reader&& r);
@@ -44,7 +47,12 @@ namespace TrenchBroom {
         }
 
         std::shared_ptr<File> file() {
-            static auto result = Disk::openFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
+            static auto result = std::make_shared<CFile>(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
+            return result;
+        }
+
+        std::shared_ptr<MappedFile> mappedFile() {
+            static auto result = std::make_shared<MappedFile>(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/10byte"));
             return result;
         }
 
@@ -65,7 +73,12 @@ namespace TrenchBroom {
         }
 
         TEST(FileReaderTest, createEmpty) {
-            const auto emptyFile = Disk::openFile(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/empty"));
+            const auto emptyFile = std::make_shared<CFile>(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/empty"));
+            createEmpty(emptyFile->reader());
+        }
+
+        TEST(MappedFileReaderTest, createEmpty) {
+            const auto emptyFile = std::make_shared<MappedFile>(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Reader/empty"));
             createEmpty(emptyFile->reader());
         }
 
@@ -101,6 +114,10 @@ namespace TrenchBroom {
             createNonEmpty(file()->reader());
         }
 
+        TEST(MappedFileReaderTest, createNonEmpty) {
+            createNonEmpty(mappedFile()->reader());
+        }
+
         void seekFromBegin(Reader&& r) {
             r.seekFromBegin(0U);
             EXPECT_EQ(0U, r.position());
@@ -124,6 +141,10 @@ namespace TrenchBroom {
             seekFromBegin(file()->reader());
         }
 
+        TEST(MappedFileReaderTest, testSeekFromBegin) {
+            seekFromBegin(mappedFile()->reader());
+        }
+
         void seekFromEnd(Reader&& r) {
             r.seekFromEnd(0U);
             EXPECT_EQ(10U, r.position());
@@ -146,6 +167,10 @@ namespace TrenchBroom {
             seekFromEnd(file()->reader());
         }
 
+        TEST(MappedFileReaderTest, testSeekFromEnd) {
+            seekFromEnd(mappedFile()->reader());
+        }
+
         void seekForward(Reader&& r) {
             r.seekForward(1U);
             EXPECT_EQ(1U, r.position());
@@ -165,6 +190,10 @@ namespace TrenchBroom {
             seekForward(file()->reader());
         }
 
+        TEST(MappedFileReaderTest, testSeekForward) {
+            seekForward(mappedFile()->reader());
+        }
+
         void subReader(Reader&& r) {
             auto s = r.subReaderFromBegin(5, 3);
 
@@ -191,5 +220,35 @@ namespace TrenchBroom {
         TEST(FileReaderTest, testSubReader) {
             subReader(file()->reader());
         }
+
+        TEST(MappedFileReaderTest, testSubReader) {
+            subReader(mappedFile()->reader());
+        }
+
+        TEST(MappedFileReaderTest, testBufferDoesNotCopy) {
+            const FileView view(Path("view"), mappedFile(), 2u, 5u);
+            const auto buffer = view.reader().buffer();
+
+            ASSERT_EQ(mappedFile()->begin() + 2, buffer.begin());
+            ASSERT_EQ(mappedFile()->begin() + 7, buffer.end());
+            ASSERT_EQ(std::string("cdefg"), std::string(buffer.begin(), buffer.end()));
+        }
+
+        TEST(FileReaderTest, testConcurrentSubReaders) {
+            // sub readers of the same file share its seek position
+            auto r = file()->reader();
+            kdl::parallel_for(1000u, [&](const size_t i) {
+                const auto offset = i % 8u;
+                auto s = r.subReaderFromBegin(offset, 2u);
+
+                const auto expected = std::string(buff() + offset, 2u);
+                if (i % 2u == 0u) {
+                    ASSERT_EQ(expected, s.readString(2u));
+                } else {
+                    auto b = s.buffer();
+                    ASSERT_EQ(expected, std::string(b.begin(), b.end()));
+                }
+            }, 8u);
+        }
     }
 }
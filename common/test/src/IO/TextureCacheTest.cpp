@@ -0,0 +1,170 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "IO/WadFileSystem.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const std::vector<std::string> TextureNames = {
+            "cr8_czg_1", "cr8_czg_3", "speedM_1", "coffin1", "czg_fronthole", "lasthopeofhuman"
+        };
+
+        static std::unique_ptr<IdMipTextureReader> createReader() {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const auto palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            return std::make_unique<IdMipTextureReader>(nameStrategy, palette);
+        }
+
+        static void assertTexturesEqual(const Assets::Texture& expected, const Assets::Texture& actual) {
+            ASSERT_EQ(expected.name(), actual.name());
+            ASSERT_EQ(expected.width(), actual.width());
+            ASSERT_EQ(expected.height(), actual.height());
+            ASSERT_EQ(expected.format(), actual.format());
+            ASSERT_EQ(expected.type(), actual.type());
+            ASSERT_EQ(expected.averageColor(), actual.averageColor());
+            ASSERT_EQ(expected.buffersIfUnprepared(), actual.buffersIfUnprepared());
+        }
+
+        TEST(TextureCacheTest, cachedTexturesAreIdenticalToDecodedTextures) {
+            TestEnvironment env("texturecachetest");
+            const auto cache = std::make_shared<TextureCache>(env.dir() + Path("cache"), 1024u * 1024u);
+
+            const auto uncachedReader = createReader();
+            const auto cachedReader = createReader();
+            cachedReader->setCache(cache);
+
+            NullLogger logger;
+            WadFileSystem wadFS(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad"), logger);
+
+            for (const auto& name : TextureNames) {
+                const auto file = wadFS.openFile(Path(name + ".D"));
+                std::unique_ptr<Assets::Texture> decoded(uncachedReader->readTexture(file));
+
+                // the first read decodes the texture and stores it, the second read loads it from the cache
+                std::unique_ptr<Assets::Texture> stored(cachedReader->readTexture(file));
+                cache->flush();
+                std::unique_ptr<Assets::Texture> loaded(cachedReader->readTexture(file));
+
+                assertTexturesEqual(*decoded, *stored);
+                assertTexturesEqual(*decoded, *loaded);
+            }
+
+            ASSERT_GT(cache->size(), 0u);
+
+            // a new cache in the same directory finds the stored entries
+            const auto reopenedCache = std::make_shared<TextureCache>(env.dir() + Path("cache"), 1024u * 1024u);
+            reopenedCache->flush();
+            ASSERT_EQ(cache->size(), reopenedCache->size());
+        }
+
+        TEST(TextureCacheTest, keyDependsOnSourceAndSalt) {
+            const FileSource source{ Path("textures/a.wad"), 12u, 256u, 1000 };
+
+            ASSERT_EQ(TextureCache::key(source, 0u), TextureCache::key(source, 0u));
+            ASSERT_NE(TextureCache::key(source, 0u), TextureCache::key(source, 1u));
+            ASSERT_NE(TextureCache::key(source, 0u), TextureCache::key(FileSource{ Path("textures/b.wad"), 12u, 256u, 1000 }, 0u));
+            ASSERT_NE(TextureCache::key(source, 0u), TextureCache::key(FileSource{ Path("textures/a.wad"), 13u, 256u, 1000 }, 0u));
+            ASSERT_NE(TextureCache::key(source, 0u), TextureCache::key(FileSource{ Path("textures/a.wad"), 12u, 255u, 1000 }, 0u));
+            ASSERT_NE(TextureCache::key(source, 0u), TextureCache::key(FileSource{ Path("textures/a.wad"), 12u, 256u, 1001 }, 0u));
+        }
+
+        TEST(TextureCacheTest, doesNotCacheFilesWithoutSource) {
+            TestEnvironment env("texturecachetest");
+            const auto cache = std::make_shared<TextureCache>(env.dir() + Path("cache"), 1024u * 1024u);
+
+            const auto reader = createReader();
+            reader->setCache(cache);
+
+            NullLogger logger;
+            WadFileSystem wadFS(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad"), logger);
+
+            const auto wadFile = wadFS.openFile(Path("cr8_czg_1.D"));
+            ASSERT_TRUE(wadFile->source().has_value());
+
+            // a copy of the texture in memory, such as a texture that was decompressed from an archive
+            const auto contents = wadFile->reader().buffer();
+            const auto file = std::make_shared<NonOwningBufferFile>(wadFile->path(), contents.begin(), contents.end());
+            ASSERT_FALSE(file->source().has_value());
+
+            std::unique_ptr<Assets::Texture> texture(reader->readTexture(file));
+            ASSERT_TRUE(texture != nullptr);
+            cache->flush();
+            ASSERT_EQ(0u, cache->size());
+        }
+
+        TEST(TextureCacheTest, evictsOldestEntriesWhenFull) {
+            TestEnvironment env("texturecachetest");
+
+            // each of these textures takes up more than 20 KB
+            const std::vector<std::string> textureNames = {
+                "cr8_czg_1", "cr8_czg_2", "cap4can-o-jam", "can-o-jam", "eat_me", "u_get_this"
+            };
+            const size_t sizeLimit = 48u * 1024u;
+            const auto cache = std::make_shared<TextureCache>(env.dir() + Path("cache"), sizeLimit);
+
+            const auto reader = createReader();
+            reader->setCache(cache);
+
+            NullLogger logger;
+            WadFileSystem wadFS(Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad"), logger);
+
+            for (const auto& name : textureNames) {
+                std::unique_ptr<Assets::Texture> texture(reader->readTexture(wadFS.openFile(Path(name + ".D"))));
+                cache->flush();
+                ASSERT_LE(cache->size(), sizeLimit);
+            }
+            ASSERT_GT(cache->size(), 0u);
+        }
+
+        TEST(TextureCacheTest, ignoresInvalidEntries) {
+            TestEnvironment env("texturecachetest");
+            const auto cache = std::make_shared<TextureCache>(env.dir() + Path("cache"), 1024u * 1024u);
+
+            const auto key = TextureCache::key(FileSource{ Path("textures/a.wad"), 0u, 16u, 0 }, 0u);
+
+            // a texture without pixels is not stored
+            const Assets::Texture texture("a", 16, 16);
+            cache->store(key, texture);
+            cache->flush();
+            ASSERT_TRUE(cache->load(key, "a") == nullptr);
+            ASSERT_EQ(0u, cache->size());
+
+            env.createFile(Path("cache/0000000000000001.tex"), "TBTC garbage");
+            ASSERT_TRUE(cache->load(1u, "a") == nullptr);
+        }
+    }
+}
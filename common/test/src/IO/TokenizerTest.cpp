@@ -23,6 +23,7 @@
 #include "IO/Tokenizer.h"
 
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
     namespace IO {
@@ -240,5 +241,44 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+
+        TEST(TokenizerTest, simpleLanguageNumbersWithPlusSign) {
+            const std::string testString("+12 +3.5");
+
+            SimpleTokenizer tokenizer(testString);
+            SimpleTokenizer::Token token;
+            ASSERT_EQ(SimpleToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(12, token.toInteger<int>());
+            ASSERT_EQ(SimpleToken::Decimal, (token = tokenizer.nextToken()).type());
+            ASSERT_DOUBLE_EQ(3.5, token.toFloat<double>());
+            ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
+        }
+
+        TEST(TokenizerTest, simpleLanguagePeekRestoresPosition) {
+            const std::string testString("{\n"
+                                    "  attribute = 1;\n"
+                                    "}");
+
+            SimpleTokenizer tokenizer(testString);
+            SimpleTokenizer::Token token;
+            ASSERT_EQ(SimpleToken::OBrace, tokenizer.nextToken().type());
+
+            const auto snapshot = tokenizer.snapshot();
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.peekToken()).type());
+            ASSERT_EQ(std::string_view("attribute"), token.view());
+            ASSERT_EQ(2u, token.line());
+            ASSERT_EQ(3u, token.column());
+
+            ASSERT_EQ(SimpleToken::String, tokenizer.nextToken().type());
+            ASSERT_EQ(SimpleToken::Equals, tokenizer.nextToken().type());
+
+            tokenizer.restore(snapshot);
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(2u, token.line());
+            ASSERT_EQ(3u, token.column());
+            ASSERT_EQ(SimpleToken::Equals, tokenizer.nextToken().type());
+            ASSERT_EQ(SimpleToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(1, token.toInteger<int>());
+        }
     }
 }
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/Brush.h"
@@ -29,6 +30,7 @@
 
 #include <vecmath/vec.h>
 
+#include <sstream>
 #include <string>
 
 namespace TrenchBroom {
@@ -931,6 +933,145 @@ common/caulk
             ASSERT_STREQ("vm::line1\\nvm::line2", world->attribute("message").c_str());
         }
 
+        TEST(WorldReaderTest, parseWithParallelBrushGeometry) {
+            const std::string data(R"(
+{
+"classname" "light"
+"_tb_layer" "1"
+}
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1
+}
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_layer"
+"_tb_name" "My Layer"
+"_tb_id" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_group"
+"_tb_type" "_tb_group"
+"_tb_name" "My Group"
+"_tb_id" "1"
+"_tb_layer" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+}
+{
+"classname" "func_door"
+"_tb_group" "1"
+{
+( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) rtz/c_mf_v3c 56 -32 0 1 1
+}
+})");
+            const vm::bbox3 worldBounds(8192.0);
+
+            const auto readAndWrite = [&](const size_t threadCount) {
+                IO::TestParserStatus status;
+                WorldReader reader(data);
+                reader.setThreadCount(threadCount);
+
+                auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+                EXPECT_EQ(1u, status.countStatus(LogLevel::Error));
+
+                std::stringstream str;
+                NodeWriter writer(*world, str);
+                writer.writeMap();
+                return str.str();
+            };
+
+            const auto expected = readAndWrite(1u);
+            ASSERT_EQ(expected, readAndWrite(2u));
+            ASSERT_EQ(expected, readAndWrite(8u));
+        }
+
+        TEST(WorldReaderTest, parseWithParallelBrushRanges) {
+            // braces in texture names and attribute values, attributes and extra attributes between brushes, an
+            // invalid brush and Windows line endings
+            const std::string brush(
+                "{\r\n"
+                "( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) {fence 0 0 0 1 1\r\n"
+                "( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex} 0 0 0 1 1\r\n"
+                "( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1\r\n"
+                "( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1\r\n"
+                "( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1\r\n"
+                "( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1\r\n"
+                "}\r\n");
+            const std::string invalidBrush(
+                "{\r\n"
+                "( -0 -0 -16 ) ( -0 -0 -16 ) ( 64 -0 -16 ) none 0 0 0 1 1\r\n"
+                "( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1\r\n"
+                "( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1\r\n"
+                "( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1\r\n"
+                "}\r\n");
+
+            std::string data("{\r\n\"classname\" \"worldspawn\"\r\n\"message\" \"{ not a brush }\"\r\n");
+            for (size_t i = 0; i < 32; ++i) {
+                data += "// brush " + std::to_string(i) + "\r\n" + (i == 17 ? invalidBrush : brush);
+                if (i == 8) {
+                    data += "\"late\" \"attribute\"\r\n";
+                }
+            }
+            data += "}\r\n{\r\n\"classname\" \"func_door\"\r\n/// hideIssues 2\r\n" + brush + brush + "}\r\n";
+
+            const vm::bbox3 worldBounds(8192.0);
+
+            const auto readAndWrite = [&](const size_t threadCount) {
+                IO::TestParserStatus status;
+                WorldReader reader(data);
+                reader.setThreadCount(threadCount);
+
+                auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+                EXPECT_EQ(2u, status.countStatus(LogLevel::Error));
+                EXPECT_EQ(32u, world->defaultLayer()->childCount());
+
+                std::stringstream str;
+                NodeWriter writer(*world, str);
+                writer.writeMap();
+                return str.str();
+            };
+
+            const auto expected = readAndWrite(1u);
+            ASSERT_EQ(expected, readAndWrite(2u));
+            ASSERT_EQ(expected, readAndWrite(3u));
+            ASSERT_EQ(expected, readAndWrite(8u));
+        }
+
         /*
         TEST(WorldReaderTest, parseIssueIgnoreFlags) {
             const std::string data("{"
@@ -72,6 +72,29 @@ namespace TrenchBroom {
             ASSERT_THROW(new BrushFace(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs)), GeometryException);
         }
 
+        TEST(BrushFaceTest, cloneSharesDataUntilModified) {
+            const vm::vec3 p0(0.0,  0.0, 4.0);
+            const vm::vec3 p1(1.0,  0.0, 4.0);
+            const vm::vec3 p2(0.0, -1.0, 4.0);
+
+            const BrushFaceAttributes attribs("");
+            BrushFace face(p0, p1, p2, attribs, std::make_unique<ParaxialTexCoordSystem>(p0, p1, p2, attribs));
+            std::unique_ptr<BrushFace> clone(face.clone());
+            ASSERT_EQ(face.data(), clone->data());
+
+            clone->transform(vm::translation_matrix(vm::vec3(0.0, 0.0, 4.0)), false);
+            ASSERT_NE(face.data(), clone->data());
+            ASSERT_EQ(4.0, face.boundary().distance);
+            ASSERT_EQ(8.0, clone->boundary().distance);
+            ASSERT_VEC_EQ(p0, face.points()[0]);
+
+            // the data is no longer shared, so it is modified in place
+            const auto data = clone->data().get();
+            clone->transform(vm::translation_matrix(vm::vec3(0.0, 0.0, 4.0)), false);
+            ASSERT_EQ(data, clone->data().get());
+            ASSERT_EQ(12.0, clone->boundary().distance);
+        }
+
         TEST(BrushFaceTest, textureUsageCount) {
             const vm::vec3 p0(0.0,  0.0, 4.0);
             const vm::vec3 p1(1.0,  0.0, 4.0);
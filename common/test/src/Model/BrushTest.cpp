@@ -40,6 +40,8 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/vec.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
@@ -2738,6 +2740,47 @@ namespace TrenchBroom {
             kdl::col_delete_all(result);
         }
 
+        TEST(BrushTest, subtractMultipleWithDisjointFragments) {
+            const vm::bbox3 worldBounds(4096.0);
+            World world(MapFormat::Standard);
+
+            // the second subtrahend is disjoint from some of the fragments of the first subtraction, and the third
+            // subtrahend is disjoint from the minuend
+            const vm::bbox3 minuendBounds(vm::vec3(0.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 64.0));
+            const std::vector<vm::bbox3> subtrahendBounds {
+                vm::bbox3(vm::vec3(0.0, 0.0, 32.0), vm::vec3(32.0, 64.0, 64.0)),
+                vm::bbox3(vm::vec3(48.0, 0.0, 0.0), vm::vec3(64.0, 64.0, 16.0)),
+                vm::bbox3(vm::vec3(128.0, 128.0, 128.0), vm::vec3(192.0, 192.0, 192.0))
+            };
+
+            BrushBuilder builder(&world, worldBounds);
+            Brush* minuend = builder.createCuboid(minuendBounds, "minuend");
+
+            std::vector<Brush*> subtrahends;
+            for (const auto& bounds : subtrahendBounds) {
+                subtrahends.push_back(builder.createCuboid(bounds, "subtrahend"));
+            }
+
+            const std::vector<Brush*> result = minuend->subtract(world, worldBounds, "default", subtrahends);
+            ASSERT_FALSE(result.empty());
+
+            FloatType volume = 0.0;
+            for (const Brush* fragment : result) {
+                const auto& bounds = fragment->logicalBounds();
+                ASSERT_TRUE(minuendBounds.contains(bounds));
+                for (const auto& subtrahend : subtrahendBounds) {
+                    // all fragments are at least 16 units wide, so their interior must not touch any subtrahend
+                    ASSERT_FALSE(bounds.expand(-1.0).intersects(subtrahend));
+                }
+                volume += bounds.volume();
+            }
+            ASSERT_DOUBLE_EQ(64.0 * 64.0 * 64.0 - 32.0 * 64.0 * 32.0 - 16.0 * 64.0 * 16.0, volume);
+
+            delete minuend;
+            kdl::col_delete_all(subtrahends);
+            kdl::col_delete_all(result);
+        }
+
         TEST(BrushTest, subtractEnclosed) {
             const vm::bbox3 worldBounds(4096.0);
             World world(MapFormat::Standard);
@@ -3428,6 +3471,44 @@ namespace TrenchBroom {
             delete cube;
         }
 
+        TEST(BrushTest, snapshotSharesFaceData) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard);
+            const BrushBuilder builder(&world, worldBounds);
+
+            std::unique_ptr<Brush> cube(builder.createCube(128.0, "some_texture"));
+
+            std::vector<const BrushFace::Data*> originalData;
+            std::vector<vm::plane3> originalBoundaries;
+            for (const BrushFace* face : cube->faces()) {
+                originalData.push_back(face->data().get());
+                originalBoundaries.push_back(face->boundary());
+            }
+
+            std::unique_ptr<NodeSnapshot> snapshot(cube->takeSnapshot());
+            ASSERT_NE(nullptr, snapshot);
+
+            // taking the snapshot doesn't copy the face data
+            for (size_t i = 0; i < cube->faceCount(); ++i) {
+                ASSERT_EQ(originalData[i], cube->faces()[i]->data().get());
+            }
+
+            cube->transform(vm::translation_matrix(vm::vec3(32.0, 0.0, 0.0)), false, worldBounds);
+            for (size_t i = 0; i < cube->faceCount(); ++i) {
+                ASSERT_NE(originalData[i], cube->faces()[i]->data().get());
+            }
+
+            snapshot->restore(worldBounds);
+            ASSERT_EQ(originalData.size(), cube->faceCount());
+            for (size_t i = 0; i < cube->faceCount(); ++i) {
+                const auto* face = cube->faces()[i];
+                ASSERT_EQ(originalData[i], face->data().get());
+                ASSERT_VEC_EQ(originalBoundaries[i].normal, face->boundary().normal);
+                ASSERT_DOUBLE_EQ(originalBoundaries[i].distance, face->boundary().distance);
+                ASSERT_EQ("some_texture", face->textureName());
+            }
+        }
+
         TEST(BrushTest, resizePastWorldBounds) {
             const vm::bbox3 worldBounds(8192.0);
             World world(MapFormat::Standard);
@@ -0,0 +1,263 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/CollectNodesVisitor.h"
+#include "Model/EmptyAttributeValueIssueGenerator.h"
+#include "Model/EmptyBrushEntityIssueGenerator.h"
+#include "Model/EmptyGroupIssueGenerator.h"
+#include "Model/Entity.h"
+#include "Model/Issue.h"
+#include "Model/IssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/LongAttributeNameIssueGenerator.h"
+#include "Model/MissingClassnameIssueGenerator.h"
+#include "Model/NonIntegerPlanePointsIssueGenerator.h"
+#include "Model/NonIntegerVerticesIssueGenerator.h"
+#include "Model/WorldBoundsIssueGenerator.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushIssue : public Issue {
+        public:
+            static const IssueType Type;
+        public:
+            explicit BrushIssue(Brush* brush) :
+            Issue(brush) {}
+        private:
+            IssueType doGetType() const override {
+                return Type;
+            }
+
+            std::string doGetDescription() const override {
+                return "Brush";
+            }
+        };
+
+        const IssueType BrushIssue::Type = Issue::freeType();
+
+        /**
+         * Reports every brush, and is not thread safe so that it must run on the calling thread.
+         */
+        class BrushIssueGenerator : public IssueGenerator {
+        public:
+            BrushIssueGenerator() :
+            IssueGenerator(BrushIssue::Type, "Brush") {}
+        private:
+            void doGenerate(Brush* brush, IssueList& issues) const override {
+                issues.push_back(new BrushIssue(brush));
+            }
+        };
+
+        static std::unique_ptr<World> loadWorld(const std::string& data) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            IO::WorldReader reader(data);
+            auto world = reader.read(MapFormat::Standard, worldBounds, status);
+
+            world->registerIssueGenerator(new MissingClassnameIssueGenerator());
+            world->registerIssueGenerator(new EmptyAttributeValueIssueGenerator());
+            world->registerIssueGenerator(new EmptyBrushEntityIssueGenerator());
+            world->registerIssueGenerator(new LinkTargetIssueGenerator());
+            world->registerIssueGenerator(new LongAttributeNameIssueGenerator(8));
+            world->registerIssueGenerator(new NonIntegerPlanePointsIssueGenerator());
+            world->registerIssueGenerator(new NonIntegerVerticesIssueGenerator());
+            world->registerIssueGenerator(new WorldBoundsIssueGenerator(vm::bbox3(1024.0)));
+            world->registerIssueGenerator(new BrushIssueGenerator());
+            return world;
+        }
+
+        static const std::string MapData(R"(
+// entity 0
+{
+"classname" "worldspawn"
+"averyverylongkey" "value"
+// brush 0
+{
+( 0 0 0 ) ( 0 1 0 ) ( 0 0 1 ) tex 0 0 0 1 1
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) tex 0 0 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex 0 0 0 1 1
+( 64 64 64 ) ( 64 64 65 ) ( 64 65 64 ) tex 0 0 0 1 1
+( 64 64 64 ) ( 65 64 64 ) ( 64 64 65 ) tex 0 0 0 1 1
+( 64 64 64 ) ( 64 65 64 ) ( 65 64 64 ) tex 0 0 0 1 1
+}
+// brush 1
+{
+( 2000 0 0 ) ( 2000 1 0 ) ( 2000 0 1 ) tex 0 0 0 1 1
+( 2000 0 0 ) ( 2000 0 1 ) ( 2001 0 0 ) tex 0 0 0 1 1
+( 2000 0 0 ) ( 2001 0 0 ) ( 2000 1 0 ) tex 0 0 0 1 1
+( 2064 64 64 ) ( 2064 64 65 ) ( 2064 65 64 ) tex 0 0 0 1 1
+( 2064 64 64 ) ( 2065 64 64 ) ( 2064 64 65 ) tex 0 0 0 1 1
+( 2064 64 64 ) ( 2064 65 64 ) ( 2065 64 64 ) tex 0 0 0 1 1
+}
+// brush 2
+{
+( 0.5 0 0 ) ( 0.5 1 0 ) ( 0.5 0 1 ) tex 0 0 0 1 1
+( 0 0 0 ) ( 0 0 1 ) ( 1 0 0 ) tex 0 0 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 0 1 0 ) tex 0 0 0 1 1
+( 64 64 64 ) ( 64 64 65 ) ( 64 65 64 ) tex 0 0 0 1 1
+( 64 64 64 ) ( 65 64 64 ) ( 64 64 65 ) tex 0 0 0 1 1
+( 64 64 64 ) ( 64 65 64 ) ( 65 64 64 ) tex 0 0 0 1 1
+}
+}
+// entity 1
+{
+"origin" "0 0 0"
+"target" "nothing"
+"message" ""
+}
+// entity 2
+{
+"classname" "func_wall"
+}
+// entity 3
+{
+"classname" "light"
+"origin" "4000 0 0"
+}
+)");
+
+        using IssueKey = std::tuple<size_t, IssueType, std::string>;
+
+        static std::vector<IssueKey> collectIssues(World& world) {
+            CollectNodesVisitor visitor;
+            world.acceptAndRecurse(visitor);
+
+            std::vector<IssueKey> result;
+            for (auto* node : visitor.nodes()) {
+                for (const auto* issue : node->issues(world.registeredIssueGenerators())) {
+                    result.emplace_back(issue->lineNumber(), issue->type(), issue->description());
+                }
+            }
+
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
+        template <typename P>
+        static AttributableNode* findAttributableNode(World& world, const P& predicate) {
+            CollectNodesVisitor visitor;
+            world.acceptAndRecurse(visitor);
+            for (auto* node : visitor.nodes()) {
+                auto* attributable = dynamic_cast<AttributableNode*>(node);
+                if (attributable != nullptr && predicate(attributable)) {
+                    return attributable;
+                }
+            }
+            return nullptr;
+        }
+
+        static Brush* findBrush(World& world, const size_t index) {
+            CollectNodesVisitor visitor;
+            world.acceptAndRecurse(visitor);
+
+            size_t count = 0u;
+            for (auto* node : visitor.nodes()) {
+                auto* brush = dynamic_cast<Brush*>(node);
+                if (brush != nullptr && count++ == index) {
+                    return brush;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * Changes the attributes, the geometry, the children and the links of some nodes.
+         */
+        static void editWorld(World& world) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            auto* light = findAttributableNode(world, [](const AttributableNode* node) { return node->classname() == "light"; });
+            auto* target = findAttributableNode(world, [](const AttributableNode* node) { return node->hasAttribute("target"); });
+            auto* funcWall = findAttributableNode(world, [](const AttributableNode* node) { return node->classname() == "func_wall"; });
+            ASSERT_NE(nullptr, light);
+            ASSERT_NE(nullptr, target);
+            ASSERT_NE(nullptr, funcWall);
+
+            // resolves the missing link target of another entity
+            light->addOrUpdateAttribute("targetname", "nothing");
+            // removes an empty attribute value
+            target->removeAttribute("message");
+
+            auto* brush = findBrush(world, 2u);
+            ASSERT_NE(nullptr, brush);
+            brush->transform(vm::translation_matrix(vm::vec3(0.5, 0.0, 0.0)), false, worldBounds);
+
+            // moves the bounds of the entity out of the world bounds
+            funcWall->addChild(findBrush(world, 1u)->clone(worldBounds));
+        }
+
+        TEST(IssueValidationTest, incrementalValidationFindsSameIssues) {
+            auto incrementalWorld = loadWorld(MapData);
+            const auto issuesBeforeEdit = collectIssues(*incrementalWorld);
+
+            editWorld(*incrementalWorld);
+            const auto issuesAfterEdit = collectIssues(*incrementalWorld);
+            ASSERT_NE(issuesBeforeEdit, issuesAfterEdit);
+
+            // this world is validated for the first time after the edit
+            auto world = loadWorld(MapData);
+            editWorld(*world);
+            ASSERT_EQ(collectIssues(*world), issuesAfterEdit);
+
+            editWorld(*incrementalWorld);
+            incrementalWorld->validateAllIssues();
+            editWorld(*world);
+            ASSERT_EQ(collectIssues(*world), collectIssues(*incrementalWorld));
+        }
+
+        TEST(IssueValidationTest, parallelValidationFindsSameIssues) {
+
+            auto serialWorld = loadWorld(MapData);
+            const auto expected = collectIssues(*serialWorld);
+            ASSERT_FALSE(expected.empty());
+
+            auto parallelWorld = loadWorld(MapData);
+            parallelWorld->validateAllIssues();
+            ASSERT_EQ(expected, collectIssues(*parallelWorld));
+
+            // validating again doesn't generate any more issues
+            parallelWorld->validateAllIssues();
+            ASSERT_EQ(expected, collectIssues(*parallelWorld));
+
+            // nor does validating after the issues were invalidated
+            parallelWorld->registerIssueGenerator(new EmptyGroupIssueGenerator());
+            serialWorld->registerIssueGenerator(new EmptyGroupIssueGenerator());
+            parallelWorld->validateAllIssues();
+            ASSERT_EQ(collectIssues(*serialWorld), collectIssues(*parallelWorld));
+        }
+    }
+}
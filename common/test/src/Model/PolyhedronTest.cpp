@@ -32,8 +32,10 @@
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <cmath>
 #include <iterator>
 #include <tuple>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -1760,6 +1762,160 @@ TEST(PolyhedronTest, testWeaveSimpleCap) {
             poly.clip(std::get<1>(vm::from_points(vm::vec3d(-483.0, 1371.0, 131.0),  vm::vec3d(-184.0, 1513.0, 396.0),  vm::vec3d(-184.0, 1428.0, 237.0))));
         }
 
+        void assertIntersectPlanesMatchesClip(const std::vector<vm::plane3d>& planes, size_t expectedFaceCount);
+        void assertIntersectPlanesMatchesClip(const std::vector<vm::plane3d>& planes, const size_t expectedFaceCount) {
+            const vm::bbox3d bounds(8192.0);
+
+            Polyhedron3d clipped(bounds);
+            for (const auto& plane : planes) {
+                ASSERT_FALSE(clipped.clip(plane).empty());
+            }
+
+            Polyhedron3d intersected;
+            const auto faces = intersected.intersectPlanes(planes, bounds);
+            ASSERT_EQ(planes.size(), faces.size());
+            ASSERT_TRUE(intersected.closed());
+
+            ASSERT_EQ(expectedFaceCount, intersected.faceCount());
+            ASSERT_EQ(clipped.faceCount(), intersected.faceCount());
+            ASSERT_EQ(clipped.edgeCount(), intersected.edgeCount());
+            ASSERT_EQ(clipped.vertexCount(), intersected.vertexCount());
+            for (const auto* vertex : clipped.vertices()) {
+                ASSERT_TRUE(intersected.hasVertex(vertex->position(), 0.001));
+            }
+
+            for (size_t i = 0u; i < planes.size(); ++i) {
+                if (faces[i] != nullptr) {
+                    for (const auto* halfEdge : faces[i]->boundary()) {
+                        ASSERT_EQ(vm::plane_status::inside, planes[i].point_status(halfEdge->origin()->position()));
+                    }
+                    ASSERT_TRUE(clipped.hasFace(faces[i]->vertexPositions(), 0.001));
+                }
+            }
+        }
+
+        static std::vector<vm::plane3d> makeCubePlanes(const double size) {
+            return {
+                vm::plane3d(size, vm::vec3d::pos_x()),
+                vm::plane3d(size, vm::vec3d::neg_x()),
+                vm::plane3d(size, vm::vec3d::pos_y()),
+                vm::plane3d(size, vm::vec3d::neg_y()),
+                vm::plane3d(size, vm::vec3d::pos_z()),
+                vm::plane3d(size, vm::vec3d::neg_z())
+            };
+        }
+
+        TEST(PolyhedronTest, intersectPlanesCube) {
+            assertIntersectPlanesMatchesClip(makeCubePlanes(16.0), 6u);
+        }
+
+        TEST(PolyhedronTest, intersectPlanesWithRedundantPlanes) {
+            auto planes = makeCubePlanes(16.0);
+
+            // does not touch the cube
+            planes.push_back(vm::plane3d(64.0, vm::normalize(vm::vec3d(1.0, 1.0, 1.0))));
+            // touches an edge of the cube
+            planes.push_back(vm::plane3d(32.0 / std::sqrt(2.0), vm::normalize(vm::vec3d(1.0, 1.0, 0.0))));
+            // touches a vertex of the cube
+            planes.push_back(vm::plane3d(48.0 / std::sqrt(3.0), vm::normalize(vm::vec3d(-1.0, 1.0, 1.0))));
+            // coincides with a face of the cube
+            planes.push_back(vm::plane3d(16.0, vm::vec3d::pos_x()));
+
+            assertIntersectPlanesMatchesClip(planes, 6u);
+
+            Polyhedron3d polyhedron;
+            const auto faces = polyhedron.intersectPlanes(planes, vm::bbox3d(8192.0));
+            ASSERT_NE(nullptr, faces[0]);
+            for (size_t i = 6u; i < faces.size(); ++i) {
+                ASSERT_EQ(nullptr, faces[i]);
+            }
+        }
+
+        TEST(PolyhedronTest, intersectPlanesPyramid) {
+            // four planes meet at the apex
+            const auto d = 8.0 / std::sqrt(2.0);
+            assertIntersectPlanesMatchesClip({
+                vm::plane3d(0.0, vm::vec3d::neg_z()),
+                vm::plane3d(d, vm::normalize(vm::vec3d(+1.0, 0.0, 1.0))),
+                vm::plane3d(d, vm::normalize(vm::vec3d(-1.0, 0.0, 1.0))),
+                vm::plane3d(d, vm::normalize(vm::vec3d(0.0, +1.0, 1.0))),
+                vm::plane3d(d, vm::normalize(vm::vec3d(0.0, -1.0, 1.0)))
+            }, 5u);
+        }
+
+        TEST(PolyhedronTest, intersectPlanesCutCorners) {
+            auto planes = makeCubePlanes(32.0);
+            for (const auto x : { -1.0, 1.0 }) {
+                for (const auto y : { -1.0, 1.0 }) {
+                    for (const auto z : { -1.0, 1.0 }) {
+                        planes.push_back(vm::plane3d(80.0 / std::sqrt(3.0), vm::normalize(vm::vec3d(x, y, z))));
+                    }
+                }
+            }
+            assertIntersectPlanesMatchesClip(planes, 14u);
+        }
+
+        TEST(PolyhedronTest, intersectPlanesPrisms) {
+            for (size_t sides = 3u; sides <= 8u; ++sides) {
+                std::vector<vm::plane3d> planes;
+                planes.push_back(vm::plane3d(32.0, vm::vec3d::pos_z()));
+                planes.push_back(vm::plane3d(0.0, vm::vec3d::neg_z()));
+                for (size_t i = 0u; i < sides; ++i) {
+                    const auto angle = 0.3 + vm::C::two_pi() * static_cast<double>(i) / static_cast<double>(sides);
+                    const auto normal = vm::vec3d(std::cos(angle), std::sin(angle), 0.0);
+                    planes.push_back(vm::plane3d(dot(vm::vec3d(1024.0, -512.0, 0.0), normal) + 24.0, normal));
+                }
+                assertIntersectPlanesMatchesClip(planes, sides + 2u);
+            }
+        }
+
+        TEST(PolyhedronTest, intersectPlanesWithInvalidSeam) {
+            // see PolyhedronTest::clipWithInvalidSeam
+            // Some of these planes meet in two vertices that are only 0.003 units apart, and both vertices are on the
+            // same three planes, so the topology is inconsistent and the caller must fall back to clipping.
+            Polyhedron3d polyhedron;
+            ASSERT_TRUE(polyhedron.intersectPlanes({
+                std::get<1>(vm::from_points(vm::vec3d(-459.0, 1579.0, -115.0), vm::vec3d(-483.0, 1371.0, 131.0),  vm::vec3d(-184.0, 1428.0, 237.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-184.0, 1428.0, 237.0),  vm::vec3d(-184.0, 1513.0, 396.0),  vm::vec3d(-184.0, 1777.0, 254.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-484.0, 1513.0, 395.0),  vm::vec3d(-483.0, 1371.0, 131.0),  vm::vec3d(-483.0, 1777.0, 253.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-483.0, 1371.0, 131.0),  vm::vec3d(-459.0, 1579.0, -115.0), vm::vec3d(-483.0, 1777.0, 253.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-184.0, 1513.0, 396.0),  vm::vec3d(-484.0, 1513.0, 395.0),  vm::vec3d(-184.0, 1777.0, 254.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-184.0, 1777.0, 254.0),  vm::vec3d(-483.0, 1777.0, 253.0),  vm::vec3d(-183.0, 1692.0,  95.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-483.0, 1777.0, 253.0),  vm::vec3d(-459.0, 1579.0, -115.0), vm::vec3d(-183.0, 1692.0,  95.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-483.0, 1371.0, 131.0),  vm::vec3d(-484.0, 1513.0, 395.0),  vm::vec3d(-184.0, 1513.0, 396.0))),
+                std::get<1>(vm::from_points(vm::vec3d(-483.0, 1371.0, 131.0),  vm::vec3d(-184.0, 1513.0, 396.0),  vm::vec3d(-184.0, 1428.0, 237.0)))
+            }, vm::bbox3d(8192.0)).empty());
+            ASSERT_TRUE(polyhedron.empty());
+        }
+
+        TEST(PolyhedronTest, intersectPlanesFallsBack) {
+            const vm::bbox3d bounds(8192.0);
+
+            // not closed
+            Polyhedron3d open;
+            ASSERT_TRUE(open.intersectPlanes({
+                vm::plane3d(16.0, vm::vec3d::pos_x()),
+                vm::plane3d(16.0, vm::vec3d::neg_x()),
+                vm::plane3d(16.0, vm::vec3d::pos_y()),
+                vm::plane3d(16.0, vm::vec3d::neg_y())
+            }, bounds).empty());
+            ASSERT_TRUE(open.empty());
+
+            // empty intersection
+            auto emptyPlanes = makeCubePlanes(16.0);
+            emptyPlanes[0] = vm::plane3d(-32.0, vm::vec3d::pos_x());
+            Polyhedron3d empty;
+            ASSERT_TRUE(empty.intersectPlanes(emptyPlanes, bounds).empty());
+            ASSERT_TRUE(empty.empty());
+
+            // exceeds the bounds
+            auto largePlanes = makeCubePlanes(16.0);
+            largePlanes[0] = vm::plane3d(10000.0, vm::vec3d::pos_x());
+            Polyhedron3d large;
+            ASSERT_TRUE(large.intersectPlanes(largePlanes, bounds).empty());
+            ASSERT_TRUE(large.empty());
+        }
+
         bool findAndRemove(std::vector<Polyhedron3d>& result, const std::vector<vm::vec3d>& vertices);
         bool findAndRemove(std::vector<Polyhedron3d>& result, const std::vector<vm::vec3d>& vertices) {
             for (auto it = std::begin(result), end = std::end(result); it != end; ++it) {
@@ -19,14 +19,20 @@
 
 #include <gtest/gtest.h>
 
+#include "Assets/Texture.h"
 #include "Model/Tag.h"
 #include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/World.h"
 
+#include <memory>
+#include <vector>
+
 namespace TrenchBroom {
     namespace Model {
         TEST(TaggingTest, testTagBrush) {
@@ -59,5 +65,77 @@ namespace TrenchBroom {
             ASSERT_FALSE(brush->hasTag(tag1));
             ASSERT_FALSE(brush->hasTag(tag2));
         }
+
+        static SmartTag makeSmartTag(const std::string& name, const size_t index, std::unique_ptr<TagMatcher> matcher) {
+            auto tag = SmartTag(name, {}, std::move(matcher));
+            tag.setIndex(index);
+            return tag;
+        }
+
+        TEST(TaggingTest, testUpdateTextureTags) {
+            Assets::Texture liquid("water", 16, 16);
+            liquid.setSurfaceParms({ "liquid" });
+            Assets::Texture solid("water", 16, 16);
+
+            const vm::bbox3 worldBounds{4096.0};
+            World world{MapFormat::Standard};
+
+            BrushBuilder builder{&world, worldBounds};
+            Brush* brush = builder.createCube(64.0, "e1u1/clip", "hint_a", "hint_b", "HINT", "wall", "water");
+            world.defaultLayer()->addChild(brush);
+
+            TagManager tagManager;
+            tagManager.registerSmartTags({
+                makeSmartTag("Clip", 0u, std::make_unique<TextureNameTagMatcher>("clip")),
+                makeSmartTag("Hint", 1u, std::make_unique<TextureNameTagMatcher>("hint*")),
+                makeSmartTag("Liquid", 2u, std::make_unique<SurfaceParmTagMatcher>("liquid")),
+                makeSmartTag("Detail", 3u, std::make_unique<ContentFlagsTagMatcher>(1 << 27))
+            });
+
+            const auto& clip = tagManager.smartTag("Clip");
+            const auto& hint = tagManager.smartTag("Hint");
+            const auto& liquidTag = tagManager.smartTag("Liquid");
+            const auto& detail = tagManager.smartTag("Detail");
+
+            const auto faceTags = [&]() {
+                std::vector<std::vector<bool>> result;
+                for (auto* face : brush->faces()) {
+                    face->updateTags(tagManager);
+                    result.push_back({ face->hasTag(clip), face->hasTag(hint), face->hasTag(liquidTag), face->hasTag(detail) });
+                }
+                return result;
+            };
+
+            const auto expectedFaceTags = [&]() {
+                std::vector<std::vector<bool>> result;
+                for (const auto* face : brush->faces()) {
+                    result.push_back({ clip.matches(*face), hint.matches(*face), liquidTag.matches(*face), detail.matches(*face) });
+                }
+                return result;
+            };
+
+            ASSERT_EQ(expectedFaceTags(), faceTags());
+            // updating again uses the cached texture tags
+            ASSERT_EQ(expectedFaceTags(), faceTags());
+
+            auto* waterFace = brush->findFace("water");
+            ASSERT_NE(nullptr, waterFace);
+            ASSERT_FALSE(waterFace->hasTag(liquidTag));
+
+            // the cached tags are reevaluated if a face texture name resolves to a different texture
+            waterFace->setTexture(&liquid);
+            waterFace->updateTags(tagManager);
+            ASSERT_TRUE(waterFace->hasTag(liquidTag));
+
+            waterFace->setTexture(&solid);
+            waterFace->updateTags(tagManager);
+            ASSERT_FALSE(waterFace->hasTag(liquidTag));
+
+            waterFace->unsetTexture();
+            ASSERT_EQ(expectedFaceTags(), faceTags());
+
+            tagManager.invalidateTextureTags();
+            ASSERT_EQ(expectedFaceTags(), faceTags());
+        }
     }
 }
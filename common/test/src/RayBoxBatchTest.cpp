@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "RayBoxBatch.h"
+
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <bitset>
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    using Batch = BoxBatch<3>;
+    using BatchTest = RayBoxBatchTest<double, 3>;
+
+    static void setBox(Batch& batch, const size_t j, const vm::vec3f& min, const vm::vec3f& max) {
+        for (size_t i = 0u; i < 3u; ++i) {
+            batch.min[i][j] = min[i];
+            batch.max[i][j] = max[i];
+        }
+    }
+
+    TEST(RayBoxBatchTest, testAxisAlignedRay) {
+        Batch batch;
+        setBox(batch, 0u, vm::vec3f(-1.0f, -1.0f, 4.0f), vm::vec3f(1.0f, 1.0f, 6.0f));  // hit
+        setBox(batch, 1u, vm::vec3f(-1.0f, -1.0f, -6.0f), vm::vec3f(1.0f, 1.0f, -4.0f)); // behind the origin
+        setBox(batch, 2u, vm::vec3f(1.0f, -1.0f, 4.0f), vm::vec3f(2.0f, 1.0f, 6.0f));   // touching
+        setBox(batch, 3u, vm::vec3f(2.0f, 2.0f, 4.0f), vm::vec3f(3.0f, 3.0f, 6.0f));    // miss
+
+        const auto test = BatchTest(vm::ray3(vm::vec3(1.0, 0.0, 0.0), vm::vec3::pos_z()));
+        ASSERT_EQ(0x5u, test.test(batch));
+        ASSERT_EQ(0x5u, test.testScalar(batch));
+    }
+
+    TEST(RayBoxBatchTest, testRayWithOriginInsideBox) {
+        Batch batch;
+        setBox(batch, 0u, vm::vec3f(-1.0f, -1.0f, -1.0f), vm::vec3f(1.0f, 1.0f, 1.0f));
+        setBox(batch, 1u, vm::vec3f(0.0f, 0.0f, 0.0f), vm::vec3f(0.0f, 0.0f, 0.0f));
+        setBox(batch, 2u, vm::vec3f(-3.0f, -3.0f, -3.0f), vm::vec3f(-2.0f, -2.0f, -2.0f));
+        setBox(batch, 3u, vm::vec3f(2.0f, 2.0f, 2.0f), vm::vec3f(3.0f, 3.0f, 3.0f));
+
+        const auto test = BatchTest(vm::ray3(vm::vec3::zero(), vm::normalize(vm::vec3(1.0, 1.0, 1.0))));
+        ASSERT_EQ(0xBu, test.test(batch));
+        ASSERT_EQ(0xBu, test.testScalar(batch));
+    }
+
+    TEST(RayBoxBatchTest, simdMatchesScalar) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> coord(-64.0f, 64.0f);
+        std::uniform_real_distribution<float> extent(0.0f, 16.0f);
+        std::uniform_int_distribution<int> axis(-1, 1);
+        std::uniform_int_distribution<int> snap(0, 3);
+
+        for (size_t k = 0u; k < 10000u; ++k) {
+            Batch batch;
+            for (size_t j = 0u; j < Batch::Width; ++j) {
+                const auto min = vm::vec3f(coord(rng), coord(rng), coord(rng));
+                setBox(batch, j, min, min + vm::vec3f(extent(rng), extent(rng), extent(rng)));
+            }
+
+            auto origin = vm::vec3(static_cast<double>(coord(rng)), static_cast<double>(coord(rng)), static_cast<double>(coord(rng)));
+            if (snap(rng) == 0) {
+                // place the origin on a box face
+                origin[0] = static_cast<double>(batch.min[0][0]);
+            }
+
+            // mix arbitrary directions with directions that are parallel to one or more axes
+            auto direction = vm::vec3(static_cast<double>(coord(rng)), static_cast<double>(coord(rng)), static_cast<double>(coord(rng)));
+            if (snap(rng) == 0) {
+                direction = vm::vec3(static_cast<double>(axis(rng)), static_cast<double>(axis(rng)), 1.0);
+            }
+
+            const auto test = BatchTest(vm::ray3(origin, vm::normalize(direction)));
+            ASSERT_EQ(test.testScalar(batch), test.test(batch));
+            ASSERT_EQ(test.testScalar(batch), test.test(WideBoxBatch<3>(batch)));
+        }
+    }
+
+    TEST(RayBoxBatchTest, packetTestIsConservative) {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> coord(-64.0f, 64.0f);
+        std::uniform_real_distribution<float> extent(0.0f, 16.0f);
+        std::uniform_real_distribution<double> jitter(-0.2, 0.2);
+
+        size_t culled = 0u;
+        for (size_t k = 0u; k < 1000u; ++k) {
+            // a bundle of rays with nearby origins and similar directions
+            const auto origin = vm::vec3(static_cast<double>(coord(rng)), static_cast<double>(coord(rng)), static_cast<double>(coord(rng)));
+            const auto direction = vm::vec3(static_cast<double>(coord(rng)), static_cast<double>(coord(rng)), static_cast<double>(coord(rng)));
+
+            std::vector<vm::ray3> rays;
+            for (size_t r = 0u; r < 16u; ++r) {
+                const auto offset = vm::vec3(jitter(rng), jitter(rng), jitter(rng));
+                rays.emplace_back(origin + offset, vm::normalize(direction + offset * 8.0));
+            }
+
+            const auto packetTest = RayPacketBoxBatchTest<double, 3>(std::begin(rays), std::end(rays));
+            for (size_t b = 0u; b < 16u; ++b) {
+                Batch batch;
+                for (size_t j = 0u; j < Batch::Width; ++j) {
+                    const auto min = vm::vec3f(coord(rng), coord(rng), coord(rng));
+                    setBox(batch, j, min, min + vm::vec3f(extent(rng), extent(rng), extent(rng)));
+                }
+
+                const auto packetHits = packetTest.test(batch);
+                for (const auto& ray : rays) {
+                    const auto hits = BatchTest(ray).test(batch);
+                    ASSERT_EQ(hits, hits & packetHits);
+                }
+                culled += Batch::Width - std::bitset<Batch::Width>(packetHits).count();
+            }
+        }
+
+        // make sure that the test actually culls something
+        ASSERT_GT(culled, 0u);
+    }
+
+    TEST(RayBoxBatchTest, packetTestWithDivergentRays) {
+        Batch batch;
+        for (size_t j = 0u; j < Batch::Width; ++j) {
+            setBox(batch, j, vm::vec3f(10.0f, 10.0f, 10.0f), vm::vec3f(11.0f, 11.0f, 11.0f));
+        }
+
+        // the rays point in opposite directions along the x axis, so nothing can be culled
+        const auto rays = std::vector<vm::ray3>{
+            vm::ray3(vm::vec3::zero(), vm::normalize(vm::vec3(1.0, 1.0, 1.0))),
+            vm::ray3(vm::vec3::zero(), vm::normalize(vm::vec3(-1.0, 1.0, 1.0)))
+        };
+        ASSERT_EQ(0xFu, (RayPacketBoxBatchTest<double, 3>(std::begin(rays), std::end(rays)).test(batch)));
+    }
+}
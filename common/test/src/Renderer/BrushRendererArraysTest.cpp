@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Renderer/BrushRendererArrays.h"
+#include "Renderer/GL.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        /**
+         * Holds the given elements as if they had been uploaded, so that no GL context is needed.
+         */
+        class CleanIndexHolder : public VboHolder<GLuint> {
+        public:
+            explicit CleanIndexHolder(const std::vector<GLuint>& elements) :
+            VboHolder<GLuint>(VboType::ElementArrayBuffer) {
+                resize(elements.size());
+                std::copy(std::begin(elements), std::end(elements), getPointerToWriteElementsTo(0, elements.size()));
+                m_dirtyRange = DirtyRangeTracker(elements.size());
+            }
+
+            const DirtyRangeTracker& dirtyRange() const {
+                return m_dirtyRange;
+            }
+        };
+
+        static const std::vector<GLuint> Elements = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+        TEST(BrushRendererArraysTest, updateUnchangedElements) {
+            CleanIndexHolder holder(Elements);
+            ASSERT_TRUE(holder.prepared());
+
+            holder.updateElements(2, 6, Elements.data() + 2);
+            ASSERT_TRUE(holder.prepared());
+            ASSERT_EQ(Elements, holder.elements());
+
+            holder.updateElements(0, Elements.size(), Elements.data());
+            ASSERT_TRUE(holder.prepared());
+            ASSERT_EQ(Elements, holder.elements());
+        }
+
+        TEST(BrushRendererArraysTest, updateElementsMarksChangedRangeDirty) {
+            CleanIndexHolder holder(Elements);
+
+            // elements 3 and 6 change, 4 and 5 are rewritten with the same values
+            const std::vector<GLuint> update = { 2, 13, 4, 5, 16, 7 };
+            holder.updateElements(2, update.size(), update.data());
+
+            ASSERT_FALSE(holder.prepared());
+            ASSERT_EQ(3u, holder.dirtyRange().m_dirtyPos);
+            ASSERT_EQ(4u, holder.dirtyRange().m_dirtySize);
+            ASSERT_EQ((std::vector<GLuint>{ 0, 1, 2, 13, 4, 5, 16, 7, 8, 9 }), holder.elements());
+        }
+
+        TEST(BrushRendererArraysTest, updateSingleChangedElement) {
+            CleanIndexHolder holder(Elements);
+
+            const std::vector<GLuint> update = { 4, 15, 6 };
+            holder.updateElements(4, update.size(), update.data());
+
+            ASSERT_EQ(5u, holder.dirtyRange().m_dirtyPos);
+            ASSERT_EQ(1u, holder.dirtyRange().m_dirtySize);
+            ASSERT_EQ((std::vector<GLuint>{ 0, 1, 2, 3, 4, 15, 6, 7, 8, 9 }), holder.elements());
+        }
+
+        TEST(BrushRendererArraysTest, updateElementsChangedAtBothEnds) {
+            CleanIndexHolder holder(Elements);
+
+            const std::vector<GLuint> update = { 10, 1, 2, 3, 4, 5, 6, 7, 8, 19 };
+            holder.updateElements(0, update.size(), update.data());
+
+            ASSERT_EQ(0u, holder.dirtyRange().m_dirtyPos);
+            ASSERT_EQ(Elements.size(), holder.dirtyRange().m_dirtySize);
+            ASSERT_EQ(update, holder.elements());
+        }
+
+        TEST(BrushRendererArraysTest, updateElementsExtendsDirtyRange) {
+            CleanIndexHolder holder(Elements);
+
+            const std::vector<GLuint> first = { 11 };
+            holder.updateElements(1, first.size(), first.data());
+            ASSERT_EQ(1u, holder.dirtyRange().m_dirtyPos);
+            ASSERT_EQ(1u, holder.dirtyRange().m_dirtySize);
+
+            // an unchanged update does not extend the range
+            holder.updateElements(8, 2, Elements.data() + 8);
+            ASSERT_EQ(1u, holder.dirtyRange().m_dirtyPos);
+            ASSERT_EQ(1u, holder.dirtyRange().m_dirtySize);
+
+            const std::vector<GLuint> second = { 7, 18 };
+            holder.updateElements(7, second.size(), second.data());
+            ASSERT_EQ(1u, holder.dirtyRange().m_dirtyPos);
+            ASSERT_EQ(8u, holder.dirtyRange().m_dirtySize);
+            ASSERT_EQ((std::vector<GLuint>{ 0, 11, 2, 3, 4, 5, 6, 7, 18, 9 }), holder.elements());
+        }
+    }
+}
@@ -0,0 +1,302 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FloatType.h"
+#include "Assets/Texture.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+#include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
+
+#include <kdl/vector_utils.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        using Vertex = GLVertexTypes::P3NT2::Vertex;
+        using Primitive = std::vector<float>;
+        using PrimitivesByTexture = std::map<const Assets::Texture*, std::multiset<Primitive>>;
+
+        static void appendVertex(Primitive& primitive, const Vertex& vertex) {
+            static_assert(sizeof(Vertex) == 8u * sizeof(float), "vertex must consist of 8 floats");
+
+            float floats[8];
+            std::memcpy(floats, &vertex, sizeof(Vertex));
+            primitive.insert(std::end(primitive), std::begin(floats), std::end(floats));
+        }
+
+        /**
+         * Returns the primitives with the given number of vertices which the given indices refer to, as lists of
+         * their vertices. Primitives whose indices were zeroed are skipped.
+         */
+        static std::multiset<Primitive> renderedPrimitives(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices, const size_t primitiveSize) {
+            std::multiset<Primitive> result;
+            for (size_t i = 0; i + primitiveSize <= indices.size(); i += primitiveSize) {
+                if (std::all_of(std::begin(indices) + i, std::begin(indices) + i + primitiveSize, [](const GLuint index) { return index == 0u; })) {
+                    continue;
+                }
+
+                Primitive primitive;
+                for (size_t j = 0; j < primitiveSize; ++j) {
+                    appendVertex(primitive, vertices[indices[i + j]]);
+                }
+                result.insert(std::move(primitive));
+            }
+            return result;
+        }
+
+        static PrimitivesByTexture renderedTriangles(const BrushRenderer::Arrays& arrays) {
+            PrimitivesByTexture result;
+            for (const auto& [texture, indices] : arrays.opaqueFaceIndices) {
+                auto triangles = renderedPrimitives(arrays.vertices, indices, 3u);
+                if (!triangles.empty()) {
+                    result[texture] = std::move(triangles);
+                }
+            }
+            return result;
+        }
+
+        static size_t zeroedTriangleCount(const std::vector<GLuint>& indices) {
+            size_t result = 0;
+            for (size_t i = 0; i + 3u <= indices.size(); i += 3u) {
+                if (indices[i] == 0u && indices[i + 1] == 0u && indices[i + 2] == 0u) {
+                    ++result;
+                }
+            }
+            return result;
+        }
+
+        static void assertEqualArrays(const BrushRenderer::Arrays& expected, const BrushRenderer::Arrays& actual) {
+            ASSERT_EQ(expected.vertices.size(), actual.vertices.size());
+            ASSERT_EQ(0, std::memcmp(expected.vertices.data(), actual.vertices.data(), expected.vertices.size() * sizeof(Vertex)));
+            ASSERT_EQ(expected.edgeIndices, actual.edgeIndices);
+            ASSERT_EQ(expected.opaqueFaceIndices, actual.opaqueFaceIndices);
+            ASSERT_EQ(expected.transparentFaceIndices, actual.transparentFaceIndices);
+        }
+
+        class BrushRendererTest : public ::testing::Test {
+        protected:
+            vm::bbox3 m_worldBounds;
+            Model::World* m_world;
+            std::vector<Assets::Texture*> m_textures;
+            std::vector<Model::Brush*> m_brushes;
+
+            void SetUp() override {
+                m_worldBounds = vm::bbox3(8192.0);
+                m_world = new Model::World(Model::MapFormat::Standard);
+                m_textures.push_back(new Assets::Texture("textureA", 64, 64));
+                m_textures.push_back(new Assets::Texture("textureB", 64, 64));
+            }
+
+            void TearDown() override {
+                // the brushes must release their textures first
+                kdl::vec_clear_and_delete(m_brushes);
+                kdl::vec_clear_and_delete(m_textures);
+                delete m_world;
+            }
+
+            /**
+             * Adds the given number of cubes with a side length of 64 units. The cubes are laid out in rows of 16
+             * along the X axis, which are stacked into layers of 16 rows. All faces of the cubes use the first
+             * texture.
+             */
+            void makeBrushes(const size_t count) {
+                const Model::BrushBuilder builder(m_world, m_worldBounds);
+                for (size_t i = 0; i < count; ++i) {
+                    const auto min = vm::vec3(static_cast<FloatType>(i % 16u),
+                                              static_cast<FloatType>((i / 16u) % 16u),
+                                              static_cast<FloatType>(i / 256u)) * 128.0;
+                    auto* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(64.0, 64.0, 64.0)), "");
+                    for (auto* face : brush->faces()) {
+                        face->setTexture(m_textures[0]);
+                    }
+                    m_brushes.push_back(brush);
+                }
+            }
+
+            /**
+             * Asserts that the given renderer renders the same triangles and edges as a renderer which validates all
+             * brushes from scratch.
+             */
+            void assertRendersLikeNewRenderer(const BrushRenderer& renderer) {
+                BrushRenderer newRenderer;
+                newRenderer.addBrushes(m_brushes);
+                newRenderer.validate();
+
+                const auto arrays = renderer.arrays();
+                const auto newArrays = newRenderer.arrays();
+                ASSERT_EQ(renderedTriangles(newArrays), renderedTriangles(arrays));
+                ASSERT_EQ(renderedPrimitives(newArrays.vertices, newArrays.edgeIndices, 2u),
+                          renderedPrimitives(arrays.vertices, arrays.edgeIndices, 2u));
+            }
+        };
+
+        TEST_F(BrushRendererTest, updateMovedBrushInPlace) {
+            makeBrushes(3u);
+
+            BrushRenderer renderer;
+            renderer.addBrushes(m_brushes);
+            renderer.validate();
+            const auto before = renderer.arrays();
+
+            auto* brush = m_brushes[1];
+            brush->transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)), false, m_worldBounds);
+            renderer.invalidateBrushes({ brush });
+            renderer.validate();
+            const auto after = renderer.arrays();
+
+            // the brush keeps its blocks, and only its vertices change
+            ASSERT_EQ(before.edgeIndices, after.edgeIndices);
+            ASSERT_EQ(before.opaqueFaceIndices, after.opaqueFaceIndices);
+            ASSERT_EQ(before.vertices.size(), after.vertices.size());
+
+            size_t changedVertexCount = 0;
+            for (size_t i = 0; i < after.vertices.size(); ++i) {
+                if (std::memcmp(&before.vertices[i], &after.vertices[i], sizeof(Vertex)) != 0) {
+                    ++changedVertexCount;
+                }
+            }
+            ASSERT_EQ(brush->brushRendererBrushCache().cachedVertices().size(), changedVertexCount);
+
+            assertRendersLikeNewRenderer(renderer);
+        }
+
+        TEST_F(BrushRendererTest, reallocateBrushWithChangedTexture) {
+            makeBrushes(3u);
+
+            BrushRenderer renderer;
+            renderer.addBrushes(m_brushes);
+            renderer.validate();
+
+            const auto* textureA = m_textures[0];
+            const auto* textureB = m_textures[1];
+            const auto before = renderer.arrays();
+            ASSERT_EQ(0u, before.opaqueFaceIndices.count(textureB));
+            ASSERT_EQ(36u, renderedTriangles(before).at(textureA).size());
+
+            auto* brush = m_brushes[1];
+            brush->faces().front()->setTexture(m_textures[1]);
+            renderer.invalidateBrushes({ brush });
+            renderer.validate();
+            const auto after = renderer.arrays();
+
+            // the face moved to the index array of its new texture, and the old block of the brush was zeroed
+            const auto triangles = renderedTriangles(after);
+            ASSERT_EQ(34u, triangles.at(textureA).size());
+            ASSERT_EQ(2u, triangles.at(textureB).size());
+            ASSERT_LT(0u, zeroedTriangleCount(after.opaqueFaceIndices.at(textureA)));
+
+            assertRendersLikeNewRenderer(renderer);
+        }
+
+        TEST_F(BrushRendererTest, reallocateBrushWithChangedFaceCount) {
+            makeBrushes(3u);
+
+            BrushRenderer renderer;
+            renderer.addBrushes(m_brushes);
+            renderer.validate();
+
+            auto* brush = m_brushes[1];
+            const auto faceCount = brush->faces().size();
+
+            const auto corner = vm::vec3(128.0, 0.0, 0.0);
+            ASSERT_TRUE(brush->canRemoveVertices(m_worldBounds, { corner }));
+            brush->removeVertices(m_worldBounds, { corner });
+            for (auto* face : brush->faces()) {
+                face->setTexture(m_textures[0]);
+            }
+            renderer.invalidateBrushes({ brush });
+            renderer.validate();
+
+            // cutting off a corner turns three quads into triangles and adds a triangle, so the brush has fewer
+            // triangles than before and its old block cannot be filled completely
+            ASSERT_EQ(faceCount + 1u, brush->faces().size());
+            const auto after = renderer.arrays();
+            ASSERT_LT(0u, zeroedTriangleCount(after.opaqueFaceIndices.at(m_textures[0])));
+
+            assertRendersLikeNewRenderer(renderer);
+        }
+
+        TEST_F(BrushRendererTest, validateConcurrently) {
+            // with at least 256 brushes per thread, 1024 brushes are validated by 4 threads
+            makeBrushes(1024u);
+            for (size_t i = 0; i < m_brushes.size(); ++i) {
+                const auto& faces = m_brushes[i]->faces();
+                for (size_t j = 0; j < faces.size(); ++j) {
+                    faces[j]->setTexture(m_textures[(i + j) % m_textures.size()]);
+                }
+            }
+
+            BrushRenderer concurrentRenderer;
+            concurrentRenderer.addBrushes(m_brushes);
+            concurrentRenderer.validate(4u);
+
+            BrushRenderer serialRenderer;
+            serialRenderer.addBrushes(m_brushes);
+            serialRenderer.validate(1u);
+
+            assertEqualArrays(serialRenderer.arrays(), concurrentRenderer.arrays());
+
+            // Change every other brush, so that 2 threads are used. The brushes whose textures or face counts change
+            // are reallocated, and the moved brushes are updated in place.
+            std::vector<Model::Brush*> changedBrushes;
+            for (size_t i = 0; i < m_brushes.size(); i += 2u) {
+                auto* brush = m_brushes[i];
+                switch ((i / 2u) % 3u) {
+                    case 0:
+                        for (auto* face : brush->faces()) {
+                            face->setTexture(face->texture() == m_textures[0] ? m_textures[1] : m_textures[0]);
+                        }
+                        break;
+                    case 1:
+                        brush->removeVertices(m_worldBounds, { brush->logicalBounds().min });
+                        break;
+                    default:
+                        brush->transform(vm::translation_matrix(vm::vec3(16.0, 0.0, 0.0)), false, m_worldBounds);
+                        break;
+                }
+                changedBrushes.push_back(brush);
+            }
+
+            concurrentRenderer.invalidateBrushes(changedBrushes);
+            concurrentRenderer.validate(4u);
+
+            serialRenderer.invalidateBrushes(changedBrushes);
+            serialRenderer.validate(1u);
+
+            assertEqualArrays(serialRenderer.arrays(), concurrentRenderer.arrays());
+            assertRendersLikeNewRenderer(concurrentRenderer);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Renderer/Frustum.h"
+#include "Renderer/OrthographicCamera.h"
+#include "Renderer/PerspectiveCamera.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+#include <vecmath/vec.h>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        static vm::bbox3f boxAt(const vm::vec3f& center, const float size) {
+            return vm::bbox3f(center - vm::vec3f::fill(size), center + vm::vec3f::fill(size));
+        }
+
+        TEST(FrustumTest, unboundedFrustumIntersectsEverything) {
+            const Frustum frustum;
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f::zero(), 1.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(-10000.0f, 5000.0f, 3.0f), 1.0f)));
+        }
+
+        TEST(FrustumTest, intersectsWithPlanes) {
+            // a box shaped frustum of size 20 around the X axis
+            const Frustum frustum(vm::plane3f(10.0f, vm::vec3f::pos_z()),
+                                  vm::plane3f(10.0f, vm::vec3f::neg_y()),
+                                  vm::plane3f(10.0f, vm::vec3f::neg_z()),
+                                  vm::plane3f(10.0f, vm::vec3f::pos_y()));
+
+            // inside
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f::zero(), 1.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(1000.0f, 0.0f, 0.0f), 1.0f)));
+
+            // straddling one or more planes
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(0.0f, 0.0f, 10.0f), 1.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(0.0f, -10.0f, -10.0f), 1.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f::zero(), 100.0f)));
+
+            // touching
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(0.0f, 11.0f, 0.0f), 1.0f)));
+
+            // outside
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(0.0f, 0.0f, 12.0f), 1.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(0.0f, 0.0f, -12.0f), 1.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(0.0f, 12.0f, 0.0f), 1.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(0.0f, -12.0f, 0.0f), 1.0f)));
+        }
+
+        TEST(FrustumTest, intersectsWithPerspectiveCamera) {
+            // looks along the positive X axis with a horizontal field of view of 90 degrees
+            PerspectiveCamera camera;
+            camera.moveTo(vm::vec3f::zero());
+            camera.setDirection(vm::vec3f::pos_x(), vm::vec3f::pos_z());
+
+            const Frustum frustum(camera);
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 0.0f), 8.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(100.0f, 90.0f, 0.0f), 8.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f::zero(), 8.0f)));
+
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(-100.0f, 0.0f, 0.0f), 8.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 500.0f, 0.0f), 8.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, -500.0f, 0.0f), 8.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 500.0f), 8.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, -500.0f), 8.0f)));
+        }
+
+        TEST(FrustumTest, intersectsWithOrthographicCamera) {
+            // the default viewport is 1024 by 768 pixels
+            OrthographicCamera camera;
+            camera.moveTo(vm::vec3f::zero());
+            camera.setDirection(vm::vec3f::pos_x(), vm::vec3f::pos_z());
+
+            const Frustum frustum(camera);
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 0.0f), 8.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(-100.0f, 500.0f, 0.0f), 8.0f)));
+            ASSERT_TRUE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 380.0f), 8.0f)));
+
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 600.0f, 0.0f), 8.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, 400.0f), 8.0f)));
+            ASSERT_FALSE(frustum.intersects(boxAt(vm::vec3f(100.0f, 0.0f, -400.0f), 8.0f)));
+        }
+    }
+}
@@ -0,0 +1,270 @@
+/*
+ Copyright (C) 2020 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "SlabAllocator.h"
+#include "SlabPool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+    // Every test does its work on a thread of its own, so that the blocks cached by that thread are returned to the
+    // shared pool when it exits. The tests use the largest size class, which is not used by anything else.
+
+    template <typename F>
+    static void runOnThread(F f) {
+        std::thread thread(f);
+        thread.join();
+    }
+
+    static std::uintptr_t chunkOf(const void* block) {
+        return reinterpret_cast<std::uintptr_t>(block) & ~static_cast<std::uintptr_t>(SlabPool::ChunkSize - 1);
+    }
+
+    static size_t blocksPerChunk() {
+        // the chunk header takes up at least one block
+        return SlabPool::ChunkSize / SlabPool::MaxBlockSize - 1;
+    }
+
+    TEST(SlabPoolTest, allocateAllSizeClasses) {
+        const auto before = SlabPool::stats();
+
+        runOnThread([]() {
+            std::vector<unsigned char*> blocks;
+            for (size_t size = 1; size <= SlabPool::MaxBlockSize; ++size) {
+                auto* first = static_cast<unsigned char*>(SlabPool::allocate(size));
+                auto* second = static_cast<unsigned char*>(SlabPool::allocate(size));
+                ASSERT_NE(first, second);
+                ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(first) % 16u);
+                ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(second) % 16u);
+
+                std::memset(first, static_cast<int>(size % 256), size);
+                std::memset(second, static_cast<int>(size % 256), size);
+                blocks.push_back(first);
+                blocks.push_back(second);
+            }
+
+            // no block was overwritten by a block of another size
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                const auto size = i / 2 + 1;
+                for (size_t j = 0; j < size; ++j) {
+                    ASSERT_EQ(static_cast<unsigned char>(size % 256), blocks[i][j]);
+                }
+            }
+
+            for (auto* block : blocks) {
+                SlabPool::deallocate(block);
+            }
+        });
+
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+
+    TEST(SlabPoolTest, deallocateNull) {
+        const auto before = SlabPool::stats();
+        SlabPool::deallocate(nullptr);
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+
+    TEST(SlabPoolTest, deallocateOnOtherThread) {
+        const auto before = SlabPool::stats();
+        const auto count = 10 * blocksPerChunk();
+
+        std::vector<void*> blocks;
+        runOnThread([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                blocks.push_back(SlabPool::allocate(SlabPool::MaxBlockSize));
+            }
+        });
+        ASSERT_GE(SlabPool::stats().usedBlockCount, before.usedBlockCount + count);
+
+        runOnThread([&]() {
+            for (auto* block : blocks) {
+                SlabPool::deallocate(block);
+            }
+        });
+
+        const auto after = SlabPool::stats();
+        ASSERT_EQ(before.usedBlockCount, after.usedBlockCount);
+        ASSERT_LE(after.chunkCount, before.chunkCount + 1u);
+    }
+
+    TEST(SlabPoolTest, cacheOverflowReturnsBlocks) {
+        const auto before = SlabPool::stats();
+        const auto count = 4 * SlabPool::MaxCachedBlocks;
+
+        SlabPool::Stats allocated, deallocated;
+        runOnThread([&]() {
+            std::vector<void*> blocks;
+            for (size_t i = 0; i < count; ++i) {
+                blocks.push_back(SlabPool::allocate(SlabPool::MaxBlockSize));
+            }
+            allocated = SlabPool::stats();
+
+            for (auto* block : blocks) {
+                SlabPool::deallocate(block);
+            }
+            deallocated = SlabPool::stats();
+        });
+
+        ASSERT_GE(allocated.usedBlockCount, before.usedBlockCount + count);
+        ASSERT_LE(allocated.usedBlockCount, before.usedBlockCount + count + SlabPool::BatchSize);
+
+        // the thread keeps at most MaxCachedBlocks blocks while it is running
+        ASSERT_GE(deallocated.usedBlockCount, before.usedBlockCount + SlabPool::BatchSize);
+        ASSERT_LE(deallocated.usedBlockCount, before.usedBlockCount + SlabPool::MaxCachedBlocks);
+
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+
+    TEST(SlabPoolTest, emptyChunksAreReusedOrDestroyed) {
+        const auto before = SlabPool::stats();
+        const auto count = 10 * blocksPerChunk();
+
+        size_t peakChunkCount = 0;
+        runOnThread([&]() {
+            std::vector<void*> blocks;
+            for (size_t i = 0; i < count; ++i) {
+                blocks.push_back(SlabPool::allocate(SlabPool::MaxBlockSize));
+            }
+            peakChunkCount = SlabPool::stats().chunkCount;
+
+            for (auto* block : blocks) {
+                SlabPool::deallocate(block);
+            }
+        });
+
+        ASSERT_GE(peakChunkCount, before.chunkCount + 9u);
+
+        // all but one of the empty chunks are destroyed, and the last one is kept for reuse
+        const auto afterDeallocation = SlabPool::stats();
+        ASSERT_EQ(before.usedBlockCount, afterDeallocation.usedBlockCount);
+        ASSERT_LE(afterDeallocation.chunkCount, before.chunkCount + 1u);
+
+        size_t chunkCountAfterReuse = 0;
+        runOnThread([&]() {
+            void* block = SlabPool::allocate(SlabPool::MaxBlockSize);
+            chunkCountAfterReuse = SlabPool::stats().chunkCount;
+            SlabPool::deallocate(block);
+        });
+
+        ASSERT_EQ(afterDeallocation.chunkCount, chunkCountAfterReuse);
+        ASSERT_EQ(afterDeallocation.chunkCount, SlabPool::stats().chunkCount);
+    }
+
+    TEST(SlabPoolTest, exitingThreadReturnsCachedBlocks) {
+        const auto before = SlabPool::stats();
+
+        size_t usedBlockCountBeforeExit = 0;
+        runOnThread([&]() {
+            void* block = SlabPool::allocate(SlabPool::MaxBlockSize);
+            SlabPool::deallocate(block);
+            usedBlockCountBeforeExit = SlabPool::stats().usedBlockCount;
+        });
+
+        ASSERT_EQ(before.usedBlockCount + SlabPool::BatchSize, usedBlockCountBeforeExit);
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+
+    TEST(SlabPoolTest, nestedArenaScopes) {
+        const auto before = SlabPool::stats();
+
+        runOnThread([&]() {
+            SlabPool::Arena outer;
+            SlabPool::Arena inner;
+
+            void* outerBlock1 = nullptr;
+            void* innerBlock = nullptr;
+            void* outerBlock2 = nullptr;
+            {
+                SlabPool::Arena::Scope outerScope(outer);
+                outerBlock1 = SlabPool::allocate(SlabPool::MaxBlockSize);
+                {
+                    SlabPool::Arena::Scope innerScope(inner);
+                    innerBlock = SlabPool::allocate(SlabPool::MaxBlockSize);
+                }
+                outerBlock2 = SlabPool::allocate(SlabPool::MaxBlockSize);
+            }
+
+            // arena blocks are not taken from the shared pool
+            EXPECT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+            EXPECT_EQ(chunkOf(outerBlock1), chunkOf(outerBlock2));
+            EXPECT_NE(chunkOf(outerBlock1), chunkOf(innerBlock));
+            EXPECT_NE(outerBlock1, outerBlock2);
+
+            void* poolBlock = SlabPool::allocate(SlabPool::MaxBlockSize);
+            EXPECT_EQ(before.usedBlockCount + SlabPool::BatchSize, SlabPool::stats().usedBlockCount);
+            SlabPool::deallocate(poolBlock);
+        });
+
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+
+    TEST(SlabPoolTest, deallocateArenaBlock) {
+        const auto before = SlabPool::stats();
+
+        runOnThread([&]() {
+            SlabPool::Arena arena;
+
+            void* arenaBlock = nullptr;
+            {
+                SlabPool::Arena::Scope scope(arena);
+                arenaBlock = SlabPool::allocate(SlabPool::MaxBlockSize);
+                SlabPool::deallocate(arenaBlock);
+
+                // the freed block is not reused by the arena
+                EXPECT_NE(arenaBlock, SlabPool::allocate(SlabPool::MaxBlockSize));
+            }
+
+            // the block is not put into the thread's cache, which would hand it out again first
+            SlabPool::deallocate(arenaBlock);
+            void* poolBlock = SlabPool::allocate(SlabPool::MaxBlockSize);
+            EXPECT_NE(arenaBlock, poolBlock);
+            EXPECT_NE(chunkOf(arenaBlock), chunkOf(poolBlock));
+            SlabPool::deallocate(poolBlock);
+        });
+
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+
+#ifdef TB_ENABLE_SLAB_ALLOCATOR
+    struct LargeObject : public SlabAllocator<LargeObject> {
+        unsigned char data[SlabPool::MaxBlockSize];
+    };
+
+    TEST(SlabPoolTest, slabAllocator) {
+        const auto before = SlabPool::stats();
+
+        size_t usedBlockCount = 0;
+        runOnThread([&]() {
+            auto* object = new LargeObject();
+            std::memset(object->data, 0xff, sizeof(object->data));
+            usedBlockCount = SlabPool::stats().usedBlockCount;
+            delete object;
+        });
+
+        ASSERT_EQ(before.usedBlockCount + SlabPool::BatchSize, usedBlockCount);
+        ASSERT_EQ(before.usedBlockCount, SlabPool::stats().usedBlockCount);
+    }
+#endif
+}
@@ -24,6 +24,7 @@
 #include "View/UndoableCommand.h"
 #include "View/CommandProcessor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -150,6 +151,53 @@ namespace TrenchBroom {
 
         const Command::CommandType TestCommand::Type = Command::freeType();
 
+        /**
+         * Increments a counter when executed and decrements it when undone, and pretends to occupy the given number of
+         * bytes.
+         */
+        class CountingCommand : public UndoableCommand {
+        public:
+            static const CommandType Type;
+        private:
+            int& m_counter;
+            size_t m_memorySize;
+        public:
+            CountingCommand(int& counter, const size_t memorySize) :
+            UndoableCommand(Type, "counting command"),
+            m_counter(counter),
+            m_memorySize(memorySize) {}
+        private:
+            std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade*) override {
+                ++m_counter;
+                return std::make_unique<CommandResult>(true);
+            }
+
+            std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade*) override {
+                --m_counter;
+                return std::make_unique<CommandResult>(true);
+            }
+
+            bool doIsRepeatable(MapDocumentCommandFacade*) const override {
+                return true;
+            }
+
+            std::unique_ptr<UndoableCommand> doRepeat(MapDocumentCommandFacade*) const override {
+                return std::make_unique<CountingCommand>(m_counter, m_memorySize);
+            }
+
+            bool doCollateWith(UndoableCommand*) override {
+                return false;
+            }
+
+            size_t doGetMemorySize() const override {
+                return m_memorySize;
+            }
+
+            deleteCopyAndMove(CountingCommand)
+        };
+
+        const Command::CommandType CountingCommand::Type = Command::freeType();
+
         TEST(CommandProcessorTest, doAndUndoSuccessfulCommand) {
             /*
              * Execute a successful command, then undo it successfully.
@@ -606,5 +654,79 @@ namespace TrenchBroom {
             ASSERT_EQ(commandName1, commandProcessor.undoCommandName());
             ASSERT_EQ(commandName2, commandProcessor.redoCommandName());
         }
+
+        TEST(CommandProcessorTest, limitUndoStackMemorySize) {
+            /*
+             * Execute many commands which together exceed the memory limit, then undo and redo all remaining commands.
+             */
+
+            const size_t memoryLimit = 1024u * 1024u;
+            const size_t commandMemorySize = 1000u;
+            const int commandCount = 10000;
+
+            CommandProcessor commandProcessor(nullptr, std::chrono::milliseconds(1000), memoryLimit);
+            ASSERT_EQ(memoryLimit, commandProcessor.memoryLimit());
+
+            int counter = 0;
+            size_t peakMemorySize = 0u;
+            for (int i = 0; i < commandCount; ++i) {
+                ASSERT_TRUE(commandProcessor.executeAndStore(std::make_unique<CountingCommand>(counter, commandMemorySize))->success());
+                peakMemorySize = std::max(peakMemorySize, commandProcessor.undoStackMemorySize());
+            }
+            ASSERT_EQ(commandCount, counter);
+            ASSERT_LE(peakMemorySize, memoryLimit);
+            ASSERT_GT(peakMemorySize, memoryLimit - 2u * commandMemorySize);
+
+            int undoCount = 0;
+            while (commandProcessor.canUndo()) {
+                ASSERT_TRUE(commandProcessor.undo()->success());
+                ++undoCount;
+            }
+            ASSERT_EQ(0u, commandProcessor.undoStackMemorySize());
+            ASSERT_LT(undoCount, commandCount);
+            ASSERT_GT(undoCount, 0);
+            ASSERT_EQ(commandCount - undoCount, counter);
+
+            while (commandProcessor.canRedo()) {
+                ASSERT_TRUE(commandProcessor.redo()->success());
+            }
+            ASSERT_EQ(commandCount, counter);
+            ASSERT_EQ(peakMemorySize, commandProcessor.undoStackMemorySize());
+
+            // lowering the limit drops more commands, but the most recent command is always kept
+            commandProcessor.setMemoryLimit(0u);
+            ASSERT_TRUE(commandProcessor.canUndo());
+            ASSERT_TRUE(commandProcessor.undo()->success());
+            ASSERT_FALSE(commandProcessor.canUndo());
+            ASSERT_EQ(commandCount - 1, counter);
+        }
+
+        TEST(CommandProcessorTest, repeatAfterLimitingUndoStackMemorySize) {
+            /*
+             * Execute repeatable commands which together exceed the memory limit, then repeat them.
+             */
+
+            const size_t commandMemorySize = 1000u;
+            const size_t memoryLimit = 10u * commandMemorySize;
+
+            CommandProcessor commandProcessor(nullptr, std::chrono::milliseconds(1000), memoryLimit);
+
+            int counter = 0;
+            ASSERT_TRUE(commandProcessor.executeAndStore(std::make_unique<CountingCommand>(counter, commandMemorySize))->success());
+            const auto storedCommandSize = commandProcessor.undoStackMemorySize();
+
+            for (int i = 1; i < 100; ++i) {
+                ASSERT_TRUE(commandProcessor.executeAndStore(std::make_unique<CountingCommand>(counter, commandMemorySize))->success());
+            }
+            ASSERT_EQ(100, counter);
+
+            const auto remainingCommandCount = static_cast<int>(commandProcessor.undoStackMemorySize() / storedCommandSize);
+            ASSERT_EQ(static_cast<int>(memoryLimit / storedCommandSize), remainingCommandCount);
+
+            // the dropped commands were removed from the repeat stack, so only the remaining commands are repeated
+            ASSERT_TRUE(commandProcessor.canRepeat());
+            ASSERT_TRUE(commandProcessor.repeat()->success());
+            ASSERT_EQ(100 + remainingCommandCount, counter);
+        }
     }
 }
@@ -0,0 +1,132 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef KDL_PARALLEL_H
+#define KDL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace kdl {
+    /**
+     * Returns the number of threads to use for parallel algorithms by default. This is the number of hardware
+     * threads, but at least 1.
+     */
+    inline std::size_t parallel_default_thread_count() {
+        return std::max(static_cast<std::size_t>(std::thread::hardware_concurrency()), std::size_t(1));
+    }
+
+    /**
+     * Calls the given lambda once for each index in the range [0, count). The calls are distributed over the given
+     * number of threads, and the order in which the indices are processed is unspecified. The calling thread is used as
+     * one of the worker threads, and this function returns once all indices have been processed.
+     *
+     * If the thread count is 1 or if there is at most one index to process, the lambda is called on the calling thread
+     * in increasing index order.
+     *
+     * If the lambda throws an exception, the remaining indices are still processed and the first exception is rethrown
+     * to the caller once all threads have finished.
+     *
+     * @tparam L the type of the lambda, must be callable with a std::size_t argument
+     * @param count the number of indices to process
+     * @param lambda the lambda to call
+     * @param threadCount the number of threads to use, 0 means the default thread count
+     */
+    template<typename L>
+    void parallel_for(const std::size_t count, L&& lambda, std::size_t threadCount = 0u) {
+        if (threadCount == 0u) {
+            threadCount = parallel_default_thread_count();
+        }
+        threadCount = std::min(threadCount, count);
+
+        if (threadCount <= 1u) {
+            for (std::size_t i = 0u; i < count; ++i) {
+                lambda(i);
+            }
+            return;
+        }
+
+        std::atomic<std::size_t> nextIndex(0u);
+        const auto work = [&]() {
+            for (std::size_t i = nextIndex++; i < count; i = nextIndex++) {
+                lambda(i);
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        workers.reserve(threadCount - 1u);
+        for (std::size_t i = 0u; i < threadCount - 1u; ++i) {
+            workers.push_back(std::async(std::launch::async, work));
+        }
+
+        std::exception_ptr exception;
+        try {
+            work();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        for (auto& worker : workers) {
+            try {
+                worker.get();
+            } catch (...) {
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /**
+     * Applies the given lambda to each element of the given vector and returns a vector containing the resulting
+     * values, in order in which their original elements appeared in v. The lambda is applied in parallel using the
+     * given number of threads, so it must be safe to call it concurrently for different elements.
+     *
+     * The result type of the lambda must be default constructible and move assignable, and it must not be bool since
+     * the elements of std::vector<bool> cannot be written concurrently.
+     *
+     * @tparam T the type of the vector elements
+     * @tparam A the vector's allocator type
+     * @tparam L the type of the lambda to apply
+     * @param v the vector
+     * @param lambda the lambda to apply
+     * @param threadCount the number of threads to use, 0 means the default thread count
+     * @return a vector containing the transformed values
+     */
+    template<typename T, typename A, typename L>
+    auto vec_parallel_transform(const std::vector<T, A>& v, L&& lambda, const std::size_t threadCount = 0u) {
+        using ResultType = decltype(lambda(std::declval<const T&>()));
+
+        std::vector<ResultType> result(v.size());
+        parallel_for(v.size(), [&](const std::size_t i) {
+            result[i] = lambda(v[i]);
+        }, threadCount);
+
+        return result;
+    }
+}
+
+#endif //KDL_PARALLEL_H
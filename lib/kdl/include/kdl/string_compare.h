@@ -139,21 +139,29 @@ namespace kdl {
         inline bool str_matches_glob(const std::string_view s, const std::string_view p) {
             return kdl::str_matches_glob(s, p, char_equal());
         }
+
+        /**
+         * A compiled glob pattern that matches strings with case sensitivity.
+         *
+         * @see kdl::glob_matcher
+         */
+        using glob_matcher = kdl::glob_matcher<char_equal>;
     }
 
     /**
      * Contains functions for working with strings case insensitively.
      */
     namespace ci {
+        // std::tolower requires a value that is representable as unsigned char, so chars must be converted first
         struct char_less {
             bool operator()(const char& lhs, const char& rhs) const {
-                return std::tolower(lhs) < std::tolower(rhs);
+                return std::tolower(static_cast<unsigned char>(lhs)) < std::tolower(static_cast<unsigned char>(rhs));
             }
         };
 
         struct char_equal {
             bool operator()(const char& lhs, const char& rhs) const {
-                return std::tolower(lhs) == std::tolower(rhs);
+                return std::tolower(static_cast<unsigned char>(lhs)) == std::tolower(static_cast<unsigned char>(rhs));
             }
         };
 
@@ -256,6 +264,13 @@ namespace kdl {
         inline bool str_matches_glob(const std::string_view& s, const std::string_view& p) {
             return kdl::str_matches_glob(s, p, char_equal());
         }
+
+        /**
+         * A compiled glob pattern that matches strings without case sensitivity.
+         *
+         * @see kdl::glob_matcher
+         */
+        using glob_matcher = kdl::glob_matcher<char_equal>;
     }
 }
 
@@ -19,6 +19,9 @@
 #define KDL_STRING_COMPARE_DETAIL_H
 
 #include <algorithm> // for std::mismatch, std::sort, std::search, std::equal
+#include <array> // used in glob_matcher
+#include <cstdint> // used in glob_matcher
+#include <string>
 #include <string_view>
 #include <vector> // used in str_matches_glob
 
@@ -228,6 +231,143 @@ namespace kdl {
 
         return false;
     }
+
+    /**
+     * A glob pattern that is compiled once and can then be matched against many strings. The pattern syntax and the
+     * results are the same as for `kdl::str_matches_glob`.
+     *
+     * The pattern is compiled into a nondeterministic finite automaton with one state per pattern element. The
+     * automaton is simulated by keeping the set of active states in a 64 bit mask, so matching a string takes time
+     * linear in its length, and it doesn't allocate. Patterns with 64 or more elements fall back to
+     * `kdl::str_matches_glob`.
+     *
+     * @tparam CharEqual the type of the binary predicate used to test characters for equality
+     */
+    template <typename CharEqual>
+    class glob_matcher {
+    private:
+        using state_set = std::uint64_t;
+        static constexpr std::size_t max_state_count = 64u;
+
+        std::string m_pattern;
+        CharEqual m_char_equal;
+        bool m_compiled;
+        // the states that consume the given character and advance to the next state
+        std::array<state_set, 256u> m_advance_states;
+        // the states that consume any character (*) or any digit (%*) and stay, or advance without consuming
+        state_set m_any_string_states;
+        state_set m_digit_string_states;
+        state_set m_accept_state;
+    public:
+        /**
+         * Compiles the given glob pattern.
+         *
+         * @param pattern the pattern
+         * @param char_equal the binary predicate
+         */
+        explicit glob_matcher(const std::string_view pattern, const CharEqual& char_equal = CharEqual()) :
+        m_pattern(pattern),
+        m_char_equal(char_equal),
+        m_compiled(false),
+        m_advance_states(),
+        m_any_string_states(0u),
+        m_digit_string_states(0u),
+        m_accept_state(0u) {
+            compile();
+        }
+
+        /**
+         * Returns the pattern.
+         */
+        const std::string& pattern() const {
+            return m_pattern;
+        }
+
+        /**
+         * Checks whether the given string matches this pattern.
+         *
+         * @param str the string to match
+         * @return true if the given string matches this pattern
+         */
+        bool matches(const std::string_view str) const {
+            if (!m_compiled) {
+                return str_matches_glob(str, m_pattern, m_char_equal);
+            }
+
+            auto states = closure(1u);
+            for (const auto c : str) {
+                auto next = (states & m_advance_states[static_cast<unsigned char>(c)]) << 1u;
+                next |= states & m_any_string_states;
+                if (c >= '0' && c <= '9') {
+                    next |= states & m_digit_string_states;
+                }
+
+                states = closure(next);
+                if (states == 0u) {
+                    return false;
+                }
+            }
+
+            return (states & m_accept_state) != 0u;
+        }
+    private:
+        void compile() {
+            std::size_t state = 0u;
+            std::size_t p_i = 0u;
+            while (p_i < m_pattern.length()) {
+                if (state + 1u >= max_state_count) {
+                    m_advance_states.fill(0u);
+                    m_any_string_states = m_digit_string_states = 0u;
+                    return;
+                }
+
+                const auto bit = state_set(1u) << state;
+                const auto p = m_pattern[p_i];
+                if (p == '\\' && p_i < m_pattern.length() - 1u) {
+                    // an invalid escape sequence creates a state that doesn't match anything
+                    const auto n = m_pattern[p_i + 1u];
+                    if (n == '*' || n == '?' || n == '%' || n == '\\') {
+                        m_advance_states[static_cast<unsigned char>(n)] |= bit;
+                    }
+                    p_i += 2u;
+                } else if (p == '*') {
+                    m_any_string_states |= bit;
+                    p_i += 1u;
+                } else if (p == '%' && p_i < m_pattern.length() - 1u && m_pattern[p_i + 1u] == '*') {
+                    m_digit_string_states |= bit;
+                    p_i += 2u;
+                } else {
+                    for (std::size_t c = 0u; c < m_advance_states.size(); ++c) {
+                        // characters above 127 are negative here, so the predicate must accept any char value
+                        const auto s = static_cast<char>(c);
+                        if (p == '?' || (p == '%' && s >= '0' && s <= '9') || (p != '%' && m_char_equal(p, s))) {
+                            m_advance_states[c] |= bit;
+                        }
+                    }
+                    p_i += 1u;
+                }
+                ++state;
+            }
+
+            m_accept_state = state_set(1u) << state;
+            m_compiled = true;
+        }
+
+        /**
+         * Adds the states that can be reached from the given states without consuming a character, i.e. by skipping
+         * over * and %*.
+         */
+        state_set closure(state_set states) const {
+            const auto skip_states = m_any_string_states | m_digit_string_states;
+            while (true) {
+                const auto next = states | ((states & skip_states) << 1u);
+                if (next == states) {
+                    return states;
+                }
+                states = next;
+            }
+        }
+    };
 }
 
 #endif //KDL_STRING_COMPARE_DETAIL_H
@@ -23,6 +23,9 @@
 #include <algorithm> // for std::search
 #include <iterator>
 #include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <string>
 #include <string_view>
 #include <sstream>
@@ -30,6 +33,17 @@
 
 #include <nonstd/optional.hpp>
 
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+// std::from_chars is only available for floating point types if the library defines this macro
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define KDL_HAS_FROM_CHARS 1
+#endif
+
 namespace kdl {
     /**
      * Splits the given strings along the given delimiters and returns a list of the nonempty parts.
@@ -363,6 +377,103 @@ namespace kdl {
         }
     }
 
+    namespace detail {
+        /**
+         * Skips leading whitespace and a leading plus sign, which are accepted by the standard library's string
+         * conversion functions, but not by std::from_chars.
+         */
+        inline const char* skip_number_prefix(const char* begin, const char* end) {
+            while (begin != end && std::isspace(static_cast<unsigned char>(*begin))) {
+                ++begin;
+            }
+            if (end - begin > 1 && *begin == '+' && begin[1] != '+' && begin[1] != '-') {
+                ++begin;
+            }
+            return begin;
+        }
+
+#ifndef KDL_HAS_FROM_CHARS
+        /**
+         * Applies the given C library conversion function to a null terminated copy of the given characters. The copy
+         * is made on the stack unless the number of characters is large.
+         */
+        template <typename T, typename C>
+        nonstd::optional<T> chars_to_number(const char* begin, const char* end, const C& convert) {
+            constexpr std::size_t BufferSize = 64u;
+            const auto length = static_cast<std::size_t>(end - begin);
+
+            const auto doConvert = [&](const char* str) -> nonstd::optional<T> {
+                char* last = nullptr;
+                errno = 0;
+                const auto result = convert(str, &last);
+                if (last == str || errno == ERANGE) {
+                    return nonstd::nullopt;
+                }
+                return result;
+            };
+
+            if (length >= BufferSize) {
+                return doConvert(std::string(begin, end).c_str());
+            }
+
+            char buffer[BufferSize];
+            std::copy(begin, end, buffer);
+            buffer[length] = '\0';
+            return doConvert(buffer);
+        }
+#endif
+    }
+
+    /**
+     * Interprets the given range of characters as a signed long integer and returns it. If the characters cannot be
+     * parsed, returns an empty optional.
+     *
+     * Behaves like str_to_long, but does not require the characters to be copied into a string, and uses
+     * std::from_chars if available.
+     *
+     * @param begin the beginning of the range of characters
+     * @param end the end of the range of characters
+     * @return the signed long integer value or an empty optional if the given characters cannot be interpreted as a
+     * signed long integer
+     */
+    inline nonstd::optional<long> str_to_long(const char* begin, const char* end) {
+        begin = detail::skip_number_prefix(begin, end);
+#ifdef KDL_HAS_FROM_CHARS
+        long result;
+        if (std::from_chars(begin, end, result).ec != std::errc()) {
+            return nonstd::nullopt;
+        }
+        return result;
+#else
+        return detail::chars_to_number<long>(begin, end, [](const char* str, char** last) { return std::strtol(str, last, 10); });
+#endif
+    }
+
+    /**
+     * Interprets the given range of characters as a 64 bit floating point value and returns it. If the characters
+     * cannot be parsed, returns an empty optional.
+     *
+     * Behaves like str_to_double, but does not require the characters to be copied into a string, and uses
+     * std::from_chars if available.
+     *
+     * @param begin the beginning of the range of characters
+     * @param end the end of the range of characters
+     * @return the 64 bit floating point value or an empty optional if the given characters cannot be interpreted as a
+     * 64 bit floating point value
+     */
+    inline nonstd::optional<double> str_to_double(const char* begin, const char* end) {
+        begin = detail::skip_number_prefix(begin, end);
+#ifdef KDL_HAS_FROM_CHARS
+        double result;
+        if (std::from_chars(begin, end, result).ec != std::errc()) {
+            return nonstd::nullopt;
+        }
+        return result;
+#else
+        return detail::chars_to_number<double>(begin, end, [](const char* str, char** last) { return std::strtod(str, last); });
+#endif
+    }
+
     /**
      * Interprets the given string as a long double value value and returns it. If the given string cannot be parsed,
      * returns an empty optional.
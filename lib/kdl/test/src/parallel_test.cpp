@@ -0,0 +1,69 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include "kdl/parallel.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace kdl {
+    TEST(parallel_test, parallel_for) {
+        for (std::size_t threadCount = 1u; threadCount <= 8u; ++threadCount) {
+            auto counts = std::vector<int>(1000u, 0);
+            parallel_for(counts.size(), [&](const std::size_t i) {
+                ++counts[i];
+            }, threadCount);
+
+            ASSERT_EQ(std::vector<int>(1000u, 1), counts);
+        }
+    }
+
+    TEST(parallel_test, parallel_for_empty) {
+        std::atomic<std::size_t> calls(0u);
+        parallel_for(0u, [&](const std::size_t) { ++calls; }, 4u);
+        ASSERT_EQ(0u, calls);
+    }
+
+    TEST(parallel_test, parallel_for_rethrows) {
+        std::atomic<std::size_t> calls(0u);
+        ASSERT_THROW(parallel_for(100u, [&](const std::size_t i) {
+            ++calls;
+            if (i == 50u) {
+                throw std::runtime_error("test");
+            }
+        }, 4u), std::runtime_error);
+        ASSERT_EQ(100u, calls);
+    }
+
+    TEST(parallel_test, vec_parallel_transform) {
+        auto v = std::vector<int>();
+        for (int i = 0; i < 1000; ++i) {
+            v.push_back(i);
+        }
+
+        auto expected = std::vector<int>();
+        for (const int i : v) {
+            expected.push_back(i * 2);
+        }
+
+        ASSERT_EQ(expected, vec_parallel_transform(v, [](const int i) { return i * 2; }, 4u));
+        ASSERT_EQ(std::vector<int>(), vec_parallel_transform(std::vector<int>(), [](const int i) { return i * 2; }));
+    }
+}
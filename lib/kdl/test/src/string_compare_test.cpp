@@ -161,6 +161,32 @@ namespace kdl {
             ASSERT_TRUE(str_matches_glob("34dkadj%773", "*\\%%*"));
         }
 
+        TEST(string_utils_cs_test, glob_matcher) {
+            ASSERT_TRUE(glob_matcher("").matches(""));
+            ASSERT_FALSE(glob_matcher("?").matches(""));
+            ASSERT_TRUE(glob_matcher("a*f*l").matches("asdfjkl"));
+            ASSERT_FALSE(glob_matcher("a*f").matches("asdF"));
+            ASSERT_TRUE(glob_matcher("asd\\*\\?fj\\\\kl").matches("asd*?fj\\kl"));
+            ASSERT_TRUE(glob_matcher("Z*%*bdc").matches("Zasdf3376bdc"));
+            ASSERT_FALSE(glob_matcher("Zasdf%*").matches("Zasdf3376bdc"));
+            ASSERT_TRUE(glob_matcher("*\\%%*").matches("34dkadj%773"));
+            ASSERT_FALSE(glob_matcher("a\\b").matches("ab"));
+
+            // patterns that are too long to be compiled are matched by str_matches_glob
+            const auto longPattern = std::string(100u, '?') + "*";
+            ASSERT_TRUE(glob_matcher(longPattern).matches(std::string(120u, 'x')));
+            ASSERT_FALSE(glob_matcher(longPattern).matches(std::string(99u, 'x')));
+
+            const auto strings = std::vector<std::string>({ "", "a", "1", "ab1", "a1b", "*", "?", "%", "\\", "a*1?", "111", "ba%" });
+            const auto patterns = std::vector<std::string>({ "", "*", "?", "%", "%*", "a*", "*1", "a%*b", "\\*", "\\%%", "??", "*%*?", "b\\" });
+            for (const auto& pattern : patterns) {
+                const auto matcher = glob_matcher(pattern);
+                for (const auto& str : strings) {
+                    ASSERT_EQ(str_matches_glob(str, pattern), matcher.matches(str)) << str << " " << pattern;
+                }
+            }
+        }
+
         template <typename C>
         C sorted(C c) {
             kdl::sort(c, string_less());
@@ -304,6 +330,20 @@ namespace kdl {
             ASSERT_TRUE(str_matches_glob("aSD*?fJ\\kL", "asd\\*\\?fj\\\\kl"));
         }
 
+        TEST(string_utils_ci_test, glob_matcher) {
+            ASSERT_TRUE(glob_matcher("asdf").matches("ASdf"));
+            ASSERT_TRUE(glob_matcher("a*f").matches("aSDF"));
+            ASSERT_FALSE(glob_matcher("a?f").matches("AsDF"));
+            ASSERT_TRUE(glob_matcher("asd\\*fjkl").matches("ASd*fjKl"));
+            ASSERT_TRUE(glob_matcher("*light%").matches("SKY_Light2"));
+
+            // characters outside of the ASCII range
+            ASSERT_TRUE(glob_matcher("caf\xe9").matches("CAF\xe9"));
+            ASSERT_TRUE(glob_matcher("*\xe9*").matches("a\xe9" "b"));
+            ASSERT_FALSE(glob_matcher("caf\xe9").matches("cafe"));
+            ASSERT_FALSE(glob_matcher("cafe").matches("caf\xe9"));
+        }
+
         template <typename C>
         C sorted(C c) {
             kdl::sort(c, string_less());
@@ -175,6 +175,55 @@ namespace kdl {
         ASSERT_EQ(nonstd::nullopt, str_to_double(""));
     }
 
+    static nonstd::optional<long> str_to_long_range(const std::string& str) {
+        return str_to_long(str.data(), str.data() + str.size());
+    }
+
+    TEST(string_format_test, str_to_long_range) {
+        ASSERT_EQ(nonstd::optional<long>{0l}, str_to_long_range("0"));
+        ASSERT_EQ(nonstd::optional<long>{123231l}, str_to_long_range("123231"));
+        ASSERT_EQ(nonstd::optional<long>{123231l}, str_to_long_range("+123231"));
+        ASSERT_EQ(nonstd::optional<long>{-123231l}, str_to_long_range("-123231"));
+        ASSERT_EQ(nonstd::optional<long>{123231l}, str_to_long_range("123231b"));
+        ASSERT_EQ(nonstd::optional<long>{123231l}, str_to_long_range("   123231   "));
+        ASSERT_EQ(nonstd::nullopt, str_to_long_range("+-123231"));
+        ASSERT_EQ(nonstd::nullopt, str_to_long_range("a123231"));
+        ASSERT_EQ(nonstd::nullopt, str_to_long_range("99999999999999999999999"));
+        ASSERT_EQ(nonstd::nullopt, str_to_long_range(" "));
+        ASSERT_EQ(nonstd::nullopt, str_to_long_range(""));
+
+        // only the given range is parsed
+        const std::string str("1234");
+        ASSERT_EQ(nonstd::optional<long>{12l}, str_to_long(str.data(), str.data() + 2));
+    }
+
+    static nonstd::optional<double> str_to_double_range(const std::string& str) {
+        return str_to_double(str.data(), str.data() + str.size());
+    }
+
+    TEST(string_format_test, str_to_double_range) {
+        ASSERT_EQ(nonstd::optional<double>{0.0}, str_to_double_range("0"));
+        ASSERT_EQ(nonstd::optional<double>{1.0}, str_to_double_range("1.0"));
+        ASSERT_EQ(nonstd::optional<double>{1.0}, str_to_double_range("+1.0"));
+        ASSERT_EQ(nonstd::optional<double>{-0.5}, str_to_double_range("-.5"));
+        ASSERT_EQ(nonstd::optional<double>{1500.0}, str_to_double_range("1.5e3"));
+        ASSERT_EQ(nonstd::optional<double>{1.5}, str_to_double_range("  1.5abc"));
+        ASSERT_EQ(nonstd::nullopt, str_to_double_range("+-1.0"));
+        ASSERT_EQ(nonstd::nullopt, str_to_double_range("a123231.0"));
+        ASSERT_EQ(nonstd::nullopt, str_to_double_range("1e999"));
+        ASSERT_EQ(nonstd::nullopt, str_to_double_range(" "));
+        ASSERT_EQ(nonstd::nullopt, str_to_double_range(""));
+
+        // only the given range is parsed
+        const std::string str("0.125");
+        ASSERT_EQ(nonstd::optional<double>{0.1}, str_to_double(str.data(), str.data() + 3));
+
+        // the results are identical to those of str_to_double
+        for (const auto* value : { "0.7071067811865476", "-4095.999999", "3.4028234663852886e+38", "1e-300", "0.1", "123456789.123456789" }) {
+            ASSERT_EQ(str_to_double(value), str_to_double_range(value));
+        }
+    }
+
     TEST(string_format_test, str_to_long_double) {
         ASSERT_EQ(nonstd::optional<long double>{0.0L}, str_to_long_double("0"));
         ASSERT_EQ(nonstd::optional<long double>{1.0L}, str_to_long_double("1.0"));